@@ -0,0 +1,398 @@
+/**
+ * \file corrector_check.c
+ * \author Alex Andriati
+ * \brief Check the convergence-controlled corrector of Adams PC methods
+ *
+ * Two properties of `*_adams4pc_controlled` and `*_adams6pc_controlled`
+ * are checked:
+ *
+ * 1. With zero tolerances the corrector never converges, thus with a
+ *    maximum of `k` iterations the result must be bit-identical to the
+ *    fixed `k` iterations of `*_adams4pc` and `*_adams6pc`. A real system
+ *    of 3 equations and a complex system of 2 equations are integrated
+ *    with both routines for `k = 1, 2, 3`
+ *
+ * 2. The Milne estimate of a single step started from the exact solution
+ *    must agree with the true local error (computed minus exact) of the
+ *    converged corrector. A real system with known solution is used with
+ *    grid step 0.025, and the deviation is the norm of the difference of
+ *    the estimate and the true error relative to the norm of the latter
+ *
+ * After build the application, run:
+ * $ ./corrector_check
+ * which print the outcome of each case and exit with failure status if
+ * any result differs or the Milne estimate deviates more than 3%
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "singlestep.h"
+#include "multistep.h"
+
+
+#define CHECK_X0 0.8
+#define CHECK_NSTEPS 400
+#define CHECK_H 0.005
+#define MILNE_H 0.025
+#define MILNE_TOL 0.03
+
+
+/** \brief Forced Lorenz system with 3 equations */
+void
+real_sys_der(RealODEInputParameters inp_params, Rarray yprime)
+{
+    Rarray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = 10.0 * (y[1] - y[0]) + sin(inp_params->x);
+    yprime[1] = y[0] * (28.0 - y[2]) - y[1];
+    yprime[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+}
+
+
+/** \brief Nonlinear complex system with 2 equations */
+void
+cplx_sys_der(ComplexODEInputParameters inp_params, Carray yprime)
+{
+    Carray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = I * y[1] * inp_params->x - 0.1 * y[0] * y[0];
+    yprime[1] = I * y[0] + 0.3 * y[1] * conj(y[1]);
+}
+
+
+/** \brief System with solution `exp(-x / 2)`, `sin(x)` and `cos(x)` */
+void
+exact_sys_der(RealODEInputParameters inp_params, Rarray yprime)
+{
+    Rarray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = -0.5 * y[0];
+    yprime[1] = y[2];
+    yprime[2] = -y[1];
+}
+
+
+/** \brief Solution of `exact_sys_der` at `x` */
+void
+exact_solution(double x, Rarray y)
+{
+    y[0] = exp(-0.5 * x);
+    y[1] = sin(x);
+    y[2] = cos(x);
+}
+
+
+/** \brief Return 1 if controlled and fixed corrector give the same result
+ *
+ * \param 1 : multistep order, 4 or 6
+ * \param 2 : number of corrector iterations
+ */
+int
+real_compare_fixed(int ms_order, unsigned int iter)
+{
+    int
+        i,
+        same;
+    double
+        y0[3],
+        yfix[3],
+        yctr[3];
+    RealWorkspaceMS
+        ws_fix,
+        ws_ctr;
+    RealCorrectorControl
+        ctrl;
+
+    y0[0] = 1.0;
+    y0[1] = 2.0;
+    y0[2] = 3.0;
+    ws_fix = get_real_multistep_history_ws(ms_order, 3);
+    ws_ctr = get_real_multistep_history_ws(ms_order, 3);
+    ctrl = get_real_corrector_control(3, iter, 0.0, 0.0);
+    if (ms_order == 4)
+    {
+        init_real_multistep(
+                CHECK_H, &real_sys_der, NULL, ws_fix, y0,
+                &real_rungekutta4, NULL
+        );
+        init_real_multistep(
+                CHECK_H, &real_sys_der, NULL, ws_ctr, y0,
+                &real_rungekutta4, NULL
+        );
+    }
+    else
+    {
+        init_real_multistep(
+                CHECK_H, &real_sys_der, NULL, ws_fix, y0,
+                &real_rungekutta5, NULL
+        );
+        init_real_multistep(
+                CHECK_H, &real_sys_der, NULL, ws_ctr, y0,
+                &real_rungekutta5, NULL
+        );
+    }
+
+    same = 1;
+    for (i = ms_order - 1; i < CHECK_NSTEPS; i++)
+    {
+        if (ms_order == 4)
+        {
+            real_adams4pc(
+                    CHECK_H, i * CHECK_H, &real_sys_der, NULL, ws_fix, NULL,
+                    iter, yfix
+            );
+            if (real_adams4pc_controlled(
+                    CHECK_H, i * CHECK_H, &real_sys_der, NULL, ws_ctr, NULL,
+                    ctrl, NULL, yctr) == 0) same = 0;
+        }
+        else
+        {
+            real_adams6pc(
+                    CHECK_H, i * CHECK_H, &real_sys_der, NULL, ws_fix, NULL,
+                    iter, yfix
+            );
+            if (real_adams6pc_controlled(
+                    CHECK_H, i * CHECK_H, &real_sys_der, NULL, ws_ctr, NULL,
+                    ctrl, NULL, yctr) == 0) same = 0;
+        }
+        if (ctrl->iterations != iter) same = 0;
+        real_set_next_multistep(
+                (i + 1) * CHECK_H, &real_sys_der, NULL, ws_fix, NULL, yfix
+        );
+        real_set_next_multistep(
+                (i + 1) * CHECK_H, &real_sys_der, NULL, ws_ctr, NULL, yctr
+        );
+    }
+    if (memcmp(real_multistep_prev_step(ws_fix, 0),
+               real_multistep_prev_step(ws_ctr, 0), 3 * sizeof(double)) != 0)
+    {
+        same = 0;
+    }
+
+    destroy_real_corrector_control(ctrl);
+    destroy_real_multistep_ws(ws_fix);
+    destroy_real_multistep_ws(ws_ctr);
+    return same;
+}
+
+
+/** \brief Return 1 if controlled and fixed corrector give the same result
+ *
+ * \param 1 : multistep order, 4 or 6
+ * \param 2 : number of corrector iterations
+ */
+int
+cplx_compare_fixed(int ms_order, unsigned int iter)
+{
+    int
+        i,
+        same;
+    double complex
+        y0[2],
+        yfix[2],
+        yctr[2];
+    ComplexWorkspaceMS
+        ws_fix,
+        ws_ctr;
+    ComplexCorrectorControl
+        ctrl;
+
+    y0[0] = 1.0 + 0.5 * I;
+    y0[1] = 0.2 - I;
+    ws_fix = get_cplx_multistep_history_ws(ms_order, 2);
+    ws_ctr = get_cplx_multistep_history_ws(ms_order, 2);
+    ctrl = get_cplx_corrector_control(2, iter, 0.0, 0.0);
+    if (ms_order == 4)
+    {
+        init_cplx_multistep(
+                CHECK_H, &cplx_sys_der, NULL, ws_fix, y0,
+                &cplx_rungekutta4, NULL
+        );
+        init_cplx_multistep(
+                CHECK_H, &cplx_sys_der, NULL, ws_ctr, y0,
+                &cplx_rungekutta4, NULL
+        );
+    }
+    else
+    {
+        init_cplx_multistep(
+                CHECK_H, &cplx_sys_der, NULL, ws_fix, y0,
+                &cplx_rungekutta5, NULL
+        );
+        init_cplx_multistep(
+                CHECK_H, &cplx_sys_der, NULL, ws_ctr, y0,
+                &cplx_rungekutta5, NULL
+        );
+    }
+
+    same = 1;
+    for (i = ms_order - 1; i < CHECK_NSTEPS; i++)
+    {
+        if (ms_order == 4)
+        {
+            cplx_adams4pc(
+                    CHECK_H, i * CHECK_H, &cplx_sys_der, NULL, ws_fix, NULL,
+                    iter, yfix
+            );
+            if (cplx_adams4pc_controlled(
+                    CHECK_H, i * CHECK_H, &cplx_sys_der, NULL, ws_ctr, NULL,
+                    ctrl, NULL, yctr) == 0) same = 0;
+        }
+        else
+        {
+            cplx_adams6pc(
+                    CHECK_H, i * CHECK_H, &cplx_sys_der, NULL, ws_fix, NULL,
+                    iter, yfix
+            );
+            if (cplx_adams6pc_controlled(
+                    CHECK_H, i * CHECK_H, &cplx_sys_der, NULL, ws_ctr, NULL,
+                    ctrl, NULL, yctr) == 0) same = 0;
+        }
+        if (ctrl->iterations != iter) same = 0;
+        cplx_set_next_multistep(
+                (i + 1) * CHECK_H, &cplx_sys_der, NULL, ws_fix, NULL, yfix
+        );
+        cplx_set_next_multistep(
+                (i + 1) * CHECK_H, &cplx_sys_der, NULL, ws_ctr, NULL, yctr
+        );
+    }
+    if (memcmp(cplx_multistep_prev_step(ws_fix, 0),
+               cplx_multistep_prev_step(ws_ctr, 0),
+               2 * sizeof(double complex)) != 0)
+    {
+        same = 0;
+    }
+
+    destroy_cplx_corrector_control(ctrl);
+    destroy_cplx_multistep_ws(ws_fix);
+    destroy_cplx_multistep_ws(ws_ctr);
+    return same;
+}
+
+
+/** \brief Return relative deviation of Milne estimate from local error
+ *
+ * The history is set with the exact solution at `CHECK_X0 - j * h` and
+ * one step is done with the corrector iterated to convergence
+ *
+ * \param 1 : multistep order, 4 or 6
+ * \param 2 : grid step
+ */
+double
+milne_deviation(int ms_order, double h)
+{
+    int
+        i,
+        j;
+    double
+        err,
+        diff_summ,
+        err_summ,
+        yexact[3],
+        yerr[3],
+        ynext[3];
+    _RealODEInputParameters
+        sys_params;
+    RealWorkspaceMS
+        ws;
+    RealCorrectorControl
+        ctrl;
+
+    exact_solution(CHECK_X0, yexact);
+    ws = get_real_multistep_history_ws(ms_order, 3);
+    ctrl = get_real_corrector_control(3, 50, 1E-15, 1E-15);
+    init_real_multistep(
+            h, &exact_sys_der, NULL, ws, yexact, &real_rungekutta5, NULL
+    );
+    /* replace Runge-Kutta steps by the exact solution */
+    sys_params.system_size = 3;
+    sys_params.extra_args = NULL;
+    for (j = 0; j < ms_order; j++)
+    {
+        sys_params.x = CHECK_X0 - j * h;
+        sys_params.y = real_multistep_prev_step(ws, j);
+        exact_solution(sys_params.x, sys_params.y);
+        exact_sys_der(&sys_params, real_multistep_prev_der(ws, j));
+    }
+
+    if (ms_order == 4)
+    {
+        real_adams4pc_controlled(
+                h, CHECK_X0, &exact_sys_der, NULL, ws, NULL, ctrl, yerr,
+                ynext
+        );
+    }
+    else
+    {
+        real_adams6pc_controlled(
+                h, CHECK_X0, &exact_sys_der, NULL, ws, NULL, ctrl, yerr,
+                ynext
+        );
+    }
+    exact_solution(CHECK_X0 + h, yexact);
+
+    diff_summ = 0;
+    err_summ = 0;
+    for (i = 0; i < 3; i++)
+    {
+        err = ynext[i] - yexact[i];
+        diff_summ = diff_summ + (yerr[i] - err) * (yerr[i] - err);
+        err_summ = err_summ + err * err;
+    }
+
+    destroy_real_corrector_control(ctrl);
+    destroy_real_multistep_ws(ws);
+    return sqrt(diff_summ / err_summ);
+}
+
+
+int main()
+{
+    int
+        k,
+        failed,
+        real_same,
+        cplx_same,
+        orders[2] = {4, 6};
+    unsigned int
+        iter;
+    double
+        dev;
+
+    failed = 0;
+    printf("\nControlled corrector with zero tolerances vs fixed iterations");
+    for (k = 0; k < 2; k++)
+    {
+        for (iter = 1; iter <= 3; iter++)
+        {
+            real_same = real_compare_fixed(orders[k], iter);
+            cplx_same = cplx_compare_fixed(orders[k], iter);
+            printf("\nadams%dpc %u iterations  real %-10s complex %s",
+                   orders[k], iter,
+                   real_same ? "identical" : "DIFFERENT",
+                   cplx_same ? "identical" : "DIFFERENT");
+            if (!real_same || !cplx_same) failed = 1;
+        }
+    }
+
+    printf("\n\nMilne estimate vs true local error with h = %.3lf", MILNE_H);
+    for (k = 0; k < 2; k++)
+    {
+        dev = milne_deviation(orders[k], MILNE_H);
+        printf("\nadams%dpc  relative deviation %.2lf%%",
+               orders[k], 100 * dev);
+        if (dev > MILNE_TOL) failed = 1;
+    }
+
+    printf("\n\n");
+    if (failed) return EXIT_FAILURE;
+    return 0;
+}
@@ -0,0 +1,180 @@
+/**
+ * \file odesys_hpp_check.cpp
+ * \author Alex Andriati
+ * \brief Compare the C++ front end `odesys.hpp` with the C routines
+ *
+ * The templates of `odesys.hpp` repeat the operations of the library
+ * routines in the same order, thus without floating point contraction
+ * (this file and the library kernels are built with `-ffp-contract=off`)
+ * the results must be bit-identical to `*_integrate`. A real system of 3
+ * equations, with a parameter captured by the lambda, and a complex
+ * system of 2 equations, both depending on `x`, are solved with all
+ * methods of `*_integrate` in `odesys_hpp_reference.c` and here
+ *
+ * After build the application, run:
+ * $ ./odesys_hpp_check <number_of_steps>
+ * which print for each method if the results are identical and exit
+ * with failure status otherwise. Default number of steps is 400
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include "odesys.hpp"
+
+extern "C" void
+odesys_hpp_reference(int method, unsigned int nsteps, double * y, double * z);
+
+
+#define CHECK_X0 0.3
+#define CHECK_X1 2.3
+
+
+typedef std::complex<double> Complex;
+
+
+/** \brief Integrate with the C++ front end as `*_integrate`
+ *
+ * \param method : index in `FixedStepMethod` enumeration of integrate.h
+ * \param nsteps : number of steps from `CHECK_X0` to `CHECK_X1`
+ * \param f : callable computing derivatives `f(x, y, dy)`
+ * \param y : (MODIFIED) initial condition in input
+ */
+template <typename T, std::size_t N, typename F>
+void
+hpp_integrate(int method, unsigned int nsteps, F && f,
+              odesys::State<T, N> & y)
+{
+    unsigned int
+        i;
+    double
+        h;
+    odesys::State<T, N>
+        ynext;
+    odesys::Adams4PC<T, N>
+        adams4;
+    odesys::Adams6PC<T, N>
+        adams6;
+
+    h = (CHECK_X1 - CHECK_X0) / nsteps;
+    if (method < 3)
+    {
+        for (i = 0; i < nsteps; i++)
+        {
+            if (method == 0)
+            {
+                odesys::rungekutta2<T, N>(h, CHECK_X0 + i * h, f, y, y);
+            }
+            if (method == 1)
+            {
+                odesys::rungekutta4<T, N>(h, CHECK_X0 + i * h, f, y, y);
+            }
+            if (method == 2)
+            {
+                odesys::rungekutta5<T, N>(h, CHECK_X0 + i * h, f, y, y);
+            }
+        }
+        return;
+    }
+
+    if (method == 3)
+    {
+        adams4.init(h, CHECK_X0, f, y);
+        for (i = 3; i < nsteps; i++)
+        {
+            adams4.step(h, CHECK_X0 + i * h, f, 1, ynext);
+            adams4.set_next(CHECK_X0 + (i + 1) * h, f, ynext);
+        }
+        y = adams4.prev_step(0);
+        return;
+    }
+
+    adams6.init(h, CHECK_X0, f, y);
+    for (i = 5; i < nsteps; i++)
+    {
+        adams6.step(h, CHECK_X0 + i * h, f, 1, ynext);
+        adams6.set_next(CHECK_X0 + (i + 1) * h, f, ynext);
+    }
+    y = adams6.prev_step(0);
+}
+
+
+int main(int argc, char * argv[])
+{
+    int
+        m,
+        failed,
+        real_same,
+        cplx_same;
+    unsigned int
+        nsteps;
+    double
+        sigma,
+        y_ref[3],
+        z_ref[4];
+    const char
+        * names[5] = {"rungekutta2", "rungekutta4", "rungekutta5",
+                      "adams4pc", "adams6pc"};
+    odesys::State<double, 3>
+        y;
+    odesys::State<Complex, 2>
+        z;
+
+    nsteps = 400;
+    if (argc > 2)
+    {
+        printf("\nMax 1 argument accepted. %d given\n\n", argc - 1);
+        exit(EXIT_FAILURE);
+    }
+    if (argc == 2) sscanf(argv[1], "%u", &nsteps);
+    if (nsteps < 6)
+    {
+        printf("\nAt least 6 steps are required but %u given\n\n", nsteps);
+        exit(EXIT_FAILURE);
+    }
+
+    sigma = 10.0;
+    auto real_sys_der = [sigma](double x, const odesys::State<double, 3> & y,
+                                odesys::State<double, 3> & yprime)
+    {
+        yprime[0] = sigma * (y[1] - y[0]) + std::sin(x);
+        yprime[1] = y[0] * (28.0 - y[2]) - y[1];
+        yprime[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+    };
+    auto cplx_sys_der = [](double x, const odesys::State<Complex, 2> & y,
+                           odesys::State<Complex, 2> & yprime)
+    {
+        yprime[0] = Complex(0.0, 1.0) * y[1] * x - 0.1 * y[0] * y[0];
+        yprime[1] = Complex(0.0, 1.0) * y[0] + 0.3 * y[1] * std::conj(y[1]);
+    };
+
+    failed = 0;
+    for (m = 0; m < 5; m++)
+    {
+        y_ref[0] = 1.0;
+        y_ref[1] = 2.0;
+        y_ref[2] = 3.0;
+        z_ref[0] = 1.0;
+        z_ref[1] = 0.5;
+        z_ref[2] = 0.2;
+        z_ref[3] = -1.0;
+        y = {y_ref[0], y_ref[1], y_ref[2]};
+        z = {Complex(z_ref[0], z_ref[1]), Complex(z_ref[2], z_ref[3])};
+
+        odesys_hpp_reference(m, nsteps, y_ref, z_ref);
+        hpp_integrate<double, 3>(m, nsteps, real_sys_der, y);
+        hpp_integrate<Complex, 2>(m, nsteps, cplx_sys_der, z);
+
+        real_same = memcmp(y_ref, y.data(), sizeof(y_ref)) == 0;
+        cplx_same = memcmp(z_ref, z.data(), sizeof(z_ref)) == 0;
+        printf("\n%-12s real %-10s complex %s", names[m],
+               real_same ? "identical" : "DIFFERENT",
+               cplx_same ? "identical" : "DIFFERENT");
+        if (!real_same || !cplx_same) failed = 1;
+    }
+
+    printf("\n\n");
+    if (failed) return EXIT_FAILURE;
+    return 0;
+}
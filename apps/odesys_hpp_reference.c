@@ -0,0 +1,79 @@
+/**
+ * \file odesys_hpp_reference.c
+ * \author Alex Andriati
+ * \brief C side of `odesys_hpp_check`, see `odesys_hpp_check.cpp`
+ *
+ * The C headers use the C99 `double complex` type, thus the routines of
+ * the library are called from this file, and complex values are given
+ * to the C++ side as pairs of real and imaginary parts
+ */
+
+#include <math.h>
+#include "integrate.h"
+
+
+#define CHECK_X0 0.3
+#define CHECK_X1 2.3
+
+
+/** \brief Forced Lorenz system with 3 equations */
+static void
+real_sys_der(RealODEInputParameters inp_params, Rarray yprime)
+{
+    double
+        sigma;
+    Rarray
+        y;
+
+    y = inp_params->y;
+    sigma = *((double *) inp_params->extra_args);
+    yprime[0] = sigma * (y[1] - y[0]) + sin(inp_params->x);
+    yprime[1] = y[0] * (28.0 - y[2]) - y[1];
+    yprime[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+}
+
+
+/** \brief Nonlinear complex system with 2 equations */
+static void
+cplx_sys_der(ComplexODEInputParameters inp_params, Carray yprime)
+{
+    Carray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = I * y[1] * inp_params->x - 0.1 * y[0] * y[0];
+    yprime[1] = I * y[0] + 0.3 * y[1] * conj(y[1]);
+}
+
+
+/** \brief Integrate both systems with `*_integrate`
+ *
+ * \param 1 : method index in `FixedStepMethod` enumeration
+ * \param 2 : number of steps from `CHECK_X0` to `CHECK_X1`
+ * \param 3 : (MODIFIED) 3 real values, initial condition in input
+ * \param 4 : (MODIFIED) 2 complex values as 4 doubles (real and imag)
+ */
+void
+odesys_hpp_reference(int method, unsigned int nsteps, double * y, double * z)
+{
+    double
+        sigma;
+    double complex
+        zc[2];
+
+    sigma = 10.0;
+    zc[0] = z[0] + I * z[1];
+    zc[1] = z[2] + I * z[3];
+    real_integrate(
+            (FixedStepMethod) method, 1, 3, CHECK_X0, CHECK_X1, nsteps,
+            &real_sys_der, &sigma, nsteps, NULL, NULL, y
+    );
+    cplx_integrate(
+            (FixedStepMethod) method, 1, 2, CHECK_X0, CHECK_X1, nsteps,
+            &cplx_sys_der, NULL, nsteps, NULL, NULL, zc
+    );
+    z[0] = creal(zc[0]);
+    z[1] = cimag(zc[0]);
+    z[2] = creal(zc[1]);
+    z[3] = cimag(zc[1]);
+}
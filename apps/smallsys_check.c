@@ -0,0 +1,270 @@
+/**
+ * \file smallsys_check.c
+ * \author Alex Andriati
+ * \brief Compare routines of small fixed size with the generic ones
+ *
+ * The routines of `smallsys.h` repeat the operations of the generic
+ * routines in the same order, thus for every method of `*_integrate`
+ * the results must be bit-identical. A real system of 3 equations and
+ * a complex system of 2 equations, both depending on `x`, are solved
+ * with `*_integrate` and with the `_n3` and `_n2` routines
+ *
+ * After build the application, run:
+ * $ ./smallsys_check <number_of_steps>
+ * which print for each method if the results are identical and exit
+ * with failure status otherwise. Default number of steps is 400
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "integrate.h"
+#include "smallsys.h"
+
+
+#define CHECK_X0 0.3
+#define CHECK_X1 2.3
+
+
+/** \brief Forced Lorenz system with 3 equations */
+void
+real_sys_der(RealODEInputParameters inp_params, Rarray yprime)
+{
+    Rarray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = 10.0 * (y[1] - y[0]) + sin(inp_params->x);
+    yprime[1] = y[0] * (28.0 - y[2]) - y[1];
+    yprime[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+}
+
+
+/** \brief Nonlinear complex system with 2 equations */
+void
+cplx_sys_der(ComplexODEInputParameters inp_params, Carray yprime)
+{
+    Carray
+        y;
+
+    y = inp_params->y;
+    yprime[0] = I * y[1] * inp_params->x - 0.1 * y[0] * y[0];
+    yprime[1] = I * y[0] + 0.3 * y[1] * conj(y[1]);
+}
+
+
+/** \brief Integrate with specialized routines as `real_integrate` */
+void
+real_small_integrate(FixedStepMethod method, unsigned int nsteps, Rarray y)
+{
+    int
+        ms_order;
+    unsigned int
+        i;
+    double
+        h,
+        ynext[3];
+    RealSmallHistory
+        hist;
+
+    h = (CHECK_X1 - CHECK_X0) / nsteps;
+    ms_order = 0;
+    if (method == ADAMS4PC) ms_order = 4;
+    if (method == ADAMS6PC) ms_order = 6;
+
+    if (ms_order == 0)
+    {
+        for (i = 0; i < nsteps; i++)
+        {
+            if (method == RUNGEKUTTA2)
+            {
+                real_rungekutta2_n3(
+                        h, CHECK_X0 + i * h, &real_sys_der, NULL, y, y
+                );
+            }
+            if (method == RUNGEKUTTA4)
+            {
+                real_rungekutta4_n3(
+                        h, CHECK_X0 + i * h, &real_sys_der, NULL, y, y
+                );
+            }
+            if (method == RUNGEKUTTA5)
+            {
+                real_rungekutta5_n3(
+                        h, CHECK_X0 + i * h, &real_sys_der, NULL, y, y
+                );
+            }
+        }
+        return;
+    }
+
+    real_small_multistep_init_n3(
+            h, CHECK_X0, &real_sys_der, NULL, ms_order, y, &hist
+    );
+    for (i = ms_order - 1; i < nsteps; i++)
+    {
+        if (method == ADAMS4PC)
+        {
+            real_adams4pc_n3(
+                    h, CHECK_X0 + i * h, &real_sys_der, NULL, &hist, 1,
+                    ynext
+            );
+        }
+        else
+        {
+            real_adams6pc_n3(
+                    h, CHECK_X0 + i * h, &real_sys_der, NULL, &hist, 1,
+                    ynext
+            );
+        }
+        real_small_set_next_n3(
+                CHECK_X0 + (i + 1) * h, &real_sys_der, NULL, &hist, ynext
+        );
+    }
+    memcpy(y, real_small_prev_step(&hist, 0), 3 * sizeof(double));
+}
+
+
+/** \brief Integrate with specialized routines as `cplx_integrate` */
+void
+cplx_small_integrate(FixedStepMethod method, unsigned int nsteps, Carray y)
+{
+    int
+        ms_order;
+    unsigned int
+        i;
+    double
+        h;
+    double complex
+        ynext[2];
+    ComplexSmallHistory
+        hist;
+
+    h = (CHECK_X1 - CHECK_X0) / nsteps;
+    ms_order = 0;
+    if (method == ADAMS4PC) ms_order = 4;
+    if (method == ADAMS6PC) ms_order = 6;
+
+    if (ms_order == 0)
+    {
+        for (i = 0; i < nsteps; i++)
+        {
+            if (method == RUNGEKUTTA2)
+            {
+                cplx_rungekutta2_n2(
+                        h, CHECK_X0 + i * h, &cplx_sys_der, NULL, y, y
+                );
+            }
+            if (method == RUNGEKUTTA4)
+            {
+                cplx_rungekutta4_n2(
+                        h, CHECK_X0 + i * h, &cplx_sys_der, NULL, y, y
+                );
+            }
+            if (method == RUNGEKUTTA5)
+            {
+                cplx_rungekutta5_n2(
+                        h, CHECK_X0 + i * h, &cplx_sys_der, NULL, y, y
+                );
+            }
+        }
+        return;
+    }
+
+    cplx_small_multistep_init_n2(
+            h, CHECK_X0, &cplx_sys_der, NULL, ms_order, y, &hist
+    );
+    for (i = ms_order - 1; i < nsteps; i++)
+    {
+        if (method == ADAMS4PC)
+        {
+            cplx_adams4pc_n2(
+                    h, CHECK_X0 + i * h, &cplx_sys_der, NULL, &hist, 1,
+                    ynext
+            );
+        }
+        else
+        {
+            cplx_adams6pc_n2(
+                    h, CHECK_X0 + i * h, &cplx_sys_der, NULL, &hist, 1,
+                    ynext
+            );
+        }
+        cplx_small_set_next_n2(
+                CHECK_X0 + (i + 1) * h, &cplx_sys_der, NULL, &hist, ynext
+        );
+    }
+    memcpy(y, cplx_small_prev_step(&hist, 0), 2 * sizeof(double complex));
+}
+
+
+int main(int argc, char * argv[])
+{
+    int
+        m,
+        failed,
+        real_same,
+        cplx_same;
+    unsigned int
+        nsteps;
+    double
+        y_gen[3],
+        y_small[3];
+    double complex
+        z_gen[2],
+        z_small[2];
+    const char
+        * names[5] = {"rungekutta2", "rungekutta4", "rungekutta5",
+                      "adams4pc", "adams6pc"};
+    FixedStepMethod
+        methods[5] = {RUNGEKUTTA2, RUNGEKUTTA4, RUNGEKUTTA5,
+                      ADAMS4PC, ADAMS6PC};
+
+    nsteps = 400;
+    if (argc > 2)
+    {
+        printf("\nMax 1 argument accepted. %d given\n\n", argc - 1);
+        exit(EXIT_FAILURE);
+    }
+    if (argc == 2) sscanf(argv[1], "%u", &nsteps);
+    if (nsteps < 6)
+    {
+        printf("\nAt least 6 steps are required but %u given\n\n", nsteps);
+        exit(EXIT_FAILURE);
+    }
+
+    failed = 0;
+    for (m = 0; m < 5; m++)
+    {
+        y_gen[0] = 1.0;
+        y_gen[1] = 2.0;
+        y_gen[2] = 3.0;
+        z_gen[0] = 1.0 + 0.5 * I;
+        z_gen[1] = 0.2 - I;
+        memcpy(y_small, y_gen, sizeof(y_gen));
+        memcpy(z_small, z_gen, sizeof(z_gen));
+
+        real_integrate(
+                methods[m], 1, 3, CHECK_X0, CHECK_X1, nsteps,
+                &real_sys_der, NULL, nsteps, NULL, NULL, y_gen
+        );
+        cplx_integrate(
+                methods[m], 1, 2, CHECK_X0, CHECK_X1, nsteps,
+                &cplx_sys_der, NULL, nsteps, NULL, NULL, z_gen
+        );
+        real_small_integrate(methods[m], nsteps, y_small);
+        cplx_small_integrate(methods[m], nsteps, z_small);
+
+        real_same = memcmp(y_gen, y_small, sizeof(y_gen)) == 0;
+        cplx_same = memcmp(z_gen, z_small, sizeof(z_gen)) == 0;
+        printf("\n%-12s real %-10s complex %s", names[m],
+               real_same ? "identical" : "DIFFERENT",
+               cplx_same ? "identical" : "DIFFERENT");
+        if (!real_same || !cplx_same) failed = 1;
+    }
+
+    printf("\n\n");
+    if (failed) return EXIT_FAILURE;
+    return 0;
+}
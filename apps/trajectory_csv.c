@@ -0,0 +1,54 @@
+/**
+ * \file trajectory_csv.c
+ * \author Alex Andriati
+ * \brief Convert binary trajectory file to CSV text
+ *
+ * Files written by the trajectory sink of trajectory.h keep raw values
+ * to avoid text formatting during the integration. This application
+ * converts them for plotting tools or inspection
+ *
+ * After build the application, run:
+ * $ ./trajectory_csv <binary_file> [<csv_file>]
+ * where the CSV text is printed in the terminal if no output file is
+ * given. Values are printed with 17 significant digits, thus the
+ * conversion back to double is exact
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "trajectory.h"
+
+
+int main(int argc, char * argv[])
+{
+    long
+        nrec;
+    FILE
+        * out;
+
+    if (argc < 2 || argc > 3)
+    {
+        printf("\nUsage: %s <binary_file> [<csv_file>]\n\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    out = stdout;
+    if (argc == 3)
+    {
+        out = fopen(argv[2], "w");
+        if (out == NULL)
+        {
+            printf("\nCannot open output file %s\n\n", argv[2]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    nrec = real_trajectory_to_csv(argv[1], out);
+    if (out != stdout) fclose(out);
+    if (nrec < 0)
+    {
+        fprintf(stderr, "\nInvalid trajectory file %s\n\n", argv[1]);
+        exit(EXIT_FAILURE);
+    }
+    return 0;
+}
@@ -0,0 +1,410 @@
+/**
+ * \file bench_problems.c
+ * \author Alex Andriati
+ * \brief Definition of standard test problems for benchmarks
+ *
+ * Stiff problems and constants are taken from ref. [1] sec. IV.10 and
+ * ref. [2]. The interval of the stiff ones is short enough to allow
+ * explicit methods with the step sizes used in the benchmarks
+ *
+ * [1] E. Hairer and G. Wanner, Solving Ordinary Differential Equations II,
+ * Stiff and Differential-Algebraic Problems, Springer, 2nd Edition
+ * [2] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ */
+
+#include <math.h>
+#include <time.h>
+#include "bench_problems.h"
+
+#define BRUSS_ALPHA_1D (1.0 / 50)
+#define BRUSS_ALPHA_2D 0.1
+#define NBODY_SOFTENING 0.1
+#define TRAP_LENGTH 20.0
+
+
+static void
+lorenz(RealODEInputParameters inp, Rarray der)
+{
+    Rarray y = inp->y;
+    der[0] = 10 * (y[1] - y[0]);
+    der[1] = y[0] * (28 - y[2]) - y[1];
+    der[2] = y[0] * y[1] - 8.0 / 3 * y[2];
+}
+
+
+static void
+vanderpol(RealODEInputParameters inp, Rarray der)
+{
+    Rarray y = inp->y;
+    der[0] = y[1];
+    der[1] = 5 * (1 - y[0] * y[0]) * y[1] - y[0];
+}
+
+
+static void
+robertson(RealODEInputParameters inp, Rarray der)
+{
+    Rarray y = inp->y;
+    der[0] = - 0.04 * y[0] + 1E4 * y[1] * y[2];
+    der[2] = 3E7 * y[1] * y[1];
+    der[1] = - der[0] - der[2];
+}
+
+
+static void
+robertson_jac(RealODEInputParameters inp, Rarray jac)
+{
+    Rarray y = inp->y;
+    jac[0] = - 0.04;
+    jac[1] = 1E4 * y[2];
+    jac[2] = 1E4 * y[1];
+    jac[6] = 0;
+    jac[7] = 6E7 * y[1];
+    jac[8] = 0;
+    jac[3] = - jac[0] - jac[6];
+    jac[4] = - jac[1] - jac[7];
+    jac[5] = - jac[2] - jac[8];
+}
+
+
+/* y = [u_1 ... u_n v_1 ... v_n] with u = 1 and v = 3 at boundaries */
+static void
+brusselator1d(RealODEInputParameters inp, Rarray der)
+{
+    unsigned int
+        i,
+        n;
+    double
+        c,
+        ul,
+        ur,
+        vl,
+        vr;
+    Rarray
+        u,
+        v;
+    n = inp->system_size / 2;
+    u = inp->y;
+    v = &inp->y[n];
+    c = BRUSS_ALPHA_1D * (n + 1) * (n + 1);
+    for (i = 0; i < n; i++)
+    {
+        ul = (i == 0) ? 1.0 : u[i - 1];
+        ur = (i == n - 1) ? 1.0 : u[i + 1];
+        vl = (i == 0) ? 3.0 : v[i - 1];
+        vr = (i == n - 1) ? 3.0 : v[i + 1];
+        der[i] = 1 + u[i] * u[i] * v[i] - 4 * u[i]
+               + c * (ul - 2 * u[i] + ur);
+        der[n + i] = 3 * u[i] - u[i] * u[i] * v[i]
+                   + c * (vl - 2 * v[i] + vr);
+    }
+}
+
+
+/* periodic grid with u at `[i * n + j]` followed by v in same layout */
+static void
+brusselator2d(RealODEInputParameters inp, Rarray der)
+{
+    unsigned int
+        i,
+        j,
+        k,
+        n,
+        nn;
+    double
+        c,
+        lu,
+        lv;
+    Rarray
+        u,
+        v;
+    nn = inp->system_size / 2;
+    n = (unsigned int) (sqrt((double) nn) + 0.5);
+    u = inp->y;
+    v = &inp->y[nn];
+    c = BRUSS_ALPHA_2D * n * n;
+    for (i = 0; i < n; i++)
+    {
+        for (j = 0; j < n; j++)
+        {
+            k = i * n + j;
+            lu = u[((i + n - 1) % n) * n + j] + u[((i + 1) % n) * n + j]
+               + u[i * n + (j + n - 1) % n] + u[i * n + (j + 1) % n]
+               - 4 * u[k];
+            lv = v[((i + n - 1) % n) * n + j] + v[((i + 1) % n) * n + j]
+               + v[i * n + (j + n - 1) % n] + v[i * n + (j + 1) % n]
+               - 4 * v[k];
+            der[k] = 1 + u[k] * u[k] * v[k] - 4.4 * u[k] + c * lu;
+            der[nn + k] = 3.4 * u[k] - u[k] * u[k] * v[k] + c * lv;
+        }
+    }
+}
+
+
+/* y = [positions (3 per body) velocities (3 per body)], masses 1 / n */
+static void
+nbody(RealODEInputParameters inp, Rarray der)
+{
+    unsigned int
+        i,
+        j,
+        d,
+        n;
+    double
+        dr[3],
+        r2,
+        f;
+    Rarray
+        pos,
+        vel,
+        acc;
+    n = inp->system_size / 6;
+    pos = inp->y;
+    vel = &inp->y[3 * n];
+    acc = &der[3 * n];
+    for (i = 0; i < 3 * n; i++)
+    {
+        der[i] = vel[i];
+        acc[i] = 0;
+    }
+    for (i = 0; i < n; i++)
+    {
+        for (j = i + 1; j < n; j++)
+        {
+            r2 = NBODY_SOFTENING * NBODY_SOFTENING;
+            for (d = 0; d < 3; d++)
+            {
+                dr[d] = pos[3 * j + d] - pos[3 * i + d];
+                r2 = r2 + dr[d] * dr[d];
+            }
+            f = 1.0 / (n * r2 * sqrt(r2));
+            for (d = 0; d < 3; d++)
+            {
+                acc[3 * i + d] = acc[3 * i + d] + f * dr[d];
+                acc[3 * j + d] = acc[3 * j + d] - f * dr[d];
+            }
+        }
+    }
+}
+
+
+/* i psi' = - psi'' / 2 + x^2 psi / 2 with zero at domain boundaries */
+static void
+schrodinger(ComplexODEInputParameters inp, Carray der)
+{
+    unsigned int
+        i,
+        n;
+    double
+        dx,
+        x;
+    double complex
+        left,
+        right;
+    Carray
+        psi;
+    n = inp->system_size;
+    psi = inp->y;
+    dx = TRAP_LENGTH / (n + 1);
+    for (i = 0; i < n; i++)
+    {
+        x = - TRAP_LENGTH / 2 + (i + 1) * dx;
+        left = (i == 0) ? 0 : psi[i - 1];
+        right = (i == n - 1) ? 0 : psi[i + 1];
+        der[i] = I * (0.5 * (left - 2 * psi[i] + right) / (dx * dx)
+               - 0.5 * x * x * psi[i]);
+    }
+}
+
+
+void
+bench_problem_setup(BenchProblemId id, unsigned int param, BenchProblem * p)
+{
+    p->id = id;
+    p->param = param;
+    p->is_complex = 0;
+    p->x0 = 0;
+    p->x1 = 1;
+    p->der = NULL;
+    p->cder = NULL;
+    p->jac = NULL;
+    p->args = NULL;
+    switch (id)
+    {
+        case LORENZ:
+            p->name = "lorenz";
+            p->param = 3;
+            p->system_size = 3;
+            p->der = &lorenz;
+            break;
+        case VANDERPOL:
+            p->name = "vanderpol";
+            p->param = 2;
+            p->system_size = 2;
+            p->x1 = 2;
+            p->der = &vanderpol;
+            break;
+        case ROBERTSON:
+            p->name = "robertson";
+            p->param = 3;
+            p->system_size = 3;
+            p->x1 = 0.05;
+            p->der = &robertson;
+            p->jac = &robertson_jac;
+            break;
+        case BRUSSELATOR_1D:
+            p->name = "brusselator1d";
+            p->system_size = 2 * param;
+            p->der = &brusselator1d;
+            break;
+        case BRUSSELATOR_2D:
+            p->name = "brusselator2d";
+            p->system_size = 2 * param * param;
+            p->x1 = 0.5;
+            p->der = &brusselator2d;
+            break;
+        case NBODY:
+            p->name = "nbody";
+            p->system_size = 6 * param;
+            p->der = &nbody;
+            break;
+        case SCHRODINGER:
+            p->name = "schrodinger";
+            p->is_complex = 1;
+            p->system_size = param;
+            p->x1 = 0.5;
+            p->cder = &schrodinger;
+            break;
+    }
+}
+
+
+void
+bench_problem_init_real(BenchProblem * p, Rarray y)
+{
+    unsigned int
+        i,
+        j,
+        n;
+    double
+        s,
+        t;
+    unsigned long
+        seed;
+
+    n = p->param;
+    switch (p->id)
+    {
+        case LORENZ:
+            y[0] = 1;
+            y[1] = 1;
+            y[2] = 1;
+            break;
+        case VANDERPOL:
+            y[0] = 2;
+            y[1] = 0;
+            break;
+        case ROBERTSON:
+            y[0] = 1;
+            y[1] = 0;
+            y[2] = 0;
+            break;
+        case BRUSSELATOR_1D:
+            for (i = 0; i < n; i++)
+            {
+                y[i] = 1 + sin(2 * M_PI * (i + 1) / (n + 1));
+                y[n + i] = 3;
+            }
+            break;
+        case BRUSSELATOR_2D:
+            for (i = 0; i < n; i++)
+            {
+                s = (double) i / n;
+                for (j = 0; j < n; j++)
+                {
+                    t = (double) j / n;
+                    y[i * n + j] = 22 * t * pow(1 - t, 1.5);
+                    y[n * n + i * n + j] = 27 * s * pow(1 - s, 1.5);
+                }
+            }
+            break;
+        case NBODY:
+            /* bodies around a ring with deterministic perturbations */
+            seed = 12345;
+            for (i = 0; i < n; i++)
+            {
+                s = 2 * M_PI * i / n;
+                for (j = 0; j < 6; j++)
+                {
+                    seed = (1103515245 * seed + 12345) % 2147483648UL;
+                    t = 0.1 * ((double) seed / 2147483648UL - 0.5);
+                    if (j < 3) y[3 * i + j] = t;
+                    else       y[3 * n + 3 * i + j - 3] = t;
+                }
+                y[3 * i] = y[3 * i] + cos(s);
+                y[3 * i + 1] = y[3 * i + 1] + sin(s);
+                y[3 * n + 3 * i] = y[3 * n + 3 * i] - 0.5 * sin(s);
+                y[3 * n + 3 * i + 1] = y[3 * n + 3 * i + 1] + 0.5 * cos(s);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+
+void
+bench_problem_init_cplx(BenchProblem * p, Carray y)
+{
+    unsigned int
+        i,
+        n;
+    double
+        dx,
+        x;
+    n = p->param;
+    dx = TRAP_LENGTH / (n + 1);
+    for (i = 0; i < n; i++)
+    {
+        /* displaced ground state of the harmonic trap */
+        x = - TRAP_LENGTH / 2 + (i + 1) * dx;
+        y[i] = exp(- 0.5 * (x - 1) * (x - 1)) / pow(M_PI, 0.25);
+    }
+}
+
+
+void
+bench_counted_der(RealODEInputParameters inp, Rarray der)
+{
+    BenchCounter
+        * counter;
+    counter = (BenchCounter *) inp->extra_args;
+    counter->calls++;
+    inp->extra_args = counter->args;
+    counter->der(inp, der);
+    inp->extra_args = (void *) counter;
+}
+
+
+void
+bench_counted_cder(ComplexODEInputParameters inp, Carray der)
+{
+    BenchCounter
+        * counter;
+    counter = (BenchCounter *) inp->extra_args;
+    counter->calls++;
+    inp->extra_args = counter->args;
+    counter->cder(inp, der);
+    inp->extra_args = (void *) counter;
+}
+
+
+double
+bench_clock(void)
+{
+    struct timespec
+        t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + 1E-9 * t.tv_nsec;
+}
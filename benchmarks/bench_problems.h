@@ -0,0 +1,95 @@
+/**
+ * \file bench_problems.h
+ * \author Alex Andriati
+ * \brief Standard test problems used by benchmark tools
+ *
+ * Each problem provides the derivative routine, initial condition and
+ * integration interval, with a size parameter for those defined on a
+ * grid or with several bodies. A wrapper of the derivative routine
+ * counts the number of evaluations (RHS calls)
+ */
+
+#ifndef ODE_BENCH_PROBLEMS_H
+#define ODE_BENCH_PROBLEMS_H
+
+#include "odesys.h"
+
+/** \brief Identifier of standard problems */
+typedef enum{
+    LORENZ,             /// chaotic system with 3 equations
+    VANDERPOL,          /// oscillator with `mu = 5`, 2 equations
+    ROBERTSON,          /// stiff chemical kinetics, 3 equations
+    BRUSSELATOR_1D,     /// reaction-diffusion in `size` grid points
+    BRUSSELATOR_2D,     /// reaction-diffusion in `size x size` grid
+    NBODY,              /// gravitational problem with `size` bodies
+    SCHRODINGER         /// complex linear harmonic trap, `size` points
+} BenchProblemId;
+
+/** \brief Problem setup with derivative, interval and initial condition */
+typedef struct{
+    BenchProblemId
+        id;
+    const char
+        * name;
+    int
+        is_complex;     /// nonzero if `cder` must be used
+    unsigned int
+        param,          /// size parameter given to the problem
+        system_size;    /// number of equations
+    double
+        x0,             /// initial grid point
+        x1;             /// final grid point
+    real_odesys_der
+        der;            /// derivatives of real problems
+    cplx_odesys_der
+        cder;           /// derivatives of complex problems
+    real_odesys_jac
+        jac;            /// analytic Jacobian (NULL if not provided)
+    void
+        * args;         /// extra arguments of derivative routine
+} BenchProblem;
+
+/** \brief Extra arguments of derivative wrapper counting calls */
+typedef struct{
+    real_odesys_der
+        der;
+    cplx_odesys_der
+        cder;
+    void
+        * args;
+    unsigned long
+        calls;
+} BenchCounter;
+
+
+/** \brief Set problem struct fields
+ *
+ * \param 1 : problem identifier
+ * \param 2 : size parameter (ignored for fixed size problems)
+ * \param 3 : (OUTPUT) problem setup
+ */
+void
+bench_problem_setup(BenchProblemId, unsigned int, BenchProblem *);
+
+/** \brief Set initial condition of real problem */
+void
+bench_problem_init_real(BenchProblem *, Rarray);
+
+/** \brief Set initial condition of complex problem */
+void
+bench_problem_init_cplx(BenchProblem *, Carray);
+
+/** \brief Real derivative wrapper with `BenchCounter` in `extra_args` */
+void
+bench_counted_der(RealODEInputParameters, Rarray);
+
+/** \brief Complex derivative wrapper with `BenchCounter` in `extra_args` */
+void
+bench_counted_cder(ComplexODEInputParameters, Carray);
+
+/** \brief Elapsed time in seconds from an arbitrary fixed instant */
+double
+bench_clock(void);
+
+
+#endif
@@ -0,0 +1,351 @@
+/**
+ * \file odesys_bench.c
+ * \author Alex Andriati
+ * \brief Benchmark of all fixed step integrators on standard problems
+ *
+ * For every problem, system size and step size, each method integrates
+ * the whole interval and the following data are written in JSON format
+ * (to the file given as first argument or to standard output):
+ *
+ * - ns_per_step     : wall time per step (best of several repetitions)
+ * - rhs_per_step    : number of derivative evaluations per step
+ * - workspace_bytes : memory allocated by the integrator
+ * - error           : max norm of the difference to a reference solution
+ *                     relative to the max norm of the reference
+ * - stable          : false if the run failed or the error is not finite
+ *                     or above `MAX_STABLE_ERROR` (then `error` is null)
+ *
+ * The reference is computed with 5th order Runge-Kutta and step size 8
+ * times smaller than the smallest one of the problem. BDF uses dense LU
+ * decomposition and thus runs only for systems up to `BDF_MAX_SIZE`
+ *
+ * The step sizes are given for each system size, such that `h` times
+ * the largest eigenvalue of the Jacobian stays inside the stability
+ * region of all methods. In the method of lines problems it grows with
+ * `1 / dx^2`, thus the steps of the larger grids are smaller
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "bench_problems.h"
+
+#define MIN_TIME 0.02
+#define MAX_REPETITIONS 1000
+#define REF_REFINEMENT 8
+#define BDF_MAX_SIZE 256
+#define MAX_STABLE_ERROR 1.0
+#define NMETHODS 6
+
+typedef enum{
+    BENCH_RK2,
+    BENCH_RK4,
+    BENCH_RK5,
+    BENCH_ADAMS4,
+    BENCH_ADAMS6,
+    BENCH_BDF5
+} BenchMethod;
+
+static const char
+    * method_names[NMETHODS] = {
+        "rungekutta2",
+        "rungekutta4",
+        "rungekutta5",
+        "adams4pc",
+        "adams6pc",
+        "bdf5"
+    };
+
+/** \brief Problems, size parameters and step sizes of the benchmark
+ *
+ * `steps[s]` are the two step sizes used with size parameter `params[s]`
+ */
+typedef struct{
+    BenchProblemId
+        id;
+    unsigned int
+        params[2];
+    double
+        steps[2][2];
+} BenchCase;
+
+/* Schrodinger: max|lambda| = 2 / dx^2 + 50, about 130 with 128 points
+ * and 1370 with 512 points, then h * max|lambda| is at most 0.34 */
+static BenchCase
+    cases[] = {
+        {LORENZ, {3, 0}, {{1E-2, 5E-3}, {0, 0}}},
+        {VANDERPOL, {2, 0}, {{1E-2, 5E-3}, {0, 0}}},
+        {ROBERTSON, {3, 0}, {{1E-4, 5E-5}, {0, 0}}},
+        {BRUSSELATOR_1D, {32, 128}, {{5E-4, 2.5E-4}, {5E-4, 2.5E-4}}},
+        {BRUSSELATOR_2D, {16, 32}, {{5E-4, 2.5E-4}, {5E-4, 2.5E-4}}},
+        {NBODY, {8, 64}, {{1E-2, 5E-3}, {1E-2, 5E-3}}},
+        {SCHRODINGER, {128, 512}, {{1E-3, 5E-4}, {2.5E-4, 1.25E-4}}}
+    };
+
+
+/** \brief Memory allocated by method for system of `n` elements */
+static unsigned long
+workspace_bytes(BenchMethod method, unsigned long n, unsigned long elem)
+{
+    int
+        nstages;
+    switch (method)
+    {
+        case BENCH_ADAMS4:
+            return (4 + 1 + 4 + 1) * n * elem;
+        case BENCH_ADAMS6:
+            return (6 + 1 + 6 + 1) * n * elem;
+        case BENCH_BDF5:
+            return ((5 + 1 + 5 + 4) * n + 2 * n * n) * elem
+                   + n * sizeof(int);
+        default:
+            /* Runge-Kutta workspace arena (in-place steps) */
+            nstages = RK5_WS_STAGES;
+            if (method == BENCH_RK2) nstages = RK2_WS_STAGES;
+            if (method == BENCH_RK4) nstages = RK4_WS_STAGES;
+            if (elem == sizeof(double))
+            {
+                return real_rungekutta_ws_bytes(n, nstages);
+            }
+            return cplx_rungekutta_ws_bytes(n, nstages);
+    }
+}
+
+
+static FixedStepMethod
+fixed_step_method(BenchMethod method)
+{
+    switch (method)
+    {
+        case BENCH_RK2:
+            return RUNGEKUTTA2;
+        case BENCH_RK4:
+            return RUNGEKUTTA4;
+        case BENCH_ADAMS4:
+            return ADAMS4PC;
+        case BENCH_ADAMS6:
+            return ADAMS6PC;
+        default:
+            return RUNGEKUTTA5;
+    }
+}
+
+
+/** \brief Integrate real problem with BDF, return -1 if Newton failed */
+static int
+run_bdf(BenchProblem * p, real_odesys_der der, void * args,
+        unsigned int nsteps, Rarray y)
+{
+    unsigned int
+        i,
+        n;
+    double
+        h;
+    RealWorkspaceBDF
+        ws;
+    n = p->system_size;
+    h = (p->x1 - p->x0) / nsteps;
+    ws = get_real_bdf_ws(BDF_MAX_ORDER, n);
+    init_real_bdf(h, der, args, ws, y, &real_rungekutta5);
+    for (i = ws->ms.ms_order - 1; i < nsteps; i++)
+    {
+        if (real_bdf_step(h, p->x0 + i * h, der, p->jac, args, ws, y))
+        {
+            destroy_real_bdf_ws(ws);
+            return -1;
+        }
+    }
+    destroy_real_bdf_ws(ws);
+    return 0;
+}
+
+
+/** \brief Run method once from initial condition, return 0 if succeeded */
+static int
+run_once(BenchProblem * p, BenchMethod method, unsigned int nsteps,
+         int counted, BenchCounter * counter, void * y)
+{
+    void
+        * args;
+    real_odesys_der
+        der;
+    cplx_odesys_der
+        cder;
+
+    counter->der = p->der;
+    counter->cder = p->cder;
+    counter->args = p->args;
+    der = counted ? &bench_counted_der : p->der;
+    cder = counted ? &bench_counted_cder : p->cder;
+    args = counted ? (void *) counter : p->args;
+    if (p->is_complex)
+    {
+        bench_problem_init_cplx(p, (Carray) y);
+        cplx_integrate(
+                fixed_step_method(method), 1, p->system_size, p->x0,
+                p->x1, nsteps, cder, args, nsteps, NULL, NULL, (Carray) y
+        );
+        return 0;
+    }
+    bench_problem_init_real(p, (Rarray) y);
+    if (method == BENCH_BDF5) return run_bdf(p, der, args, nsteps, y);
+    real_integrate(
+            fixed_step_method(method), 1, p->system_size, p->x0, p->x1,
+            nsteps, der, args, nsteps, NULL, NULL, (Rarray) y
+    );
+    return 0;
+}
+
+
+/** \brief Relative difference in max norm of real or complex arrays */
+static double
+relative_error(BenchProblem * p, void * y, void * yref)
+{
+    unsigned int
+        i;
+    double
+        diff,
+        norm,
+        d,
+        r;
+    diff = 0;
+    norm = 0;
+    for (i = 0; i < p->system_size; i++)
+    {
+        if (p->is_complex)
+        {
+            d = cabs(((Carray) y)[i] - ((Carray) yref)[i]);
+            r = cabs(((Carray) yref)[i]);
+        }
+        else
+        {
+            d = fabs(((Rarray) y)[i] - ((Rarray) yref)[i]);
+            r = fabs(((Rarray) yref)[i]);
+        }
+        if (!(d <= diff)) diff = d;
+        if (r > norm) norm = r;
+    }
+    return diff / norm;
+}
+
+
+static void
+json_double(FILE * out, const char * key, double value, const char * end)
+{
+    if (isfinite(value)) fprintf(out, "\"%s\": %.6e%s", key, value, end);
+    else                 fprintf(out, "\"%s\": null%s", key, end);
+}
+
+
+int main(int argc, char * argv[])
+{
+    int
+        failed,
+        stable,
+        first;
+    unsigned int
+        c,
+        s,
+        k,
+        m,
+        nsteps,
+        reps;
+    unsigned long
+        elem;
+    double
+        t0,
+        elapsed,
+        best,
+        error;
+    void
+        * y,
+        * yref;
+    FILE
+        * out;
+    BenchProblem
+        p;
+    BenchCounter
+        counter;
+
+    out = stdout;
+    if (argc > 1)
+    {
+        out = fopen(argv[1], "w");
+        if (out == NULL)
+        {
+            printf("\nCannot open output file %s\n\n", argv[1]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    fprintf(out, "{\n  \"library\": \"odesys\",\n  \"results\": [");
+    first = 1;
+    for (c = 0; c < sizeof(cases) / sizeof(BenchCase); c++)
+    {
+        for (s = 0; s < 2 && cases[c].params[s] > 0; s++)
+        {
+            bench_problem_setup(cases[c].id, cases[c].params[s], &p);
+            elem = p.is_complex ? sizeof(double complex) : sizeof(double);
+            y = malloc(p.system_size * elem);
+            yref = malloc(p.system_size * elem);
+            if (y == NULL || yref == NULL)
+            {
+                printf("\nProblem in benchmark array allocation\n\n");
+                exit(EXIT_FAILURE);
+            }
+
+            nsteps = (unsigned int)
+                     ((p.x1 - p.x0) / cases[c].steps[s][1] + 0.5);
+            run_once(&p, BENCH_RK5, REF_REFINEMENT * nsteps, 0, &counter, yref);
+
+            for (k = 0; k < 2; k++)
+            {
+                nsteps = (unsigned int)
+                         ((p.x1 - p.x0) / cases[c].steps[s][k] + 0.5);
+                for (m = 0; m < NMETHODS; m++)
+                {
+                    if (m == BENCH_BDF5 && (p.is_complex
+                                || p.system_size > BDF_MAX_SIZE)) continue;
+                    counter.calls = 0;
+                    failed = run_once(&p, m, nsteps, 1, &counter, y);
+                    error = failed ? NAN : relative_error(&p, y, yref);
+                    /* a diverged solution carries no error information */
+                    stable = isfinite(error) && error <= MAX_STABLE_ERROR;
+                    if (!stable) error = NAN;
+                    best = INFINITY;
+                    reps = 0;
+                    elapsed = 0;
+                    while (elapsed < MIN_TIME && reps < MAX_REPETITIONS)
+                    {
+                        t0 = bench_clock();
+                        run_once(&p, m, nsteps, 0, &counter, y);
+                        t0 = bench_clock() - t0;
+                        if (t0 < best) best = t0;
+                        elapsed = elapsed + t0;
+                        reps++;
+                    }
+
+                    fprintf(out, "%s\n    {", first ? "" : ",");
+                    first = 0;
+                    fprintf(out, "\"problem\": \"%s\", ", p.name);
+                    fprintf(out, "\"system_size\": %u, ", p.system_size);
+                    fprintf(out, "\"method\": \"%s\", ", method_names[m]);
+                    json_double(out, "h", cases[c].steps[s][k], ", ");
+                    fprintf(out, "\"steps\": %u, ", nsteps);
+                    json_double(out, "ns_per_step", 1E9 * best / nsteps, ", ");
+                    json_double(out, "rhs_per_step",
+                            (double) counter.calls / nsteps, ", ");
+                    fprintf(out, "\"workspace_bytes\": %lu, ",
+                            workspace_bytes(m, p.system_size, elem));
+                    fprintf(out, "\"stable\": %s, ", stable ? "true" : "false");
+                    json_double(out, "error", error, "}");
+                }
+            }
+            free(y);
+            free(yref);
+        }
+    }
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,327 @@
+/**
+ * \file workprecision.c
+ * \author Alex Andriati
+ * \brief Work-precision data of all integrators on standard problems
+ *
+ * Fixed step methods are run with a sequence of step sizes halved at
+ * each level, and adaptive methods with a sequence of tolerances. For
+ * each run the error relative to a reference solution (5th order RK
+ * with step size 16 times smaller than the smallest one), the number
+ * of derivative evaluations and the wall time (best of repetitions)
+ * are written in CSV, or in JSON if the output file ends with `.json`
+ *
+ * Adams predictor-corrector methods are run through `real_integrate`
+ * with 1, 2 and 3 corrector iterations, while the variable step and
+ * order Adams method (Nordsieck form) is run with the sequence of
+ * tolerances as adaptive methods. Only real problems are considered
+ *
+ * usage: odesys_workprecision [output file (default stdout in CSV)]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench_problems.h"
+
+#define MIN_TIME 0.02
+#define MAX_REPETITIONS 200
+#define STEP_LEVELS 7
+#define TOL_LEVELS 10
+#define REF_REFINEMENT 16
+#define MAX_NITER 3
+
+typedef enum{
+    WP_FIXED_STEP,
+    WP_ADAMS,
+    WP_ADAPTIVE,
+    WP_NORDSIECK
+} WorkPrecisionKind;
+
+/** \brief Method entry with kind and identification in the library */
+typedef struct{
+    const char
+        * name;
+    WorkPrecisionKind
+        kind;
+    FixedStepMethod
+        fixed;
+    EmbeddedPairRK
+        pair;
+    unsigned int
+        ms_order;
+} WorkPrecisionMethod;
+
+static WorkPrecisionMethod
+    methods[] = {
+        {"rungekutta2", WP_FIXED_STEP, RUNGEKUTTA2, DORMAND_PRINCE_54, 0},
+        {"rungekutta4", WP_FIXED_STEP, RUNGEKUTTA4, DORMAND_PRINCE_54, 0},
+        {"rungekutta5", WP_FIXED_STEP, RUNGEKUTTA5, DORMAND_PRINCE_54, 0},
+        {"adams4pc", WP_ADAMS, ADAMS4PC, DORMAND_PRINCE_54, 4},
+        {"adams6pc", WP_ADAMS, ADAMS6PC, DORMAND_PRINCE_54, 6},
+        {"bogackishampine32", WP_ADAPTIVE, RUNGEKUTTA5, BOGACKI_SHAMPINE_32, 0},
+        {"cashkarp54", WP_ADAPTIVE, RUNGEKUTTA5, CASH_KARP_54, 0},
+        {"dormandprince54", WP_ADAPTIVE, RUNGEKUTTA5, DORMAND_PRINCE_54, 0},
+        {"adamsnordsieck", WP_NORDSIECK, RUNGEKUTTA5, DORMAND_PRINCE_54, 12}
+    };
+
+/** \brief Problems, size parameter and number of steps of first level */
+typedef struct{
+    BenchProblemId
+        id;
+    unsigned int
+        param,
+        nsteps;
+} WorkPrecisionCase;
+
+static WorkPrecisionCase
+    cases[] = {
+        {LORENZ, 3, 100},
+        {VANDERPOL, 2, 50},
+        {BRUSSELATOR_1D, 16, 50},
+        {NBODY, 8, 50}
+    };
+
+
+/** \brief Adaptive step integration, return number of steps taken */
+static unsigned int
+run_adaptive(BenchProblem * p, EmbeddedPairRK pair, double tol,
+             real_odesys_der der, void * args, Rarray y)
+{
+    unsigned int
+        nsteps;
+    double
+        x,
+        h;
+    RealWorkspaceAdaptive
+        ws;
+
+    ws = get_real_adaptive_ws(pair, p->system_size, tol, tol);
+    x = p->x0;
+    h = 0;
+    while (x < p->x1)
+    {
+        if (real_adaptive_step(p->x1, der, args, ws, &x, &h, y)) break;
+    }
+    nsteps = ws->accepted + ws->rejected;
+    destroy_real_adaptive_ws(ws);
+    return nsteps;
+}
+
+
+/** \brief Variable step and order Adams, return number of steps taken */
+static unsigned int
+run_nordsieck(BenchProblem * p, unsigned int max_order, double tol,
+              real_odesys_der der, void * args, Rarray y)
+{
+    unsigned int
+        nsteps;
+    double
+        x,
+        h;
+    RealWorkspaceNordsieck
+        ws;
+
+    ws = get_real_nordsieck_ws(max_order, p->system_size, tol, tol);
+    x = p->x0;
+    h = 0;
+    while (x < p->x1)
+    {
+        if (real_nordsieck_step(p->x1, der, args, ws, &x, &h, y)) break;
+    }
+    nsteps = ws->accepted + ws->rejected + ws->conv_failures;
+    destroy_real_nordsieck_ws(ws);
+    return nsteps;
+}
+
+
+/** \brief Run method from initial condition and return number of steps */
+static unsigned int
+run_once(BenchProblem * p, WorkPrecisionMethod * m, unsigned int niter,
+         unsigned int nsteps, double tol, BenchCounter * counter, Rarray y)
+{
+    void
+        * args;
+    real_odesys_der
+        der;
+
+    der = p->der;
+    args = p->args;
+    if (counter != NULL)
+    {
+        counter->der = p->der;
+        counter->args = p->args;
+        counter->calls = 0;
+        der = &bench_counted_der;
+        args = (void *) counter;
+    }
+    bench_problem_init_real(p, y);
+    switch (m->kind)
+    {
+        case WP_ADAPTIVE:
+            return run_adaptive(p, m->pair, tol, der, args, y);
+        case WP_NORDSIECK:
+            return run_nordsieck(p, m->ms_order, tol, der, args, y);
+        default:
+            /* corrector iterations are ignored by Runge-Kutta methods */
+            real_integrate(
+                    m->fixed, niter, p->system_size, p->x0, p->x1, nsteps,
+                    der, args, nsteps, NULL, NULL, y
+            );
+            return nsteps;
+    }
+}
+
+
+/** \brief Max norm of difference relative to max norm of reference */
+static double
+relative_error(unsigned int n, Rarray y, Rarray yref)
+{
+    unsigned int
+        i;
+    double
+        diff,
+        norm;
+    diff = 0;
+    norm = 0;
+    for (i = 0; i < n; i++)
+    {
+        if (!(fabs(y[i] - yref[i]) <= diff)) diff = fabs(y[i] - yref[i]);
+        if (fabs(yref[i]) > norm) norm = fabs(yref[i]);
+    }
+    return diff / norm;
+}
+
+
+static void
+write_record(FILE * out, int json, int first, const char * problem,
+             unsigned int size, const char * method, unsigned int niter,
+             double h, double tol, unsigned int nsteps, unsigned long calls,
+             double time, double error)
+{
+    if (!json)
+    {
+        fprintf(out, "%s,%u,%s,%u,%.6e,%.6e,%u,%lu,%.6e,%.6e\n", problem,
+                size, method, niter, h, tol, nsteps, calls, time, error);
+        return;
+    }
+    fprintf(out, "%s\n    {\"problem\": \"%s\", \"system_size\": %u, ",
+            first ? "" : ",", problem, size);
+    fprintf(out, "\"method\": \"%s\", \"niter\": %u, ", method, niter);
+    fprintf(out, "\"h\": %.6e, \"tol\": %.6e, \"steps\": %u, ", h, tol, nsteps);
+    fprintf(out, "\"rhs_calls\": %lu, \"time\": %.6e, ", calls, time);
+    if (isfinite(error)) fprintf(out, "\"error\": %.6e}", error);
+    else                 fprintf(out, "\"error\": null}");
+}
+
+
+int main(int argc, char * argv[])
+{
+    int
+        json,
+        first,
+        adaptive;
+    unsigned int
+        c,
+        k,
+        m,
+        niter,
+        max_niter,
+        nsteps,
+        taken,
+        reps;
+    unsigned long
+        calls;
+    double
+        h,
+        tol,
+        t0,
+        best,
+        elapsed,
+        error;
+    Rarray
+        y,
+        yref;
+    FILE
+        * out;
+    BenchProblem
+        p;
+    BenchCounter
+        counter;
+
+    out = stdout;
+    json = 0;
+    if (argc > 1)
+    {
+        out = fopen(argv[1], "w");
+        if (out == NULL)
+        {
+            printf("\nCannot open output file %s\n\n", argv[1]);
+            exit(EXIT_FAILURE);
+        }
+        k = strlen(argv[1]);
+        json = (k > 5 && strcmp(&argv[1][k - 5], ".json") == 0);
+    }
+
+    if (json) fprintf(out, "{\n  \"library\": \"odesys\",\n  \"results\": [");
+    else      fprintf(out, "problem,system_size,method,niter,h,tol,steps,"
+                           "rhs_calls,time,error\n");
+    first = 1;
+    for (c = 0; c < sizeof(cases) / sizeof(WorkPrecisionCase); c++)
+    {
+        bench_problem_setup(cases[c].id, cases[c].param, &p);
+        y = (Rarray) malloc(p.system_size * sizeof(double));
+        yref = (Rarray) malloc(p.system_size * sizeof(double));
+        if (y == NULL || yref == NULL)
+        {
+            printf("\nProblem in work-precision array allocation\n\n");
+            exit(EXIT_FAILURE);
+        }
+        nsteps = REF_REFINEMENT * (cases[c].nsteps << (STEP_LEVELS - 1));
+        run_once(&p, &methods[2], 1, nsteps, 0, NULL, yref);
+
+        for (m = 0; m < sizeof(methods) / sizeof(WorkPrecisionMethod); m++)
+        {
+            max_niter = (methods[m].kind == WP_ADAMS) ? MAX_NITER : 1;
+            for (niter = 1; niter <= max_niter; niter++)
+            {
+                adaptive = (methods[m].kind == WP_ADAPTIVE
+                        || methods[m].kind == WP_NORDSIECK);
+                for (k = 0; k < STEP_LEVELS || (adaptive && k < TOL_LEVELS); k++)
+                {
+                    nsteps = cases[c].nsteps << k;
+                    tol = pow(10.0, - 3.0 - k);
+                    if (adaptive) h = 0;
+                    else h = (p.x1 - p.x0) / nsteps;
+                    if (!adaptive) tol = 0;
+
+                    taken = run_once(&p, &methods[m], niter, nsteps, tol,
+                                     &counter, y);
+                    calls = counter.calls;
+                    error = relative_error(p.system_size, y, yref);
+                    best = INFINITY;
+                    elapsed = 0;
+                    reps = 0;
+                    while (elapsed < MIN_TIME && reps < MAX_REPETITIONS)
+                    {
+                        t0 = bench_clock();
+                        run_once(&p, &methods[m], niter, nsteps, tol, NULL, y);
+                        t0 = bench_clock() - t0;
+                        if (t0 < best) best = t0;
+                        elapsed = elapsed + t0;
+                        reps++;
+                    }
+                    write_record(out, json, first, p.name, p.system_size,
+                                 methods[m].name, niter, h, tol, taken,
+                                 calls, best, error);
+                    first = 0;
+                }
+            }
+        }
+        free(y);
+        free(yref);
+    }
+    if (json) fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,34 @@
+/**
+ * \file adams_coefficients.h
+ * \author Alex Andriati
+ * \brief Coefficients of Adams predictor-corrector schemes
+ *
+ * This file is private to the library and shared by the routines which
+ * implement Adams-Bashforth(P)-Moulton(C) schemes with different storage.
+ * The arrays follow the convention of `real_general_multistep` with the
+ * left-hand-side `a` and right-hand-side `b` weights. Only include if
+ * using all arrays otherwise warning will be prompt in compilation
+ */
+
+#ifndef ADAMS_COEFFICIENTS_H
+#define ADAMS_COEFFICIENTS_H
+
+
+static double
+    ADAMS4_LEFT[5] = {1.0, -1.0, 0.0, 0.0, 0.0},
+    ADAMS4_PRED[5] = {0.0, 55.0 / 24, -59.0 / 24, 37.0 / 24, -9.0 / 24},
+    ADAMS4_CORR[5] = {9.0 / 24, 19.0 / 24, -5.0 / 24, 1.0 / 24, 0.0};
+
+static double
+    ADAMS6_LEFT[7] = {1.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0},
+    ADAMS6_PRED[7] = {0.0, 4277.0 / 1440, -7923.0 / 1440, 9982.0 / 1440, -7298.0 / 1440, 2877.0 / 1440, -475.0 / 1440},
+    ADAMS6_CORR[7] = {475.0 / 1440, 1427.0 / 1440, -798.0 / 1440, 482.0 / 1440, -173.0 / 1440, 27.0 / 1440, 0.0};
+
+/* Milne device: local error of corrector (computed minus exact) is
+ * estimated by the factor `C_corr / (C_pred - C_corr)` of the error
+ * constants times the difference predictor minus corrector */
+#define ADAMS4_MILNE (- 19.0 / 270)
+#define ADAMS6_MILNE (- 863.0 / 19950)
+
+
+#endif
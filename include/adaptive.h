@@ -0,0 +1,404 @@
+/**
+ * \file adaptive.h
+ * \author Alex Andriati
+ * \brief ODE integration routines with adaptive step size control
+ *
+ * Embedded Runge-Kutta pairs compute two solutions of different order
+ * sharing the same derivative evaluations. Their difference provides
+ * an estimate of the local truncation error, which is used to accept
+ * or reject a step and to propose the size of the next one. The step
+ * routines reuse the Runge-Kutta workspace of singlestep.h while the
+ * driver manages its own workspace with tolerances and statistics
+ */
+
+#ifndef ODE_ADAPTIVE_H
+#define ODE_ADAPTIVE_H
+
+#include "derivative_signature.h"
+#include "singlestep.h"
+
+/** \brief Embedded Runge-Kutta pairs available in adaptive driver
+ *
+ * The numbers in the names give the order of the solution propagated
+ * and the order of the embedded solution used to estimate the error
+ */
+typedef enum{
+    BOGACKI_SHAMPINE_32,    /// 4 stages with First Same As Last (FSAL)
+    CASH_KARP_54,           /// 6 stages without FSAL
+    DORMAND_PRINCE_54       /// 7 stages with FSAL (6 evaluations per step)
+} EmbeddedPairRK;
+
+/** \brief Struct to provide complex workspace for adaptive step driver
+ *
+ * Besides the Runge-Kutta workspace used by the embedded pair, hold
+ * the tolerances, step size bounds and counters of accepted/rejected
+ * steps. If the client modifies the solution between driver calls
+ * `k1_ready` must be set to zero to discard derivative reuse. Stats are
+ * recorded in the struct attached to `rk->stats` (see stats.h)
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        k1_ready;       /// nonzero if `rk->work1` has derivative at `x`
+    EmbeddedPairRK
+        method;         /// embedded pair used to propagate
+    double
+        abs_tol,        /// absolute tolerance of local error
+        rel_tol,        /// relative tolerance of local error
+        h_min,          /// smallest step size accepted
+        h_max;          /// largest step size allowed (zero for no limit)
+    unsigned int
+        accepted,       /// number of accepted steps
+        rejected;       /// number of rejected steps
+    ComplexWorkspaceRK
+        rk;             /// stage derivatives of embedded pair
+    Carray
+        ynext,          /// trial solution
+        yerr;           /// local error estimate of trial solution
+} _ComplexWorkspaceAdaptive;
+
+/** \brief Workspace struct address for adaptive step driver */
+typedef _ComplexWorkspaceAdaptive * ComplexWorkspaceAdaptive;
+
+/** \brief Struct to provide real workspace for adaptive step driver
+ *
+ * Besides the Runge-Kutta workspace used by the embedded pair, hold
+ * the tolerances, step size bounds and counters of accepted/rejected
+ * steps. If the client modifies the solution between driver calls
+ * `k1_ready` must be set to zero to discard derivative reuse. Stats are
+ * recorded in the struct attached to `rk->stats` (see stats.h)
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        k1_ready;       /// nonzero if `rk->work1` has derivative at `x`
+    EmbeddedPairRK
+        method;         /// embedded pair used to propagate
+    double
+        abs_tol,        /// absolute tolerance of local error
+        rel_tol,        /// relative tolerance of local error
+        h_min,          /// smallest step size accepted
+        h_max;          /// largest step size allowed (zero for no limit)
+    unsigned int
+        accepted,       /// number of accepted steps
+        rejected;       /// number of rejected steps
+    RealWorkspaceRK
+        rk;             /// stage derivatives of embedded pair
+    Rarray
+        ynext,          /// trial solution
+        yerr;           /// local error estimate of trial solution
+} _RealWorkspaceAdaptive;
+
+/** \brief Workspace struct address for adaptive step driver */
+typedef _RealWorkspaceAdaptive * RealWorkspaceAdaptive;
+
+typedef void (*real_embedded_routine)(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceRK,
+        int,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+typedef void (*cplx_embedded_routine)(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceRK,
+        int,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Dormand-Prince 5(4) embedded pair step
+ *
+ * Propagate the 5th order solution and estimate its error with the
+ * embedded 4th order one. The last stage is the derivative at the new
+ * point, left in `work7` of the workspace, which can be used as first
+ * stage of the next step (FSAL) by swapping `work1` and `work7`
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+cplx_dormandprince54(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceRK,
+        int,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Dormand-Prince 5(4) embedded pair step
+ *
+ * Propagate the 5th order solution and estimate its error with the
+ * embedded 4th order one. The last stage is the derivative at the new
+ * point, left in `work7` of the workspace, which can be used as first
+ * stage of the next step (FSAL) by swapping `work1` and `work7`
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+real_dormandprince54(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceRK,
+        int,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Cash-Karp 5(4) embedded pair step
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+cplx_cashkarp54(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceRK,
+        int,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Cash-Karp 5(4) embedded pair step
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+real_cashkarp54(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceRK,
+        int,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Bogacki-Shampine 3(2) embedded pair step
+ *
+ * The last stage is the derivative at the new point, left in `work4`
+ * of the workspace, which can be used as first stage of next step by
+ * swapping `work1` and `work4` (FSAL)
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+cplx_bogackishampine32(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceRK,
+        int,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Bogacki-Shampine 3(2) embedded pair step
+ *
+ * The last stage is the derivative at the new point, left in `work4`
+ * of the workspace, which can be used as first stage of next step by
+ * swapping `work1` and `work4` (FSAL)
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `work1` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ * \param 9 : (OUTPUT) local error estimate of param 8
+ */
+void
+real_bogackishampine32(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceRK,
+        int,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : embedded pair to use
+ * \param 2 : system size
+ * \param 3 : absolute tolerance
+ * \param 4 : relative tolerance
+ */
+ComplexWorkspaceAdaptive
+get_cplx_adaptive_ws(EmbeddedPairRK, int, double, double);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : embedded pair to use
+ * \param 2 : system size
+ * \param 3 : absolute tolerance
+ * \param 4 : relative tolerance
+ */
+RealWorkspaceAdaptive
+get_real_adaptive_ws(EmbeddedPairRK, int, double, double);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_adaptive_ws(ComplexWorkspaceAdaptive);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_adaptive_ws(RealWorkspaceAdaptive);
+
+
+/**
+ * \brief Advance one accepted step with local error control
+ *
+ * Try steps with the embedded pair of the workspace until the weighted
+ * RMS norm of the error estimate, using weights `abs_tol + rel_tol * |y|`
+ * is smaller than one. Rejected steps are retried with reduced size and
+ * the derivative at `x` is reused. The step never goes beyond `xend`,
+ * and the proposal for the next step is not reduced by this truncation,
+ * thus `xend` may be an output point with integration going on after it.
+ * Only forward integration is supported (`xend > x`), since a step size
+ * not positive is taken as request of an initial estimate
+ *
+ * \param 1 : final grid point where the step is truncated
+ * \param 2 : function pointing to routine that compute derivatives
+ * \param 3 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 4 : (MODIFIED) Workspace struct address with step control setup
+ * \param 5 : (MODIFIED) current grid point, advanced by the accepted step
+ * \param 6 : (MODIFIED) step size to try, replaced by proposal for next
+ *            step. If not positive on input, an initial step size is estimated
+ * \param 7 : (MODIFIED) function values at `x` replaced by the new ones
+ *
+ * \return 0 if a step was accepted and -1 if the step size fell below
+ *         the `h_min` workspace field (no change in params 5 and 7)
+ */
+int
+cplx_adaptive_step(
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceAdaptive,
+        double *,
+        double *,
+        Carray
+);
+
+
+/**
+ * \brief Advance one accepted step with local error control
+ *
+ * Try steps with the embedded pair of the workspace until the weighted
+ * RMS norm of the error estimate, using weights `abs_tol + rel_tol * |y|`
+ * is smaller than one. Rejected steps are retried with reduced size and
+ * the derivative at `x` is reused. The step never goes beyond `xend`,
+ * and the proposal for the next step is not reduced by this truncation,
+ * thus `xend` may be an output point with integration going on after it.
+ * Only forward integration is supported (`xend > x`), since a step size
+ * not positive is taken as request of an initial estimate
+ *
+ * \param 1 : final grid point where the step is truncated
+ * \param 2 : function pointing to routine that compute derivatives
+ * \param 3 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 4 : (MODIFIED) Workspace struct address with step control setup
+ * \param 5 : (MODIFIED) current grid point, advanced by the accepted step
+ * \param 6 : (MODIFIED) step size to try, replaced by proposal for next
+ *            step. If not positive on input, an initial step size is estimated
+ * \param 7 : (MODIFIED) function values at `x` replaced by the new ones
+ *
+ * \return 0 if a step was accepted and -1 if the step size fell below
+ *         the `h_min` workspace field (no change in params 5 and 7)
+ */
+int
+real_adaptive_step(
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceAdaptive,
+        double *,
+        double *,
+        Rarray
+);
+
+
+#endif
@@ -7,8 +7,8 @@
  * This file is supposed to be (absolutely) private for end users which
  * will consume the library. Moreover, the static keywords ensure clash
  * cannot happen with other libraries and the implementation cannot be
- * duplicated within this library. Only include if using all functions
- * otherwise warning will be prompt in compilation
+ * duplicated within this library. The functions are also inline, thus
+ * no warning is prompt in compilation units using only some of them
  */
 
 #ifndef ARRAYS_ASSISTANT_H
@@ -20,7 +20,7 @@
 
 
 /** \brief Return fresh allocated real(double) array */
-static Rarray
+static inline Rarray
 alloc_rarr(unsigned int array_size)
 {
     Rarray ptr = (Rarray) malloc(array_size * sizeof(double));
@@ -34,7 +34,7 @@ alloc_rarr(unsigned int array_size)
 
 
 /** \brief Return fresh allocated complex(double) array */
-static Carray
+static inline Carray
 alloc_carr(unsigned int array_size)
 {
     Carray ptr = (Carray) malloc(array_size * sizeof(double complex));
@@ -48,18 +48,22 @@ alloc_carr(unsigned int array_size)
 
 
 /** \brief Copy values from the first array to the second */
-static void
+static inline void
 carr_copy_values(unsigned int array_size, Carray from, Carray to)
 {
-    for (unsigned int i = 0; i < array_size; i++) to[i] = from[i];
+    unsigned int
+        i;
+    for (i = 0; i < array_size; i++) to[i] = from[i];
 }
 
 
 /** \brief Copy values from the first array to the second */
-static void
+static inline void
 rarr_copy_values(unsigned int array_size, Rarray from, Rarray to)
 {
-    for (unsigned int i = 0; i < array_size; i++) to[i] = from[i];
+    unsigned int
+        i;
+    for (i = 0; i < array_size; i++) to[i] = from[i];
 }
 
 
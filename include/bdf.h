@@ -0,0 +1,151 @@
+/**
+ * \file bdf.h
+ * \author Alex Andriati
+ * \brief Backward differentiation formulas (BDF) for stiff systems
+ *
+ * BDF methods of order k = 1, ..., 5 solve at each step the implicit
+ * equation `y_j+1 = a[1] * y_j + ... + a[k] * y_j+1-k + h * b * y'_j+1`
+ * for the unknown `y_j+1`. In stiff problems the fixed point iteration
+ * of `real_general_multistep` only converges for tiny step sizes, thus
+ * here a modified Newton method is used, with the iteration matrix
+ * `I - h * b * J` kept in LU factorized form along several steps and
+ * only updated when the convergence degrades
+ *
+ * The methods can be self-starting, with the order raised by one at each
+ * step up to the maximum order set in the workspace, or started with a
+ * Runge-Kutta routine as the other multistep methods. The step size must
+ * be kept constant, otherwise the integration shall be restarted with
+ * `init_real_bdf`
+ */
+
+#ifndef ODE_BDF_H
+#define ODE_BDF_H
+
+#include "derivative_signature.h"
+#include "multistep.h"
+
+/** \brief Maximum order of BDF methods (higher orders are not stable) */
+#define BDF_MAX_ORDER 5
+
+/** \brief Struct to provide real workspace for BDF methods
+ *
+ * Extend the multistep workspace, which is the first field and is set
+ * in history mode with `ms_order` equal to the maximum order, thus the
+ * workspace address can be cast to `RealWorkspaceMS` to access previous
+ * steps. BDF needs no previous derivatives, thus `ms.prev_der` has a
+ * single chunk with the derivative of the last Newton iterate. The
+ * Newton iteration converges when the weighted norm of the correction
+ * with tolerances `abs_tol` and `rel_tol` is below 1. Newton iterations,
+ * Jacobian evaluations and LU decompositions are counted in the stats
+ * struct attached to `ms` (see stats.h)
+ */
+typedef struct{
+    _RealWorkspaceMS
+        ms;             /// previous steps and derivative (history mode)
+    int
+        nsteps,         /// number of valid previous steps in history
+        order,          /// order used in the last step
+        jac_ready,      /// nonzero if `jac` was evaluated
+        lu_ready;       /// nonzero if `lu` has the factorized matrix
+    unsigned int
+        max_iter;       /// max number of Newton iterations per attempt
+    double
+        abs_tol,        /// absolute tolerance of Newton corrections
+        rel_tol,        /// relative tolerance of Newton corrections
+        hb_lu,          /// value of `h * b` in the factorized matrix
+        conv_rate;      /// convergence rate estimate of Newton iterations
+    Rarray
+        jac,            /// Jacobian matrix (row major) `jac[i * n + j]`
+        lu,             /// LU decomposition of `I - h * b * jac`
+        psi,            /// known part from previous steps
+        delta,          /// Newton correction
+        ywork,          /// perturbed solution for finite differences
+        fwork;          /// derivative at perturbed solution
+    int
+        * pivots;       /// row permutations of LU decomposition
+} _RealWorkspaceBDF;
+
+/** \brief Struct address with working arrays for BDF methods */
+typedef _RealWorkspaceBDF * RealWorkspaceBDF;
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * Newton tolerances are set to `abs_tol = 1E-10` and `rel_tol = 1E-8`
+ * and the maximum number of iterations to 4, which can be changed in
+ * the struct fields afterwards
+ *
+ * \param 1 : maximum BDF order (from 1 to `BDF_MAX_ORDER`, clamped)
+ * \param 2 : system size
+ */
+RealWorkspaceBDF
+get_real_bdf_ws(unsigned int, unsigned int);
+
+/** \brief Free allocated workspace struct and its internal pointers */
+void
+destroy_real_bdf_ws(RealWorkspaceBDF);
+
+/** \brief Set initial steps in history and restart the integration
+ *
+ * Must be called before the first step and whenever the step size is
+ * changed. Without Runge-Kutta routine the method starts with order 1,
+ * which is safe for stiff problems but limits the global accuracy to
+ * second order. Otherwise the previous steps required by the maximum
+ * order are computed with the Runge-Kutta routine as in
+ * `init_real_multistep`, but without the derivatives at these steps,
+ * and the most recent one is at `x = (ms_order - 1) * h`. The Jacobian is kept but the LU
+ * decomposition is discarded
+ *
+ * \param 1 : grid step size
+ * \param 2 : routine to compute ODE system derivative
+ * \param 3 : optional arguments required to compute system derivative
+ * \param 4 : (MODIFIED) workspace struct address
+ * \param 5 : array with initial condition
+ * \param 6 : address of RungeKutta routine to compute the first steps
+ *            or NULL to raise the order by one at each step
+ */
+void
+init_real_bdf(
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceBDF,
+        Rarray,
+        real_rk_routine
+);
+
+/**
+ * \brief Propagate one step with BDF method and modified Newton iteration
+ *
+ * The order used is the minimum between the number of known steps in
+ * history and the maximum order of the workspace. The predictor is the
+ * polynomial extrapolation of previous steps. If the Newton iteration
+ * diverges or is too slow, the Jacobian is evaluated at the last iterate
+ * and the matrix refactorized to continue the iterations, up to three
+ * Jacobian evaluations in the step. In case of success the solution is
+ * appended to the workspace history
+ *
+ * \param 1 : grid spacing `h` (constant since last `init_real_bdf`)
+ * \param 2 : grid point `x` of the most recent step in history
+ * \param 3 : function pointer to routine that compute derivatives
+ * \param 4 : function pointer to routine that compute Jacobian. If NULL
+ *            it is approximated by finite differences of param 3
+ * \param 5 : extra arguments required in param 3 and param 4
+ * \param 6 : (MODIFIED) workspace struct address
+ * \param 7 : (OUTPUT) solution at next grid point `x + h`
+ *
+ * \return 0 if succeeded and -1 if Newton iteration did not converge
+ */
+int
+real_bdf_step(
+        double,
+        double,
+        real_odesys_der,
+        real_odesys_jac,
+        void *,
+        RealWorkspaceBDF,
+        Rarray
+);
+
+
+#endif
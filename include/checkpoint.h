@@ -0,0 +1,128 @@
+/**
+ * \file checkpoint.h
+ * \author Alex Andriati
+ * \brief Checkpoint and restart of multistep integration state
+ *
+ * Restarting a multistep method with `init_*_multistep` reruns the
+ * Runge-Kutta startup, which changes the trajectory. The routines here
+ * save the complete state (previous steps and their derivatives, grid
+ * point, step size and a method id given by the client) to a binary
+ * file, such that the integration resumes bit-for-bit after restore
+ *
+ * File layout (version `CHECKPOINT_VERSION`), all in the byte order of
+ * the machine which wrote the file:
+ *
+ *      8 bytes     magic "ODESYSCK"
+ *      uint32      format version
+ *      uint32      endian tag 0x01020304 (byte swapped if read reversed)
+ *      uint32      1 if complex system, 0 if real
+ *      int32       method id given by the client
+ *      uint32      number of previous steps (`ms_order`)
+ *      uint32      system size
+ *      double      step size `h`
+ *      double      most recent grid point `x`
+ *      double[]    previous steps, most recent first
+ *      double[]    derivatives of previous steps, most recent first
+ *
+ * Complex values are stored as real and imaginary parts. Files written
+ * on a machine with the other byte order are converted when restored.
+ * The file is written with a single `writev` call to a temporary file
+ * which replaces the target only when complete, thus a run killed while
+ * writing keeps the previous checkpoint
+ */
+
+#ifndef ODE_CHECKPOINT_H
+#define ODE_CHECKPOINT_H
+
+#include "multistep.h"
+
+/** \brief Current version of checkpoint file format */
+#define CHECKPOINT_VERSION 1
+
+
+/**
+ * \brief Save complex multistep state to binary file
+ *
+ * \param 1 : file name
+ * \param 2 : method id chosen by the client (e.g. `FixedStepMethod`)
+ * \param 3 : step size `h`
+ * \param 4 : most recent grid point `x`
+ * \param 5 : multistep workspace with derivatives of previous steps
+ * \param 6 : Concatenated previous steps `[y_j y_j-1 ...]` as given to
+ *            the multistep routines. Ignored if workspace in history mode
+ *
+ * \return 0 if the file was written and -1 otherwise
+ */
+int
+cplx_multistep_checkpoint(
+        const char *,
+        int,
+        double,
+        double,
+        ComplexWorkspaceMS,
+        Carray
+);
+
+
+/**
+ * \brief Save real multistep state to binary file
+ *
+ * See `cplx_multistep_checkpoint` for parameters
+ */
+int
+real_multistep_checkpoint(
+        const char *,
+        int,
+        double,
+        double,
+        RealWorkspaceMS,
+        Rarray
+);
+
+
+/**
+ * \brief Restore complex multistep state from binary file
+ *
+ * The workspace must have the same `ms_order` and system size of the
+ * file. The steps are restored in the order of a fresh workspace, thus
+ * the multistep routines continue exactly as before the checkpoint
+ *
+ * \param 1 : file name
+ * \param 2 : (OUTPUT) method id. May be NULL
+ * \param 3 : (OUTPUT) step size `h`
+ * \param 4 : (OUTPUT) most recent grid point `x`
+ * \param 5 : (MODIFIED) multistep workspace
+ * \param 6 : (OUTPUT) Concatenated previous steps. Ignored (may be NULL)
+ *            if workspace in history mode
+ *
+ * \return 0 if the state was restored and -1 if the file could not be
+ *         read or does not match the workspace (nothing changed)
+ */
+int
+cplx_multistep_restore(
+        const char *,
+        int *,
+        double *,
+        double *,
+        ComplexWorkspaceMS,
+        Carray
+);
+
+
+/**
+ * \brief Restore real multistep state from binary file
+ *
+ * See `cplx_multistep_restore` for parameters
+ */
+int
+real_multistep_restore(
+        const char *,
+        int *,
+        double *,
+        double *,
+        RealWorkspaceMS,
+        Rarray
+);
+
+
+#endif
@@ -0,0 +1,343 @@
+/**
+ * \file dense.h
+ * \author Alex Andriati
+ * \brief Dense output to evaluate the solution between grid points
+ *
+ * After a step from `x` to `x + h` the solution inside the step is
+ * approximated by a polynomial in `t = (x' - x) / h`, built from the
+ * stage derivatives left in the workspace of the method, thus without
+ * new derivative evaluations. The polynomial coefficients are stored
+ * in the dense output workspace, and evaluating the solution at any
+ * point costs `degree` multiply-add operations per equation
+ *
+ * Available interpolants:
+ *
+ * Continuous extensions of Runge-Kutta methods, which combine the same
+ * stages with weights `b(t)` depending on the point. They are of 2nd
+ * order for `*_rungekutta2`, 3rd order for `*_rungekutta4`,
+ * `*_rungekutta5`, Cash-Karp and Bogacki-Shampine, and 4th order for
+ * Dormand-Prince
+ *
+ * Hermite interpolants, cubic from solution and derivative at both ends
+ * of the step, and quintic for multistep methods using also the step
+ * before, with derivatives from the `prev_der` field
+ *
+ * The interpolants built only from the stages use the solution at the
+ * end of the step, thus they work with in-place steps (`y == ynext`)
+ */
+
+#ifndef ODE_DENSE_H
+#define ODE_DENSE_H
+
+#include "derivative_signature.h"
+#include "singlestep.h"
+#include "multistep.h"
+#include "adaptive.h"
+
+/** \brief Max degree of the interpolating polynomials */
+#define DENSE_MAX_DEGREE 5
+
+/** \brief Struct to provide complex workspace of dense output
+ *
+ * The coefficient of `t^p` of all equations is the chunk `p` of the
+ * `coef` array, with `DENSE_MAX_DEGREE + 1` chunks of system size
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        degree;         /// degree of polynomial of last step set
+    double
+        x,              /// grid point at beginning of the step
+        h;              /// step size
+    Carray
+        coef;           /// polynomial coefficients
+} _ComplexDenseOutput;
+
+/** \brief Workspace struct address of dense output */
+typedef _ComplexDenseOutput * ComplexDenseOutput;
+
+/** \brief Struct to provide real workspace of dense output
+ *
+ * The coefficient of `t^p` of all equations is the chunk `p` of the
+ * `coef` array, with `DENSE_MAX_DEGREE + 1` chunks of system size
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        degree;         /// degree of polynomial of last step set
+    double
+        x,              /// grid point at beginning of the step
+        h;              /// step size
+    Rarray
+        coef;           /// polynomial coefficients
+} _RealDenseOutput;
+
+/** \brief Workspace struct address of dense output */
+typedef _RealDenseOutput * RealDenseOutput;
+
+
+/** \brief Return fresh allocated workspace of dense output */
+ComplexDenseOutput
+get_cplx_dense_ws(int sys_size);
+
+
+/** \brief Return fresh allocated workspace of dense output */
+RealDenseOutput
+get_real_dense_ws(int sys_size);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_dense_ws(ComplexDenseOutput);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_dense_ws(RealDenseOutput);
+
+
+/**
+ * \brief Evaluate the solution at any point of the last step set
+ *
+ * Points outside the step are extrapolated, with quickly growing error
+ *
+ * \param 1 : workspace with interpolant set
+ * \param 2 : point where the solution is required
+ * \param 3 : (OUTPUT) interpolated solution
+ */
+void
+cplx_dense_eval_at(ComplexDenseOutput, double, Carray);
+
+
+/** \brief Evaluate the solution at any point of the last step set
+ *
+ * Points outside the step are extrapolated, with quickly growing error
+ *
+ * \param 1 : workspace with interpolant set
+ * \param 2 : point where the solution is required
+ * \param 3 : (OUTPUT) interpolated solution
+ */
+void
+real_dense_eval_at(RealDenseOutput, double, Rarray);
+
+
+/**
+ * \brief Set cubic Hermite interpolant of a step
+ *
+ * \param 1 : step size `h`
+ * \param 2 : grid point `x` at beginning of the step
+ * \param 3 : solution at `x`
+ * \param 4 : derivative at `x`
+ * \param 5 : solution at `x + h`
+ * \param 6 : derivative at `x + h`
+ * \param 7 : (OUTPUT) dense output workspace
+ */
+void
+cplx_dense_hermite3(
+        double,
+        double,
+        Carray,
+        Carray,
+        Carray,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/**
+ * \brief Set cubic Hermite interpolant of a step
+ *
+ * \param 1 : step size `h`
+ * \param 2 : grid point `x` at beginning of the step
+ * \param 3 : solution at `x`
+ * \param 4 : derivative at `x`
+ * \param 5 : solution at `x + h`
+ * \param 6 : derivative at `x + h`
+ * \param 7 : (OUTPUT) dense output workspace
+ */
+void
+real_dense_hermite3(
+        double,
+        double,
+        Rarray,
+        Rarray,
+        Rarray,
+        Rarray,
+        RealDenseOutput
+);
+
+
+/**
+ * \brief Set continuous extension of the last `*_rungekutta2` step
+ *
+ * \param 1 : step size `h`
+ * \param 2 : grid point `x` at beginning of the step
+ * \param 3 : Runge-Kutta workspace used in the step
+ * \param 4 : solution at `x + h` computed in the step
+ * \param 5 : (OUTPUT) dense output workspace
+ */
+void
+cplx_dense_rungekutta2(
+        double,
+        double,
+        ComplexWorkspaceRK,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/** \brief Set continuous extension of the last `*_rungekutta2` step
+ *
+ * See `cplx_dense_rungekutta2` for parameters
+ */
+void
+real_dense_rungekutta2(
+        double,
+        double,
+        RealWorkspaceRK,
+        Rarray,
+        RealDenseOutput
+);
+
+
+/** \brief Set continuous extension of the last `*_rungekutta4` step
+ *
+ * See `cplx_dense_rungekutta2` for parameters
+ */
+void
+cplx_dense_rungekutta4(
+        double,
+        double,
+        ComplexWorkspaceRK,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/** \brief Set continuous extension of the last `*_rungekutta4` step
+ *
+ * See `cplx_dense_rungekutta2` for parameters
+ */
+void
+real_dense_rungekutta4(
+        double,
+        double,
+        RealWorkspaceRK,
+        Rarray,
+        RealDenseOutput
+);
+
+
+/** \brief Set continuous extension of the last `*_rungekutta5` step
+ *
+ * See `cplx_dense_rungekutta2` for parameters
+ */
+void
+cplx_dense_rungekutta5(
+        double,
+        double,
+        ComplexWorkspaceRK,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/** \brief Set continuous extension of the last `*_rungekutta5` step
+ *
+ * See `cplx_dense_rungekutta2` for parameters
+ */
+void
+real_dense_rungekutta5(
+        double,
+        double,
+        RealWorkspaceRK,
+        Rarray,
+        RealDenseOutput
+);
+
+
+/**
+ * \brief Set continuous extension of last step accepted by adaptive driver
+ *
+ * Must be called right after `cplx_adaptive_step`, since the stages of
+ * the embedded pair are taken from the workspace (exchanged for FSAL)
+ *
+ * \param 1 : grid point before the call of the adaptive driver
+ * \param 2 : grid point after the call (end of the accepted step)
+ * \param 3 : workspace of the adaptive driver
+ * \param 4 : solution at param 2
+ * \param 5 : (OUTPUT) dense output workspace
+ */
+void
+cplx_dense_adaptive(
+        double,
+        double,
+        ComplexWorkspaceAdaptive,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/**
+ * \brief Set continuous extension of last step accepted by adaptive driver
+ *
+ * Must be called right after `real_adaptive_step`, since the stages of
+ * the embedded pair are taken from the workspace (exchanged for FSAL)
+ *
+ * \param 1 : grid point before the call of the adaptive driver
+ * \param 2 : grid point after the call (end of the accepted step)
+ * \param 3 : workspace of the adaptive driver
+ * \param 4 : solution at param 2
+ * \param 5 : (OUTPUT) dense output workspace
+ */
+void
+real_dense_adaptive(
+        double,
+        double,
+        RealWorkspaceAdaptive,
+        Rarray,
+        RealDenseOutput
+);
+
+
+/**
+ * \brief Set Hermite interpolant of the last step of multistep method
+ *
+ * The interpolant is quintic, from the three most recent steps, or
+ * cubic if the workspace holds only two, thus the workspace order must
+ * be at least two. Must be called after the `*_set_next_multistep` of
+ * the step, which evaluates the derivative at the new point
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : most recent grid point, the step is from `x - h` to `x`
+ * \param 3 : multistep workspace
+ * \param 4 : Concatenated previous steps `[y_j y_j-1 ...]` as given to
+ *            the multistep routines. Ignored if workspace in history mode
+ * \param 5 : (OUTPUT) dense output workspace
+ */
+void
+cplx_dense_multistep(
+        double,
+        double,
+        ComplexWorkspaceMS,
+        Carray,
+        ComplexDenseOutput
+);
+
+
+/**
+ * \brief Set Hermite interpolant of the last step of multistep method
+ *
+ * See `cplx_dense_multistep` for parameters
+ */
+void
+real_dense_multistep(
+        double,
+        double,
+        RealWorkspaceMS,
+        Rarray,
+        RealDenseOutput
+);
+
+
+#endif
@@ -39,6 +39,54 @@ typedef struct{
 /** \brief Input parameters struct address needed in function signature */
 typedef _ComplexODEInputParameters * ComplexODEInputParameters;
 
+/** \brief Struct with input parameters for ensemble derivatives computation
+ *
+ * All members of the ensemble are copies of the same ODE system with
+ * different states, stored in a single block such that the component `i`
+ * of member `k` is at `y[i * component_stride + k * member_stride]`. In
+ * the default structure of arrays (SoA) layout it is `y[i * ensemble_size
+ * + k]`. Members may be at different grid points and have their own
+ * arguments, given in `member_x` and `member_args` (NULL if not used)
+ */
+typedef struct{
+    unsigned int system_size;   /// number of equations of each member
+    unsigned int ensemble_size; /// number of independent members
+    unsigned int component_stride; /// distance between components of member
+    unsigned int member_stride; /// distance between consecutive members
+    double x;                   /// grid point of the known solutions
+    Rarray member_x;            /// grid point of each member (or NULL)
+    Rarray y;                   /// function values of all members at `x`
+    void * extra_args;          /// user-defined external arguments
+    void ** member_args;        /// arguments of each member (or NULL)
+} _RealEnsembleInputParameters;
+
+/** \brief Input parameters struct address needed in function signature */
+typedef _RealEnsembleInputParameters * RealEnsembleInputParameters;
+
+/** \brief Struct with input parameters for ensemble derivatives computation
+ *
+ * All members of the ensemble are copies of the same ODE system with
+ * different states, stored in a single block such that the component `i`
+ * of member `k` is at `y[i * component_stride + k * member_stride]`. In
+ * the default structure of arrays (SoA) layout it is `y[i * ensemble_size
+ * + k]`. Members may be at different grid points and have their own
+ * arguments, given in `member_x` and `member_args` (NULL if not used)
+ */
+typedef struct{
+    unsigned int system_size;   /// number of equations of each member
+    unsigned int ensemble_size; /// number of independent members
+    unsigned int component_stride; /// distance between components of member
+    unsigned int member_stride; /// distance between consecutive members
+    double x;                   /// grid point of the known solutions
+    Rarray member_x;            /// grid point of each member (or NULL)
+    Carray y;                   /// function values of all members at `x`
+    void * extra_args;          /// user-defined external arguments
+    void ** member_args;        /// arguments of each member (or NULL)
+} _ComplexEnsembleInputParameters;
+
+/** \brief Input parameters struct address needed in function signature */
+typedef _ComplexEnsembleInputParameters * ComplexEnsembleInputParameters;
+
 /**
  * \brief Function signature to compute derivatives of real ODE system
  *
@@ -55,5 +103,41 @@ typedef void (*real_odesys_der)(RealODEInputParameters, Rarray);
  */
 typedef void (*cplx_odesys_der)(ComplexODEInputParameters, Carray);
 
+/**
+ * \brief Function signature of second order real system y'' = f(x, y)
+ *
+ * The second derivatives do not depend on the first ones, as in
+ * Newton's equations with conservative forces
+ *
+ * \param 1 : Struct with positions `y` at grid point `x`
+ * \param 2 : (OUTPUT) second derivatives (accelerations)
+ */
+typedef void (*real_odesys_der2)(RealODEInputParameters, Rarray);
+
+/**
+ * \brief Function signature to compute Jacobian of real ODE system
+ *
+ * \param 1 : Struct with input system parameters required
+ * \param 2 : (OUTPUT) matrix `n x n` in row major order with element
+ *            `[i * n + j]` the derivative of `y'_i` with respect to `y_j`
+ */
+typedef void (*real_odesys_jac)(RealODEInputParameters, Rarray);
+
+/**
+ * \brief Function signature to compute derivatives of a real ensemble
+ *
+ * \param 1 : Struct with input parameters of all ensemble members
+ * \param 2 : (OUTPUT) derivatives of all members in the same SoA layout
+ */
+typedef void (*real_ensemble_der)(RealEnsembleInputParameters, Rarray);
+
+/**
+ * \brief Function signature to compute derivatives of a complex ensemble
+ *
+ * \param 1 : Struct with input parameters of all ensemble members
+ * \param 2 : (OUTPUT) derivatives of all members in the same SoA layout
+ */
+typedef void (*cplx_ensemble_der)(ComplexEnsembleInputParameters, Carray);
+
 
 #endif
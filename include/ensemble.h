@@ -0,0 +1,739 @@
+/**
+ * \file ensemble.h
+ * \author Alex Andriati
+ * \brief Integration routines for ensembles of copies of an ODE system
+ *
+ * Parameter sweeps require the integration of many copies of the same
+ * (usually small) ODE system with different initial conditions. Instead
+ * of one integrator call per member, the ensemble routines integrate all
+ * members at once, with states stored as structure of arrays (SoA). The
+ * component `i` of member `k` is at `y[i * ensemble_size + k]`, thus the
+ * derivatives are requested once per stage for the whole ensemble and the
+ * stage combinations are contiguous loops over all members
+ *
+ * Optionally, with `EnsembleMembers` attached to the workspace, members
+ * may be stored contiguously (AoS) instead, for derivative routines from
+ * libraries working on one state at a time, and may have their own grid
+ * points (shifted by a constant from the common one) and arguments. The
+ * stage combinations do not depend on the layout, thus still are single
+ * vector operations over the whole ensemble
+ */
+
+#ifndef ODE_ENSEMBLE_H
+#define ODE_ENSEMBLE_H
+
+#include "derivative_signature.h"
+#include "singlestep.h"
+#include "multistep.h"
+
+/** \brief Memory layout of ensemble states */
+typedef enum{
+    ENSEMBLE_SOA,   /// component `i` of member `k` at `i * ensemble_size + k`
+    ENSEMBLE_AOS    /// component `i` of member `k` at `k * system_size + i`
+} EnsembleLayout;
+
+/** \brief Struct with layout and data of each member of an ensemble
+ *
+ * Attached to field `members` of ensemble workspaces (NULL by default,
+ * meaning SoA layout with all members at the same grid point and with
+ * the same arguments). The grid point of member `k` is `x + xshift[k]`
+ * with `x` the grid point given to the integration routines, and the
+ * derivative routine receives them in `member_x`
+ */
+typedef struct{
+    int
+        ensemble_size;  /// number of members
+    EnsembleLayout
+        layout;         /// memory layout of states and derivatives
+    Rarray
+        xshift,         /// grid point shift of each member (NULL if none)
+        xmember;        /// grid point of each member in current stage
+    void
+        ** args;        /// arguments of each member (NULL if none)
+} _EnsembleMembers;
+
+/** \brief Struct address of ensemble members data */
+typedef _EnsembleMembers * EnsembleMembers;
+
+/** \brief Struct to provide complex workspace for ensemble Runge-Kutta
+ *
+ * The Runge-Kutta workspace has arrays for all members of the ensemble
+ * such that its system size is `system_size * ensemble_size`
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations of each member
+        ensemble_size;  /// number of members
+    ComplexWorkspaceRK
+        rk;             /// workspace with arrays for all members
+    EnsembleMembers
+        members;        /// layout and member data (NULL for defaults)
+} _ComplexEnsembleWorkspaceRK;
+
+/** \brief Workspace struct address for ensemble Runge-Kutta */
+typedef _ComplexEnsembleWorkspaceRK * ComplexEnsembleWorkspaceRK;
+
+/** \brief Struct to provide real workspace for ensemble Runge-Kutta
+ *
+ * The Runge-Kutta workspace has arrays for all members of the ensemble
+ * such that its system size is `system_size * ensemble_size`
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations of each member
+        ensemble_size;  /// number of members
+    RealWorkspaceRK
+        rk;             /// workspace with arrays for all members
+    EnsembleMembers
+        members;        /// layout and member data (NULL for defaults)
+} _RealEnsembleWorkspaceRK;
+
+/** \brief Workspace struct address for ensemble Runge-Kutta */
+typedef _RealEnsembleWorkspaceRK * RealEnsembleWorkspaceRK;
+
+/** \brief Struct to provide complex workspace for ensemble multistep methods
+ *
+ * The multistep workspace is in history mode with chunks for all members
+ * such that its system size is `system_size * ensemble_size`
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations of each member
+        ensemble_size;  /// number of members
+    ComplexWorkspaceMS
+        ms;             /// history mode workspace for all members
+    EnsembleMembers
+        members;        /// layout and member data (NULL for defaults)
+} _ComplexEnsembleWorkspaceMS;
+
+/** \brief Workspace struct address for ensemble multistep methods */
+typedef _ComplexEnsembleWorkspaceMS * ComplexEnsembleWorkspaceMS;
+
+/** \brief Struct to provide real workspace for ensemble multistep methods
+ *
+ * The multistep workspace is in history mode with chunks for all members
+ * such that its system size is `system_size * ensemble_size`
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations of each member
+        ensemble_size;  /// number of members
+    RealWorkspaceMS
+        ms;             /// history mode workspace for all members
+    EnsembleMembers
+        members;        /// layout and member data (NULL for defaults)
+} _RealEnsembleWorkspaceMS;
+
+/** \brief Workspace struct address for ensemble multistep methods */
+typedef _RealEnsembleWorkspaceMS * RealEnsembleWorkspaceMS;
+
+typedef void (*real_ensemble_rk_routine)(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceRK,
+        Rarray,
+        Rarray
+);
+
+typedef void (*cplx_ensemble_rk_routine)(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceRK,
+        Carray,
+        Carray
+);
+
+
+/** \brief Return fresh allocated struct with layout and member data
+ *
+ * \param 1 : number of members in the ensemble
+ * \param 2 : memory layout of states and derivatives
+ * \param 3 : grid point shift of each member (copied). May be NULL
+ * \param 4 : arguments of each member (addresses copied). May be NULL
+ */
+EnsembleMembers
+get_ensemble_members(int, EnsembleLayout, Rarray, void **);
+
+
+/** \brief Free struct of member data (must be detached from workspaces) */
+void
+destroy_ensemble_members(EnsembleMembers);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ */
+ComplexEnsembleWorkspaceRK
+get_cplx_ensemble_rungekutta_ws(int, int);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ */
+RealEnsembleWorkspaceRK
+get_real_ensemble_rungekutta_ws(int, int);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_ensemble_rungekutta_ws(ComplexEnsembleWorkspaceRK);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_ensemble_rungekutta_ws(RealEnsembleWorkspaceRK);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : multistep order (number of previous steps required)
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ */
+ComplexEnsembleWorkspaceMS
+get_cplx_ensemble_multistep_ws(int, int, int);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : multistep order (number of previous steps required)
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ */
+RealEnsembleWorkspaceMS
+get_real_ensemble_multistep_ws(int, int, int);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_ensemble_multistep_ws(ComplexEnsembleWorkspaceMS);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_ensemble_multistep_ws(RealEnsembleWorkspaceMS);
+
+
+/** \brief Copy state of one member to the ensemble SoA array
+ *
+ * Only valid for the default layout. With `EnsembleMembers` attached to
+ * the workspace use `cplx_ensemble_set_member_layout`
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ * \param 3 : index of the member
+ * \param 4 : state of the member with `system_size` values
+ * \param 5 : (MODIFIED) ensemble array in SoA layout
+ */
+void
+cplx_ensemble_set_member(int, int, int, Carray, Carray);
+
+
+/** \brief Copy state of one member to the ensemble array in given layout
+ *
+ * \param 1 : member data attached to the workspace (field `members`),
+ *            NULL for the default SoA layout
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ * \param 4 : index of the member
+ * \param 5 : state of the member with `system_size` values
+ * \param 6 : (MODIFIED) ensemble array in the layout of param 1
+ */
+void
+cplx_ensemble_set_member_layout(
+        EnsembleMembers, int, int, int, Carray, Carray
+);
+
+
+/** \brief Copy state of one member to the ensemble SoA array
+ *
+ * Only valid for the default layout. With `EnsembleMembers` attached to
+ * the workspace use `real_ensemble_set_member_layout`
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ * \param 3 : index of the member
+ * \param 4 : state of the member with `system_size` values
+ * \param 5 : (MODIFIED) ensemble array in SoA layout
+ */
+void
+real_ensemble_set_member(int, int, int, Rarray, Rarray);
+
+
+/** \brief Copy state of one member to the ensemble array in given layout
+ *
+ * \param 1 : member data attached to the workspace (field `members`),
+ *            NULL for the default SoA layout
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ * \param 4 : index of the member
+ * \param 5 : state of the member with `system_size` values
+ * \param 6 : (MODIFIED) ensemble array in the layout of param 1
+ */
+void
+real_ensemble_set_member_layout(
+        EnsembleMembers, int, int, int, Rarray, Rarray
+);
+
+
+/** \brief Copy state of one member from the ensemble SoA array
+ *
+ * Only valid for the default layout. With `EnsembleMembers` attached to
+ * the workspace use `cplx_ensemble_get_member_layout`
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ * \param 3 : index of the member
+ * \param 4 : ensemble array in SoA layout
+ * \param 5 : (OUTPUT) state of the member with `system_size` values
+ */
+void
+cplx_ensemble_get_member(int, int, int, Carray, Carray);
+
+
+/** \brief Copy state of one member from the ensemble array in given layout
+ *
+ * \param 1 : member data attached to the workspace (field `members`),
+ *            NULL for the default SoA layout
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ * \param 4 : index of the member
+ * \param 5 : ensemble array in the layout of param 1
+ * \param 6 : (OUTPUT) state of the member with `system_size` values
+ */
+void
+cplx_ensemble_get_member_layout(
+        EnsembleMembers, int, int, int, Carray, Carray
+);
+
+
+/** \brief Copy state of one member from the ensemble SoA array
+ *
+ * Only valid for the default layout. With `EnsembleMembers` attached to
+ * the workspace use `real_ensemble_get_member_layout`
+ *
+ * \param 1 : system size of each member
+ * \param 2 : number of members in the ensemble
+ * \param 3 : index of the member
+ * \param 4 : ensemble array in SoA layout
+ * \param 5 : (OUTPUT) state of the member with `system_size` values
+ */
+void
+real_ensemble_get_member(int, int, int, Rarray, Rarray);
+
+
+/** \brief Copy state of one member from the ensemble array in given layout
+ *
+ * \param 1 : member data attached to the workspace (field `members`),
+ *            NULL for the default SoA layout
+ * \param 2 : system size of each member
+ * \param 3 : number of members in the ensemble
+ * \param 4 : index of the member
+ * \param 5 : ensemble array in the layout of param 1
+ * \param 6 : (OUTPUT) state of the member with `system_size` values
+ */
+void
+real_ensemble_get_member_layout(
+        EnsembleMembers, int, int, int, Rarray, Rarray
+);
+
+
+/**
+ * \brief 5th order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `cplx_rungekutta5` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+cplx_ensemble_rungekutta5(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceRK,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief 5th order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `real_rungekutta5` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _RealEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+real_ensemble_rungekutta5(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceRK,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief 4th order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `cplx_rungekutta4` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+cplx_ensemble_rungekutta4(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceRK,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief 4th order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `real_rungekutta4` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _RealEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+real_ensemble_rungekutta4(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceRK,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief 2nd order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `cplx_rungekutta2` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+cplx_ensemble_rungekutta2(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceRK,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief 2nd order Runge-Kutta step of all members of the ensemble
+ *
+ * Same scheme of `real_rungekutta2` with one derivative call per stage
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute ensemble derivatives
+ * \param 4 : extra arguments (void pointer in _RealEnsembleInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : function values of all members at `x` in SoA layout
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ */
+void
+real_ensemble_rungekutta2(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceRK,
+        Rarray,
+        Rarray
+);
+
+
+/** \brief Set initial steps of ensemble multistep scheme using given RK
+ *
+ * The initial steps are set in workspace history, starting at `x = 0`
+ *
+ * \param 1 : grid step size
+ * \param 2 : routine to compute ensemble derivatives
+ * \param 3 : optional arguments required to compute derivatives
+ * \param 4 : (MODIFIED) workspace struct pointer with multistep setup
+ * \param 5 : initial condition of all members in SoA layout
+ * \param 6 : address of ensemble RungeKutta routine to use
+ */
+void
+init_cplx_ensemble_multistep(
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceMS,
+        Carray,
+        cplx_ensemble_rk_routine
+);
+
+
+/** \brief Set initial steps of ensemble multistep scheme using given RK
+ *
+ * The initial steps are set in workspace history, starting at `x = 0`
+ *
+ * \param 1 : grid step size
+ * \param 2 : routine to compute ensemble derivatives
+ * \param 3 : optional arguments required to compute derivatives
+ * \param 4 : (MODIFIED) workspace struct pointer with multistep setup
+ * \param 5 : initial condition of all members in SoA layout
+ * \param 6 : address of ensemble RungeKutta routine to use
+ */
+void
+init_real_ensemble_multistep(
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceMS,
+        Rarray,
+        real_ensemble_rk_routine
+);
+
+
+/** \brief Set fresh computed ensemble solution as most recent step
+ *
+ * \param 1 : next (fresh computed solution) grid point
+ * \param 2 : routine to compute ensemble derivatives
+ * \param 3 : optional arguments required to compute derivatives
+ * \param 4 : (MODIFIED) workspace struct pointer with history
+ * \param 5 : fresh computed solution of all members at param 1
+ */
+void
+cplx_ensemble_set_next_multistep(
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceMS,
+        Carray
+);
+
+
+/** \brief Set fresh computed ensemble solution as most recent step
+ *
+ * \param 1 : next (fresh computed solution) grid point
+ * \param 2 : routine to compute ensemble derivatives
+ * \param 3 : optional arguments required to compute derivatives
+ * \param 4 : (MODIFIED) workspace struct pointer with history
+ * \param 5 : fresh computed solution of all members at param 1
+ */
+void
+real_ensemble_set_next_multistep(
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceMS,
+        Rarray
+);
+
+
+/** \brief Address of j-th previous step of all members (0 most recent) */
+Carray
+cplx_ensemble_prev_step(ComplexEnsembleWorkspaceMS, unsigned int);
+
+
+/** \brief Address of j-th previous step of all members (0 most recent) */
+Rarray
+real_ensemble_prev_step(RealEnsembleWorkspaceMS, unsigned int);
+
+
+/**
+ * \brief General multistep operation for all members of the ensemble
+ *
+ * Same scheme of `cplx_general_multistep` using the history of previous
+ * steps held in the workspace
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history
+ * \param 6 : function weights `a` as array of `m + 1` elements
+ * \param 7 : derivative weights `b` as array of `m + 1` elements
+ * \param 8 : number of iterations of implicit method (0 for explicit)
+ * \param 9 : (OUTPUT) solution at next grid step
+ *            (INPUT)  use as predictor if parameter 8 is greater than 0
+ */
+void
+cplx_ensemble_general_multistep(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceMS,
+        Rarray,
+        Rarray,
+        unsigned int,
+        Carray
+);
+
+
+/**
+ * \brief General multistep operation for all members of the ensemble
+ *
+ * Same scheme of `real_general_multistep` using the history of previous
+ * steps held in the workspace
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history
+ * \param 6 : function weights `a` as array of `m + 1` elements
+ * \param 7 : derivative weights `b` as array of `m + 1` elements
+ * \param 8 : number of iterations of implicit method (0 for explicit)
+ * \param 9 : (OUTPUT) solution at next grid step
+ *            (INPUT)  use as predictor if parameter 8 is greater than 0
+ */
+void
+real_ensemble_general_multistep(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceMS,
+        Rarray,
+        Rarray,
+        unsigned int,
+        Rarray
+);
+
+
+/** \brief 4th order Adams predictor-corrector step of all members
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history of order 4
+ * \param 6 : number of iterations of corrector (zero for predictor only)
+ * \param 7 : (OUTPUT) solution at next grid step
+ */
+void
+cplx_ensemble_adams4pc(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceMS,
+        unsigned int,
+        Carray
+);
+
+
+/** \brief 4th order Adams predictor-corrector step of all members
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history of order 4
+ * \param 6 : number of iterations of corrector (zero for predictor only)
+ * \param 7 : (OUTPUT) solution at next grid step
+ */
+void
+real_ensemble_adams4pc(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceMS,
+        unsigned int,
+        Rarray
+);
+
+
+/** \brief 6th order Adams predictor-corrector step of all members
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history of order 6
+ * \param 6 : number of iterations of corrector (zero for predictor only)
+ * \param 7 : (OUTPUT) solution at next grid step
+ */
+void
+cplx_ensemble_adams6pc(
+        double,
+        double,
+        cplx_ensemble_der,
+        void *,
+        ComplexEnsembleWorkspaceMS,
+        unsigned int,
+        Carray
+);
+
+
+/** \brief 6th order Adams predictor-corrector step of all members
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : grid point `x` of the most recent step
+ * \param 3 : routine to compute ensemble derivatives
+ * \param 4 : optional arguments required to compute derivatives
+ * \param 5 : workspace struct pointer with history of order 6
+ * \param 6 : number of iterations of corrector (zero for predictor only)
+ * \param 7 : (OUTPUT) solution at next grid step
+ */
+void
+real_ensemble_adams6pc(
+        double,
+        double,
+        real_ensemble_der,
+        void *,
+        RealEnsembleWorkspaceMS,
+        unsigned int,
+        Rarray
+);
+
+
+#endif
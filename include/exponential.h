@@ -0,0 +1,182 @@
+/**
+ * \file exponential.h
+ * \author Alex Andriati
+ * \brief Exponential integrators for complex systems y' = L y + N(x, y)
+ *
+ * When the linear part `L` is stiff (as the dispersion of Schrodinger
+ * equations in Fourier space) explicit methods require steps smaller
+ * than the fastest linear scale, although the solution may be smooth.
+ * Exponential integrators solve the linear part exactly, thus the step
+ * size is only restricted by the nonlinear part `N`. The operator `L`
+ * is diagonal, given by its elements, and for diagonalizable operators
+ * the system must be written in the basis of eigenvectors (the user
+ * routine of `N` may transform back and forth, e.g. with FFTs)
+ *
+ * The user routine with signature `cplx_odesys_der` computes only the
+ * nonlinear part `N(x, y)`. The exponentials and phi-functions of `h L`
+ * depend on the step size and are computed in the first step with a
+ * given `h`, then kept in the workspace until the step size changes
+ */
+
+#ifndef ODE_EXPONENTIAL_H
+#define ODE_EXPONENTIAL_H
+
+#include "derivative_signature.h"
+#include "tableau.h"
+
+/** \brief Struct to provide workspace of ETDRK4 method
+ *
+ * Besides the stages, hold the coefficients of the method for the step
+ * size `h` (zero if not computed yet)
+ */
+typedef struct{
+    int
+        system_size;    /// number of equations in ODE system
+    double
+        h;              /// step size of the coefficients
+    Carray
+        lin,            /// diagonal of linear operator `L`
+        e,              /// exp(h L)
+        e2,             /// exp(h L / 2)
+        q,              /// (exp(h L / 2) - 1) / L
+        f1,             /// coefficient of N(y) in the solution
+        f2,             /// coefficient of N(a) and N(b) in the solution
+        f3,             /// coefficient of N(c) in the solution
+        nv,             /// nonlinear part at the stages
+        na,
+        nb,
+        nc,
+        a,              /// stage arguments (`b` array reused for `c`)
+        b;
+} _ComplexWorkspaceETD;
+
+/** \brief Workspace struct address of ETDRK4 method */
+typedef _ComplexWorkspaceETD * ComplexWorkspaceETD;
+
+/** \brief Struct to provide workspace of Lawson methods
+ *
+ * Lawson methods apply the Runge-Kutta method of a Butcher tableau to
+ * `exp(-x L) y`, thus every term of a stage is multiplied by one of the
+ * exponentials `exp(d h L)` with `d` a difference of nodes. The nonzero
+ * terms are stored by rows as in the tableau workspace, rows `0` to
+ * `stages - 1` for the stages, row `stages` for `b` and `stages + 1`
+ * for `b - bhat`, with the index of their exponentials (-1 for `d = 0`)
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        stages,         /// number of stages of the tableau
+        nexp;           /// number of distinct exponentials
+    double
+        h;              /// step size of the exponentials
+    const ButcherTableau
+        * tableau;      /// method coefficients (not owned by workspace)
+    int
+        * nterms,       /// number of nonzero terms in each row
+        * term_stage,   /// stage index of each term
+        * term_exp,     /// exponential index of each term
+        * row_exp;      /// exponential index of `y` in each row
+    double
+        * term_weight,  /// coefficient of each term
+        * exp_frac;     /// fraction `d` of step of each exponential
+    Carray
+        lin,            /// diagonal of linear operator `L`
+        * expo,         /// exponentials `exp(d h L)`
+        * k,            /// nonlinear part at the stages
+        karg;           /// argument of stage evaluation
+} _ComplexWorkspaceLawson;
+
+/** \brief Workspace struct address of Lawson methods */
+typedef _ComplexWorkspaceLawson * ComplexWorkspaceLawson;
+
+
+/** \brief Return fresh allocated workspace of ETDRK4 method
+ *
+ * \param 1 : system size
+ * \param 2 : diagonal of linear operator (copied to workspace)
+ */
+ComplexWorkspaceETD
+get_cplx_etd_ws(int sys_size, Carray lin);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_etd_ws(ComplexWorkspaceETD);
+
+
+/** \brief Return fresh allocated workspace of Lawson method
+ *
+ * The integrating factor Runge-Kutta of 4th order is the Lawson method
+ * with the classical tableau `TABLEAU_RK4`
+ *
+ * \param 1 : system size
+ * \param 2 : diagonal of linear operator (copied to workspace)
+ * \param 3 : Runge-Kutta tableau, which must live while the workspace
+ *            is used. The nodes should be nondecreasing, otherwise the
+ *            exponentials of negative fractions may overflow
+ */
+ComplexWorkspaceLawson
+get_cplx_lawson_ws(int sys_size, Carray lin, const ButcherTableau *);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_lawson_ws(ComplexWorkspaceLawson);
+
+
+/**
+ * \brief Exponential time differencing 4th order Runge-Kutta step
+ *
+ * Method of Cox and Matthews with the phi-functions evaluated by
+ * contour integrals as proposed by Kassam and Trefethen, accurate for
+ * any `h L` including zero
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute nonlinear part
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : (MODIFIED) workspace, coefficients updated if `h` changed
+ * \param 6 : function values `y` computed at current grid point
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
+ */
+void
+cplx_etdrk4_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceETD,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Lawson (generalized integrating factor) Runge-Kutta step
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute nonlinear part
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : (MODIFIED) workspace, exponentials updated if `h` changed
+ * \param 6 : function values `y` computed at current grid point
+ * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
+ * \param 8 : (OUTPUT) local error estimate of param 7 from the embedded
+ *            solution. Ignored if NULL or the tableau has no `bhat`
+ */
+void
+cplx_lawson_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceLawson,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+#endif
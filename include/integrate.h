@@ -0,0 +1,216 @@
+/**
+ * \file integrate.h
+ * \author Alex Andriati
+ * \brief Drivers to integrate ODE systems over a full interval
+ *
+ * Instead of writing the loop around the single step routines in the
+ * client application, the drivers here propagate the solution from
+ * `x0` to `x1` with a fixed number of steps and call an user routine
+ * (observer) only at the output points. Runge-Kutta methods advance
+ * the solution in place, while multistep methods keep the previous
+ * steps in the workspace history, where a new step only moves an index,
+ * and their startup is done automatically
+ *
+ * The driver with events also stops the integration (or reports) when
+ * user functions `g(x, y)` cross zero. The crossings are located inside
+ * the step by root finding on a cubic Hermite interpolant built from the
+ * solution and derivatives at both ends of the step, which are already
+ * computed by the methods, thus without extra derivative evaluations
+ */
+
+#ifndef ODE_INTEGRATE_H
+#define ODE_INTEGRATE_H
+
+#include "derivative_signature.h"
+#include "singlestep.h"
+#include "multistep.h"
+
+/** \brief Fixed step methods available in the integration drivers
+ *
+ * Adams predictor-corrector methods use the number of corrector
+ * iterations given to the drivers (one for PECE) and are started with
+ * 4th and 5th order Runge-Kutta respectively
+ */
+typedef enum{
+    RUNGEKUTTA2,
+    RUNGEKUTTA4,
+    RUNGEKUTTA5,
+    ADAMS4PC,
+    ADAMS6PC
+} FixedStepMethod;
+
+/**
+ * \brief Function signature of observer for real ODE system
+ *
+ * \param 1 : Struct with current grid point, solution and system size
+ *            with `extra_args` the observer arguments given to driver.
+ *            The solution array must not be modified
+ */
+typedef void (*real_odesys_observer)(RealODEInputParameters);
+
+/**
+ * \brief Function signature of observer for complex ODE system
+ *
+ * \param 1 : Struct with current grid point, solution and system size
+ *            with `extra_args` the observer arguments given to driver.
+ *            The solution array must not be modified
+ */
+typedef void (*cplx_odesys_observer)(ComplexODEInputParameters);
+
+/**
+ * \brief Function signature of event of real ODE system
+ *
+ * \param 1 : Struct with grid point, solution and system size with
+ *            `extra_args` the arguments of the derivative routine.
+ *            The solution array must not be modified
+ *
+ * \return value of event function `g(x, y)`, with events at its zeros
+ */
+typedef double (*real_odesys_event)(RealODEInputParameters);
+
+/**
+ * \brief Function signature called when an event is found
+ *
+ * \param 1 : index of the event in the array given to driver
+ * \param 2 : Struct with event point, interpolated solution and system
+ *            size with `extra_args` the observer arguments given to driver
+ */
+typedef void (*real_odesys_event_handler)(int, RealODEInputParameters);
+
+/** \brief Event of real ODE system
+ *
+ * Only crossings where `g` changes sign between the grid points are
+ * detected, thus two zeros inside the same step cancel each other. The
+ * `direction` refers to the change of `g` along the integration
+ */
+typedef struct{
+    real_odesys_event
+        g;              /// event function
+    int
+        direction,      /// +1 (-1) only increasing (decreasing), 0 both
+        terminal;       /// nonzero to stop integration at the event
+} RealODEEvent;
+
+
+/**
+ * \brief Integrate complex ODE system from `x0` to `x1` with fixed step
+ *
+ * The step size is `h = (x1 - x0) / nsteps`. The observer is called at
+ * `x0`, after every `out_every` steps and at `x1`. For multistep methods
+ * with less steps than required by the startup, the Runge-Kutta method
+ * of the startup is used in the whole interval
+ *
+ * \param 1 : method to propagate the solution
+ * \param 2 : corrector iterations of Adams methods, zero for predictor
+ *            only (ignored by Runge-Kutta methods)
+ * \param 3 : system size
+ * \param 4 : initial grid point `x0`
+ * \param 5 : final grid point `x1`
+ * \param 6 : number of steps
+ * \param 7 : function pointer to routine that compute derivatives
+ * \param 8 : extra arguments required in param 7
+ * \param 9 : number of steps between consecutive observer calls
+ * \param 10: observer routine. May be NULL
+ * \param 11: extra arguments passed to param 10
+ * \param 12: (MODIFIED) solution at `x0` overwritten by solution at `x1`
+ */
+void
+cplx_integrate(
+        FixedStepMethod,
+        unsigned int,
+        unsigned int,
+        double,
+        double,
+        unsigned int,
+        cplx_odesys_der,
+        void *,
+        unsigned int,
+        cplx_odesys_observer,
+        void *,
+        Carray
+);
+
+/**
+ * \brief Integrate real ODE system from `x0` to `x1` with fixed step
+ *
+ * The step size is `h = (x1 - x0) / nsteps`. The observer is called at
+ * `x0`, after every `out_every` steps and at `x1`. For multistep methods
+ * with less steps than required by the startup, the Runge-Kutta method
+ * of the startup is used in the whole interval
+ *
+ * \param 1 : method to propagate the solution
+ * \param 2 : corrector iterations of Adams methods, zero for predictor
+ *            only (ignored by Runge-Kutta methods)
+ * \param 3 : system size
+ * \param 4 : initial grid point `x0`
+ * \param 5 : final grid point `x1`
+ * \param 6 : number of steps
+ * \param 7 : function pointer to routine that compute derivatives
+ * \param 8 : extra arguments required in param 7
+ * \param 9 : number of steps between consecutive observer calls
+ * \param 10: observer routine. May be NULL
+ * \param 11: extra arguments passed to param 10
+ * \param 12: (MODIFIED) solution at `x0` overwritten by solution at `x1`
+ */
+void
+real_integrate(
+        FixedStepMethod,
+        unsigned int,
+        unsigned int,
+        double,
+        double,
+        unsigned int,
+        real_odesys_der,
+        void *,
+        unsigned int,
+        real_odesys_observer,
+        void *,
+        Rarray
+);
+
+
+
+/**
+ * \brief Integrate real ODE system with fixed step until a terminal event
+ *
+ * Same as `real_integrate` checking the events after every step. The
+ * Runge-Kutta methods run through their tableau (see tableau.h) to take
+ * the derivative at the end of a step as first stage of the next one,
+ * and the Adams methods use the derivatives held in their history. The
+ * events found in a step are reported in the order they occur until the
+ * first terminal one, where the integration stops. The root is located
+ * with the Illinois method to machine precision of the grid point
+ *
+ * \param 1-11 : same as params 1-11 of `real_integrate`
+ * \param 12: number of events
+ * \param 13: array with events. Event functions receive param 8
+ * \param 14: routine called at every event found. May be NULL
+ * \param 15: (OUTPUT) grid point where integration stopped
+ * \param 16: (MODIFIED) solution at `x0` overwritten by solution at param
+ *            15, interpolated if the integration stopped at an event
+ *
+ * \return index of terminal event that stopped the integration or -1 if
+ *         it reached `x1`
+ */
+int
+real_integrate_events(
+        FixedStepMethod,
+        unsigned int,
+        unsigned int,
+        double,
+        double,
+        unsigned int,
+        real_odesys_der,
+        void *,
+        unsigned int,
+        real_odesys_observer,
+        void *,
+        unsigned int,
+        const RealODEEvent *,
+        real_odesys_event_handler,
+        double *,
+        Rarray
+);
+
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * \file kernels.h
+ * \author Alex Andriati
+ * \brief Vector kernels for linear combinations of arrays
+ *
+ * All stage updates of Runge-Kutta and multistep methods are linear
+ * combinations of a few arrays with scalar weights. The kernels here
+ * compute them in a single pass over memory with explicit SIMD code,
+ * selecting at runtime the widest instruction set the CPU supports
+ * (AVX-512, AVX2 or scalar fallback). All variants do the very same
+ * operations in the same order without fused multiply-add, thus the
+ * results are bit-identical whatever the instruction set selected.
+ *
+ * The `*_threads` variants also split the arrays among threads when the
+ * library is built with OpenMP (`ODESYS_OPENMP`), and otherwise run as
+ * the serial ones. Small arrays are not split, as the cost to fork the
+ * threads would dominate. The results do not depend on the number of
+ * threads either.
+ *
+ * This file is private to the library and not included in odesys.h
+ */
+
+#ifndef ODE_KERNELS_H
+#define ODE_KERNELS_H
+
+#include "arrays.h"
+
+
+/**
+ * \brief Compute `out = base + scale * (w[0] * v[0] + ... + w[n-1] * v[n-1])`
+ *
+ * The sum is accumulated from left to right for each element. For large
+ * number of terms the scaled partial sums of `KERNEL_MAX_TERMS` (8) are
+ * accumulated in the output, thus the output may be the same array of
+ * `base` or any of the first 8 arrays of `v` (in-place), but not one of
+ * the following ones, which stops the program
+ *
+ * \param 1 : number of elements in each array
+ * \param 2 : array added without weight. If NULL it is taken as zero
+ * \param 3 : common factor of the weighted sum (usually step size)
+ * \param 4 : number of weighted terms `n` (at least one)
+ * \param 5 : weights of the arrays
+ * \param 6 : addresses of the arrays to combine
+ * \param 7 : (OUTPUT) linear combination
+ */
+void
+rarr_lincomb(
+        unsigned int,
+        Rarray,
+        double,
+        unsigned int,
+        double *,
+        Rarray *,
+        Rarray
+);
+
+
+/**
+ * \brief Compute `out = base + scale * (w[0] * v[0] + ... + w[n-1] * v[n-1])`
+ *
+ * Complex arrays with real weights, implemented with the real kernel
+ * over real and imaginary parts. See `rarr_lincomb`
+ */
+void
+carr_lincomb(
+        unsigned int,
+        Carray,
+        double,
+        unsigned int,
+        double *,
+        Carray *,
+        Carray
+);
+
+
+/**
+ * \brief Same as `rarr_lincomb` with the arrays split among threads
+ *
+ * \param 1 : maximum number of threads
+ * \param 2-8 : same as params 1-7 of `rarr_lincomb`
+ */
+void
+rarr_lincomb_threads(
+        int,
+        unsigned int,
+        Rarray,
+        double,
+        unsigned int,
+        double *,
+        Rarray *,
+        Rarray
+);
+
+
+/**
+ * \brief Same as `carr_lincomb` with the arrays split among threads
+ *
+ * \param 1 : maximum number of threads
+ * \param 2-8 : same as params 1-7 of `carr_lincomb`
+ */
+void
+carr_lincomb_threads(
+        int,
+        unsigned int,
+        Carray,
+        double,
+        unsigned int,
+        double *,
+        Carray *,
+        Carray
+);
+
+
+/**
+ * \brief Set array to zero using the same partition among threads of
+ * the `*_threads` kernels, such that memory pages are first touched, and
+ * thus placed in the NUMA node, by the thread which will process them
+ *
+ * \param 1 : maximum number of threads
+ * \param 2 : number of elements
+ * \param 3 : (OUTPUT) array set to zero
+ */
+void
+rarr_first_touch(int, unsigned int, Rarray);
+
+
+/** \brief Complex version of `rarr_first_touch` */
+void
+carr_first_touch(int, unsigned int, Carray);
+
+
+/** \brief Name of the instruction set selected for the kernels */
+const char *
+kernels_simd_name(void);
+
+
+#endif
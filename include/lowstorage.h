@@ -0,0 +1,329 @@
+/**
+ * \file lowstorage.h
+ * \author Alex Andriati
+ * \brief Low-storage Runge-Kutta methods for very large systems
+ *
+ * The classical Runge-Kutta routines keep all stage derivatives, thus
+ * the 5th order method needs 7 work arrays of system size. The methods
+ * here are written as recurrences which overwrite the same registers at
+ * every stage, thus only two or three work arrays (registers) are needed
+ * besides the solution, regardless of the number of stages. They use
+ * their own workspace, obtained with `get_*_lowstorage_ws`
+ *
+ * Three forms are available:
+ *
+ * 2N (Williamson) : with the increment `q` and the solution `y`
+ *      q = A[i] * q + h * f(x + c[i] * h, y)
+ *      y = y + B[i] * q
+ *
+ * 3R (van der Houwen) : with stage argument `X`, derivative `K` and
+ * solution `y` (`X = y` in the first stage)
+ *      K = f(x + c[i] * h, X)
+ *      X = y + h * a[i] * K
+ *      y = y + h * b[i] * K
+ *
+ * 2S and 3S* (Ketcheson) : with `S1 = S3 = y` and `S2 = 0` at start
+ *      S2 = S2 + delta[i] * S1
+ *      S1 = gamma1[i] * S1 + gamma2[i] * S2 + gamma3[i] * S3
+ *           + h * beta[i] * f(x + c[i] * h, S1)
+ * where the 2S form has no `gamma3` and thus needs no copy of `y`
+ *
+ * Since the derivative routine writes in an output array, one register
+ * of all forms holds the derivative of the current stage
+ */
+
+#ifndef ODE_LOWSTORAGE_H
+#define ODE_LOWSTORAGE_H
+
+#include "derivative_signature.h"
+
+/** \brief Number of registers used by methods in 2N, 3R and 2S forms */
+#define LOWSTORAGE_REGISTERS 2
+
+/** \brief Number of registers used by methods in 3S* form */
+#define LOWSTORAGE_3S_REGISTERS 3
+
+/** \brief Struct to provide workspace for low-storage methods
+ *
+ * The registers are placed in a single aligned block as the arrays of
+ * the Runge-Kutta workspace of singlestep.h. With two registers the
+ * last one is NULL. The number of threads is one when the workspace is
+ * created, see `set_*_lowstorage_threads`
+ */
+typedef struct{
+    int
+        system_size,
+        registers,      /// number of registers set (two or three)
+        nthreads;       /// threads of stage combinations (OpenMP build)
+    void
+        * arena;        /// block with all registers
+    Carray
+        work1,
+        work2,
+        work3;
+} _ComplexWorkspaceLowStorage;
+
+/** \brief Struct workspace address for low-storage methods */
+typedef _ComplexWorkspaceLowStorage * ComplexWorkspaceLowStorage;
+
+/** \brief Struct to provide workspace for low-storage methods
+ *
+ * The registers are placed in a single aligned block as the arrays of
+ * the Runge-Kutta workspace of singlestep.h. With two registers the
+ * last one is NULL. The number of threads is one when the workspace is
+ * created, see `set_*_lowstorage_threads`
+ */
+typedef struct{
+    int
+        system_size,
+        registers,      /// number of registers set (two or three)
+        nthreads;       /// threads of stage combinations (OpenMP build)
+    void
+        * arena;        /// block with all registers
+    Rarray
+        work1,
+        work2,
+        work3;
+} _RealWorkspaceLowStorage;
+
+/** \brief Struct workspace address for low-storage methods */
+typedef _RealWorkspaceLowStorage * RealWorkspaceLowStorage;
+
+/** \brief Coefficients of low-storage method in 2N form */
+typedef struct{
+    const char
+        * name;         /// method name for output purposes
+    int
+        stages,         /// number of stages `s`
+        order;          /// order of the method
+    const double
+        * A,            /// increment coefficients (A[0] = 0)
+        * B,            /// solution update coefficients
+        * c;            /// nodes (fraction of step of each stage)
+} LowStorage2N;
+
+/** \brief Coefficients of low-storage method in 3R form
+ *
+ * Butcher tableau with `a[i][j] = b[j]` for `j < i - 1`, thus only the
+ * subdiagonal `a[i] = a[i + 1][i]` is given with `stages - 1` elements
+ */
+typedef struct{
+    const char
+        * name;         /// method name for output purposes
+    int
+        stages,         /// number of stages `s`
+        order;          /// order of the method
+    const double
+        * a,            /// subdiagonal of Butcher tableau
+        * b,            /// weights of Butcher tableau
+        * c;            /// nodes (fraction of step of each stage)
+} LowStorage3R;
+
+/** \brief Coefficients of low-storage method in 2S or 3S* form
+ *
+ * All arrays have `stages` elements. The method is in 2S form if
+ * `gamma3` is NULL, otherwise a copy of the solution at the start of
+ * the step is kept in a third register (3S* form)
+ */
+typedef struct{
+    const char
+        * name;         /// method name for output purposes
+    int
+        stages,         /// number of stages `s`
+        order;          /// order of the method
+    const double
+        * gamma1,       /// coefficients of stage register `S1`
+        * gamma2,       /// coefficients of accumulated register `S2`
+        * gamma3,       /// coefficients of initial solution `S3` (or NULL)
+        * beta,         /// coefficients of stage derivatives
+        * delta,        /// coefficients of `S1` accumulated in `S2`
+        * c;            /// nodes (fraction of step of each stage)
+} LowStorage3S;
+
+/*
+ * Library of low-storage methods. Refs. are listed in lowstorage.c
+ *
+ * `LS2N_WILLIAMSON_3`          3rd order, 3 stages, ref. [1]
+ * `LS2N_CARPENTER_KENNEDY_4`   4th order, 5 stages, ref. [2]
+ * `LS3R_WRAY_3`                3rd order, 3 stages, ref. [3]
+ * `LS2S_KETCHESON_SSP_10_4`    4th order, 10 stages SSP, ref. [4]
+ * `LS3S_KETCHESON_SSP_4_3`     3rd order, 4 stages SSP, ref. [4]
+ */
+extern const LowStorage2N LS2N_WILLIAMSON_3;
+extern const LowStorage2N LS2N_CARPENTER_KENNEDY_4;
+extern const LowStorage3R LS3R_WRAY_3;
+extern const LowStorage3S LS2S_KETCHESON_SSP_10_4;
+extern const LowStorage3S LS3S_KETCHESON_SSP_4_3;
+
+
+/** \brief Return fresh allocated workspace with registers set
+ *
+ * \param 1 : system size
+ * \param 2 : number of registers, `LOWSTORAGE_REGISTERS` or
+ *            `LOWSTORAGE_3S_REGISTERS` for methods in 3S* form
+ */
+ComplexWorkspaceLowStorage
+get_cplx_lowstorage_ws(int sys_size, int registers);
+
+
+/** \brief Return fresh allocated workspace (see complex version) */
+RealWorkspaceLowStorage
+get_real_lowstorage_ws(int sys_size, int registers);
+
+
+/** \brief Set number of threads of the stage combinations
+ *
+ * Same as `set_cplx_rungekutta_threads`, the registers are set to zero
+ * with the partition among threads used in the steps (first touch)
+ *
+ * \param 1 : (MODIFIED) workspace
+ * \param 2 : number of threads (one for serial execution)
+ */
+void
+set_cplx_lowstorage_threads(ComplexWorkspaceLowStorage, int);
+
+
+/** \brief Set number of threads of the stage combinations (see complex) */
+void
+set_real_lowstorage_threads(RealWorkspaceLowStorage, int);
+
+
+/** \brief Free allocated workspace struct and its registers */
+void
+destroy_cplx_lowstorage_ws(ComplexWorkspaceLowStorage);
+
+
+/** \brief Free allocated workspace struct and its registers */
+void
+destroy_real_lowstorage_ws(RealWorkspaceLowStorage);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 2N form
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : Workspace with at least `LOWSTORAGE_REGISTERS` registers
+ * \param 6 : method coefficients
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 7 (in-place step), which
+ *            avoids a copy
+ */
+void
+cplx_lowstorage2n_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceLowStorage,
+        const LowStorage2N *,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 2N form
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace with at least `LOWSTORAGE_REGISTERS` registers
+ * \param 6 : method coefficients
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 7 (in-place step), which
+ *            avoids a copy
+ */
+void
+real_lowstorage2n_step(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceLowStorage,
+        const LowStorage2N *,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 3R form
+ *
+ * See `cplx_lowstorage2n_step` for parameters
+ */
+void
+cplx_lowstorage3r_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceLowStorage,
+        const LowStorage3R *,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 3R form
+ *
+ * See `real_lowstorage2n_step` for parameters
+ */
+void
+real_lowstorage3r_step(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceLowStorage,
+        const LowStorage3R *,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 2S or 3S* form
+ *
+ * See `cplx_lowstorage2n_step` for parameters. Methods in 3S* form
+ * require a workspace with `LOWSTORAGE_3S_REGISTERS` registers
+ */
+void
+cplx_lowstorage3s_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceLowStorage,
+        const LowStorage3S *,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Low-storage Runge-Kutta step in 2S or 3S* form
+ *
+ * See `real_lowstorage2n_step` for parameters. Methods in 3S* form
+ * require a workspace with `LOWSTORAGE_3S_REGISTERS` registers
+ */
+void
+real_lowstorage3s_step(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceLowStorage,
+        const LowStorage3S *,
+        Rarray,
+        Rarray
+);
+
+
+#endif
@@ -14,18 +14,33 @@
 #include "derivative_signature.h"
 #include "singlestep.h"
 
+/** \brief Maximum number of previous steps of multistep workspaces */
+#define MULTISTEP_MAX_ORDER 12
+
 /** \brief Struct to provide complex workspace for multistep methods
  *
  * Provide basic data to simplify the general multistep methods API,
  * with max number of previous steps required, system size and array
  * with all demanded previous derivatives pre-computed
+ *
+ * In history mode the previous steps are also kept in the workspace
+ * and both `yhist` and `prev_der` are circular buffers, where the j-th
+ * previous step (j = 0 the most recent) is at chunk `(head + j) % ms_order`
+ * Thus, advancing a step only moves `head` instead of shifting chunks.
+ * Without history mode `head` is always zero and the previous steps are
+ * given by the client in a concatenated array
  */
 typedef struct{
     int
         ms_order,       /// number of previous steps required
-        system_size;    /// number of equations in ODE system
+        system_size,    /// number of equations in ODE system
+        head,           /// chunk index of the most recent step
+        nthreads;       /// threads of vector operations (OpenMP build)
+    IntegratorStats
+        stats;          /// counters and timers (NULL if none, see stats.h)
     Carray
-        prev_der;       /// Hold all required previous derivatives
+        prev_der,       /// Hold all required previous derivatives
+        yhist;          /// Previous steps if in history mode (else NULL)
 } _ComplexWorkspaceMS;
 
 /** \brief Workspace struct address for multistep methods */
@@ -36,18 +51,86 @@ typedef _ComplexWorkspaceMS * ComplexWorkspaceMS;
  * Provide basic data to simplify the general multistep methods API,
  * with max number of previous steps required, system size and array
  * with all demanded previous derivatives pre-computed
+ *
+ * In history mode the previous steps are also kept in the workspace
+ * and both `yhist` and `prev_der` are circular buffers, where the j-th
+ * previous step (j = 0 the most recent) is at chunk `(head + j) % ms_order`
+ * Thus, advancing a step only moves `head` instead of shifting chunks.
+ * Without history mode `head` is always zero and the previous steps are
+ * given by the client in a concatenated array
  */
 typedef struct{
     int
         ms_order,       /// number of previous steps required
-        system_size;    /// number of equations in ODE system
+        system_size,    /// number of equations in ODE system
+        head,           /// chunk index of the most recent step
+        nthreads;       /// threads of vector operations (OpenMP build)
+    IntegratorStats
+        stats;          /// counters and timers (NULL if none, see stats.h)
     Rarray
-        prev_der;       /// Hold all required previous derivatives
+        prev_der,       /// Hold all required previous derivatives
+        yhist;          /// Previous steps if in history mode (else NULL)
 } _RealWorkspaceMS;
 
 /** \brief Struct address with working array for multistep methods */
 typedef _RealWorkspaceMS * RealWorkspaceMS;
 
+/** \brief Corrector iteration control of complex Adams PC methods
+ *
+ * The corrector is iterated until the weighted root-mean-square of the
+ * change between iterates, with weights `abs_tol + rel_tol * |y|`, is
+ * at most one or `max_iter` iterations are done. The outcome of the
+ * last step is reported in the remaining fields
+ */
+typedef struct{
+    int
+        system_size;    /// number of equations in ODE system
+    unsigned int
+        max_iter,       /// maximum number of corrector iterations
+        iterations;     /// (OUTPUT) iterations done in last step
+    int
+        converged;      /// (OUTPUT) 1 if last step converged, 0 otherwise
+    double
+        abs_tol,        /// absolute tolerance of the change
+        rel_tol,        /// relative tolerance of the change
+        change_norm,    /// (OUTPUT) weighted norm of last change
+        milne_norm;     /// (OUTPUT) weighted norm of Milne estimate
+    Carray
+        ypred,          /// predictor value
+        yprev;          /// previous corrector iterate
+} _ComplexCorrectorControl;
+
+/** \brief Struct address of complex corrector iteration control */
+typedef _ComplexCorrectorControl * ComplexCorrectorControl;
+
+/** \brief Corrector iteration control of real Adams PC methods
+ *
+ * The corrector is iterated until the weighted root-mean-square of the
+ * change between iterates, with weights `abs_tol + rel_tol * |y|`, is
+ * at most one or `max_iter` iterations are done. The outcome of the
+ * last step is reported in the remaining fields
+ */
+typedef struct{
+    int
+        system_size;    /// number of equations in ODE system
+    unsigned int
+        max_iter,       /// maximum number of corrector iterations
+        iterations;     /// (OUTPUT) iterations done in last step
+    int
+        converged;      /// (OUTPUT) 1 if last step converged, 0 otherwise
+    double
+        abs_tol,        /// absolute tolerance of the change
+        rel_tol,        /// relative tolerance of the change
+        change_norm,    /// (OUTPUT) weighted norm of last change
+        milne_norm;     /// (OUTPUT) weighted norm of Milne estimate
+    Rarray
+        ypred,          /// predictor value
+        yprev;          /// previous corrector iterate
+} _RealCorrectorControl;
+
+/** \brief Struct address of real corrector iteration control */
+typedef _RealCorrectorControl * RealCorrectorControl;
+
 
 /** \brief Alloc struct internal array based on its integer fields */
 void
@@ -65,6 +148,77 @@ free_cplx_multistep_wsarray(ComplexWorkspaceMS);
 void
 free_real_multistep_wsarray(RealWorkspaceMS);
 
+/** \brief Alloc history of previous steps setting workspace in history mode
+ *
+ * Must be called after `alloc_cplx_multistep_wsarray`. Afterwards, the
+ * multistep routines ignore the array of concatenated previous steps
+ * and use the one in workspace, which may be then given as NULL
+ */
+void
+alloc_cplx_multistep_wshistory(ComplexWorkspaceMS);
+
+/** \brief Alloc history of previous steps setting workspace in history mode
+ *
+ * Must be called after `alloc_real_multistep_wsarray`. Afterwards, the
+ * multistep routines ignore the array of concatenated previous steps
+ * and use the one in workspace, which may be then given as NULL
+ */
+void
+alloc_real_multistep_wshistory(RealWorkspaceMS);
+
+/** \brief Set number of threads of the multistep vector operations
+ *
+ * Only effective if the library is built with `ODESYS_OPENMP`, and for
+ * large systems. Each chunk of `prev_der` and of the history (if set)
+ * is set to zero with the same partition among threads of the vector
+ * operations (first touch), thus this routine must be called after the
+ * arrays are allocated and before the initialization of the steps
+ *
+ * \param 1 : (MODIFIED) workspace with arrays allocated
+ * \param 2 : number of threads (one for serial execution)
+ */
+void
+set_cplx_multistep_threads(ComplexWorkspaceMS, int);
+
+/** \brief Set number of threads of the multistep vector operations
+ *
+ * See `set_cplx_multistep_threads`
+ */
+void
+set_real_multistep_threads(RealWorkspaceMS, int);
+
+/** \brief Address of the j-th previous step held in workspace history
+ *
+ * \param 1 : workspace struct address in history mode
+ * \param 2 : `j` with 0 the most recent step and `ms_order - 1` the oldest
+ */
+Carray
+cplx_multistep_prev_step(ComplexWorkspaceMS, unsigned int);
+
+/** \brief Address of the j-th previous step held in workspace history
+ *
+ * \param 1 : workspace struct address in history mode
+ * \param 2 : `j` with 0 the most recent step and `ms_order - 1` the oldest
+ */
+Rarray
+real_multistep_prev_step(RealWorkspaceMS, unsigned int);
+
+/** \brief Address of the derivative at the j-th previous step
+ *
+ * \param 1 : workspace struct address
+ * \param 2 : `j` with 0 the most recent step and `ms_order - 1` the oldest
+ */
+Carray
+cplx_multistep_prev_der(ComplexWorkspaceMS, unsigned int);
+
+/** \brief Address of the derivative at the j-th previous step
+ *
+ * \param 1 : workspace struct address
+ * \param 2 : `j` with 0 the most recent step and `ms_order - 1` the oldest
+ */
+Rarray
+real_multistep_prev_der(RealWorkspaceMS, unsigned int);
+
 /** \brief Set initial steps of multistep scheme using given RK method
  *
  * \param 1 : grid step size
@@ -74,7 +228,8 @@ free_real_multistep_wsarray(RealWorkspaceMS);
  *            The `prev_der` field is set with initial derivatives needed
  * \param 5 : array with initial condition
  * \param 6 : address of RungeKutta routine to use
- * \param 7 : (OUTPUT) concatenated initial steps required
+ * \param 7 : (OUTPUT) concatenated initial steps required. If NULL the
+ *            steps are set in the history of workspace (history mode)
  */
 void
 init_real_multistep(
@@ -96,7 +251,8 @@ init_real_multistep(
  *            The `prev_der` field is set with initial derivatives needed
  * \param 5 : array with initial condition
  * \param 6 : address of RungeKutta routine to use
- * \param 7 : (OUTPUT) concatenated initial steps required
+ * \param 7 : (OUTPUT) concatenated initial steps required. If NULL the
+ *            steps are set in the history of workspace (history mode)
  */
 void
 init_cplx_multistep(
@@ -111,16 +267,16 @@ init_cplx_multistep(
 
 /** \brief Return fresh allocated struct address with internal fields set
  *
- * \param 1 : system size
- * \param 2 : multistep order (number of previous steps required)
+ * \param 1 : multistep order (from 1 to `MULTISTEP_MAX_ORDER`)
+ * \param 2 : system size
  */
 ComplexWorkspaceMS
 get_cplx_multistep_ws(unsigned int, unsigned int);
 
 /** \brief Return fresh allocated struct address with internal fields set
  *
- * \param 1 : system size
- * \param 2 : multistep order (number of previous steps required)
+ * \param 1 : multistep order (from 1 to `MULTISTEP_MAX_ORDER`)
+ * \param 2 : system size
  */
 RealWorkspaceMS
 get_real_multistep_ws(unsigned int, unsigned int);
@@ -135,6 +291,22 @@ destroy_cplx_multistep_ws(ComplexWorkspaceMS);
 void
 destroy_real_multistep_ws(RealWorkspaceMS);
 
+/** \brief Return fresh allocated struct address in history mode
+ *
+ * \param 1 : multistep order (number of previous steps required)
+ * \param 2 : system size
+ */
+ComplexWorkspaceMS
+get_cplx_multistep_history_ws(unsigned int, unsigned int);
+
+/** \brief Return fresh allocated struct address in history mode
+ *
+ * \param 1 : multistep order (number of previous steps required)
+ * \param 2 : system size
+ */
+RealWorkspaceMS
+get_real_multistep_history_ws(unsigned int, unsigned int);
+
 /** \brief Prepare system to propagate next step of multistep method
  *
  * Since multiple steps are required and they are consumed by API as
@@ -145,13 +317,18 @@ destroy_real_multistep_ws(RealWorkspaceMS);
  * steps must be update to continue, and this routine automate these
  * operations. See `cplx_general_multistep` (specially param 6)
  *
+ * In history mode no chunk is displaced. The circular index `head` of the
+ * workspace is moved to the oldest chunk, which is overwritten with the
+ * fresh solution and its derivative
+ *
  * \param 1 : next (fresh computed system solution) grid point
  * \param 2 : routine that compute system derivative
  * \param 3 : extra arguments (void pointer of *ODEInputParameters struct)
  * \param 4 : (MODIFIED) Workspace struct address with previous derivatives
  *           used in param6 of `cplx_general_multistep` to generate param 5
  * \param 4 : (MODIFIED) Set of known previous steps used in param 6 of
- *           `cplx_general_multistep` to generate param 5
+ *           `cplx_general_multistep` to generate param 5. Ignored in
+ *           history mode
  * \param 5 : Fresh computed system solution at next grid point
  */
 void
@@ -174,13 +351,18 @@ cplx_set_next_multistep(
  * steps must be update to continue, and this routine automate these
  * operations. See `real_general_multistep` (specially param 6)
  *
+ * In history mode no chunk is displaced. The circular index `head` of the
+ * workspace is moved to the oldest chunk, which is overwritten with the
+ * fresh solution and its derivative
+ *
  * \param 1 : next (fresh computed system solution) grid point
  * \param 2 : routine that compute system derivative
  * \param 3 : extra arguments (void pointer of *ODEInputParameters struct)
  * \param 4 : (MODIFIED) Workspace struct address with previous derivatives
  *           used in param 6 of `real_general_multistep` to generate param 5
  * \param 4 : (MODIFIED) Set of known previous steps used in param 6 of
- *           `real_general_multistep` to generate param 5
+ *           `real_general_multistep` to generate param 5. Ignored in
+ *           history mode
  * \param 5 : Fresh computed system solution at next grid point
  */
 void
@@ -219,6 +401,7 @@ real_set_next_multistep(
  *            required depending on the multistep order. Within system
  *            of size `n` and multistep order `m`, the array must have
  *            size `m * n` with `[y_j y_j-1 ...  y_j+1-m]` concatenated
+ *            Ignored if workspace is in history mode
  * \param 7 : Function weights `a` as array of `m + 1` elements. It is
  *            used in left-hand-side of the method, ignoring a[0] given
  *            by `y_j+1 + a[1] * y_j + ... + a[m] * y_j+1-m`
@@ -271,6 +454,7 @@ cplx_general_multistep
  *            required depending on the multistep order. Within system
  *            of size `n` and multistep order `m`, the array must have
  *            size `m * n` with `[y_j y_j-1 ...  y_j+1-m]` concatenated
+ *            Ignored if workspace is in history mode
  * \param 7 : Function weights `a` as array of `m + 1` elements. It is
  *            used in left-hand-side of the method, ignoring a[0] given
  *            by `y_j+1 + a[1] * y_j + ... + a[m] * y_j+1-m`
@@ -314,6 +498,7 @@ real_general_multistep
  *            derivative of previous steps concatenated as
  *            `[y'_j y'_j-1 ...  y'_j-3]`
  * \param 6 : Concatenated function steps required: `[y_j y_j-1 ...  y_j-3]`
+ *            Ignored if workspace is in history mode
  * \param 7 : Number of iterations for implicit part (Moulton), if
  *            zero, perform only explicit part (Bashforth)
  * \param 8: (OUTPUT) solution at next grid step
@@ -347,6 +532,7 @@ real_adams4pc(
  *            derivative of previous steps concatenated as
  *            `[y'_j y'_j-1 ...  y'_j-3]`
  * \param 6 : Concatenated function steps required: `[y_j y_j-1 ...  y_j-3]`
+ *            Ignored if workspace is in history mode
  * \param 7 : Number of iterations for implicit part (Moulton), if
  *            zero, perform only explicit part (Bashforth)
  * \param 8: (OUTPUT) solution at next grid step
@@ -390,4 +576,138 @@ cplx_adams6pc(
 );
 
 
+/** \brief Return corrector control with working arrays allocated
+ *
+ * \param 1 : system size
+ * \param 2 : maximum number of corrector iterations (at least 1)
+ * \param 3 : absolute tolerance of the change between iterates
+ * \param 4 : relative tolerance of the change between iterates
+ */
+ComplexCorrectorControl
+get_cplx_corrector_control(int, unsigned int, double, double);
+
+
+/** \brief Return corrector control with working arrays allocated
+ *
+ * \param 1 : system size
+ * \param 2 : maximum number of corrector iterations (at least 1)
+ * \param 3 : absolute tolerance of the change between iterates
+ * \param 4 : relative tolerance of the change between iterates
+ */
+RealCorrectorControl
+get_real_corrector_control(int, unsigned int, double, double);
+
+
+/** \brief Free corrector control struct and its internal arrays */
+void
+destroy_cplx_corrector_control(ComplexCorrectorControl);
+
+
+/** \brief Free corrector control struct and its internal arrays */
+void
+destroy_real_corrector_control(RealCorrectorControl);
+
+
+/** \brief 4th order Adams PC step with convergence-controlled corrector
+ *
+ * Same as `cplx_adams4pc` but the corrector is iterated until the change
+ * between iterates is within tolerance (see `_ComplexCorrectorControl`).
+ * The Milne device provides the local error estimate of the corrector
+ * `-19 / 270 * (y_pred - y_corr)`, whose weighted norm is reported in
+ * the control struct
+ *
+ * \param 1-6 : same as `cplx_adams4pc`
+ * \param 7 : (MODIFIED) corrector control with tolerances and report of
+ *            iterations, convergence and norms of the step
+ * \param 8 : (OUTPUT) Milne estimate of local error (computed minus
+ *            exact solution). Ignored if NULL
+ * \param 9 : (OUTPUT) solution at next grid step
+ *
+ * \return 0 if the corrector converged, -1 otherwise (`ynext` has the
+ *         last iterate)
+ */
+int
+cplx_adams4pc_controlled(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceMS,
+        Carray,
+        ComplexCorrectorControl,
+        Carray,
+        Carray
+);
+
+
+/** \brief 4th order Adams PC step with convergence-controlled corrector
+ *
+ * Same as `real_adams4pc` but the corrector is iterated until the change
+ * between iterates is within tolerance (see `_RealCorrectorControl`).
+ * The Milne device provides the local error estimate of the corrector
+ * `-19 / 270 * (y_pred - y_corr)`, whose weighted norm is reported in
+ * the control struct
+ *
+ * \param 1-6 : same as `real_adams4pc`
+ * \param 7 : (MODIFIED) corrector control with tolerances and report of
+ *            iterations, convergence and norms of the step
+ * \param 8 : (OUTPUT) Milne estimate of local error (computed minus
+ *            exact solution). Ignored if NULL
+ * \param 9 : (OUTPUT) solution at next grid step
+ *
+ * \return 0 if the corrector converged, -1 otherwise (`ynext` has the
+ *         last iterate)
+ */
+int
+real_adams4pc_controlled(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceMS,
+        Rarray,
+        RealCorrectorControl,
+        Rarray,
+        Rarray
+);
+
+
+/** \brief 6th order Adams PC step with convergence-controlled corrector
+ *
+ * See `cplx_adams4pc_controlled`. The Milne estimate of the local error
+ * is `-863 / 19950 * (y_pred - y_corr)`
+ */
+int
+cplx_adams6pc_controlled(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceMS,
+        Carray,
+        ComplexCorrectorControl,
+        Carray,
+        Carray
+);
+
+
+/** \brief 6th order Adams PC step with convergence-controlled corrector
+ *
+ * See `real_adams4pc_controlled`. The Milne estimate of the local error
+ * is `-863 / 19950 * (y_pred - y_corr)`
+ */
+int
+real_adams6pc_controlled(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceMS,
+        Rarray,
+        RealCorrectorControl,
+        Rarray,
+        Rarray
+);
+
+
 #endif
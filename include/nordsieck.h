@@ -0,0 +1,285 @@
+/**
+ * \file nordsieck.h
+ * \author Alex Andriati
+ * \brief Variable step and variable order Adams methods
+ *
+ * The history of the solution is kept in the Nordsieck form, that is,
+ * the array `z_j = h^j * y^(j) / j!` for `j = 0, ..., q` with `q` the
+ * current order, instead of derivatives at equally spaced points. Thus
+ * a change of step size by the ratio `r` is a rescaling `z_j -> r^j z_j`
+ * and the order is changed by adding or dropping the last column.
+ *
+ * Each step is the predictor (Pascal triangle applied to `z`) followed
+ * by the Adams-Moulton corrector solved by functional iteration. The
+ * step size and the order from 1 to `NORDSIECK_MAX_ORDER` are selected
+ * from the local error estimates of the current and neighbour orders as
+ * in the Adams mode of LSODE (ref. [1] and [2] sec. III.7)
+ *
+ * [1] A.C. Hindmarsh, ODEPACK, A Systematized Collection of ODE Solvers,
+ * IMACS Transactions on Scientific Computation, vol. 1, 1983
+ * [2] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ */
+
+#ifndef ODE_NORDSIECK_H
+#define ODE_NORDSIECK_H
+
+#include "derivative_signature.h"
+
+/** \brief Maximum order of variable order Adams methods */
+#define NORDSIECK_MAX_ORDER 12
+
+/** \brief Struct to provide complex workspace for Nordsieck Adams methods
+ *
+ * Hold the Nordsieck array with `max_order + 1` chunks of `system_size`
+ * scaled with step size `h` at the grid point `x`, tolerances, step size
+ * bounds, method coefficients and statistics. The local error of every
+ * step must have weighted RMS norm, with weights `abs_tol + rel_tol *
+ * |y|` from the modulus of complex values, smaller than one. The last
+ * chunk of `z` holds the correction of the previous step, used to
+ * estimate the error of a higher order, when the current order is
+ * smaller than the maximum
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        max_order,      /// largest order allowed (1 to 12)
+        order,          /// current order `q`
+        started,        /// nonzero after `z` is set from the solution
+        wait;           /// steps before next step size/order change
+    double
+        x,              /// grid point of Nordsieck array
+        h,              /// step size in which `z` is scaled
+        abs_tol,        /// absolute tolerance of local error
+        rel_tol,        /// relative tolerance of local error
+        h_min,          /// smallest step size accepted
+        h_max,          /// largest step size allowed (zero for no limit)
+        rmax,           /// largest ratio of next step size change
+        conv_rate;      /// convergence rate estimate of corrector
+    unsigned int
+        accepted,       /// number of accepted steps
+        rejected,       /// number of steps rejected by error test
+        conv_failures,  /// number of steps failed in corrector iteration
+        rhs_evals;      /// number of derivative evaluations
+    double
+        el[NORDSIECK_MAX_ORDER + 1][NORDSIECK_MAX_ORDER + 1],
+        tesco[NORDSIECK_MAX_ORDER + 1][3];
+    Rarray
+        ewt;            /// error weights
+    Carray
+        z,              /// Nordsieck array `[z_0 z_1 ... z_max_order]`
+        acor,           /// accumulated correction of the step
+        savf,           /// scaled derivative of corrector iterates
+        ywork;          /// corrector iterate
+} _ComplexWorkspaceNordsieck;
+
+/** \brief Struct address with working arrays for Nordsieck methods */
+typedef _ComplexWorkspaceNordsieck * ComplexWorkspaceNordsieck;
+
+/** \brief Struct to provide real workspace for Nordsieck Adams methods
+ *
+ * Hold the Nordsieck array with `max_order + 1` chunks of `system_size`
+ * scaled with step size `h` at the grid point `x`, tolerances, step size
+ * bounds, method coefficients and statistics. The local error of every
+ * step must have weighted RMS norm, with weights `abs_tol + rel_tol *
+ * |y|`, smaller than one. The last chunk of `z` holds the correction of
+ * the previous step, used to estimate the error of a higher order, when
+ * the current order is smaller than the maximum
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        max_order,      /// largest order allowed (1 to 12)
+        order,          /// current order `q`
+        started,        /// nonzero after `z` is set from the solution
+        wait;           /// steps before next step size/order change
+    double
+        x,              /// grid point of Nordsieck array
+        h,              /// step size in which `z` is scaled
+        abs_tol,        /// absolute tolerance of local error
+        rel_tol,        /// relative tolerance of local error
+        h_min,          /// smallest step size accepted
+        h_max,          /// largest step size allowed (zero for no limit)
+        rmax,           /// largest ratio of next step size change
+        conv_rate;      /// convergence rate estimate of corrector
+    unsigned int
+        accepted,       /// number of accepted steps
+        rejected,       /// number of steps rejected by error test
+        conv_failures,  /// number of steps failed in corrector iteration
+        rhs_evals;      /// number of derivative evaluations
+    double
+        el[NORDSIECK_MAX_ORDER + 1][NORDSIECK_MAX_ORDER + 1],
+        tesco[NORDSIECK_MAX_ORDER + 1][3];
+    Rarray
+        z,              /// Nordsieck array `[z_0 z_1 ... z_max_order]`
+        acor,           /// accumulated correction of the step
+        savf,           /// scaled derivative of corrector iterates
+        ewt,            /// error weights
+        ywork;          /// corrector iterate
+} _RealWorkspaceNordsieck;
+
+/** \brief Struct address with working arrays for Nordsieck methods */
+typedef _RealWorkspaceNordsieck * RealWorkspaceNordsieck;
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : maximum order (from 1 to `NORDSIECK_MAX_ORDER`, clamped)
+ * \param 2 : system size
+ * \param 3 : absolute tolerance
+ * \param 4 : relative tolerance
+ */
+ComplexWorkspaceNordsieck
+get_cplx_nordsieck_ws(int, int, double, double);
+
+
+/** \brief Return fresh allocated struct address with internal fields set
+ *
+ * \param 1 : maximum order (from 1 to `NORDSIECK_MAX_ORDER`, clamped)
+ * \param 2 : system size
+ * \param 3 : absolute tolerance
+ * \param 4 : relative tolerance
+ */
+RealWorkspaceNordsieck
+get_real_nordsieck_ws(int, int, double, double);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_nordsieck_ws(ComplexWorkspaceNordsieck);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_nordsieck_ws(RealWorkspaceNordsieck);
+
+
+/** \brief Discard Nordsieck array to restart integration in next step */
+void
+reset_cplx_nordsieck_ws(ComplexWorkspaceNordsieck);
+
+
+/** \brief Discard Nordsieck array to restart integration in next step */
+void
+reset_real_nordsieck_ws(RealWorkspaceNordsieck);
+
+
+/** \brief Change step size of Nordsieck array, with `O(order * n)` cost
+ *
+ * \param 1 : (MODIFIED) workspace with Nordsieck array set
+ * \param 2 : new step size
+ */
+void
+cplx_nordsieck_rescale(ComplexWorkspaceNordsieck, double);
+
+
+/** \brief Change step size of Nordsieck array, with `O(order * n)` cost
+ *
+ * \param 1 : (MODIFIED) workspace with Nordsieck array set
+ * \param 2 : new step size
+ */
+void
+real_nordsieck_rescale(RealWorkspaceNordsieck, double);
+
+
+/** \brief Interpolate solution from Nordsieck array
+ *
+ * \param 1 : workspace with Nordsieck array set
+ * \param 2 : grid point, preferably within the last step taken
+ * \param 3 : (OUTPUT) solution at grid point of param 2
+ */
+void
+cplx_nordsieck_interpolate(ComplexWorkspaceNordsieck, double, Carray);
+
+
+/** \brief Interpolate solution from Nordsieck array
+ *
+ * \param 1 : workspace with Nordsieck array set
+ * \param 2 : grid point, preferably within the last step taken
+ * \param 3 : (OUTPUT) solution at grid point of param 2
+ */
+void
+real_nordsieck_interpolate(RealWorkspaceNordsieck, double, Rarray);
+
+
+/**
+ * \brief Advance one accepted step with step size and order control
+ *
+ * In the first call (or after `reset_cplx_nordsieck_ws`) the Nordsieck
+ * array is set with order 1 from the given solution. Steps rejected by
+ * the error test or by divergence of the corrector are retried with
+ * reduced size, and after three consecutive error test failures the
+ * method restarts with order 1. The step never goes beyond `xend`, in
+ * which case it is reduced by a rescaling of the history. For dense
+ * output use a far `xend` and `cplx_nordsieck_interpolate`
+ *
+ * \param 1 : final grid point where the step is truncated
+ * \param 2 : function pointing to routine that compute derivatives
+ * \param 3 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 4 : (MODIFIED) Workspace struct address with step control setup
+ * \param 5 : (MODIFIED) current grid point, advanced by the accepted step
+ * \param 6 : (MODIFIED) step size to try, replaced by proposal for next
+ *            step. If zero in the first call an initial step size is
+ *            estimated. If changed by the client between calls the
+ *            history is rescaled
+ * \param 7 : (MODIFIED) function values at `x` replaced by the new ones.
+ *            Only read in the first call, afterwards the solution is
+ *            taken from the Nordsieck array
+ *
+ * \return 0 if a step was accepted and -1 if the step size fell below
+ *         the `h_min` workspace field or the step failed repeatedly
+ *         (no change in params 5 and 7)
+ */
+int
+cplx_nordsieck_step(
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceNordsieck,
+        double *,
+        double *,
+        Carray
+);
+
+
+/**
+ * \brief Advance one accepted step with step size and order control
+ *
+ * In the first call (or after `reset_real_nordsieck_ws`) the Nordsieck
+ * array is set with order 1 from the given solution. Steps rejected by
+ * the error test or by divergence of the corrector are retried with
+ * reduced size, and after three consecutive error test failures the
+ * method restarts with order 1. The step never goes beyond `xend`, in
+ * which case it is reduced by a rescaling of the history. For dense
+ * output use a far `xend` and `real_nordsieck_interpolate`
+ *
+ * \param 1 : final grid point where the step is truncated
+ * \param 2 : function pointing to routine that compute derivatives
+ * \param 3 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 4 : (MODIFIED) Workspace struct address with step control setup
+ * \param 5 : (MODIFIED) current grid point, advanced by the accepted step
+ * \param 6 : (MODIFIED) step size to try, replaced by proposal for next
+ *            step. If zero in the first call an initial step size is
+ *            estimated. If changed by the client between calls the
+ *            history is rescaled
+ * \param 7 : (MODIFIED) function values at `x` replaced by the new ones.
+ *            Only read in the first call, afterwards the solution is
+ *            taken from the Nordsieck array
+ *
+ * \return 0 if a step was accepted and -1 if the step size fell below
+ *         the `h_min` workspace field or the step failed repeatedly
+ *         (no change in params 5 and 7)
+ */
+int
+real_nordsieck_step(
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceNordsieck,
+        double *,
+        double *,
+        Rarray
+);
+
+
+#endif
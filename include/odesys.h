@@ -15,5 +15,19 @@
 #include "derivative_signature.h"
 #include "singlestep.h"
 #include "multistep.h"
+#include "adaptive.h"
+#include "ensemble.h"
+#include "bdf.h"
+#include "integrate.h"
+#include "nordsieck.h"
+#include "smallsys.h"
+#include "tableau.h"
+#include "lowstorage.h"
+#include "secondorder.h"
+#include "exponential.h"
+#include "dense.h"
+#include "checkpoint.h"
+#include "trajectory.h"
+#include "stats.h"
 
 #endif
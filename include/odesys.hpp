@@ -0,0 +1,356 @@
+/**
+ * \file odesys.hpp
+ * \author Alex Andriati
+ * \brief Header-only C++ front end with inlined right-hand sides
+ *
+ * The C routines call the derivatives through a function pointer which
+ * receives a `_*ODEInputParameters` struct, thus the compiler cannot
+ * inline small systems in the stage loops. The templates here take the
+ * derivative as any callable type, with signature
+ *
+ *     void f(double x, const std::array<T, N> & y, std::array<T, N> & dy)
+ *
+ * where extra arguments are captured by the callable (lambda, functor),
+ * the scalar type `T` is `double` or `std::complex<double>` and the
+ * system size `N` is a compile-time constant. The states are held in
+ * `std::array`, thus no heap memory is used and small systems are kept
+ * in registers.
+ *
+ * The stage combinations do the very same floating point operations in
+ * the same order of the C routines, thus the results are bit-identical
+ * to `*_rungekutta2/4/5` and `*_adams4pc/6pc` (with the multistep start
+ * of `*_integrate`) as long as floating point contraction is disabled
+ * (`-ffp-contract=off`) as it is in the library kernels.
+ *
+ * This file is not part of the C library and shall only be included in
+ * C++ sources (C++11 or later)
+ */
+
+#ifndef ODESYS_HPP
+#define ODESYS_HPP
+
+#include <array>
+#include <cstddef>
+#include <complex>
+
+namespace odesys
+{
+
+/** \brief State of ODE system with `N` equations */
+template <typename T, std::size_t N>
+using State = std::array<T, N>;
+
+
+/**
+ * \brief 2nd order Runge-Kutta step, same as `*_rungekutta2`
+ *
+ * \param h : grid spacing
+ * \param x : current grid point
+ * \param f : callable computing derivatives `f(x, y, dy)`
+ * \param y : function values at `x`
+ * \param ynext : (OUTPUT) function values at `x + h`. May be `y`
+ */
+template <typename T, std::size_t N, typename F>
+inline void
+rungekutta2(double h, double x, F && f, const State<T, N> & y,
+            State<T, N> & ynext)
+{
+    State<T, N>
+        k1,
+        k2,
+        karg;
+
+    f(x, y, k1);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h * (1.0 * k1[i]);
+    f(x + h, karg, k2);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        ynext[i] = y[i] + h * (0.5 * k1[i] + 0.5 * k2[i]);
+    }
+}
+
+
+/**
+ * \brief 4th order Runge-Kutta step, same as `*_rungekutta4`
+ *
+ * See `rungekutta2` for parameters
+ */
+template <typename T, std::size_t N, typename F>
+inline void
+rungekutta4(double h, double x, F && f, const State<T, N> & y,
+            State<T, N> & ynext)
+{
+    State<T, N>
+        k1,
+        k2,
+        k3,
+        k4,
+        karg;
+
+    f(x, y, k1);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h * (0.5 * k1[i]);
+    f(x + 0.5 * h, karg, k2);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h * (0.5 * k2[i]);
+    f(x + 0.5 * h, karg, k3);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h * (1.0 * k3[i]);
+    f(x + h, karg, k4);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        ynext[i] = y[i] + h / 6 * (
+                1.0 * k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + 1.0 * k4[i]
+        );
+    }
+}
+
+
+/**
+ * \brief 5th order Runge-Kutta step, same as `*_rungekutta5`
+ *
+ * See `rungekutta2` for parameters
+ */
+template <typename T, std::size_t N, typename F>
+inline void
+rungekutta5(double h, double x, F && f, const State<T, N> & y,
+            State<T, N> & ynext)
+{
+    State<T, N>
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        karg;
+
+    /* Butcher table 236a p.103 as in singlestep.c */
+    f(x, y, k1);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h / 4 * (1.0 * k1[i]);
+    f(x + 0.25 * h, karg, k2);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        karg[i] = y[i] + h / 8 * (1.0 * k1[i] + 1.0 * k2[i]);
+    }
+    f(x + 0.25 * h, karg, k3);
+    for (std::size_t i = 0; i < N; i++) karg[i] = y[i] + h / 2 * (1.0 * k3[i]);
+    f(x + 0.5 * h, karg, k4);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        karg[i] = y[i] + h / 16 * (
+                3.0 * k1[i] + (- 6.0) * k2[i] + 6.0 * k3[i] + 9.0 * k4[i]
+        );
+    }
+    f(x + 0.75 * h, karg, k5);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        karg[i] = y[i] + h / 7 * (
+                (- 3.0) * k1[i] + 8.0 * k2[i] + 6.0 * k3[i]
+                + (- 12.0) * k4[i] + 8.0 * k5[i]
+        );
+    }
+    f(x + h, karg, k6);
+    for (std::size_t i = 0; i < N; i++)
+    {
+        ynext[i] = y[i] + h / 90 * (
+                7.0 * k1[i] + 32.0 * k3[i] + 12.0 * k4[i]
+                + 32.0 * k5[i] + 7.0 * k6[i]
+        );
+    }
+}
+
+
+/**
+ * \brief Adams predictor-corrector of order 4 or 6 in history mode
+ *
+ * Hold the previous steps and their derivatives in circular buffers as
+ * the multistep workspace in history mode, where the j-th previous step
+ * is `prev_step(j)`. The usage follows the C routines: `init` set the
+ * first `Order` steps with Runge-Kutta (order 4 for Adams 4 and order 5
+ * for Adams 6), and then each `step` is followed by `set_next`
+ *
+ * \tparam T : scalar type (`double` or `std::complex<double>`)
+ * \tparam N : system size
+ * \tparam Order : number of previous steps, 4 or 6
+ */
+template <typename T, std::size_t N, int Order>
+class AdamsPC
+{
+    static_assert(Order == 4 || Order == 6, "Adams PC of order 4 or 6");
+
+public:
+
+    /** \brief Set initial steps as `init_*_multistep` in `*_integrate`
+     *
+     * The grid points of the startup are `x0 + i * h` computed as in
+     * `*_integrate`, thus with derivatives evaluated at the same points
+     *
+     * \param h : grid spacing
+     * \param x0 : initial grid point
+     * \param f : callable computing derivatives `f(x, y, dy)`
+     * \param y0 : initial condition
+     */
+    template <typename F>
+    void
+    init(double h, double x0, F && f, const State<T, N> & y0)
+    {
+        double
+            x;
+        auto
+            shifted = [&f, x0](double xs, const State<T, N> & y,
+                               State<T, N> & dy) { f(xs + x0, y, dy); };
+
+        head_ = 0;
+        yhist_[Order - 1] = y0;
+        x = 0;
+        shifted(x, yhist_[Order - 1], der_[Order - 1]);
+        for (int i = 1; i < Order; i++)
+        {
+            if (Order == 4)
+            {
+                rungekutta4<T, N>(h, x, shifted, yhist_[Order - i],
+                                  yhist_[Order - 1 - i]);
+            }
+            else
+            {
+                rungekutta5<T, N>(h, x, shifted, yhist_[Order - i],
+                                  yhist_[Order - 1 - i]);
+            }
+            x = i * h;
+            shifted(x, yhist_[Order - 1 - i], der_[Order - 1 - i]);
+        }
+    }
+
+    /** \brief Propagate one step, same as `*_adams4pc` and `*_adams6pc`
+     *
+     * \param h : grid spacing
+     * \param x : grid point of the most recent step
+     * \param f : callable computing derivatives `f(x, y, dy)`
+     * \param iter : number of corrector iterations
+     * \param ynext : (OUTPUT) function values at `x + h`
+     */
+    template <typename F>
+    void
+    step(double h, double x, F && f, unsigned int iter, State<T, N> & ynext)
+    {
+        combine(h, pred_coef(), 0, ynext);
+        while (iter > 0)
+        {
+            f(x + h, ynext, der_[Order]);
+            combine(h, corr_coef(), 1, ynext);
+            iter--;
+        }
+    }
+
+    /** \brief Append new step to history, same as `*_set_next_multistep`
+     *
+     * \param xnext : grid point of new step
+     * \param f : callable computing derivatives `f(x, y, dy)`
+     * \param ynext : function values at `xnext`
+     */
+    template <typename F>
+    void
+    set_next(double xnext, F && f, const State<T, N> & ynext)
+    {
+        head_ = (head_ + Order - 1) % Order;
+        yhist_[head_] = ynext;
+        f(xnext, yhist_[head_], der_[head_]);
+    }
+
+    /** \brief The j-th previous step, with j = 0 the most recent */
+    const State<T, N> &
+    prev_step(int j) const
+    {
+        return yhist_[(head_ + j) % Order];
+    }
+
+private:
+
+    int
+        head_ = 0;
+    std::array<State<T, N>, Order>
+        yhist_;
+    std::array<State<T, N>, Order + 1>
+        der_;
+
+    static const double *
+    pred_coef()
+    {
+        static const double
+            b4[5] = {0.0, 55.0 / 24, -59.0 / 24, 37.0 / 24, -9.0 / 24},
+            b6[7] = {0.0, 4277.0 / 1440, -7923.0 / 1440, 9982.0 / 1440,
+                     -7298.0 / 1440, 2877.0 / 1440, -475.0 / 1440};
+        return Order == 4 ? b4 : b6;
+    }
+
+    static const double *
+    corr_coef()
+    {
+        static const double
+            b4[5] = {9.0 / 24, 19.0 / 24, -5.0 / 24, 1.0 / 24, 0.0},
+            b6[7] = {475.0 / 1440, 1427.0 / 1440, -798.0 / 1440,
+                     482.0 / 1440, -173.0 / 1440, 27.0 / 1440, 0.0};
+        return Order == 4 ? b4 : b6;
+    }
+
+    /** \brief Terms of `*_general_multistep` with `a = {1, -1, 0, ...}`
+     *
+     * The weights and arrays are taken in the same order of the C code,
+     * skipping zero coefficients, with the implicit derivative first if
+     * `implicit` is nonzero. At most 8 terms, thus a single kernel pass
+     */
+    void
+    combine(double h, const double * b, int implicit, State<T, N> & ynext)
+    {
+        int
+            n;
+        double
+            w[2 * Order + 1];
+        const State<T, N>
+            * v[2 * Order + 1];
+
+        n = 0;
+        if (implicit)
+        {
+            w[n] = h * b[0];
+            v[n] = &der_[Order];
+            n++;
+        }
+        for (int j = 1; j <= Order; j++)
+        {
+            int
+                chunk = (head_ + j - 1) % Order;
+            if (b[j] != 0)
+            {
+                w[n] = h * b[j];
+                v[n] = &der_[chunk];
+                n++;
+            }
+            if (j == 1)
+            {
+                w[n] = 1.0;
+                v[n] = &yhist_[chunk];
+                n++;
+            }
+        }
+        for (std::size_t i = 0; i < N; i++)
+        {
+            T
+                acc = w[0] * (*v[0])[i];
+            for (int k = 1; k < n; k++) acc = acc + w[k] * (*v[k])[i];
+            ynext[i] = 1.0 * acc;
+        }
+    }
+};
+
+
+/** \brief Adams-Bashforth-Moulton predictor-corrector of order 4 */
+template <typename T, std::size_t N>
+using Adams4PC = AdamsPC<T, N, 4>;
+
+/** \brief Adams-Bashforth-Moulton predictor-corrector of order 6 */
+template <typename T, std::size_t N>
+using Adams6PC = AdamsPC<T, N, 6>;
+
+
+} // namespace odesys
+
+#endif
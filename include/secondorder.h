@@ -0,0 +1,256 @@
+/**
+ * \file secondorder.h
+ * \author Alex Andriati
+ * \brief Integration routines for second order systems y'' = f(x, y)
+ *
+ * Second order systems are usually doubled to first order, which also
+ * doubles the work arrays of Runge-Kutta methods. The routines here
+ * keep positions `q` and velocities `v` (both with `system_size`
+ * elements) and only evaluate the second derivatives with signature
+ * `real_odesys_der2`. Two families are provided:
+ *
+ * Symplectic compositions of velocity Verlet steps, which preserve the
+ * phase space volume and keep the energy error of Hamiltonian systems
+ * bounded for very long times with fixed step size
+ *
+ * Runge-Kutta-Nystrom (RKN) methods, which need fewer stages than
+ * Runge-Kutta methods of the same order, including an embedded pair
+ * for adaptive step size
+ */
+
+#ifndef ODE_SECONDORDER_H
+#define ODE_SECONDORDER_H
+
+#include "derivative_signature.h"
+
+/** \brief Symmetric composition of velocity Verlet steps
+ *
+ * A step of size `h` is done with Verlet steps of sizes `h * w[i]`,
+ * merging consecutive half kicks of velocity, thus with `nsteps`
+ * evaluations of second derivatives per step
+ */
+typedef struct{
+    const char
+        * name;         /// method name for output purposes
+    int
+        nsteps,         /// number of Verlet steps in composition
+        order;          /// order of the method
+    const double
+        * w;            /// fractions of the step (sum to one)
+} SymplecticComposition;
+
+/*
+ * Library of compositions. Refs. are listed in secondorder.c
+ *
+ * `COMPOSITION_VELOCITY_VERLET`    2nd order, 1 evaluation
+ * `COMPOSITION_FOREST_RUTH_4`      4th order, 3 evaluations, ref. [1]
+ *                                  (the triple jump of ref. [2])
+ * `COMPOSITION_YOSHIDA_6`          6th order, 7 evaluations, ref. [2]
+ *                                  (solution A)
+ */
+extern const SymplecticComposition COMPOSITION_VELOCITY_VERLET;
+extern const SymplecticComposition COMPOSITION_FOREST_RUTH_4;
+extern const SymplecticComposition COMPOSITION_YOSHIDA_6;
+
+/** \brief Struct to provide workspace of symplectic compositions
+ *
+ * The acceleration at the end of a step is the one at the beginning of
+ * the next. If the client modifies the positions between steps, then
+ * `acc_ready` must be set to zero
+ */
+typedef struct{
+    int
+        system_size,    /// number of positions
+        acc_ready;      /// nonzero if `acc` holds accelerations at `x`
+    Rarray
+        acc;            /// accelerations at current positions
+} _RealWorkspaceSymplectic;
+
+/** \brief Workspace struct address of symplectic compositions */
+typedef _RealWorkspaceSymplectic * RealWorkspaceSymplectic;
+
+/** \brief Struct to provide workspace of Runge-Kutta-Nystrom methods
+ *
+ * Hold the stages, tolerances, step size bounds and counters of the
+ * adaptive driver. If the client modifies the solution between driver
+ * calls `k1_ready` must be set to zero to discard derivative reuse
+ */
+typedef struct{
+    int
+        system_size,    /// number of positions
+        k1_ready;       /// nonzero if `k1` has second derivative at `x`
+    double
+        abs_tol,        /// absolute tolerance of local error
+        rel_tol,        /// relative tolerance of local error
+        h_min,          /// smallest step size accepted
+        h_max;          /// largest step size allowed (zero for no limit)
+    unsigned int
+        accepted,       /// number of accepted steps
+        rejected;       /// number of rejected steps
+    Rarray
+        k1,             /// second derivatives of stages
+        k2,
+        k3,
+        k4,
+        qarg,           /// positions of stage evaluation
+        qnext,          /// trial positions
+        vnext,          /// trial velocities
+        qerr,           /// local error estimate of trial positions
+        verr;           /// local error estimate of trial velocities
+} _RealWorkspaceRKN;
+
+/** \brief Workspace struct address of Runge-Kutta-Nystrom methods */
+typedef _RealWorkspaceRKN * RealWorkspaceRKN;
+
+
+/** \brief Return fresh allocated workspace of symplectic compositions */
+RealWorkspaceSymplectic
+get_real_symplectic_ws(int sys_size);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_symplectic_ws(RealWorkspaceSymplectic);
+
+
+/** \brief Return fresh allocated workspace of Runge-Kutta-Nystrom methods
+ *
+ * \param 1 : system size (number of positions)
+ * \param 2 : absolute tolerance of local error (adaptive driver only)
+ * \param 3 : relative tolerance of local error (adaptive driver only)
+ */
+RealWorkspaceRKN
+get_real_rkn_ws(int sys_size, double abs_tol, double rel_tol);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_rkn_ws(RealWorkspaceRKN);
+
+
+/**
+ * \brief Symplectic step as composition of velocity Verlet steps
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute second derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : (MODIFIED) workspace with accelerations reused between steps
+ * \param 6 : composition coefficients
+ * \param 7 : (MODIFIED) positions at `x` replaced by the ones at `x + h`
+ * \param 8 : (MODIFIED) velocities at `x` replaced by the ones at `x + h`
+ */
+void
+real_symplectic_step(
+        double,
+        double,
+        real_odesys_der2,
+        void *,
+        RealWorkspaceSymplectic,
+        const SymplecticComposition *,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief 4th order Runge-Kutta-Nystrom step with 3 stages
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute second derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : positions at current grid point
+ * \param 7 : velocities at current grid point
+ * \param 8 : (OUTPUT) positions at `x + h`. May be param 6
+ * \param 9 : (OUTPUT) velocities at `x + h`. May be param 7
+ */
+void
+real_nystrom4(
+        double,
+        double,
+        real_odesys_der2,
+        void *,
+        RealWorkspaceRKN,
+        Rarray,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Runge-Kutta-Nystrom 4(3) embedded pair step
+ *
+ * Propagate the solution of `real_nystrom4` and estimate its error with
+ * an embedded 3rd order solution. The last stage is the derivative at
+ * the new point, left in `k4`, which can be used as first stage of the
+ * next step (FSAL) by swapping `k1` and `k4`
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute second derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address for internal derivative computation
+ * \param 6 : If nonzero, `k1` already holds second derivative at `x`
+ * \param 7 : positions at current grid point
+ * \param 8 : velocities at current grid point
+ * \param 9 : (OUTPUT) positions at `x + h`
+ * \param 10 : (OUTPUT) velocities at `x + h`
+ * \param 11 : (OUTPUT) local error estimate of param 9
+ * \param 12 : (OUTPUT) local error estimate of param 10
+ */
+void
+real_nystrom43(
+        double,
+        double,
+        real_odesys_der2,
+        void *,
+        RealWorkspaceRKN,
+        int,
+        Rarray,
+        Rarray,
+        Rarray,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+/**
+ * \brief Advance one accepted step of Runge-Kutta-Nystrom 4(3) pair
+ *
+ * Same strategy of `real_adaptive_step` with the weighted RMS norm of
+ * the errors of positions and velocities together. As there, only
+ * forward integration is supported and the truncation at `xend` does
+ * not reduce the proposal for the next step
+ *
+ * \param 1 : final grid point where the step is truncated
+ * \param 2 : function pointing to routine that compute second derivatives
+ * \param 3 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 4 : (MODIFIED) Workspace struct address with step control setup
+ * \param 5 : (MODIFIED) current grid point, advanced by the accepted step
+ * \param 6 : (MODIFIED) step size to try, replaced by proposal for next
+ *            step. If not positive on input, an initial step size is
+ *            estimated
+ * \param 7 : (MODIFIED) positions at `x` replaced by the new ones
+ * \param 8 : (MODIFIED) velocities at `x` replaced by the new ones
+ *
+ * \return 0 if a step was accepted and -1 if the step size fell below
+ *         the `h_min` workspace field (no change in params 5, 7 and 8)
+ */
+int
+real_nystrom_adaptive_step(
+        double,
+        real_odesys_der2,
+        void *,
+        RealWorkspaceRKN,
+        double *,
+        double *,
+        Rarray,
+        Rarray
+);
+
+
+#endif
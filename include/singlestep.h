@@ -7,21 +7,45 @@
  * previous adjacent step are named single step methods. Moreover, a
  * subclass of these methods are the explicit single step methods, a.k.a
  * Runge-Kutta methods, which are treated in this file
+ *
+ * The first derivative evaluation of each step receives the input array
+ * `y` itself (no copy is made), thus the derivative routine must not
+ * modify the function values given in `_*ODEInputParameters`
  */
 
 #ifndef ODE_SINGLESTEP_H
 #define ODE_SINGLESTEP_H
 
 #include "derivative_signature.h"
+#include "stats.h"
+
+/** \brief Number of work arrays used by each Runge-Kutta method */
+#define RK2_WS_STAGES 3
+#define RK4_WS_STAGES 5
+#define RK5_WS_STAGES 7
+
+/** \brief Alignment in bytes of workspace arena and of each work array */
+#define RK_WS_ALIGNMENT 64
 
 /** \brief Struct to provide workspace for single step methods
  *
  * The arrays inside this structure hold intermediate steps in
- * Runge-Kutta methods which require derivative evaluations
+ * Runge-Kutta methods which require derivative evaluations. They are
+ * placed in a single aligned block (arena) and only the first `nstages`
+ * are set, the remaining ones are NULL. A method requiring more arrays
+ * than available (see `RK*_WS_STAGES`) must not be used. The number of
+ * threads is one and no stats are attached when the arrays are set, see
+ * `set_*_rungekutta_threads`
  */
 typedef struct{
     int
-        system_size;
+        system_size,
+        nstages,        /// number of work arrays set in the arena
+        nthreads;       /// threads of stage combinations (OpenMP build)
+    void
+        * arena;        /// block owned by workspace (NULL if caller memory)
+    IntegratorStats
+        stats;          /// counters and timers (NULL if none, see stats.h)
     Carray
         work1,
         work2,
@@ -38,10 +62,22 @@ typedef _ComplexWorkspaceRK * ComplexWorkspaceRK;
 /** \brief Struct to provide workspace for single step methods
  *
  * The arrays inside this structure hold intermediate steps in
- * Runge-Kutta methods which require derivative evaluations
+ * Runge-Kutta methods which require derivative evaluations. They are
+ * placed in a single aligned block (arena) and only the first `nstages`
+ * are set, the remaining ones are NULL. A method requiring more arrays
+ * than available (see `RK*_WS_STAGES`) must not be used. The number of
+ * threads is one and no stats are attached when the arrays are set, see
+ * `set_*_rungekutta_threads`
  */
 typedef struct{
-    int system_size;
+    int
+        system_size,
+        nstages,        /// number of work arrays set in the arena
+        nthreads;       /// threads of stage combinations (OpenMP build)
+    void
+        * arena;        /// block owned by workspace (NULL if caller memory)
+    IntegratorStats
+        stats;          /// counters and timers (NULL if none, see stats.h)
     Rarray
         work1,
         work2,
@@ -76,26 +112,93 @@ typedef void (*cplx_rk_routine)(
 );
 
 
-/** \brief Alloc internal arrays in struct address given */
+/** \brief Size in bytes of workspace arena
+ *
+ * Work arrays are aligned to `RK_WS_ALIGNMENT` and padded such that
+ * the same index in different arrays do not share the lowest 12 bits
+ * of the address (4K aliasing between loads and stores)
+ *
+ * \param 1 : system size
+ * \param 2 : number of work arrays (see `RK*_WS_STAGES`)
+ */
+unsigned long
+cplx_rungekutta_ws_bytes(int sys_size, int nstages);
+
+
+/** \brief Size in bytes of workspace arena (see complex version) */
+unsigned long
+real_rungekutta_ws_bytes(int sys_size, int nstages);
+
+
+/** \brief Set internal arrays of struct address given in a single block
+ *
+ * \param 1 : (MODIFIED) workspace with `system_size` field set
+ * \param 2 : number of work arrays (see `RK*_WS_STAGES`)
+ * \param 3 : memory with at least `cplx_rungekutta_ws_bytes` bytes and
+ *            aligned to `RK_WS_ALIGNMENT`, e.g. huge pages or NUMA local
+ *            memory, which the caller must release after freeing the
+ *            workspace. If NULL, a block owned by the workspace is
+ *            allocated
+ */
+void
+set_cplx_rungekutta_wsarrays(ComplexWorkspaceRK, int, void *);
+
+
+/** \brief Set internal arrays of struct address given in a single block
+ *
+ * \param 1 : (MODIFIED) workspace with `system_size` field set
+ * \param 2 : number of work arrays (see `RK*_WS_STAGES`)
+ * \param 3 : memory with at least `real_rungekutta_ws_bytes` bytes and
+ *            aligned to `RK_WS_ALIGNMENT`, e.g. huge pages or NUMA local
+ *            memory, which the caller must release after freeing the
+ *            workspace. If NULL, a block owned by the workspace is
+ *            allocated
+ */
+void
+set_real_rungekutta_wsarrays(RealWorkspaceRK, int, void *);
+
+
+/** \brief Alloc internal arrays in struct address given (all methods) */
 void
 alloc_cplx_rungekutta_wsarrays(ComplexWorkspaceRK);
 
 
-/** \brief Alloc internal arrays in struct address given */
+/** \brief Alloc internal arrays in struct address given (all methods) */
 void
 alloc_real_rungekutta_wsarrays(RealWorkspaceRK);
 
 
-/** \brief Free internal pointers of struct given */
+/** \brief Free internal block of struct given if owned by it */
 void
 free_cplx_rungekutta_wsarrays(ComplexWorkspaceRK);
 
 
-/** \brief Free internal pointers of struct given */
+/** \brief Free internal block of struct given if owned by it */
 void
 free_real_rungekutta_wsarrays(RealWorkspaceRK);
 
 
+/** \brief Set number of threads of the stage combinations
+ *
+ * Only effective if the library is built with `ODESYS_OPENMP`, and for
+ * large systems, as the arrays are split in chunks of thousands of
+ * elements. The work arrays are set to zero using the same partition
+ * among threads (first touch), thus to have the memory pages placed in
+ * the NUMA node of the thread processing them, this routine must be
+ * called right after the arrays are set and before any step
+ *
+ * \param 1 : (MODIFIED) workspace with arrays set
+ * \param 2 : number of threads (one for serial execution)
+ */
+void
+set_cplx_rungekutta_threads(ComplexWorkspaceRK, int);
+
+
+/** \brief Set number of threads of the stage combinations (see complex) */
+void
+set_real_rungekutta_threads(RealWorkspaceRK, int);
+
+
 /** \brief Return fresh allocated struct address with internal fields set */
 ComplexWorkspaceRK
 get_cplx_rungekutta_ws(int sys_size);
@@ -106,6 +209,26 @@ RealWorkspaceRK
 get_real_rungekutta_ws(int sys_size);
 
 
+/** \brief Return workspace with given number of arrays in single block
+ *
+ * \param 1 : system size
+ * \param 2 : number of work arrays (see `RK*_WS_STAGES`)
+ * \param 3 : caller memory or NULL (see `set_cplx_rungekutta_wsarrays`)
+ */
+ComplexWorkspaceRK
+get_cplx_rungekutta_ws_arena(int sys_size, int nstages, void * mem);
+
+
+/** \brief Return workspace with given number of arrays in single block
+ *
+ * \param 1 : system size
+ * \param 2 : number of work arrays (see `RK*_WS_STAGES`)
+ * \param 3 : caller memory or NULL (see `set_real_rungekutta_wsarrays`)
+ */
+RealWorkspaceRK
+get_real_rungekutta_ws_arena(int sys_size, int nstages, void * mem);
+
+
 /** \brief Free allocated workspace struct and its internal arrays */
 void
 destroy_real_rungekutta_ws(RealWorkspaceRK);
@@ -126,6 +249,7 @@ destroy_cplx_rungekutta_ws(ComplexWorkspaceRK);
  * \param 5 : Workspace struct address for internal derivative computation
  * \param 6 : function values `y` computed at current grid point
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 cplx_rungekutta5(
@@ -149,6 +273,7 @@ cplx_rungekutta5(
  * \param 5 : Workspace struct address for internal derivative computation
  * \param 6 : function values `y` computed at current grid point
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 real_rungekutta5(
@@ -172,6 +297,7 @@ real_rungekutta5(
  * \param 5 : Workspace struct address for internal derivative computation
  * \param 6 : function values `y` computed at current grid point
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 cplx_rungekutta4
@@ -196,6 +322,7 @@ cplx_rungekutta4
  * \param 5 : Workspace struct address for internal derivative computation
  * \param 6 : function values `y` computed at current grid point `x`
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 real_rungekutta4
@@ -220,6 +347,7 @@ real_rungekutta4
  * \param 5 : Workspace struct address to avoid memory allocation
  * \param 6 : function values `y` computed at current grid point `x`
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 cplx_rungekutta2
@@ -244,6 +372,7 @@ cplx_rungekutta2
  * \param 5 : Workspace struct address to avoid memory allocation
  * \param 6 : function values `y` computed at current grid point `x`
  * \param 7 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 6 (in-place step)
  */
 void
 real_rungekutta2
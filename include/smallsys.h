@@ -0,0 +1,130 @@
+/**
+ * \file smallsys.h
+ * \author Alex Andriati
+ * \brief Integration routines specialized for small fixed system sizes
+ *
+ * The generic routines loop over `ws->system_size` with work arrays in
+ * heap memory. For systems with a few equations known in advance, the
+ * routines here are generated for each size in `SMALLSYS_SIZES`, with
+ * names ending in `_n<size>`, for instance `real_rungekutta4_n4` and
+ * `real_adams4pc_n3`. The stages are local arrays of fixed size, thus
+ * the loops are unrolled and the state kept in registers or stack, and
+ * no workspace is required. The multistep methods keep the previous
+ * steps and derivatives in a struct of fixed capacity, which can be a
+ * local variable of the caller.
+ *
+ * The stage combinations do the same operations in the same order of
+ * the generic routines, thus the results are identical to them
+ */
+
+#ifndef ODE_SMALLSYS_H
+#define ODE_SMALLSYS_H
+
+#include "derivative_signature.h"
+
+/** \brief Largest system size specialized */
+#define SMALLSYS_MAX_SIZE 8
+
+/** \brief Largest number of previous steps of specialized multistep */
+#define SMALLSYS_MAX_ORDER 6
+
+/** \brief Apply macro `X` to every specialized system size */
+#define SMALLSYS_SIZES(X) X(1) X(2) X(3) X(4) X(6) X(8)
+
+/** \brief Previous steps of multistep methods for small complex systems
+ *
+ * The j-th previous step (j = 0 the most recent) is the row
+ * `(head + j) % ms_order` of `y` and `der` as in the history mode of
+ * multistep workspace. The last row of `der` holds the derivative of
+ * the corrector iterate. Only the first `N` columns are used
+ */
+typedef struct{
+    int
+        ms_order,       /// number of previous steps (4 or 6)
+        head;           /// row of the most recent step
+    double complex
+        y[SMALLSYS_MAX_ORDER][SMALLSYS_MAX_SIZE],
+        der[SMALLSYS_MAX_ORDER + 1][SMALLSYS_MAX_SIZE];
+} ComplexSmallHistory;
+
+/** \brief Previous steps of multistep methods for small real systems
+ *
+ * The j-th previous step (j = 0 the most recent) is the row
+ * `(head + j) % ms_order` of `y` and `der` as in the history mode of
+ * multistep workspace. The last row of `der` holds the derivative of
+ * the corrector iterate. Only the first `N` columns are used
+ */
+typedef struct{
+    int
+        ms_order,       /// number of previous steps (4 or 6)
+        head;           /// row of the most recent step
+    double
+        y[SMALLSYS_MAX_ORDER][SMALLSYS_MAX_SIZE],
+        der[SMALLSYS_MAX_ORDER + 1][SMALLSYS_MAX_SIZE];
+} RealSmallHistory;
+
+
+/** \brief Address of the j-th previous step, j = 0 the most recent */
+Carray
+cplx_small_prev_step(ComplexSmallHistory *, int);
+
+
+/** \brief Address of the j-th previous step, j = 0 the most recent */
+Rarray
+real_small_prev_step(RealSmallHistory *, int);
+
+
+/*
+ * Routines generated for each size `N` in `SMALLSYS_SIZES`
+ *
+ * `*_rungekutta2_nN`, `*_rungekutta4_nN`, `*_rungekutta5_nN`
+ *      Same parameters of the generic routines without the workspace:
+ *      (h, x, yprime, args, y, ynext). The output may be the input
+ *
+ * `*_small_multistep_init_nN`
+ *      (h, x0, yprime, args, ms_order, y0, hist) set the first
+ *      `ms_order` steps (4 or 6) at `x0 + i * h` in `hist` with the 4th
+ *      order Runge-Kutta if `ms_order` is 4 and the 5th order otherwise
+ *
+ * `*_adams4pc_nN`, `*_adams6pc_nN`
+ *      (h, x, yprime, args, hist, iter, ynext) predictor and `iter`
+ *      corrector iterations from the most recent step at `x`
+ *
+ * `*_small_set_next_nN`
+ *      (xnext, yprime, args, hist, ynext) append the new step to the
+ *      history with its derivative
+ */
+
+#define SMALLSYS_DECLARE(PREFIX, T, DER, HIST, N)                       \
+void                                                                    \
+PREFIX##_rungekutta2_n##N(double, double, DER, void *, T *, T *);       \
+void                                                                    \
+PREFIX##_rungekutta4_n##N(double, double, DER, void *, T *, T *);       \
+void                                                                    \
+PREFIX##_rungekutta5_n##N(double, double, DER, void *, T *, T *);       \
+void                                                                    \
+PREFIX##_small_multistep_init_n##N(                                     \
+        double, double, DER, void *, int, T *, HIST *);                 \
+void                                                                    \
+PREFIX##_adams4pc_n##N(                                                 \
+        double, double, DER, void *, HIST *, unsigned int, T *);        \
+void                                                                    \
+PREFIX##_adams6pc_n##N(                                                 \
+        double, double, DER, void *, HIST *, unsigned int, T *);        \
+void                                                                    \
+PREFIX##_small_set_next_n##N(double, DER, void *, HIST *, T *);
+
+#define SMALLSYS_DECLARE_REAL(N) \
+    SMALLSYS_DECLARE(real, double, real_odesys_der, RealSmallHistory, N)
+#define SMALLSYS_DECLARE_CPLX(N) \
+    SMALLSYS_DECLARE(cplx, double complex, cplx_odesys_der, ComplexSmallHistory, N)
+
+SMALLSYS_SIZES(SMALLSYS_DECLARE_REAL)
+SMALLSYS_SIZES(SMALLSYS_DECLARE_CPLX)
+
+#undef SMALLSYS_DECLARE_REAL
+#undef SMALLSYS_DECLARE_CPLX
+#undef SMALLSYS_DECLARE
+
+
+#endif
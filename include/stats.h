@@ -0,0 +1,96 @@
+/**
+ * \file stats.h
+ * \author Alex Andriati
+ * \brief Counters and timers of integration routines
+ *
+ * A stats struct attached to a workspace (field `stats`, NULL if none)
+ * records the derivative evaluations, steps and corrector or Newton
+ * iterations of the routines using that workspace, the Jacobian
+ * evaluations and LU decompositions of BDF steps, as well as the time
+ * spent inside the client derivative routine and inside the library
+ * step routines. Time is measured in ticks of the processor time stamp
+ * counter where available (x86), otherwise in nanoseconds
+ *
+ * The instrumented routines are the Runge-Kutta steps of singlestep.h,
+ * the embedded pairs and driver of adaptive.h, the multistep routines
+ * of multistep.h (including the startup with `init_*_multistep`) and
+ * the BDF steps of bdf.h, in which the struct is attached to the field
+ * `ms`. For the adaptive driver it is attached to the Runge-Kutta
+ * workspace `rk`. The same struct may be attached to several workspaces
+ * to accumulate their counters
+ *
+ * If the library is built without `ODESYS_STATS` the routines do not
+ * touch the struct at all, thus attaching one has no effect and costs
+ * nothing. Otherwise the cost of a workspace without stats attached is
+ * a single pointer check per derivative evaluation
+ */
+
+#ifndef ODE_STATS_H
+#define ODE_STATS_H
+
+#include <stdio.h>
+
+/** \brief Struct with counters and timers of integration routines
+ *
+ * Time spent in library kernels (stage combinations, error norms and
+ * linear algebra) is `step_ticks - rhs_ticks`, which also includes the
+ * client Jacobian routine given to BDF steps. Fields `depth` and
+ * `start` are used internally to time nested routines only once
+ */
+typedef struct{
+    unsigned long
+        rhs_calls,      /// number of derivative evaluations
+        steps,          /// number of steps done (accepted if adaptive)
+        rejected,       /// number of rejected steps (adaptive and BDF)
+        iterations,     /// number of corrector or Newton iterations
+        jac_evals,      /// number of Jacobian evaluations (BDF)
+        lu_decomps;     /// number of LU decompositions (BDF)
+    unsigned long long
+        rhs_ticks,      /// ticks inside the client derivative routine
+        step_ticks;     /// ticks inside step routines (derivatives included)
+    unsigned int
+        depth;          /// nesting level of step routines being timed
+    unsigned long long
+        start;          /// tick counter when outermost routine started
+} _IntegratorStats;
+
+/** \brief Struct address of integration counters and timers */
+typedef _IntegratorStats * IntegratorStats;
+
+
+/** \brief Return fresh allocated stats struct with all counters zero */
+IntegratorStats
+get_integrator_stats(void);
+
+
+/** \brief Set all counters and timers to zero */
+void
+reset_integrator_stats(IntegratorStats);
+
+
+/** \brief Free stats struct (must be detached from workspaces) */
+void
+destroy_integrator_stats(IntegratorStats);
+
+
+/** \brief Return 1 if library was built with `ODESYS_STATS` and 0 otherwise */
+int
+integrator_stats_enabled(void);
+
+
+/**
+ * \brief Write stats as a JSON object
+ *
+ * Besides the struct counters the object has the build flag `enabled`,
+ * the unit of ticks `tick_unit` ("tsc" or "ns") and `library_ticks`
+ *
+ * \param 1 : stats struct address
+ * \param 2 : output stream (e.g. file opened by client or stdout)
+ *
+ * \return 0 if written and -1 on output error
+ */
+int
+integrator_stats_json(IntegratorStats, FILE *);
+
+
+#endif
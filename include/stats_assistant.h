@@ -0,0 +1,91 @@
+/**
+ * \file stats_assistant.h
+ * \author Alex Andriati
+ * \brief Private macros to record counters and timers in stats struct
+ *
+ * This file is supposed to be private for end users, as `arrays_assistant.h`.
+ * Without `ODESYS_STATS` defined in the library build all macros expand
+ * to the bare derivative call or to nothing, thus instrumented routines
+ * are the same as without instrumentation. The `stats` argument is the
+ * field of the workspace and may be NULL
+ */
+
+#ifndef STATS_ASSISTANT_H
+#define STATS_ASSISTANT_H
+
+#include "stats.h"
+
+#ifdef ODESYS_STATS
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define STATS_TICK_UNIT "tsc"
+#else
+#include <time.h>
+#define STATS_TICK_UNIT "ns"
+#endif
+
+
+/** \brief Current value of tick counter */
+static inline unsigned long long
+stats_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec
+        t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long) t.tv_sec * 1000000000ULL + t.tv_nsec;
+#endif
+}
+
+
+/** \brief Evaluate derivative `call` counting it and its ticks */
+#define STATS_RHS(stats, call)                                          \
+    do {                                                                \
+        if ((stats) != NULL)                                            \
+        {                                                               \
+            unsigned long long stats_t0_ = stats_ticks();               \
+            call;                                                       \
+            (stats)->rhs_ticks += stats_ticks() - stats_t0_;            \
+            (stats)->rhs_calls++;                                       \
+        }                                                               \
+        else call;                                                      \
+    } while (0)
+
+/** \brief Start timing a step routine (nested ones are not timed twice) */
+#define STATS_BEGIN(stats)                                              \
+    do {                                                                \
+        if ((stats) != NULL && (stats)->depth++ == 0)                   \
+        {                                                               \
+            (stats)->start = stats_ticks();                             \
+        }                                                               \
+    } while (0)
+
+/** \brief Stop timing a step routine, required before each return */
+#define STATS_END(stats)                                                \
+    do {                                                                \
+        if ((stats) != NULL && --(stats)->depth == 0)                   \
+        {                                                               \
+            (stats)->step_ticks += stats_ticks() - (stats)->start;      \
+        }                                                               \
+    } while (0)
+
+/** \brief Add `n` to counter `field` of stats struct */
+#define STATS_ADD(stats, field, n)                                      \
+    do {                                                                \
+        if ((stats) != NULL) (stats)->field += (n);                     \
+    } while (0)
+
+#else
+
+#define STATS_TICK_UNIT "none"
+#define STATS_RHS(stats, call) call
+#define STATS_BEGIN(stats) do { } while (0)
+#define STATS_END(stats) do { } while (0)
+#define STATS_ADD(stats, field, n) do { } while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * \file tableau.h
+ * \author Alex Andriati
+ * \brief Explicit Runge-Kutta methods defined by their Butcher tableau
+ *
+ * A single routine integrates any explicit Runge-Kutta method given
+ * the coefficients `a`, `b` and `c` of its Butcher tableau, with an
+ * optional embedded solution `bhat` to estimate the local error. The
+ * nonzero coefficients of each stage are collected when the workspace
+ * is created, such that every stage is a single call of the vector
+ * kernels, and the number of work arrays follows the number of stages.
+ * New methods only require a new tableau, see the library below
+ */
+
+#ifndef ODE_TABLEAU_H
+#define ODE_TABLEAU_H
+
+#include "derivative_signature.h"
+
+/** \brief Butcher tableau of explicit Runge-Kutta method
+ *
+ * The matrix `a` has `stages * stages` elements in row-major order of
+ * which only the strictly lower triangle is used. If `fsal` is nonzero
+ * (First Same As Last) the last row of `a` must be equal to `b` and the
+ * last node `c` equal to one, thus the last stage is the derivative at
+ * the new grid point and may be reused as first stage of the next step
+ */
+typedef struct{
+    const char
+        * name;             /// method name for output purposes
+    int
+        stages,             /// number of stages `s`
+        order,              /// order of solution with weights `b`
+        embedded_order,     /// order of solution with `bhat` (0 if none)
+        fsal;               /// nonzero if last stage is derivative at `x + h`
+    const double
+        * a,                /// stage coefficients (s x s row-major)
+        * b,                /// weights of propagated solution
+        * c,                /// nodes (fraction of step of each stage)
+        * bhat;             /// weights of embedded solution (NULL if none)
+} ButcherTableau;
+
+/*
+ * Library of tableaus. Refs. are listed in tableau.c
+ *
+ * `TABLEAU_HEUN_RK2`       2nd order of `*_rungekutta2`, 2 stages
+ * `TABLEAU_RK4`            classical 4th order, 4 stages
+ * `TABLEAU_RK4_38`         4th order 3/8-rule, 4 stages
+ * `TABLEAU_BUTCHER_RK5`    5th order of `*_rungekutta5`, 6 stages
+ * `TABLEAU_DORMAND_PRINCE_54`  5(4) pair with FSAL, 7 stages
+ * `TABLEAU_TSITOURAS_54`   5(4) pair with FSAL, 7 stages
+ * `TABLEAU_BUTCHER_RK6`    6th order, 7 stages
+ * `TABLEAU_VERNER_65`      6(5) pair, 8 stages
+ * `TABLEAU_FEHLBERG_78`    7(8) pair, 13 stages. The embedded solution
+ *                          is of 8th order, thus the error estimate is
+ *                          of the 7th order solution propagated
+ * `TABLEAU_VERNER_76`      7(6) pair, 10 stages
+ * `TABLEAU_VERNER_87`      8(7) pair, 13 stages
+ */
+extern const ButcherTableau TABLEAU_HEUN_RK2;
+extern const ButcherTableau TABLEAU_RK4;
+extern const ButcherTableau TABLEAU_RK4_38;
+extern const ButcherTableau TABLEAU_BUTCHER_RK5;
+extern const ButcherTableau TABLEAU_DORMAND_PRINCE_54;
+extern const ButcherTableau TABLEAU_TSITOURAS_54;
+extern const ButcherTableau TABLEAU_BUTCHER_RK6;
+extern const ButcherTableau TABLEAU_VERNER_65;
+extern const ButcherTableau TABLEAU_FEHLBERG_78;
+extern const ButcherTableau TABLEAU_VERNER_76;
+extern const ButcherTableau TABLEAU_VERNER_87;
+
+/** \brief Struct to provide complex workspace of tableau methods
+ *
+ * The nonzero coefficients are stored by rows with at most `stages`
+ * terms each: rows `0` to `stages - 1` for the stages, row `stages`
+ * for the weights `b` and row `stages + 1` for the error weights
+ * `b - bhat`. All work arrays are placed in a single aligned block
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        stages;         /// number of stages of the tableau
+    const ButcherTableau
+        * tableau;      /// method coefficients (not owned by workspace)
+    int
+        * nterms,       /// number of nonzero terms in each row
+        * term_stage;   /// stage index of each term
+    double
+        * term_weight;  /// coefficient of each term
+    void
+        * arena;        /// block with all work arrays
+    Carray
+        * k,            /// stage derivatives
+        * v,            /// arrays of terms passed to vector kernels
+        karg;           /// argument of stage derivative evaluation
+} _ComplexWorkspaceTableau;
+
+/** \brief Workspace struct address for tableau methods */
+typedef _ComplexWorkspaceTableau * ComplexWorkspaceTableau;
+
+/** \brief Struct to provide real workspace of tableau methods
+ *
+ * The nonzero coefficients are stored by rows with at most `stages`
+ * terms each: rows `0` to `stages - 1` for the stages, row `stages`
+ * for the weights `b` and row `stages + 1` for the error weights
+ * `b - bhat`. All work arrays are placed in a single aligned block
+ */
+typedef struct{
+    int
+        system_size,    /// number of equations in ODE system
+        stages;         /// number of stages of the tableau
+    const ButcherTableau
+        * tableau;      /// method coefficients (not owned by workspace)
+    int
+        * nterms,       /// number of nonzero terms in each row
+        * term_stage;   /// stage index of each term
+    double
+        * term_weight;  /// coefficient of each term
+    void
+        * arena;        /// block with all work arrays
+    Rarray
+        * k,            /// stage derivatives
+        * v,            /// arrays of terms passed to vector kernels
+        karg;           /// argument of stage derivative evaluation
+} _RealWorkspaceTableau;
+
+/** \brief Workspace struct address for tableau methods */
+typedef _RealWorkspaceTableau * RealWorkspaceTableau;
+
+
+/** \brief Return fresh allocated workspace for the tableau given
+ *
+ * \param 1 : system size
+ * \param 2 : method tableau, which must live while the workspace is used
+ */
+ComplexWorkspaceTableau
+get_cplx_tableau_ws(int sys_size, const ButcherTableau *);
+
+
+/** \brief Return fresh allocated workspace for the tableau given
+ *
+ * \param 1 : system size
+ * \param 2 : method tableau, which must live while the workspace is used
+ */
+RealWorkspaceTableau
+get_real_tableau_ws(int sys_size, const ButcherTableau *);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_cplx_tableau_ws(ComplexWorkspaceTableau);
+
+
+/** \brief Free allocated workspace struct and its internal arrays */
+void
+destroy_real_tableau_ws(RealWorkspaceTableau);
+
+
+/** \brief Exchange first and last stages to reuse the derivative (FSAL)
+ *
+ * Must be called only after an accepted step of a FSAL tableau, then
+ * the next step can be called with the first stage ready
+ */
+void
+cplx_tableau_swap_fsal(ComplexWorkspaceTableau);
+
+
+/** \brief Exchange first and last stages to reuse the derivative (FSAL) */
+void
+real_tableau_swap_fsal(RealWorkspaceTableau);
+
+
+/**
+ * \brief Runge-Kutta step of method given by Butcher tableau
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _ComplexODEInputParameters)
+ * \param 5 : Workspace struct address with the method tableau
+ * \param 6 : If nonzero, `k[0]` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 7 (in-place step)
+ * \param 9 : (OUTPUT) local error estimate `h * sum (b - bhat) k` of
+ *            param 8. Ignored if NULL or the tableau has no `bhat`
+ */
+void
+cplx_tableau_step(
+        double,
+        double,
+        cplx_odesys_der,
+        void *,
+        ComplexWorkspaceTableau,
+        int,
+        Carray,
+        Carray,
+        Carray
+);
+
+
+/**
+ * \brief Runge-Kutta step of method given by Butcher tableau
+ *
+ * \param 1 : grid spacing `h`
+ * \param 2 : current grid point `x`
+ * \param 3 : function pointing to routine that compute derivatives
+ * \param 4 : extra arguments (void pointer in _RealODEInputParameters)
+ * \param 5 : Workspace struct address with the method tableau
+ * \param 6 : If nonzero, `k[0]` already holds derivative at `x`
+ * \param 7 : function values `y` computed at current grid point
+ * \param 8 : (OUTPUT) function values at next grid point `x + h`
+ *            May be the same array of param 7 (in-place step)
+ * \param 9 : (OUTPUT) local error estimate `h * sum (b - bhat) k` of
+ *            param 8. Ignored if NULL or the tableau has no `bhat`
+ */
+void
+real_tableau_step(
+        double,
+        double,
+        real_odesys_der,
+        void *,
+        RealWorkspaceTableau,
+        int,
+        Rarray,
+        Rarray,
+        Rarray
+);
+
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * \file trajectory.h
+ * \author Alex Andriati
+ * \brief Binary trajectory sink written by a background thread
+ *
+ * Printing the solution as text at every step may cost more than the
+ * integration of large systems. The sink here appends raw records with
+ * the grid point and selected components of the solution to a memory
+ * buffer. When a buffer is full it is handed to a writer thread and
+ * the integration proceeds with the second buffer (double buffering),
+ * thus appending a record does no formatting and no system call. The
+ * integration only waits if the writer did not finish the previous
+ * buffer, i.e, if the disk is slower than the integration
+ *
+ * File layout (version `TRAJECTORY_VERSION`), all in the byte order of
+ * the machine which wrote the file:
+ *
+ *      8 bytes     magic "ODESYSTR"
+ *      uint32      format version
+ *      uint32      endian tag 0x01020304 (byte swapped if read reversed)
+ *      uint32      number of components `ncomp` in each record
+ *      uint32      system size
+ *      uint32[]    `ncomp` indexes of components recorded
+ *      double[]    records of `ncomp + 1` values `x, y[comp[0]], ...`
+ *
+ * The number of records follows from the file size, thus a file of an
+ * interrupted run is readable up to its last complete record
+ */
+
+#ifndef ODE_TRAJECTORY_H
+#define ODE_TRAJECTORY_H
+
+#include <stdio.h>
+#include <pthread.h>
+#include "derivative_signature.h"
+
+/** \brief Current version of trajectory file format */
+#define TRAJECTORY_VERSION 1
+
+/** \brief Struct of trajectory sink with buffers and writer thread
+ *
+ * The fields are managed by the sink routines and must not be changed
+ * by the client. Buffer `inflight` (NULL if none) is owned by the
+ * writer thread, while records are appended to `active`
+ */
+typedef struct{
+    int
+        fd,             /// file descriptor
+        system_size,    /// number of equations in ODE system
+        ncomp,          /// number of components in each record
+        closing,        /// nonzero when writer thread must finish
+        status;         /// zero or -1 after failed write
+    int
+        * comp;         /// indexes of components recorded
+    unsigned int
+        every,          /// record one of every `every` appended states
+        calls,          /// number of states appended (for decimation)
+        capacity,       /// number of records in each buffer
+        nfill,          /// number of records in active buffer
+        ninflight;      /// number of records in buffer being written
+    Rarray
+        buffers,        /// block with both buffers
+        active,         /// buffer receiving records
+        inflight;       /// buffer handed to writer thread
+    pthread_t
+        writer;
+    pthread_mutex_t
+        lock;
+    pthread_cond_t
+        work,           /// signaled when a buffer is handed over
+        done;           /// signaled when the writer releases a buffer
+} _RealTrajectorySink;
+
+/** \brief Struct address of trajectory sink */
+typedef _RealTrajectorySink * RealTrajectorySink;
+
+
+/**
+ * \brief Create file and start writer thread of trajectory sink
+ *
+ * \param 1 : file name (truncated if exists)
+ * \param 2 : system size
+ * \param 3 : number of components recorded. If zero all are recorded
+ * \param 4 : indexes of components recorded (copied). Ignored if param 3
+ *            is zero
+ * \param 5 : record one of every `every` states appended (zero as one)
+ * \param 6 : number of records of each buffer (zero for a default)
+ *
+ * \return sink struct address, or NULL if the file cannot be created
+ */
+RealTrajectorySink
+open_real_trajectory(
+        const char *,
+        int,
+        int,
+        const int *,
+        unsigned int,
+        unsigned int
+);
+
+
+/**
+ * \brief Append a state to the trajectory (subject to decimation)
+ *
+ * \param 1 : trajectory sink
+ * \param 2 : grid point
+ * \param 3 : solution at grid point
+ */
+void
+real_trajectory_append(RealTrajectorySink, double, Rarray);
+
+
+/**
+ * \brief Write remaining records, stop writer thread and close file
+ *
+ * The sink struct is freed in any case
+ *
+ * \return 0 if all records were written and -1 otherwise
+ */
+int
+close_real_trajectory(RealTrajectorySink);
+
+
+/**
+ * \brief Convert binary trajectory file to CSV text
+ *
+ * The first line names the columns as `x,y0,y5,...` by the component
+ * indexes, followed by one line per record
+ *
+ * \param 1 : binary trajectory file name
+ * \param 2 : output stream (e.g. file opened by client or stdout)
+ *
+ * \return number of records converted or -1 if the file is not valid
+ */
+long
+real_trajectory_to_csv(const char *, FILE *);
+
+
+#endif
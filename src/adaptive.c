@@ -0,0 +1,1117 @@
+/**
+ * \file adaptive.c
+ * \author Alex Andriati
+ * \brief Source code for embedded Runge-Kutta pairs and step size control
+ *
+ * See function signature and description in header adaptive.h
+ * The step size control follows the standard strategy of ref. [1] sec.
+ * II.4 with error measured in weighted root-mean-square norm. Some refs
+ *
+ * [1] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ * [2] J.R. Dormand and P.J. Prince, A family of embedded Runge-Kutta
+ * formulae, J. Comp. Appl. Math. 6 (1980) 19-26
+ * [3] J.R. Cash and A.H. Karp, A variable order Runge-Kutta method for
+ * initial value problems with rapidly varying right-hand sides, ACM
+ * Trans. Math. Software 16 (1990) 201-222
+ * [4] P. Bogacki and L.F. Shampine, A 3(2) pair of Runge-Kutta formulas,
+ * Appl. Math. Letters 2 (1989) 321-325
+ */
+
+#include <math.h>
+#include "adaptive.h"
+#include "arrays_assistant.h"
+#include "kernels.h"
+#include "stats_assistant.h"
+
+
+/* Step size control parameters as suggested in ref. [1] */
+#define STEP_SAFETY 0.9
+#define STEP_MIN_FACTOR 0.2
+#define STEP_MAX_FACTOR 5.0
+
+
+/** \brief Order of the embedded (lower order) solution of the pair */
+static int
+embedded_order(EmbeddedPairRK method)
+{
+    switch (method)
+    {
+        case BOGACKI_SHAMPINE_32:
+            return 2;
+        default:
+            return 4;
+    }
+}
+
+
+/** \brief Factor to scale step size based on error norm */
+static double
+step_factor(double err, int order)
+{
+    double
+        fac;
+    if (err == 0) return STEP_MAX_FACTOR;
+    fac = STEP_SAFETY * pow(err, -1.0 / (order + 1));
+    if (fac != fac || fac < STEP_MIN_FACTOR) return STEP_MIN_FACTOR;
+    if (fac > STEP_MAX_FACTOR) return STEP_MAX_FACTOR;
+    return fac;
+}
+
+
+void
+cplx_dormandprince54(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceRK ws,
+        int k1_ready,
+        Carray y,
+        Carray ynext,
+        Carray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[6];
+    Carray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        k7,
+        karg,
+        v[6];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    k4 = ws->work4;
+    k5 = ws->work5;
+    k6 = ws->work6;
+    karg = ws->work7;
+    k7 = ws->work7;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [2] table 2 (also ref. [1] table 5.2) */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = (1.0 / 5);
+    v[0] = k1;
+    carr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = (3.0 / 40);
+    w[1] = (9.0 / 40);
+    v[1] = k2;
+    carr_lincomb(sys_size, y, h, 2, w, v, karg);
+    sys_params.x = x + 3 * h / 10;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (44.0 / 45);
+    w[1] = (- 56.0 / 15);
+    w[2] = (32.0 / 9);
+    v[2] = k3;
+    carr_lincomb(sys_size, y, h, 3, w, v, karg);
+    sys_params.x = x + 4 * h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (19372.0 / 6561);
+    w[1] = (- 25360.0 / 2187);
+    w[2] = (64448.0 / 6561);
+    w[3] = (- 212.0 / 729);
+    v[3] = k4;
+    carr_lincomb(sys_size, y, h, 4, w, v, karg);
+    sys_params.x = x + 8 * h / 9;
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = (9017.0 / 3168);
+    w[1] = (- 355.0 / 33);
+    w[2] = (46732.0 / 5247);
+    w[3] = (49.0 / 176);
+    w[4] = (- 5103.0 / 18656);
+    v[4] = k5;
+    carr_lincomb(sys_size, y, h, 5, w, v, karg);
+    sys_params.x = x + h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = (35.0 / 384);
+    w[1] = (500.0 / 1113);
+    w[2] = (125.0 / 192);
+    w[3] = (- 2187.0 / 6784);
+    w[4] = (11.0 / 84);
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    carr_lincomb(sys_size, y, h, 5, w, v, ynext);
+    /* last stage evaluated at the solution itself (FSAL) */
+    sys_params.x = x + h;
+    sys_params.y = ynext;
+    STATS_RHS(ws->stats, yprime(&sys_params, k7));
+    w[0] = (71.0 / 57600);
+    w[1] = (- 71.0 / 16695);
+    w[2] = (71.0 / 1920);
+    w[3] = (- 17253.0 / 339200);
+    w[4] = (22.0 / 525);
+    w[5] = (- 1.0 / 40);
+    v[5] = k7;
+    carr_lincomb(sys_size, NULL, h, 6, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+void
+real_dormandprince54(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceRK ws,
+        int k1_ready,
+        Rarray y,
+        Rarray ynext,
+        Rarray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[6];
+    Rarray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        k7,
+        karg,
+        v[6];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    k4 = ws->work4;
+    k5 = ws->work5;
+    k6 = ws->work6;
+    karg = ws->work7;
+    k7 = ws->work7;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [2] table 2 (also ref. [1] table 5.2) */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = (1.0 / 5);
+    v[0] = k1;
+    rarr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = (3.0 / 40);
+    w[1] = (9.0 / 40);
+    v[1] = k2;
+    rarr_lincomb(sys_size, y, h, 2, w, v, karg);
+    sys_params.x = x + 3 * h / 10;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (44.0 / 45);
+    w[1] = (- 56.0 / 15);
+    w[2] = (32.0 / 9);
+    v[2] = k3;
+    rarr_lincomb(sys_size, y, h, 3, w, v, karg);
+    sys_params.x = x + 4 * h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (19372.0 / 6561);
+    w[1] = (- 25360.0 / 2187);
+    w[2] = (64448.0 / 6561);
+    w[3] = (- 212.0 / 729);
+    v[3] = k4;
+    rarr_lincomb(sys_size, y, h, 4, w, v, karg);
+    sys_params.x = x + 8 * h / 9;
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = (9017.0 / 3168);
+    w[1] = (- 355.0 / 33);
+    w[2] = (46732.0 / 5247);
+    w[3] = (49.0 / 176);
+    w[4] = (- 5103.0 / 18656);
+    v[4] = k5;
+    rarr_lincomb(sys_size, y, h, 5, w, v, karg);
+    sys_params.x = x + h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = (35.0 / 384);
+    w[1] = (500.0 / 1113);
+    w[2] = (125.0 / 192);
+    w[3] = (- 2187.0 / 6784);
+    w[4] = (11.0 / 84);
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    rarr_lincomb(sys_size, y, h, 5, w, v, ynext);
+    /* last stage evaluated at the solution itself (FSAL) */
+    sys_params.x = x + h;
+    sys_params.y = ynext;
+    STATS_RHS(ws->stats, yprime(&sys_params, k7));
+    w[0] = (71.0 / 57600);
+    w[1] = (- 71.0 / 16695);
+    w[2] = (71.0 / 1920);
+    w[3] = (- 17253.0 / 339200);
+    w[4] = (22.0 / 525);
+    w[5] = (- 1.0 / 40);
+    v[5] = k7;
+    rarr_lincomb(sys_size, NULL, h, 6, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+void
+cplx_cashkarp54(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceRK ws,
+        int k1_ready,
+        Carray y,
+        Carray ynext,
+        Carray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[5];
+    Carray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        karg,
+        v[5];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    k4 = ws->work4;
+    k5 = ws->work5;
+    k6 = ws->work6;
+    karg = ws->work7;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [3] (also ref. [3] of singlestep.c) */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = (1.0 / 5);
+    v[0] = k1;
+    carr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = (3.0 / 40);
+    w[1] = (9.0 / 40);
+    v[1] = k2;
+    carr_lincomb(sys_size, y, h, 2, w, v, karg);
+    sys_params.x = x + 3 * h / 10;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (3.0 / 10);
+    w[1] = (- 9.0 / 10);
+    w[2] = (6.0 / 5);
+    v[2] = k3;
+    carr_lincomb(sys_size, y, h, 3, w, v, karg);
+    sys_params.x = x + 3 * h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (- 11.0 / 54);
+    w[1] = (5.0 / 2);
+    w[2] = (- 70.0 / 27);
+    w[3] = (35.0 / 27);
+    v[3] = k4;
+    carr_lincomb(sys_size, y, h, 4, w, v, karg);
+    sys_params.x = x + h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = (1631.0 / 55296);
+    w[1] = (175.0 / 512);
+    w[2] = (575.0 / 13824);
+    w[3] = (44275.0 / 110592);
+    w[4] = (253.0 / 4096);
+    v[4] = k5;
+    carr_lincomb(sys_size, y, h, 5, w, v, karg);
+    sys_params.x = x + 7 * h / 8;
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = (37.0 / 378);
+    w[1] = (250.0 / 621);
+    w[2] = (125.0 / 594);
+    w[3] = (512.0 / 1771);
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k6;
+    carr_lincomb(sys_size, y, h, 4, w, v, ynext);
+    w[0] = (37.0 / 378 - 2825.0 / 27648);
+    w[1] = (250.0 / 621 - 18575.0 / 48384);
+    w[2] = (125.0 / 594 - 13525.0 / 55296);
+    w[3] = (- 277.0 / 14336);
+    w[4] = (512.0 / 1771 - 1.0 / 4);
+    v[3] = k5;
+    v[4] = k6;
+    carr_lincomb(sys_size, NULL, h, 5, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+void
+real_cashkarp54(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceRK ws,
+        int k1_ready,
+        Rarray y,
+        Rarray ynext,
+        Rarray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[5];
+    Rarray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        karg,
+        v[5];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    k4 = ws->work4;
+    k5 = ws->work5;
+    k6 = ws->work6;
+    karg = ws->work7;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [3] (also ref. [3] of singlestep.c) */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = (1.0 / 5);
+    v[0] = k1;
+    rarr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = (3.0 / 40);
+    w[1] = (9.0 / 40);
+    v[1] = k2;
+    rarr_lincomb(sys_size, y, h, 2, w, v, karg);
+    sys_params.x = x + 3 * h / 10;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (3.0 / 10);
+    w[1] = (- 9.0 / 10);
+    w[2] = (6.0 / 5);
+    v[2] = k3;
+    rarr_lincomb(sys_size, y, h, 3, w, v, karg);
+    sys_params.x = x + 3 * h / 5;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (- 11.0 / 54);
+    w[1] = (5.0 / 2);
+    w[2] = (- 70.0 / 27);
+    w[3] = (35.0 / 27);
+    v[3] = k4;
+    rarr_lincomb(sys_size, y, h, 4, w, v, karg);
+    sys_params.x = x + h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = (1631.0 / 55296);
+    w[1] = (175.0 / 512);
+    w[2] = (575.0 / 13824);
+    w[3] = (44275.0 / 110592);
+    w[4] = (253.0 / 4096);
+    v[4] = k5;
+    rarr_lincomb(sys_size, y, h, 5, w, v, karg);
+    sys_params.x = x + 7 * h / 8;
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = (37.0 / 378);
+    w[1] = (250.0 / 621);
+    w[2] = (125.0 / 594);
+    w[3] = (512.0 / 1771);
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k6;
+    rarr_lincomb(sys_size, y, h, 4, w, v, ynext);
+    w[0] = (37.0 / 378 - 2825.0 / 27648);
+    w[1] = (250.0 / 621 - 18575.0 / 48384);
+    w[2] = (125.0 / 594 - 13525.0 / 55296);
+    w[3] = (- 277.0 / 14336);
+    w[4] = (512.0 / 1771 - 1.0 / 4);
+    v[3] = k5;
+    v[4] = k6;
+    rarr_lincomb(sys_size, NULL, h, 5, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+void
+cplx_bogackishampine32(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceRK ws,
+        int k1_ready,
+        Carray y,
+        Carray ynext,
+        Carray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[4];
+    Carray
+        k1,
+        k2,
+        k3,
+        k4,
+        karg,
+        v[4];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    karg = ws->work4;
+    k4 = ws->work4;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [4] */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 0.5;
+    v[0] = k1;
+    carr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + 0.5 * h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 0.75;
+    v[0] = k2;
+    carr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + 0.75 * h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (2.0 / 9);
+    w[1] = (3.0 / 9);
+    w[2] = (4.0 / 9);
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    carr_lincomb(sys_size, y, h, 3, w, v, ynext);
+    /* last stage evaluated at the solution itself (FSAL) */
+    sys_params.x = x + h;
+    sys_params.y = ynext;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (- 5.0 / 72);
+    w[1] = (6.0 / 72);
+    w[2] = (8.0 / 72);
+    w[3] = (- 9.0 / 72);
+    v[3] = k4;
+    carr_lincomb(sys_size, NULL, h, 4, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+void
+real_bogackishampine32(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceRK ws,
+        int k1_ready,
+        Rarray y,
+        Rarray ynext,
+        Rarray yerr
+)
+{
+    int
+        sys_size;
+    double
+        w[4];
+    Rarray
+        k1,
+        k2,
+        k3,
+        k4,
+        karg,
+        v[4];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    k1 = ws->work1;
+    k2 = ws->work2;
+    k3 = ws->work3;
+    karg = ws->work4;
+    k4 = ws->work4;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
+
+    /* Coefficients from ref. [4] */
+    sys_params.x = x;
+    if (!k1_ready) STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 0.5;
+    v[0] = k1;
+    rarr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + 0.5 * h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 0.75;
+    v[0] = k2;
+    rarr_lincomb(sys_size, y, h, 1, w, v, karg);
+    sys_params.x = x + 0.75 * h;
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = (2.0 / 9);
+    w[1] = (3.0 / 9);
+    w[2] = (4.0 / 9);
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    rarr_lincomb(sys_size, y, h, 3, w, v, ynext);
+    /* last stage evaluated at the solution itself (FSAL) */
+    sys_params.x = x + h;
+    sys_params.y = ynext;
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = (- 5.0 / 72);
+    w[1] = (6.0 / 72);
+    w[2] = (8.0 / 72);
+    w[3] = (- 9.0 / 72);
+    v[3] = k4;
+    rarr_lincomb(sys_size, NULL, h, 4, w, v, yerr);
+    STATS_END(ws->stats);
+}
+
+
+ComplexWorkspaceAdaptive
+get_cplx_adaptive_ws(
+        EmbeddedPairRK method,
+        int sys_size,
+        double abs_tol,
+        double rel_tol
+)
+{
+    ComplexWorkspaceAdaptive
+        ws;
+    ws = (ComplexWorkspaceAdaptive) malloc(sizeof(_ComplexWorkspaceAdaptive));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceAdaptive allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->k1_ready = 0;
+    ws->method = method;
+    ws->abs_tol = abs_tol;
+    ws->rel_tol = rel_tol;
+    ws->h_min = 0;
+    ws->h_max = 0;
+    ws->accepted = 0;
+    ws->rejected = 0;
+    ws->rk = get_cplx_rungekutta_ws(sys_size);
+    ws->ynext = alloc_carr(sys_size);
+    ws->yerr = alloc_carr(sys_size);
+    return ws;
+}
+
+
+RealWorkspaceAdaptive
+get_real_adaptive_ws(
+        EmbeddedPairRK method,
+        int sys_size,
+        double abs_tol,
+        double rel_tol
+)
+{
+    RealWorkspaceAdaptive
+        ws;
+    ws = (RealWorkspaceAdaptive) malloc(sizeof(_RealWorkspaceAdaptive));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceAdaptive allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->k1_ready = 0;
+    ws->method = method;
+    ws->abs_tol = abs_tol;
+    ws->rel_tol = rel_tol;
+    ws->h_min = 0;
+    ws->h_max = 0;
+    ws->accepted = 0;
+    ws->rejected = 0;
+    ws->rk = get_real_rungekutta_ws(sys_size);
+    ws->ynext = alloc_rarr(sys_size);
+    ws->yerr = alloc_rarr(sys_size);
+    return ws;
+}
+
+
+void
+destroy_cplx_adaptive_ws(ComplexWorkspaceAdaptive ws)
+{
+    destroy_cplx_rungekutta_ws(ws->rk);
+    free(ws->ynext);
+    free(ws->yerr);
+    free(ws);
+}
+
+
+void
+destroy_real_adaptive_ws(RealWorkspaceAdaptive ws)
+{
+    destroy_real_rungekutta_ws(ws->rk);
+    free(ws->ynext);
+    free(ws->yerr);
+    free(ws);
+}
+
+
+/** \brief Weighted root-mean-square norm of error estimate */
+static double
+cplx_error_norm(ComplexWorkspaceAdaptive ws, Carray y)
+{
+    int
+        i;
+    double
+        w,
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        w = fmax(cabs(y[i]), cabs(ws->ynext[i]));
+        e = cabs(ws->yerr[i]) / (ws->abs_tol + ws->rel_tol * w);
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ws->system_size);
+}
+
+
+/** \brief Weighted root-mean-square norm of error estimate */
+static double
+real_error_norm(RealWorkspaceAdaptive ws, Rarray y)
+{
+    int
+        i;
+    double
+        w,
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        w = fmax(fabs(y[i]), fabs(ws->ynext[i]));
+        e = ws->yerr[i] / (ws->abs_tol + ws->rel_tol * w);
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ws->system_size);
+}
+
+
+/** \brief Initial step size estimate as in ref. [1] sec. II.4
+ *
+ * Uses two derivative evaluations, with the first one kept in `work1`
+ * of the Runge-Kutta workspace to be used in the first step
+ */
+static double
+cplx_initial_step(
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceAdaptive ws,
+        Carray y
+)
+{
+    int
+        i,
+        n;
+    double
+        w,
+        d0,
+        d1,
+        d2,
+        h0,
+        h1;
+    Carray
+        f0,
+        f1;
+    _ComplexODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    f0 = ws->rk->work1;
+    f1 = ws->yerr;
+    sys_params.x = x;
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    if (!ws->k1_ready) STATS_RHS(ws->rk->stats, yprime(&sys_params, f0));
+    ws->k1_ready = 1;
+
+    d0 = 0;
+    d1 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->abs_tol + ws->rel_tol * cabs(y[i]);
+        d0 = d0 + (cabs(y[i]) / w) * (cabs(y[i]) / w);
+        d1 = d1 + (cabs(f0[i]) / w) * (cabs(f0[i]) / w);
+    }
+    d0 = sqrt(d0 / n);
+    d1 = sqrt(d1 / n);
+    if (d0 < 1E-5 || d1 < 1E-5) h0 = 1E-6;
+    else                        h0 = 0.01 * d0 / d1;
+
+    for (i = 0; i < n; i++) ws->ynext[i] = y[i] + h0 * f0[i];
+    sys_params.x = x + h0;
+    sys_params.y = ws->ynext;
+    STATS_RHS(ws->rk->stats, yprime(&sys_params, f1));
+    d2 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = (ws->abs_tol + ws->rel_tol * cabs(y[i])) * h0;
+        d2 = d2 + (cabs(f1[i] - f0[i]) / w) * (cabs(f1[i] - f0[i]) / w);
+    }
+    d2 = sqrt(d2 / n);
+
+    if (fmax(d1, d2) <= 1E-15) h1 = fmax(1E-6, h0 * 1E-3);
+    else h1 = pow(0.01 / fmax(d1, d2), 1.0 / (embedded_order(ws->method) + 2));
+    return fmin(100 * h0, h1);
+}
+
+
+/** \brief Initial step size estimate as in ref. [1] sec. II.4
+ *
+ * Uses two derivative evaluations, with the first one kept in `work1`
+ * of the Runge-Kutta workspace to be used in the first step
+ */
+static double
+real_initial_step(
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceAdaptive ws,
+        Rarray y
+)
+{
+    int
+        i,
+        n;
+    double
+        w,
+        d0,
+        d1,
+        d2,
+        h0,
+        h1;
+    Rarray
+        f0,
+        f1;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    f0 = ws->rk->work1;
+    f1 = ws->yerr;
+    sys_params.x = x;
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    if (!ws->k1_ready) STATS_RHS(ws->rk->stats, yprime(&sys_params, f0));
+    ws->k1_ready = 1;
+
+    d0 = 0;
+    d1 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->abs_tol + ws->rel_tol * fabs(y[i]);
+        d0 = d0 + (y[i] / w) * (y[i] / w);
+        d1 = d1 + (f0[i] / w) * (f0[i] / w);
+    }
+    d0 = sqrt(d0 / n);
+    d1 = sqrt(d1 / n);
+    if (d0 < 1E-5 || d1 < 1E-5) h0 = 1E-6;
+    else                        h0 = 0.01 * d0 / d1;
+
+    for (i = 0; i < n; i++) ws->ynext[i] = y[i] + h0 * f0[i];
+    sys_params.x = x + h0;
+    sys_params.y = ws->ynext;
+    STATS_RHS(ws->rk->stats, yprime(&sys_params, f1));
+    d2 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = (ws->abs_tol + ws->rel_tol * fabs(y[i])) * h0;
+        d2 = d2 + ((f1[i] - f0[i]) / w) * ((f1[i] - f0[i]) / w);
+    }
+    d2 = sqrt(d2 / n);
+
+    if (fmax(d1, d2) <= 1E-15) h1 = fmax(1E-6, h0 * 1E-3);
+    else h1 = pow(0.01 / fmax(d1, d2), 1.0 / (embedded_order(ws->method) + 2));
+    return fmin(100 * h0, h1);
+}
+
+
+int
+cplx_adaptive_step(
+        double xend,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceAdaptive ws,
+        double * x,
+        double * h,
+        Carray y
+)
+{
+    int
+        order,
+        last_rejected;
+    double
+        err,
+        fac,
+        hstep,
+        hfree;
+    Carray
+        swap;
+    ComplexWorkspaceRK
+        rk;
+
+    rk = ws->rk;
+    STATS_BEGIN(rk->stats);
+    order = embedded_order(ws->method);
+    if (*h <= 0) *h = cplx_initial_step(*x, yprime, args, ws, y);
+    hstep = *h;
+    last_rejected = 0;
+
+    while (1)
+    {
+        if (ws->h_max > 0 && hstep > ws->h_max) hstep = ws->h_max;
+        if (hstep < ws->h_min || *x + hstep == *x)
+        {
+            STATS_END(rk->stats);
+            return -1;
+        }
+        /* step before truncation at `xend`, kept for the next proposal */
+        hfree = hstep;
+        if (*x + hstep > xend) hstep = xend - *x;
+
+        switch (ws->method)
+        {
+            case BOGACKI_SHAMPINE_32:
+                cplx_bogackishampine32(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+            case CASH_KARP_54:
+                cplx_cashkarp54(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+            case DORMAND_PRINCE_54:
+                cplx_dormandprince54(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+        }
+        /* the derivative at `x` is kept even if the step is rejected */
+        ws->k1_ready = 1;
+
+        err = cplx_error_norm(ws, y);
+        fac = step_factor(err, order);
+        if (err <= 1) break;
+
+        ws->rejected++;
+        STATS_ADD(rk->stats, rejected, 1);
+        last_rejected = 1;
+        hstep = hstep * fac;
+    }
+
+    ws->accepted++;
+    STATS_ADD(rk->stats, steps, 1);
+    *x = *x + hstep;
+    carr_copy_values(ws->system_size, ws->ynext, y);
+
+    /* First Same As Last stage becomes first stage of next step */
+    switch (ws->method)
+    {
+        case BOGACKI_SHAMPINE_32:
+            swap = rk->work1;
+            rk->work1 = rk->work4;
+            rk->work4 = swap;
+            break;
+        case DORMAND_PRINCE_54:
+            swap = rk->work1;
+            rk->work1 = rk->work7;
+            rk->work7 = swap;
+            break;
+        default:
+            ws->k1_ready = 0;
+    }
+
+    /* do not increase the step right after a rejection */
+    if (last_rejected && fac > 1) fac = 1;
+    *h = hstep * fac;
+    /* a step truncated at `xend` does not shrink the next one */
+    if (hstep < hfree) *h = fmax(*h, hfree);
+    STATS_END(rk->stats);
+    return 0;
+}
+
+
+int
+real_adaptive_step(
+        double xend,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceAdaptive ws,
+        double * x,
+        double * h,
+        Rarray y
+)
+{
+    int
+        order,
+        last_rejected;
+    double
+        err,
+        fac,
+        hstep,
+        hfree;
+    Rarray
+        swap;
+    RealWorkspaceRK
+        rk;
+
+    rk = ws->rk;
+    STATS_BEGIN(rk->stats);
+    order = embedded_order(ws->method);
+    if (*h <= 0) *h = real_initial_step(*x, yprime, args, ws, y);
+    hstep = *h;
+    last_rejected = 0;
+
+    while (1)
+    {
+        if (ws->h_max > 0 && hstep > ws->h_max) hstep = ws->h_max;
+        if (hstep < ws->h_min || *x + hstep == *x)
+        {
+            STATS_END(rk->stats);
+            return -1;
+        }
+        /* step before truncation at `xend`, kept for the next proposal */
+        hfree = hstep;
+        if (*x + hstep > xend) hstep = xend - *x;
+
+        switch (ws->method)
+        {
+            case BOGACKI_SHAMPINE_32:
+                real_bogackishampine32(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+            case CASH_KARP_54:
+                real_cashkarp54(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+            case DORMAND_PRINCE_54:
+                real_dormandprince54(
+                        hstep, *x, yprime, args, rk, ws->k1_ready,
+                        y, ws->ynext, ws->yerr
+                );
+                break;
+        }
+        /* the derivative at `x` is kept even if the step is rejected */
+        ws->k1_ready = 1;
+
+        err = real_error_norm(ws, y);
+        fac = step_factor(err, order);
+        if (err <= 1) break;
+
+        ws->rejected++;
+        STATS_ADD(rk->stats, rejected, 1);
+        last_rejected = 1;
+        hstep = hstep * fac;
+    }
+
+    ws->accepted++;
+    STATS_ADD(rk->stats, steps, 1);
+    *x = *x + hstep;
+    rarr_copy_values(ws->system_size, ws->ynext, y);
+
+    /* First Same As Last stage becomes first stage of next step */
+    switch (ws->method)
+    {
+        case BOGACKI_SHAMPINE_32:
+            swap = rk->work1;
+            rk->work1 = rk->work4;
+            rk->work4 = swap;
+            break;
+        case DORMAND_PRINCE_54:
+            swap = rk->work1;
+            rk->work1 = rk->work7;
+            rk->work7 = swap;
+            break;
+        default:
+            ws->k1_ready = 0;
+    }
+
+    /* do not increase the step right after a rejection */
+    if (last_rejected && fac > 1) fac = 1;
+    *h = hstep * fac;
+    /* a step truncated at `xend` does not shrink the next one */
+    if (hstep < hfree) *h = fmax(*h, hfree);
+    STATS_END(rk->stats);
+    return 0;
+}
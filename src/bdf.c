@@ -0,0 +1,500 @@
+/**
+ * \file bdf.c
+ * \author Alex Andriati
+ * \brief Source code for BDF methods with modified Newton iteration
+ *
+ * See function signature and description in header bdf.h
+ * The convergence test of Newton iterations and the criterion to refactor
+ * the iteration matrix follow the LSODE strategy of ref. [2]. The finite
+ * difference increments of the Jacobian are taken from RADAU5 of ref. [1]
+ *
+ * [1] E. Hairer and G. Wanner, Solving Ordinary Differential Equations II,
+ * Stiff and Differential-Algebraic Problems, Springer, 2nd Edition
+ * [2] K. Radhakrishnan and A.C. Hindmarsh, Description and Use of LSODE,
+ * the Livermore Solver for Ordinary Differential Equations, NASA (1993)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include "bdf.h"
+#include "arrays_assistant.h"
+#include "kernels.h"
+#include "stats_assistant.h"
+
+
+/* Relative change of `h * b` tolerated before refactorizing the matrix */
+#define BDF_HB_CHANGE 0.3
+/* Convergence rate above which Newton iteration is considered failed */
+#define BDF_MAX_RATE 0.9
+/* Maximum number of Jacobian evaluations in a single step */
+#define BDF_MAX_JAC_STEP 3
+
+
+/* Weights of previous steps `y_j+1 = a[1] * y_j + ... + a[k] * y_j+1-k` */
+static double BDF_A[BDF_MAX_ORDER][BDF_MAX_ORDER] = {
+    {1.0, 0, 0, 0, 0},
+    {4.0 / 3, - 1.0 / 3, 0, 0, 0},
+    {18.0 / 11, - 9.0 / 11, 2.0 / 11, 0, 0},
+    {48.0 / 25, - 36.0 / 25, 16.0 / 25, - 3.0 / 25, 0},
+    {300.0 / 137, - 300.0 / 137, 200.0 / 137, - 75.0 / 137, 12.0 / 137}
+};
+
+/* Weight of the derivative at the unknown step `h * b * y'_j+1` */
+static double BDF_B[BDF_MAX_ORDER] = {
+    1.0, 2.0 / 3, 6.0 / 11, 12.0 / 25, 60.0 / 137
+};
+
+/* Polynomial extrapolation of previous steps used as predictor */
+static double BDF_PRED[BDF_MAX_ORDER][BDF_MAX_ORDER] = {
+    {1, 0, 0, 0, 0},
+    {2, -1, 0, 0, 0},
+    {3, -3, 1, 0, 0},
+    {4, -6, 4, -1, 0},
+    {5, -10, 10, -5, 1}
+};
+
+
+RealWorkspaceBDF
+get_real_bdf_ws(unsigned int max_order, unsigned int sys_size)
+{
+    RealWorkspaceBDF
+        ws;
+    ws = (RealWorkspaceBDF) malloc(sizeof(_RealWorkspaceBDF));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceBDF allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    if (max_order < 1) max_order = 1;
+    if (max_order > BDF_MAX_ORDER) max_order = BDF_MAX_ORDER;
+    ws->ms.ms_order = max_order;
+    ws->ms.system_size = sys_size;
+    /* single chunk of derivative, previous derivatives are not needed */
+    ws->ms.prev_der = alloc_rarr(sys_size);
+    ws->ms.nthreads = 1;
+    ws->ms.stats = NULL;
+    alloc_real_multistep_wshistory(&ws->ms);
+    ws->nsteps = 0;
+    ws->order = 0;
+    ws->jac_ready = 0;
+    ws->lu_ready = 0;
+    ws->max_iter = 4;
+    ws->abs_tol = 1E-10;
+    ws->rel_tol = 1E-8;
+    ws->hb_lu = 0;
+    ws->conv_rate = 0.7;
+    ws->jac = alloc_rarr(sys_size * sys_size);
+    ws->lu = alloc_rarr(sys_size * sys_size);
+    ws->psi = alloc_rarr(sys_size);
+    ws->delta = alloc_rarr(sys_size);
+    ws->ywork = alloc_rarr(sys_size);
+    ws->fwork = alloc_rarr(sys_size);
+    ws->pivots = (int *) malloc(sys_size * sizeof(int));
+    if (ws->pivots == NULL)
+    {
+        printf("\n\nProblem in BDF pivots allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    return ws;
+}
+
+
+void
+destroy_real_bdf_ws(RealWorkspaceBDF ws)
+{
+    free_real_multistep_wsarray(&ws->ms);
+    free(ws->jac);
+    free(ws->lu);
+    free(ws->psi);
+    free(ws->delta);
+    free(ws->ywork);
+    free(ws->fwork);
+    free(ws->pivots);
+    free(ws);
+}
+
+
+void
+init_real_bdf(
+        double h,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceBDF ws,
+        Rarray y0,
+        real_rk_routine rk
+)
+{
+    int
+        j;
+    Rarray
+        y;
+    RealWorkspaceRK
+        wsrk;
+
+    ws->ms.head = 0;
+    if (rk == NULL)
+    {
+        y = real_multistep_prev_step(&ws->ms, 0);
+        rarr_copy_values(ws->ms.system_size, y0, y);
+        ws->nsteps = 1;
+    }
+    else
+    {
+        /* same steps of init_real_multistep without derivatives */
+        y = real_multistep_prev_step(&ws->ms, ws->ms.ms_order - 1);
+        rarr_copy_values(ws->ms.system_size, y0, y);
+        wsrk = get_real_rungekutta_ws(ws->ms.system_size);
+        wsrk->stats = ws->ms.stats;
+        for (j = ws->ms.ms_order - 1; j > 0; j--)
+        {
+            (*rk)(h, (ws->ms.ms_order - 1 - j) * h, yprime, args, wsrk,
+                  real_multistep_prev_step(&ws->ms, j),
+                  real_multistep_prev_step(&ws->ms, j - 1));
+        }
+        destroy_real_rungekutta_ws(wsrk);
+        ws->nsteps = ws->ms.ms_order;
+    }
+    ws->order = 0;
+    ws->lu_ready = 0;
+    ws->conv_rate = 0.7;
+}
+
+
+/** \brief Derivatives `jac` at (x, y) with forward finite differences
+ *
+ * `f0` must have the derivative at (x, y) already computed
+ */
+static void
+real_bdf_fd_jacobian(
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceBDF ws,
+        Rarray y,
+        Rarray f0
+)
+{
+    int
+        i,
+        j,
+        n;
+    double
+        inc;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->ms.system_size;
+    rarr_copy_values(n, y, ws->ywork);
+    sys_params.x = x;
+    sys_params.y = ws->ywork;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    for (j = 0; j < n; j++)
+    {
+        inc = sqrt(DBL_EPSILON * fmax(1E-5, fabs(y[j])));
+        ws->ywork[j] = y[j] + inc;
+        STATS_RHS(ws->ms.stats, yprime(&sys_params, ws->fwork));
+        for (i = 0; i < n; i++)
+        {
+            ws->jac[i * n + j] = (ws->fwork[i] - f0[i]) / inc;
+        }
+        ws->ywork[j] = y[j];
+    }
+}
+
+
+/** \brief In-place LU decomposition with partial pivoting
+ *
+ * \return 0 if succeeded and -1 if the matrix is singular
+ */
+static int
+lu_decompose(int n, Rarray a, int * pivots)
+{
+    int
+        i,
+        j,
+        k,
+        p;
+    double
+        swap;
+
+    for (k = 0; k < n; k++)
+    {
+        p = k;
+        for (i = k + 1; i < n; i++)
+        {
+            if (fabs(a[i * n + k]) > fabs(a[p * n + k])) p = i;
+        }
+        pivots[k] = p;
+        if (a[p * n + k] == 0) return -1;
+        if (p != k)
+        {
+            for (j = 0; j < n; j++)
+            {
+                swap = a[k * n + j];
+                a[k * n + j] = a[p * n + j];
+                a[p * n + j] = swap;
+            }
+        }
+        for (i = k + 1; i < n; i++)
+        {
+            a[i * n + k] = a[i * n + k] / a[k * n + k];
+            for (j = k + 1; j < n; j++)
+            {
+                a[i * n + j] = a[i * n + j] - a[i * n + k] * a[k * n + j];
+            }
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Solve in-place the linear system `a * x = b` with `a` from LU */
+static void
+lu_solve(int n, Rarray a, int * pivots, Rarray b)
+{
+    int
+        i,
+        j;
+    double
+        swap;
+
+    for (i = 0; i < n; i++)
+    {
+        if (pivots[i] != i)
+        {
+            swap = b[i];
+            b[i] = b[pivots[i]];
+            b[pivots[i]] = swap;
+        }
+    }
+    for (i = 1; i < n; i++)
+    {
+        for (j = 0; j < i; j++) b[i] = b[i] - a[i * n + j] * b[j];
+    }
+    for (i = n - 1; i >= 0; i--)
+    {
+        for (j = i + 1; j < n; j++) b[i] = b[i] - a[i * n + j] * b[j];
+        b[i] = b[i] / a[i * n + i];
+    }
+}
+
+
+/** \brief Set `lu` with decomposition of `I - hb * jac` */
+static int
+real_bdf_factorize(RealWorkspaceBDF ws, double hb)
+{
+    int
+        i,
+        n;
+
+    n = ws->ms.system_size;
+    for (i = 0; i < n * n; i++) ws->lu[i] = - hb * ws->jac[i];
+    for (i = 0; i < n; i++) ws->lu[i * n + i] = 1.0 + ws->lu[i * n + i];
+    ws->hb_lu = hb;
+    STATS_ADD(ws->ms.stats, lu_decomps, 1);
+    ws->lu_ready = (lu_decompose(n, ws->lu, ws->pivots) == 0);
+    return ws->lu_ready;
+}
+
+
+/** \brief Evaluate Jacobian at predictor with user routine or finite diff. */
+static void
+real_bdf_jacobian(
+        double x,
+        real_odesys_der yprime,
+        real_odesys_jac jac,
+        void * args,
+        RealWorkspaceBDF ws,
+        Rarray y
+)
+{
+    Rarray
+        f0;
+    _RealODEInputParameters
+        sys_params;
+
+    sys_params.x = x;
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = ws->ms.system_size;
+    if (jac != NULL) jac(&sys_params, ws->jac);
+    else
+    {
+        f0 = ws->ms.prev_der;
+        STATS_RHS(ws->ms.stats, yprime(&sys_params, f0));
+        real_bdf_fd_jacobian(x, yprime, args, ws, y, f0);
+    }
+    STATS_ADD(ws->ms.stats, jac_evals, 1);
+    ws->jac_ready = 1;
+}
+
+
+/** \brief Set predictor in `ynext` by extrapolation of `k` previous steps */
+static void
+real_bdf_predict(RealWorkspaceBDF ws, int k, Rarray ynext)
+{
+    int
+        j;
+    Rarray
+        v[BDF_MAX_ORDER];
+    for (j = 0; j < k; j++) v[j] = real_multistep_prev_step(&ws->ms, j);
+    rarr_lincomb(ws->ms.system_size, NULL, 1.0, k, BDF_PRED[k - 1], v, ynext);
+}
+
+
+/** \brief Weighted root-mean-square norm of Newton correction */
+static double
+real_bdf_norm(RealWorkspaceBDF ws, Rarray y)
+{
+    int
+        i;
+    double
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->ms.system_size; i++)
+    {
+        e = ws->delta[i] / (ws->abs_tol + ws->rel_tol * fabs(y[i]));
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ws->ms.system_size);
+}
+
+
+/** \brief Modified Newton iterations for `y - hb * f(x, y) - psi = 0`
+ *
+ * On failure `ynext` has the last iterate before diverging corrections
+ *
+ * \return 0 if converged and -1 if diverged or too slow
+ */
+static int
+real_bdf_newton(
+        double x,
+        double hb,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceBDF ws,
+        Rarray ynext
+)
+{
+    int
+        i,
+        n;
+    unsigned int
+        m;
+    double
+        dnorm,
+        dnorm_old,
+        rate;
+    Rarray
+        fder;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->ms.system_size;
+    fder = ws->ms.prev_der;
+    sys_params.x = x;
+    sys_params.y = ynext;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+
+    rate = ws->conv_rate;
+    dnorm_old = 0;
+    for (m = 0; m < ws->max_iter; m++)
+    {
+        STATS_RHS(ws->ms.stats, yprime(&sys_params, fder));
+        for (i = 0; i < n; i++)
+        {
+            ws->delta[i] = ws->psi[i] + hb * fder[i] - ynext[i];
+        }
+        lu_solve(n, ws->lu, ws->pivots, ws->delta);
+        for (i = 0; i < n; i++) ynext[i] = ynext[i] + ws->delta[i];
+        STATS_ADD(ws->ms.stats, iterations, 1);
+        dnorm = real_bdf_norm(ws, ynext);
+        if (isnan(dnorm) || (m > 0 && dnorm > BDF_MAX_RATE * dnorm_old))
+        {
+            /* diverging: keep the last iterate before this correction */
+            for (i = 0; i < n; i++) ynext[i] = ynext[i] - ws->delta[i];
+            return -1;
+        }
+        if (m > 0) rate = fmax(0.2 * rate, dnorm / dnorm_old);
+        if (dnorm * fmin(1.0, 1.5 * rate) <= 1.0)
+        {
+            ws->conv_rate = rate;
+            return 0;
+        }
+        dnorm_old = dnorm;
+    }
+    return -1;
+}
+
+
+int
+real_bdf_step(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        real_odesys_jac jac,
+        void * args,
+        RealWorkspaceBDF ws,
+        Rarray ynext
+)
+{
+    int
+        j,
+        k,
+        njac;
+    double
+        hb;
+    Rarray
+        v[BDF_MAX_ORDER];
+
+    STATS_BEGIN(ws->ms.stats);
+    k = ws->nsteps < ws->ms.ms_order ? ws->nsteps : ws->ms.ms_order;
+    hb = h * BDF_B[k - 1];
+    ws->order = k;
+
+    /* known part of implicit equation from previous steps */
+    for (j = 0; j < k; j++) v[j] = real_multistep_prev_step(&ws->ms, j);
+    rarr_lincomb(ws->ms.system_size, NULL, 1.0, k, BDF_A[k - 1], v, ws->psi);
+    real_bdf_predict(ws, k, ynext);
+
+    njac = 0;
+    if (!ws->jac_ready)
+    {
+        real_bdf_jacobian(x + h, yprime, jac, args, ws, ynext);
+        njac++;
+    }
+    if (!ws->lu_ready || fabs(hb / ws->hb_lu - 1) > BDF_HB_CHANGE)
+    {
+        real_bdf_factorize(ws, hb);
+    }
+
+    while (!ws->lu_ready || real_bdf_newton(x + h, hb, yprime, args, ws, ynext))
+    {
+        /* convergence degraded: update the matrix at the last iterate */
+        if (njac == BDF_MAX_JAC_STEP)
+        {
+            STATS_ADD(ws->ms.stats, rejected, 1);
+            STATS_END(ws->ms.stats);
+            return -1;
+        }
+        if (!ws->lu_ready) real_bdf_predict(ws, k, ynext);
+        real_bdf_jacobian(x + h, yprime, jac, args, ws, ynext);
+        njac++;
+        real_bdf_factorize(ws, hb);
+        ws->conv_rate = 0.7;
+    }
+
+    /* append solution to history overwriting the oldest step */
+    ws->ms.head = (ws->ms.head + ws->ms.ms_order - 1) % ws->ms.ms_order;
+    v[0] = real_multistep_prev_step(&ws->ms, 0);
+    rarr_copy_values(ws->ms.system_size, ynext, v[0]);
+    if (ws->nsteps < ws->ms.ms_order) ws->nsteps++;
+    STATS_ADD(ws->ms.stats, steps, 1);
+    STATS_END(ws->ms.stats);
+    return 0;
+}
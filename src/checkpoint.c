@@ -0,0 +1,429 @@
+/**
+ * \file checkpoint.c
+ * \author Alex Andriati
+ * \brief Source code of checkpoint and restart of multistep state
+ *
+ * See function signature and description in header checkpoint.h
+ * Real and complex states share the same routines working on bytes,
+ * where each chunk is one previous step (or derivative) of system size.
+ * The chunks are given in order from the most recent step, thus the
+ * circular buffers of history mode are written without any copy and
+ * restored in the order of a fresh workspace (`head = 0`)
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+#define CHECKPOINT_MAGIC "ODESYSCK"
+#define CHECKPOINT_ENDIAN_TAG 0x01020304u
+
+
+/** \brief Header of checkpoint file (48 bytes without padding) */
+typedef struct{
+    char
+        magic[8];
+    uint32_t
+        version,
+        endian,
+        is_complex;
+    int32_t
+        method;
+    uint32_t
+        ms_order,
+        system_size;
+    double
+        h,
+        x;
+} _CheckpointHeader;
+
+
+static uint32_t
+swap_uint32(uint32_t v)
+{
+    return ((v & 0xFFu) << 24) | ((v & 0xFF00u) << 8)
+         | ((v >> 8) & 0xFF00u) | (v >> 24);
+}
+
+
+/** \brief Copy `n` doubles from `from` to `to` reversing their bytes */
+static void
+copy_swapped_doubles(size_t n, const unsigned char * from, unsigned char * to)
+{
+    size_t
+        i;
+    int
+        b;
+    for (i = 0; i < n; i++)
+    {
+        for (b = 0; b < 8; b++) to[8 * i + b] = from[8 * i + 7 - b];
+    }
+}
+
+
+/** \brief Write all buffers, resuming after partial writes or signals */
+static int
+writev_all(int fd, struct iovec * iov, int iovcnt)
+{
+    ssize_t
+        n;
+    while (iovcnt > 0)
+    {
+        n = writev(fd, iov, iovcnt);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        while (iovcnt > 0 && (size_t) n >= iov->iov_len)
+        {
+            n -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0)
+        {
+            iov->iov_base = (char *) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+    return 0;
+}
+
+
+/** \brief Write header and chunks to temporary file and rename it
+ *
+ * \param 8 : number of bytes of each chunk
+ * \param 9 : addresses of previous steps, most recent first
+ * \param 10: addresses of derivatives, most recent first
+ */
+static int
+write_checkpoint(
+        const char * fname,
+        uint32_t is_complex,
+        int method,
+        double h,
+        double x,
+        unsigned int ms_order,
+        unsigned int sys_size,
+        size_t chunk_bytes,
+        void ** ychunk,
+        void ** dchunk
+)
+{
+    int
+        fd,
+        status;
+    unsigned int
+        j;
+    char
+        * tmpname;
+    struct iovec
+        * iov;
+    _CheckpointHeader
+        header;
+
+    memset(&header, 0, sizeof(_CheckpointHeader));
+    memcpy(header.magic, CHECKPOINT_MAGIC, 8);
+    header.version = CHECKPOINT_VERSION;
+    header.endian = CHECKPOINT_ENDIAN_TAG;
+    header.is_complex = is_complex;
+    header.method = method;
+    header.ms_order = ms_order;
+    header.system_size = sys_size;
+    header.h = h;
+    header.x = x;
+
+    iov = (struct iovec *) malloc((2 * ms_order + 1) * sizeof(struct iovec));
+    tmpname = (char *) malloc(strlen(fname) + 5);
+    if (iov == NULL || tmpname == NULL)
+    {
+        printf("\n\nProblem in checkpoint buffers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    iov[0].iov_base = &header;
+    iov[0].iov_len = sizeof(_CheckpointHeader);
+    for (j = 0; j < ms_order; j++)
+    {
+        iov[1 + j].iov_base = ychunk[j];
+        iov[1 + j].iov_len = chunk_bytes;
+        iov[1 + ms_order + j].iov_base = dchunk[j];
+        iov[1 + ms_order + j].iov_len = chunk_bytes;
+    }
+
+    /* the previous checkpoint is only replaced by a complete file */
+    strcpy(tmpname, fname);
+    strcat(tmpname, ".tmp");
+    status = -1;
+    fd = open(tmpname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+        status = writev_all(fd, iov, 2 * ms_order + 1);
+        if (status == 0) status = fsync(fd);
+        if (close(fd) != 0) status = -1;
+        if (status == 0) status = rename(tmpname, fname);
+        if (status != 0) unlink(tmpname);
+    }
+    free(tmpname);
+    free(iov);
+    return status == 0 ? 0 : -1;
+}
+
+
+/** \brief Map file, check header against workspace and copy the chunks
+ *
+ * See `write_checkpoint` for the chunk parameters, here as output
+ */
+static int
+read_checkpoint(
+        const char * fname,
+        uint32_t is_complex,
+        int * method,
+        double * h,
+        double * x,
+        unsigned int ms_order,
+        unsigned int sys_size,
+        size_t chunk_bytes,
+        void ** ychunk,
+        void ** dchunk
+)
+{
+    int
+        fd,
+        swap;
+    unsigned int
+        j;
+    size_t
+        file_bytes;
+    unsigned char
+        * data,
+        * src,
+        * dest;
+    struct stat
+        st;
+    _CheckpointHeader
+        header;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(header))
+    {
+        close(fd);
+        return -1;
+    }
+    file_bytes = st.st_size;
+    data = (unsigned char *) mmap(NULL, file_bytes, PROT_READ, MAP_PRIVATE,
+            fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+
+    memcpy(&header, data, sizeof(header));
+    swap = header.endian != CHECKPOINT_ENDIAN_TAG;
+    if (swap)
+    {
+        header.version = swap_uint32(header.version);
+        header.endian = swap_uint32(header.endian);
+        header.is_complex = swap_uint32(header.is_complex);
+        header.method = (int32_t) swap_uint32((uint32_t) header.method);
+        header.ms_order = swap_uint32(header.ms_order);
+        header.system_size = swap_uint32(header.system_size);
+        copy_swapped_doubles(1, data + offsetof(_CheckpointHeader, h),
+                (unsigned char *) &header.h);
+        copy_swapped_doubles(1, data + offsetof(_CheckpointHeader, x),
+                (unsigned char *) &header.x);
+    }
+    if (memcmp(header.magic, CHECKPOINT_MAGIC, 8) != 0
+            || header.endian != CHECKPOINT_ENDIAN_TAG
+            || header.version != CHECKPOINT_VERSION
+            || header.is_complex != is_complex
+            || header.ms_order != ms_order
+            || header.system_size != sys_size
+            || file_bytes != sizeof(header) + 2 * ms_order * chunk_bytes)
+    {
+        munmap(data, file_bytes);
+        return -1;
+    }
+
+    for (j = 0; j < 2 * ms_order; j++)
+    {
+        src = data + sizeof(header) + j * chunk_bytes;
+        if (j < ms_order) dest = (unsigned char *) ychunk[j];
+        else              dest = (unsigned char *) dchunk[j - ms_order];
+        if (swap) copy_swapped_doubles(chunk_bytes / 8, src, dest);
+        else      memcpy(dest, src, chunk_bytes);
+    }
+    munmap(data, file_bytes);
+    if (method != NULL) *method = header.method;
+    *h = header.h;
+    *x = header.x;
+    return 0;
+}
+
+
+int
+cplx_multistep_checkpoint(
+        const char * fname,
+        int method,
+        double h,
+        double x,
+        ComplexWorkspaceMS ws,
+        Carray y
+)
+{
+    int
+        j,
+        s,
+        status;
+    void
+        ** chunk;
+
+    s = ws->system_size;
+    chunk = (void **) malloc(2 * ws->ms_order * sizeof(void *));
+    if (chunk == NULL)
+    {
+        printf("\n\nProblem in checkpoint buffers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) chunk[j] = cplx_multistep_prev_step(ws, j);
+        else                   chunk[j] = &y[j * s];
+        chunk[ws->ms_order + j] = cplx_multistep_prev_der(ws, j);
+    }
+    status = write_checkpoint(
+            fname, 1, method, h, x, ws->ms_order, s,
+            s * sizeof(double complex), chunk, &chunk[ws->ms_order]
+    );
+    free(chunk);
+    return status;
+}
+
+
+int
+real_multistep_checkpoint(
+        const char * fname,
+        int method,
+        double h,
+        double x,
+        RealWorkspaceMS ws,
+        Rarray y
+)
+{
+    int
+        j,
+        s,
+        status;
+    void
+        ** chunk;
+
+    s = ws->system_size;
+    chunk = (void **) malloc(2 * ws->ms_order * sizeof(void *));
+    if (chunk == NULL)
+    {
+        printf("\n\nProblem in checkpoint buffers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) chunk[j] = real_multistep_prev_step(ws, j);
+        else                   chunk[j] = &y[j * s];
+        chunk[ws->ms_order + j] = real_multistep_prev_der(ws, j);
+    }
+    status = write_checkpoint(
+            fname, 0, method, h, x, ws->ms_order, s,
+            s * sizeof(double), chunk, &chunk[ws->ms_order]
+    );
+    free(chunk);
+    return status;
+}
+
+
+int
+cplx_multistep_restore(
+        const char * fname,
+        int * method,
+        double * h,
+        double * x,
+        ComplexWorkspaceMS ws,
+        Carray y
+)
+{
+    int
+        j,
+        s,
+        status;
+    void
+        ** chunk;
+
+    s = ws->system_size;
+    chunk = (void **) malloc(2 * ws->ms_order * sizeof(void *));
+    if (chunk == NULL)
+    {
+        printf("\n\nProblem in checkpoint buffers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    /* fresh order, the most recent step at chunk zero */
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) chunk[j] = &ws->yhist[j * s];
+        else                   chunk[j] = &y[j * s];
+        chunk[ws->ms_order + j] = &ws->prev_der[j * s];
+    }
+    status = read_checkpoint(
+            fname, 1, method, h, x, ws->ms_order, s,
+            s * sizeof(double complex), chunk, &chunk[ws->ms_order]
+    );
+    if (status == 0) ws->head = 0;
+    free(chunk);
+    return status;
+}
+
+
+int
+real_multistep_restore(
+        const char * fname,
+        int * method,
+        double * h,
+        double * x,
+        RealWorkspaceMS ws,
+        Rarray y
+)
+{
+    int
+        j,
+        s,
+        status;
+    void
+        ** chunk;
+
+    s = ws->system_size;
+    chunk = (void **) malloc(2 * ws->ms_order * sizeof(void *));
+    if (chunk == NULL)
+    {
+        printf("\n\nProblem in checkpoint buffers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    /* fresh order, the most recent step at chunk zero */
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) chunk[j] = &ws->yhist[j * s];
+        else                   chunk[j] = &y[j * s];
+        chunk[ws->ms_order + j] = &ws->prev_der[j * s];
+    }
+    status = read_checkpoint(
+            fname, 0, method, h, x, ws->ms_order, s,
+            s * sizeof(double), chunk, &chunk[ws->ms_order]
+    );
+    if (status == 0) ws->head = 0;
+    free(chunk);
+    return status;
+}
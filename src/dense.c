@@ -0,0 +1,788 @@
+/**
+ * \file dense.c
+ * \author Alex Andriati
+ * \brief Source code of dense output interpolants
+ *
+ * See function signature and description in header dense.h
+ * The continuous extensions are given by the polynomials `B(t) = t b(t)`
+ * of each stage, such that the solution inside the step is
+ *
+ *      y(x + t h) = y(x + h) + h * sum (B(t) - B(1)) k
+ *
+ * which only requires the solution at the end of the step. The ones of
+ * `*_rungekutta5`, Cash-Karp and Bogacki-Shampine are the unique cubic
+ * polynomials satisfying the 3rd order conditions for all `t` with the
+ * first stage as derivative at `x` and the last stage evaluated at
+ * `x + h` as derivative at `x + h`. Refs
+ *
+ * [1] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ * [2] L.F. Shampine, Interpolation for Runge-Kutta methods, SIAM J. Numer.
+ * Anal. 22 (1985) 1014-1027
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "dense.h"
+#include "arrays_assistant.h"
+#include "kernels.h"
+
+/** \brief Max number of stages of methods with continuous extension */
+#define DENSE_MAX_STAGES 7
+
+
+/* Heun's method, 2nd order */
+static const double
+    RK2_DENSE[2 * 2] = {
+    1.0, - 1.0 / 2,
+    0, 1.0 / 2
+};
+
+/* Classical 4th order method, 3rd order extension of ref. [1] sec. II.6 */
+static const double
+    RK4_DENSE[4 * 3] = {
+    1.0, - 3.0 / 2, 2.0 / 3,
+    0, 1.0, - 2.0 / 3,
+    0, 1.0, - 2.0 / 3,
+    0, - 1.0 / 2, 2.0 / 3
+};
+
+/* Butcher 5th order method, 3rd order extension */
+static const double
+    RK5_DENSE[6 * 3] = {
+    1.0, - 53.0 / 30, 38.0 / 45,
+    0, 0, 0,
+    0, 16.0 / 15, - 32.0 / 45,
+    0, 2.0 / 5, - 4.0 / 15,
+    0, 16.0 / 15, - 32.0 / 45,
+    0, - 23.0 / 30, 38.0 / 45
+};
+
+/* Cash-Karp 5th order solution, 3rd order extension */
+static const double
+    CASH_KARP_DENSE[6 * 3] = {
+    1.0, - 215.0 / 126, 152.0 / 189,
+    0, 0, 0,
+    0, 250.0 / 207, - 500.0 / 621,
+    0, 125.0 / 198, - 125.0 / 297,
+    0, - 1.0, 1.0,
+    0, 1536.0 / 1771, - 1024.0 / 1771
+};
+
+/* Bogacki-Shampine, cubic Hermite with the FSAL stage */
+static const double
+    BOGACKI_SHAMPINE_DENSE[4 * 3] = {
+    1.0, - 4.0 / 3, 5.0 / 9,
+    0, 1.0, - 2.0 / 3,
+    0, 4.0 / 3, - 8.0 / 9,
+    0, - 1.0, 1.0
+};
+
+/* Dormand-Prince, 4th order extension of ref. [2] (also ref. [1] sec.
+ * II.6 and code DOPRI5 written in this form) */
+static const double
+    DORMAND_PRINCE_DENSE[7 * 4] = {
+    1.0, - 8048581381.0 / 2820520608, 8663915743.0 / 2820520608,
+    - 12715105075.0 / 11282082432,
+    0, 0, 0, 0,
+    0, 131558114200.0 / 32700410799, - 68118460800.0 / 10900136933,
+    87487479700.0 / 32700410799,
+    0, - 1754552775.0 / 470086768, 14199869525.0 / 1410260304,
+    - 10690763975.0 / 1880347072,
+    0, 127303824393.0 / 49829197408, - 318862633887.0 / 49829197408,
+    701980252875.0 / 199316789632,
+    0, - 282668133.0 / 205662961, 2019193451.0 / 616988883,
+    - 1453857185.0 / 822651844,
+    0, 40617522.0 / 29380423, - 110615467.0 / 29380423,
+    69997945.0 / 29380423
+};
+
+/* Quintic Hermite basis in `t` with nodes at t = -1, 0, 1. Rows are the
+ * coefficients of `t^0` to `t^5` multiplying y(-1), y(0), y(1) and the
+ * derivatives in `t` (the ones in `x` times `h`) at the same nodes */
+static const double
+    HERMITE5_BASIS[6 * 6] = {
+    0, 0, 1.0, - 5.0 / 4, - 1.0 / 2, 3.0 / 4,
+    1.0, 0, - 2.0, 0, 1.0, 0,
+    0, 0, 1.0, 5.0 / 4, - 1.0 / 2, - 3.0 / 4,
+    0, 0, 1.0 / 4, - 1.0 / 4, - 1.0 / 4, 1.0 / 4,
+    0, 1.0, 0, - 2.0, 0, 1.0,
+    0, 0, - 1.0 / 4, - 1.0 / 4, 1.0 / 4, 1.0 / 4
+};
+
+
+ComplexDenseOutput
+get_cplx_dense_ws(int sys_size)
+{
+    ComplexDenseOutput
+        dense;
+    dense = (ComplexDenseOutput) malloc(sizeof(_ComplexDenseOutput));
+    if (dense == NULL)
+    {
+        printf("\n\nProblem in ComplexDenseOutput allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    dense->system_size = sys_size;
+    dense->degree = 0;
+    dense->x = 0;
+    dense->h = 1;
+    dense->coef = alloc_carr((DENSE_MAX_DEGREE + 1) * sys_size);
+    return dense;
+}
+
+
+RealDenseOutput
+get_real_dense_ws(int sys_size)
+{
+    RealDenseOutput
+        dense;
+    dense = (RealDenseOutput) malloc(sizeof(_RealDenseOutput));
+    if (dense == NULL)
+    {
+        printf("\n\nProblem in RealDenseOutput allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    dense->system_size = sys_size;
+    dense->degree = 0;
+    dense->x = 0;
+    dense->h = 1;
+    dense->coef = alloc_rarr((DENSE_MAX_DEGREE + 1) * sys_size);
+    return dense;
+}
+
+
+void
+destroy_cplx_dense_ws(ComplexDenseOutput dense)
+{
+    free(dense->coef);
+    free(dense);
+}
+
+
+void
+destroy_real_dense_ws(RealDenseOutput dense)
+{
+    free(dense->coef);
+    free(dense);
+}
+
+
+void
+cplx_dense_eval_at(ComplexDenseOutput dense, double x, Carray y)
+{
+    int
+        i,
+        p,
+        n;
+    double
+        t;
+    double complex
+        acc;
+    Carray
+        c;
+
+    n = dense->system_size;
+    c = dense->coef;
+    t = (x - dense->x) / dense->h;
+    for (i = 0; i < n; i++)
+    {
+        acc = c[dense->degree * n + i];
+        for (p = dense->degree - 1; p >= 0; p--)
+        {
+            acc = acc * t + c[p * n + i];
+        }
+        y[i] = acc;
+    }
+}
+
+
+void
+real_dense_eval_at(RealDenseOutput dense, double x, Rarray y)
+{
+    int
+        i,
+        p,
+        n;
+    double
+        t,
+        acc;
+    Rarray
+        c;
+
+    n = dense->system_size;
+    c = dense->coef;
+    t = (x - dense->x) / dense->h;
+    for (i = 0; i < n; i++)
+    {
+        acc = c[dense->degree * n + i];
+        for (p = dense->degree - 1; p >= 0; p--)
+        {
+            acc = acc * t + c[p * n + i];
+        }
+        y[i] = acc;
+    }
+}
+
+
+/** \brief Set polynomial coefficient `p` as combination of arrays
+ *
+ * Only the nonzero weights (taken with stride `stride`) enter in the
+ * vector kernel. If all of them are zero the coefficient is zero
+ */
+static void
+cplx_dense_coef(
+        ComplexDenseOutput dense,
+        int p,
+        Carray base,
+        double scale,
+        int nterms,
+        const double * weights,
+        int stride,
+        Carray * v
+)
+{
+    int
+        i,
+        n;
+    double
+        w[DENSE_MAX_STAGES];
+    Carray
+        vnz[DENSE_MAX_STAGES],
+        out;
+
+    out = &dense->coef[p * dense->system_size];
+    n = 0;
+    for (i = 0; i < nterms; i++)
+    {
+        if (weights[i * stride] == 0) continue;
+        w[n] = weights[i * stride];
+        vnz[n] = v[i];
+        n++;
+    }
+    if (n > 0)
+    {
+        carr_lincomb(dense->system_size, base, scale, n, w, vnz, out);
+        return;
+    }
+    for (i = 0; i < dense->system_size; i++)
+    {
+        out[i] = base == NULL ? 0 : base[i];
+    }
+}
+
+
+/** \brief Set polynomial coefficient `p` as combination of arrays
+ *
+ * Only the nonzero weights (taken with stride `stride`) enter in the
+ * vector kernel. If all of them are zero the coefficient is zero
+ */
+static void
+real_dense_coef(
+        RealDenseOutput dense,
+        int p,
+        Rarray base,
+        double scale,
+        int nterms,
+        const double * weights,
+        int stride,
+        Rarray * v
+)
+{
+    int
+        i,
+        n;
+    double
+        w[DENSE_MAX_STAGES];
+    Rarray
+        vnz[DENSE_MAX_STAGES],
+        out;
+
+    out = &dense->coef[p * dense->system_size];
+    n = 0;
+    for (i = 0; i < nterms; i++)
+    {
+        if (weights[i * stride] == 0) continue;
+        w[n] = weights[i * stride];
+        vnz[n] = v[i];
+        n++;
+    }
+    if (n > 0)
+    {
+        rarr_lincomb(dense->system_size, base, scale, n, w, vnz, out);
+        return;
+    }
+    for (i = 0; i < dense->system_size; i++)
+    {
+        out[i] = base == NULL ? 0 : base[i];
+    }
+}
+
+
+/** \brief Set continuous extension from stages and `B(t)` coefficients
+ *
+ * \param 5 : `stages x degree` row-major coefficients of `t` to `t^degree`
+ */
+static void
+cplx_dense_from_stages(
+        double h,
+        double x,
+        int stages,
+        int degree,
+        const double * bpoly,
+        Carray * k,
+        Carray ynext,
+        ComplexDenseOutput dense
+)
+{
+    int
+        i,
+        p;
+    double
+        b[DENSE_MAX_STAGES];
+
+    dense->x = x;
+    dense->h = h;
+    dense->degree = degree;
+    /* the weights of the step b = B(1) give back the solution at `x` */
+    for (i = 0; i < stages; i++)
+    {
+        b[i] = 0;
+        for (p = 0; p < degree; p++) b[i] += bpoly[i * degree + p];
+    }
+    cplx_dense_coef(dense, 0, ynext, - h, stages, b, 1, k);
+    for (p = 1; p <= degree; p++)
+    {
+        cplx_dense_coef(dense, p, NULL, h, stages, &bpoly[p - 1], degree, k);
+    }
+}
+
+
+/** \brief Set continuous extension from stages and `B(t)` coefficients
+ *
+ * \param 5 : `stages x degree` row-major coefficients of `t` to `t^degree`
+ */
+static void
+real_dense_from_stages(
+        double h,
+        double x,
+        int stages,
+        int degree,
+        const double * bpoly,
+        Rarray * k,
+        Rarray ynext,
+        RealDenseOutput dense
+)
+{
+    int
+        i,
+        p;
+    double
+        b[DENSE_MAX_STAGES];
+
+    dense->x = x;
+    dense->h = h;
+    dense->degree = degree;
+    /* the weights of the step b = B(1) give back the solution at `x` */
+    for (i = 0; i < stages; i++)
+    {
+        b[i] = 0;
+        for (p = 0; p < degree; p++) b[i] += bpoly[i * degree + p];
+    }
+    real_dense_coef(dense, 0, ynext, - h, stages, b, 1, k);
+    for (p = 1; p <= degree; p++)
+    {
+        real_dense_coef(dense, p, NULL, h, stages, &bpoly[p - 1], degree, k);
+    }
+}
+
+
+void
+cplx_dense_hermite3(
+        double h,
+        double x,
+        Carray y0,
+        Carray f0,
+        Carray y1,
+        Carray f1,
+        ComplexDenseOutput dense
+)
+{
+    double
+        w2[4] = {- 3.0, 3.0, - 2.0, - 1.0},
+        w3[4] = {2.0, - 2.0, 1.0, 1.0},
+        one = 1.0;
+    Carray
+        v[4];
+
+    dense->x = x;
+    dense->h = h;
+    dense->degree = 3;
+    v[0] = y0;
+    v[1] = y1;
+    v[2] = f0;
+    v[3] = f1;
+    w2[2] *= h;
+    w2[3] *= h;
+    w3[2] *= h;
+    w3[3] *= h;
+    carr_copy_values(dense->system_size, y0, dense->coef);
+    cplx_dense_coef(dense, 1, NULL, h, 1, &one, 1, &f0);
+    cplx_dense_coef(dense, 2, NULL, 1.0, 4, w2, 1, v);
+    cplx_dense_coef(dense, 3, NULL, 1.0, 4, w3, 1, v);
+}
+
+
+void
+real_dense_hermite3(
+        double h,
+        double x,
+        Rarray y0,
+        Rarray f0,
+        Rarray y1,
+        Rarray f1,
+        RealDenseOutput dense
+)
+{
+    double
+        w2[4] = {- 3.0, 3.0, - 2.0, - 1.0},
+        w3[4] = {2.0, - 2.0, 1.0, 1.0},
+        one = 1.0;
+    Rarray
+        v[4];
+
+    dense->x = x;
+    dense->h = h;
+    dense->degree = 3;
+    v[0] = y0;
+    v[1] = y1;
+    v[2] = f0;
+    v[3] = f1;
+    w2[2] *= h;
+    w2[3] *= h;
+    w3[2] *= h;
+    w3[3] *= h;
+    rarr_copy_values(dense->system_size, y0, dense->coef);
+    real_dense_coef(dense, 1, NULL, h, 1, &one, 1, &f0);
+    real_dense_coef(dense, 2, NULL, 1.0, 4, w2, 1, v);
+    real_dense_coef(dense, 3, NULL, 1.0, 4, w3, 1, v);
+}
+
+
+void
+cplx_dense_rungekutta2(
+        double h,
+        double x,
+        ComplexWorkspaceRK ws,
+        Carray ynext,
+        ComplexDenseOutput dense
+)
+{
+    Carray
+        k[2];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    cplx_dense_from_stages(h, x, 2, 2, RK2_DENSE, k, ynext, dense);
+}
+
+
+void
+cplx_dense_rungekutta4(
+        double h,
+        double x,
+        ComplexWorkspaceRK ws,
+        Carray ynext,
+        ComplexDenseOutput dense
+)
+{
+    Carray
+        k[4];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    k[2] = ws->work3;
+    k[3] = ws->work4;
+    cplx_dense_from_stages(h, x, 4, 3, RK4_DENSE, k, ynext, dense);
+}
+
+
+void
+cplx_dense_rungekutta5(
+        double h,
+        double x,
+        ComplexWorkspaceRK ws,
+        Carray ynext,
+        ComplexDenseOutput dense
+)
+{
+    Carray
+        k[6];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    k[2] = ws->work3;
+    k[3] = ws->work4;
+    k[4] = ws->work5;
+    k[5] = ws->work6;
+    cplx_dense_from_stages(h, x, 6, 3, RK5_DENSE, k, ynext, dense);
+}
+
+
+void
+cplx_dense_adaptive(
+        double xprev,
+        double x,
+        ComplexWorkspaceAdaptive ws,
+        Carray y,
+        ComplexDenseOutput dense
+)
+{
+    double
+        h;
+    ComplexWorkspaceRK
+        rk;
+    Carray
+        k[7];
+
+    h = x - xprev;
+    rk = ws->rk;
+    k[1] = rk->work2;
+    k[2] = rk->work3;
+    switch (ws->method)
+    {
+        case BOGACKI_SHAMPINE_32:
+            /* first and last stages exchanged by the driver (FSAL) */
+            k[0] = rk->work4;
+            k[3] = rk->work1;
+            cplx_dense_from_stages(
+                    h, xprev, 4, 3, BOGACKI_SHAMPINE_DENSE, k, y, dense
+            );
+            break;
+        case CASH_KARP_54:
+            k[0] = rk->work1;
+            k[3] = rk->work4;
+            k[4] = rk->work5;
+            k[5] = rk->work6;
+            cplx_dense_from_stages(
+                    h, xprev, 6, 3, CASH_KARP_DENSE, k, y, dense
+            );
+            break;
+        default:
+            k[0] = rk->work7;
+            k[3] = rk->work4;
+            k[4] = rk->work5;
+            k[5] = rk->work6;
+            k[6] = rk->work1;
+            cplx_dense_from_stages(
+                    h, xprev, 7, 4, DORMAND_PRINCE_DENSE, k, y, dense
+            );
+    }
+}
+
+
+void
+cplx_dense_multistep(
+        double h,
+        double x,
+        ComplexWorkspaceMS ws,
+        Carray y,
+        ComplexDenseOutput dense
+)
+{
+    int
+        j,
+        p,
+        s;
+    double
+        w[6];
+    Carray
+        v[6];
+
+    if (ws->ms_order < 2)
+    {
+        printf("\n\nDense output of multistep requires at least two "
+               "previous steps, but order is %d\n\n", ws->ms_order);
+        exit(EXIT_FAILURE);
+    }
+    s = ws->system_size;
+    for (j = 0; j < 3 && j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) v[2 - j] = cplx_multistep_prev_step(ws, j);
+        else                   v[2 - j] = &y[j * s];
+        v[5 - j] = cplx_multistep_prev_der(ws, j);
+    }
+    if (ws->ms_order < 3)
+    {
+        cplx_dense_hermite3(h, x - h, v[1], v[4], v[2], v[5], dense);
+        return;
+    }
+    dense->x = x - h;
+    dense->h = h;
+    dense->degree = 5;
+    for (p = 0; p <= 5; p++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            w[j] = HERMITE5_BASIS[j * 6 + p];
+            if (j > 2) w[j] *= h;
+        }
+        cplx_dense_coef(dense, p, NULL, 1.0, 6, w, 1, v);
+    }
+}
+
+
+void
+real_dense_rungekutta2(
+        double h,
+        double x,
+        RealWorkspaceRK ws,
+        Rarray ynext,
+        RealDenseOutput dense
+)
+{
+    Rarray
+        k[2];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    real_dense_from_stages(h, x, 2, 2, RK2_DENSE, k, ynext, dense);
+}
+
+
+void
+real_dense_rungekutta4(
+        double h,
+        double x,
+        RealWorkspaceRK ws,
+        Rarray ynext,
+        RealDenseOutput dense
+)
+{
+    Rarray
+        k[4];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    k[2] = ws->work3;
+    k[3] = ws->work4;
+    real_dense_from_stages(h, x, 4, 3, RK4_DENSE, k, ynext, dense);
+}
+
+
+void
+real_dense_rungekutta5(
+        double h,
+        double x,
+        RealWorkspaceRK ws,
+        Rarray ynext,
+        RealDenseOutput dense
+)
+{
+    Rarray
+        k[6];
+    k[0] = ws->work1;
+    k[1] = ws->work2;
+    k[2] = ws->work3;
+    k[3] = ws->work4;
+    k[4] = ws->work5;
+    k[5] = ws->work6;
+    real_dense_from_stages(h, x, 6, 3, RK5_DENSE, k, ynext, dense);
+}
+
+
+void
+real_dense_adaptive(
+        double xprev,
+        double x,
+        RealWorkspaceAdaptive ws,
+        Rarray y,
+        RealDenseOutput dense
+)
+{
+    double
+        h;
+    RealWorkspaceRK
+        rk;
+    Rarray
+        k[7];
+
+    h = x - xprev;
+    rk = ws->rk;
+    k[1] = rk->work2;
+    k[2] = rk->work3;
+    switch (ws->method)
+    {
+        case BOGACKI_SHAMPINE_32:
+            /* first and last stages exchanged by the driver (FSAL) */
+            k[0] = rk->work4;
+            k[3] = rk->work1;
+            real_dense_from_stages(
+                    h, xprev, 4, 3, BOGACKI_SHAMPINE_DENSE, k, y, dense
+            );
+            break;
+        case CASH_KARP_54:
+            k[0] = rk->work1;
+            k[3] = rk->work4;
+            k[4] = rk->work5;
+            k[5] = rk->work6;
+            real_dense_from_stages(
+                    h, xprev, 6, 3, CASH_KARP_DENSE, k, y, dense
+            );
+            break;
+        default:
+            k[0] = rk->work7;
+            k[3] = rk->work4;
+            k[4] = rk->work5;
+            k[5] = rk->work6;
+            k[6] = rk->work1;
+            real_dense_from_stages(
+                    h, xprev, 7, 4, DORMAND_PRINCE_DENSE, k, y, dense
+            );
+    }
+}
+
+
+void
+real_dense_multistep(
+        double h,
+        double x,
+        RealWorkspaceMS ws,
+        Rarray y,
+        RealDenseOutput dense
+)
+{
+    int
+        j,
+        p,
+        s;
+    double
+        w[6];
+    Rarray
+        v[6];
+
+    if (ws->ms_order < 2)
+    {
+        printf("\n\nDense output of multistep requires at least two "
+               "previous steps, but order is %d\n\n", ws->ms_order);
+        exit(EXIT_FAILURE);
+    }
+    s = ws->system_size;
+    for (j = 0; j < 3 && j < ws->ms_order; j++)
+    {
+        if (ws->yhist != NULL) v[2 - j] = real_multistep_prev_step(ws, j);
+        else                   v[2 - j] = &y[j * s];
+        v[5 - j] = real_multistep_prev_der(ws, j);
+    }
+    if (ws->ms_order < 3)
+    {
+        real_dense_hermite3(h, x - h, v[1], v[4], v[2], v[5], dense);
+        return;
+    }
+    dense->x = x - h;
+    dense->h = h;
+    dense->degree = 5;
+    for (p = 0; p <= 5; p++)
+    {
+        for (j = 0; j < 6; j++)
+        {
+            w[j] = HERMITE5_BASIS[j * 6 + p];
+            if (j > 2) w[j] *= h;
+        }
+        real_dense_coef(dense, p, NULL, 1.0, 6, w, 1, v);
+    }
+}
@@ -0,0 +1,1298 @@
+/**
+ * \file ensemble.c
+ * \author Alex Andriati
+ * \brief Source code for integration of ensembles of ODE systems
+ *
+ * See function signature and description in header ensemble.h
+ * The schemes are the same of singlestep.c and multistep.c, written for
+ * the whole ensemble in structure of arrays (SoA) layout. Therefore all
+ * stage combinations are single vector kernel calls over contiguous
+ * `system_size * ensemble_size` values, independent of the member each
+ * value belongs to (and of the layout). Member data is only forwarded
+ * to the derivative routine, updating the grid points of members before
+ * each call
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ensemble.h"
+#include "adams_coefficients.h"
+#include "kernels.h"
+
+
+EnsembleMembers
+get_ensemble_members(
+        int ens_size,
+        EnsembleLayout layout,
+        Rarray xshift,
+        void ** args
+)
+{
+    int
+        k;
+    EnsembleMembers
+        members;
+    members = (EnsembleMembers) malloc(sizeof(_EnsembleMembers));
+    if (members == NULL)
+    {
+        printf("\n\nProblem in EnsembleMembers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    members->ensemble_size = ens_size;
+    members->layout = layout;
+    members->xshift = NULL;
+    members->xmember = NULL;
+    members->args = NULL;
+    if (xshift != NULL)
+    {
+        members->xshift = (Rarray) malloc(2 * ens_size * sizeof(double));
+        if (members->xshift == NULL)
+        {
+            printf("\n\nProblem in EnsembleMembers allocation\n\n");
+            exit(EXIT_FAILURE);
+        }
+        members->xmember = &members->xshift[ens_size];
+        for (k = 0; k < ens_size; k++) members->xshift[k] = xshift[k];
+    }
+    if (args != NULL)
+    {
+        members->args = (void **) malloc(ens_size * sizeof(void *));
+        if (members->args == NULL)
+        {
+            printf("\n\nProblem in EnsembleMembers allocation\n\n");
+            exit(EXIT_FAILURE);
+        }
+        for (k = 0; k < ens_size; k++) members->args[k] = args[k];
+    }
+    return members;
+}
+
+
+void
+destroy_ensemble_members(EnsembleMembers members)
+{
+    if (members->xshift != NULL) free(members->xshift);
+    if (members->args != NULL) free(members->args);
+    free(members);
+}
+
+
+/** \brief Set strides of component and member according to layout */
+static void
+ensemble_member_strides(
+        EnsembleMembers members,
+        int sys_size,
+        int ens_size,
+        int * component_stride,
+        int * member_stride
+)
+{
+    *component_stride = ens_size;
+    *member_stride = 1;
+    if (members == NULL) return;
+    if (members->ensemble_size != ens_size)
+    {
+        printf("\n\nEnsembleMembers with %d members given to ensemble "
+               "of %d members\n\n", members->ensemble_size, ens_size);
+        exit(EXIT_FAILURE);
+    }
+    if (members->layout == ENSEMBLE_AOS)
+    {
+        *component_stride = 1;
+        *member_stride = sys_size;
+    }
+}
+
+
+/** \brief Set strides and member data of input parameters
+ *
+ * The system and ensemble sizes must be already set in the parameters
+ */
+static void
+set_cplx_ensemble_layout(
+        EnsembleMembers members,
+        ComplexEnsembleInputParameters p
+)
+{
+    int
+        cstride,
+        mstride;
+    ensemble_member_strides(
+            members, p->system_size, p->ensemble_size, &cstride, &mstride
+    );
+    p->component_stride = cstride;
+    p->member_stride = mstride;
+    p->member_x = NULL;
+    p->member_args = NULL;
+    if (members == NULL) return;
+    if (members->xshift != NULL) p->member_x = members->xmember;
+    p->member_args = members->args;
+}
+
+
+/** \brief Evaluate derivatives of all members at their grid points */
+static void
+cplx_ensemble_eval(
+        cplx_ensemble_der yprime,
+        EnsembleMembers members,
+        ComplexEnsembleInputParameters p,
+        Carray der
+)
+{
+    int
+        k;
+    if (p->member_x != NULL)
+    {
+        for (k = 0; k < members->ensemble_size; k++)
+        {
+            p->member_x[k] = p->x + members->xshift[k];
+        }
+    }
+    yprime(p, der);
+}
+
+
+/** \brief Set strides and member data of input parameters
+ *
+ * The system and ensemble sizes must be already set in the parameters
+ */
+static void
+set_real_ensemble_layout(
+        EnsembleMembers members,
+        RealEnsembleInputParameters p
+)
+{
+    int
+        cstride,
+        mstride;
+    ensemble_member_strides(
+            members, p->system_size, p->ensemble_size, &cstride, &mstride
+    );
+    p->component_stride = cstride;
+    p->member_stride = mstride;
+    p->member_x = NULL;
+    p->member_args = NULL;
+    if (members == NULL) return;
+    if (members->xshift != NULL) p->member_x = members->xmember;
+    p->member_args = members->args;
+}
+
+
+/** \brief Evaluate derivatives of all members at their grid points */
+static void
+real_ensemble_eval(
+        real_ensemble_der yprime,
+        EnsembleMembers members,
+        RealEnsembleInputParameters p,
+        Rarray der
+)
+{
+    int
+        k;
+    if (p->member_x != NULL)
+    {
+        for (k = 0; k < members->ensemble_size; k++)
+        {
+            p->member_x[k] = p->x + members->xshift[k];
+        }
+    }
+    yprime(p, der);
+}
+
+
+ComplexEnsembleWorkspaceRK
+get_cplx_ensemble_rungekutta_ws(int sys_size, int ens_size)
+{
+    ComplexEnsembleWorkspaceRK
+        ws;
+    ws = (ComplexEnsembleWorkspaceRK) malloc(sizeof(_ComplexEnsembleWorkspaceRK));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexEnsembleWorkspaceRK allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->ensemble_size = ens_size;
+    ws->rk = get_cplx_rungekutta_ws(sys_size * ens_size);
+    ws->members = NULL;
+    return ws;
+}
+
+
+RealEnsembleWorkspaceRK
+get_real_ensemble_rungekutta_ws(int sys_size, int ens_size)
+{
+    RealEnsembleWorkspaceRK
+        ws;
+    ws = (RealEnsembleWorkspaceRK) malloc(sizeof(_RealEnsembleWorkspaceRK));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealEnsembleWorkspaceRK allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->ensemble_size = ens_size;
+    ws->rk = get_real_rungekutta_ws(sys_size * ens_size);
+    ws->members = NULL;
+    return ws;
+}
+
+
+void
+destroy_cplx_ensemble_rungekutta_ws(ComplexEnsembleWorkspaceRK ws)
+{
+    destroy_cplx_rungekutta_ws(ws->rk);
+    free(ws);
+}
+
+
+void
+destroy_real_ensemble_rungekutta_ws(RealEnsembleWorkspaceRK ws)
+{
+    destroy_real_rungekutta_ws(ws->rk);
+    free(ws);
+}
+
+
+ComplexEnsembleWorkspaceMS
+get_cplx_ensemble_multistep_ws(int ms_order, int sys_size, int ens_size)
+{
+    ComplexEnsembleWorkspaceMS
+        ws;
+    ws = (ComplexEnsembleWorkspaceMS) malloc(sizeof(_ComplexEnsembleWorkspaceMS));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexEnsembleWorkspaceMS allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->ensemble_size = ens_size;
+    ws->ms = get_cplx_multistep_history_ws(ms_order, sys_size * ens_size);
+    ws->members = NULL;
+    return ws;
+}
+
+
+RealEnsembleWorkspaceMS
+get_real_ensemble_multistep_ws(int ms_order, int sys_size, int ens_size)
+{
+    RealEnsembleWorkspaceMS
+        ws;
+    ws = (RealEnsembleWorkspaceMS) malloc(sizeof(_RealEnsembleWorkspaceMS));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealEnsembleWorkspaceMS allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->ensemble_size = ens_size;
+    ws->ms = get_real_multistep_history_ws(ms_order, sys_size * ens_size);
+    ws->members = NULL;
+    return ws;
+}
+
+
+void
+destroy_cplx_ensemble_multistep_ws(ComplexEnsembleWorkspaceMS ws)
+{
+    destroy_cplx_multistep_ws(ws->ms);
+    free(ws);
+}
+
+
+void
+destroy_real_ensemble_multistep_ws(RealEnsembleWorkspaceMS ws)
+{
+    destroy_real_multistep_ws(ws->ms);
+    free(ws);
+}
+
+
+void
+cplx_ensemble_set_member(
+        int sys_size,
+        int ens_size,
+        int k,
+        Carray member,
+        Carray y
+)
+{
+    cplx_ensemble_set_member_layout(NULL, sys_size, ens_size, k, member, y);
+}
+
+
+void
+cplx_ensemble_set_member_layout(
+        EnsembleMembers members,
+        int sys_size,
+        int ens_size,
+        int k,
+        Carray member,
+        Carray y
+)
+{
+    int
+        i,
+        cstride,
+        mstride;
+    ensemble_member_strides(members, sys_size, ens_size, &cstride, &mstride);
+    for (i = 0; i < sys_size; i++) y[i * cstride + k * mstride] = member[i];
+}
+
+
+void
+real_ensemble_set_member(
+        int sys_size,
+        int ens_size,
+        int k,
+        Rarray member,
+        Rarray y
+)
+{
+    real_ensemble_set_member_layout(NULL, sys_size, ens_size, k, member, y);
+}
+
+
+void
+real_ensemble_set_member_layout(
+        EnsembleMembers members,
+        int sys_size,
+        int ens_size,
+        int k,
+        Rarray member,
+        Rarray y
+)
+{
+    int
+        i,
+        cstride,
+        mstride;
+    ensemble_member_strides(members, sys_size, ens_size, &cstride, &mstride);
+    for (i = 0; i < sys_size; i++) y[i * cstride + k * mstride] = member[i];
+}
+
+
+void
+cplx_ensemble_get_member(
+        int sys_size,
+        int ens_size,
+        int k,
+        Carray y,
+        Carray member
+)
+{
+    cplx_ensemble_get_member_layout(NULL, sys_size, ens_size, k, y, member);
+}
+
+
+void
+cplx_ensemble_get_member_layout(
+        EnsembleMembers members,
+        int sys_size,
+        int ens_size,
+        int k,
+        Carray y,
+        Carray member
+)
+{
+    int
+        i,
+        cstride,
+        mstride;
+    ensemble_member_strides(members, sys_size, ens_size, &cstride, &mstride);
+    for (i = 0; i < sys_size; i++) member[i] = y[i * cstride + k * mstride];
+}
+
+
+void
+real_ensemble_get_member(
+        int sys_size,
+        int ens_size,
+        int k,
+        Rarray y,
+        Rarray member
+)
+{
+    real_ensemble_get_member_layout(NULL, sys_size, ens_size, k, y, member);
+}
+
+
+void
+real_ensemble_get_member_layout(
+        EnsembleMembers members,
+        int sys_size,
+        int ens_size,
+        int k,
+        Rarray y,
+        Rarray member
+)
+{
+    int
+        i,
+        cstride,
+        mstride;
+    ensemble_member_strides(members, sys_size, ens_size, &cstride, &mstride);
+    for (i = 0; i < sys_size; i++) member[i] = y[i * cstride + k * mstride];
+}
+
+
+void
+cplx_ensemble_rungekutta5(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceRK ws,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[5];
+    Carray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        karg,
+        v[5];
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    k3 = ws->rk->work3;
+    k4 = ws->rk->work4;
+    k5 = ws->rk->work5;
+    k6 = ws->rk->work6;
+    karg = ws->rk->work7;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `cplx_rungekutta5` */
+    ens_params.x = x;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 1;
+    v[0] = k1;
+    carr_lincomb(full_size, y, h / 4, 1, w, v, karg);
+    ens_params.x = x + 0.25 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    w[0] = 1;
+    w[1] = 1;
+    v[1] = k2;
+    carr_lincomb(full_size, y, h / 8, 2, w, v, karg);
+    ens_params.x = x + 0.25 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k3);
+    w[0] = 1;
+    carr_lincomb(full_size, y, h / 2, 1, w, &k3, karg);
+    ens_params.x = x + 0.5 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k4);
+    w[0] = 3;
+    w[1] = - 6;
+    w[2] = 6;
+    w[3] = 9;
+    v[2] = k3;
+    v[3] = k4;
+    carr_lincomb(full_size, y, h / 16, 4, w, v, karg);
+    ens_params.x = x + 0.75 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k5);
+    w[0] = - 3;
+    w[1] = 8;
+    w[2] = 6;
+    w[3] = - 12;
+    w[4] = 8;
+    v[4] = k5;
+    carr_lincomb(full_size, y, h / 7, 5, w, v, karg);
+    ens_params.x = x + h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k6);
+    w[0] = 7;
+    w[1] = 32;
+    w[2] = 12;
+    w[3] = 32;
+    w[4] = 7;
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    carr_lincomb(full_size, y, h / 90, 5, w, v, ynext);
+}
+
+
+void
+real_ensemble_rungekutta5(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceRK ws,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[5];
+    Rarray
+        k1,
+        k2,
+        k3,
+        k4,
+        k5,
+        k6,
+        karg,
+        v[5];
+    _RealEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    k3 = ws->rk->work3;
+    k4 = ws->rk->work4;
+    k5 = ws->rk->work5;
+    k6 = ws->rk->work6;
+    karg = ws->rk->work7;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `real_rungekutta5` */
+    ens_params.x = x;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 1;
+    v[0] = k1;
+    rarr_lincomb(full_size, y, h / 4, 1, w, v, karg);
+    ens_params.x = x + 0.25 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    w[0] = 1;
+    w[1] = 1;
+    v[1] = k2;
+    rarr_lincomb(full_size, y, h / 8, 2, w, v, karg);
+    ens_params.x = x + 0.25 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k3);
+    w[0] = 1;
+    rarr_lincomb(full_size, y, h / 2, 1, w, &k3, karg);
+    ens_params.x = x + 0.5 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k4);
+    w[0] = 3;
+    w[1] = - 6;
+    w[2] = 6;
+    w[3] = 9;
+    v[2] = k3;
+    v[3] = k4;
+    rarr_lincomb(full_size, y, h / 16, 4, w, v, karg);
+    ens_params.x = x + 0.75 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k5);
+    w[0] = - 3;
+    w[1] = 8;
+    w[2] = 6;
+    w[3] = - 12;
+    w[4] = 8;
+    v[4] = k5;
+    rarr_lincomb(full_size, y, h / 7, 5, w, v, karg);
+    ens_params.x = x + h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k6);
+    w[0] = 7;
+    w[1] = 32;
+    w[2] = 12;
+    w[3] = 32;
+    w[4] = 7;
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    rarr_lincomb(full_size, y, h / 90, 5, w, v, ynext);
+}
+
+
+void
+cplx_ensemble_rungekutta4(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceRK ws,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[4];
+    Carray
+        k1,
+        k2,
+        k3,
+        k4,
+        karg,
+        v[4];
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    k3 = ws->rk->work3;
+    k4 = ws->rk->work4;
+    karg = ws->rk->work5;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `cplx_rungekutta4` */
+    ens_params.x = x;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 0.5;
+    carr_lincomb(full_size, y, h, 1, w, &k1, karg);
+    ens_params.x = x + 0.5 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    carr_lincomb(full_size, y, h, 1, w, &k2, karg);
+    ens_params.x = x + 0.5 * h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k3);
+    w[0] = 1;
+    carr_lincomb(full_size, y, h, 1, w, &k3, karg);
+    ens_params.x = x + h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k4);
+    w[0] = 1;
+    w[1] = 2;
+    w[2] = 2;
+    w[3] = 1;
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    v[3] = k4;
+    carr_lincomb(full_size, y, h / 6, 4, w, v, ynext);
+}
+
+
+void
+real_ensemble_rungekutta4(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceRK ws,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[4];
+    Rarray
+        k1,
+        k2,
+        k3,
+        k4,
+        karg,
+        v[4];
+    _RealEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    k3 = ws->rk->work3;
+    k4 = ws->rk->work4;
+    karg = ws->rk->work5;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `real_rungekutta4` */
+    ens_params.x = x;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 0.5;
+    rarr_lincomb(full_size, y, h, 1, w, &k1, karg);
+    ens_params.x = x + 0.5 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    rarr_lincomb(full_size, y, h, 1, w, &k2, karg);
+    ens_params.x = x + 0.5 * h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k3);
+    w[0] = 1;
+    rarr_lincomb(full_size, y, h, 1, w, &k3, karg);
+    ens_params.x = x + h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k4);
+    w[0] = 1;
+    w[1] = 2;
+    w[2] = 2;
+    w[3] = 1;
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    v[3] = k4;
+    rarr_lincomb(full_size, y, h / 6, 4, w, v, ynext);
+}
+
+
+void
+cplx_ensemble_rungekutta2(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceRK ws,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[2];
+    Carray
+        k1,
+        k2,
+        karg,
+        v[2];
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    karg = ws->rk->work3;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `cplx_rungekutta2` */
+    ens_params.x = x;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 1;
+    carr_lincomb(full_size, y, h, 1, w, &k1, karg);
+    ens_params.x = x + h;
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    w[0] = 0.5;
+    w[1] = 0.5;
+    v[0] = k1;
+    v[1] = k2;
+    carr_lincomb(full_size, y, h, 2, w, v, ynext);
+}
+
+
+void
+real_ensemble_rungekutta2(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceRK ws,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        full_size;
+    double
+        w[2];
+    Rarray
+        k1,
+        k2,
+        karg,
+        v[2];
+    _RealEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    k1 = ws->rk->work1;
+    k2 = ws->rk->work2;
+    karg = ws->rk->work3;
+
+    ens_params.y = y;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+
+    /* Same scheme of `real_rungekutta2` */
+    ens_params.x = x;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k1);
+    ens_params.y = karg;
+    w[0] = 1;
+    rarr_lincomb(full_size, y, h, 1, w, &k1, karg);
+    ens_params.x = x + h;
+    real_ensemble_eval(yprime, ws->members, &ens_params, k2);
+    w[0] = 0.5;
+    w[1] = 0.5;
+    v[0] = k1;
+    v[1] = k2;
+    rarr_lincomb(full_size, y, h, 2, w, v, ynext);
+}
+
+
+Carray
+cplx_ensemble_prev_step(ComplexEnsembleWorkspaceMS ws, unsigned int j)
+{
+    return cplx_multistep_prev_step(ws->ms, j);
+}
+
+
+Rarray
+real_ensemble_prev_step(RealEnsembleWorkspaceMS ws, unsigned int j)
+{
+    return real_multistep_prev_step(ws->ms, j);
+}
+
+
+void
+init_cplx_ensemble_multistep(
+        double h,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceMS ws,
+        Carray y0,
+        cplx_ensemble_rk_routine rk
+)
+{
+    int
+        i,
+        j,
+        full_size;
+    Carray
+        yhist;
+    ComplexEnsembleWorkspaceRK
+        wsrk;
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    yhist = ws->ms->yhist;
+    wsrk = get_cplx_ensemble_rungekutta_ws(ws->system_size, ws->ensemble_size);
+    wsrk->members = ws->members;
+    ws->ms->head = 0;
+
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+
+    /* oldest step (initial condition) in the last chunk of history */
+    j = (ws->ms->ms_order - 1) * full_size;
+    for (i = 0; i < full_size; i++) yhist[j + i] = y0[i];
+    ens_params.x = 0;
+    ens_params.y = &yhist[j];
+    cplx_ensemble_eval(yprime, ws->members, &ens_params, &ws->ms->prev_der[j]);
+
+    for (i = 1; i < ws->ms->ms_order; i++)
+    {
+        j = (ws->ms->ms_order - 1 - i) * full_size;
+        (*rk)(h, (i - 1) * h, yprime, args, wsrk, &yhist[j + full_size], &yhist[j]);
+        ens_params.x = i * h;
+        ens_params.y = &yhist[j];
+        cplx_ensemble_eval(
+                yprime, ws->members, &ens_params, &ws->ms->prev_der[j]
+        );
+    }
+
+    destroy_cplx_ensemble_rungekutta_ws(wsrk);
+}
+
+
+void
+init_real_ensemble_multistep(
+        double h,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceMS ws,
+        Rarray y0,
+        real_ensemble_rk_routine rk
+)
+{
+    int
+        i,
+        j,
+        full_size;
+    Rarray
+        yhist;
+    RealEnsembleWorkspaceRK
+        wsrk;
+    _RealEnsembleInputParameters
+        ens_params;
+
+    full_size = ws->system_size * ws->ensemble_size;
+    yhist = ws->ms->yhist;
+    wsrk = get_real_ensemble_rungekutta_ws(ws->system_size, ws->ensemble_size);
+    wsrk->members = ws->members;
+    ws->ms->head = 0;
+
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+
+    /* oldest step (initial condition) in the last chunk of history */
+    j = (ws->ms->ms_order - 1) * full_size;
+    for (i = 0; i < full_size; i++) yhist[j + i] = y0[i];
+    ens_params.x = 0;
+    ens_params.y = &yhist[j];
+    real_ensemble_eval(yprime, ws->members, &ens_params, &ws->ms->prev_der[j]);
+
+    for (i = 1; i < ws->ms->ms_order; i++)
+    {
+        j = (ws->ms->ms_order - 1 - i) * full_size;
+        (*rk)(h, (i - 1) * h, yprime, args, wsrk, &yhist[j + full_size], &yhist[j]);
+        ens_params.x = i * h;
+        ens_params.y = &yhist[j];
+        real_ensemble_eval(
+                yprime, ws->members, &ens_params, &ws->ms->prev_der[j]
+        );
+    }
+
+    destroy_real_ensemble_rungekutta_ws(wsrk);
+}
+
+
+void
+cplx_ensemble_set_next_multistep(
+        double xnext,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceMS ws,
+        Carray ynext
+)
+{
+    int
+        i,
+        m,
+        full_size;
+    ComplexWorkspaceMS
+        ms;
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    ms = ws->ms;
+    m = ms->ms_order;
+    full_size = ws->system_size * ws->ensemble_size;
+
+    ens_params.x = xnext;
+    ens_params.y = ynext;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+
+    /* oldest chunk of circular history becomes the most recent */
+    ms->head = (ms->head + m - 1) % m;
+    for (i = 0; i < full_size; i++)
+    {
+        ms->yhist[ms->head * full_size + i] = ynext[i];
+    }
+    cplx_ensemble_eval(
+            yprime, ws->members, &ens_params,
+            &ms->prev_der[ms->head * full_size]
+    );
+}
+
+
+void
+real_ensemble_set_next_multistep(
+        double xnext,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceMS ws,
+        Rarray ynext
+)
+{
+    int
+        i,
+        m,
+        full_size;
+    RealWorkspaceMS
+        ms;
+    _RealEnsembleInputParameters
+        ens_params;
+
+    ms = ws->ms;
+    m = ms->ms_order;
+    full_size = ws->system_size * ws->ensemble_size;
+
+    ens_params.x = xnext;
+    ens_params.y = ynext;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+
+    /* oldest chunk of circular history becomes the most recent */
+    ms->head = (ms->head + m - 1) % m;
+    for (i = 0; i < full_size; i++)
+    {
+        ms->yhist[ms->head * full_size + i] = ynext[i];
+    }
+    real_ensemble_eval(
+            yprime, ws->members, &ens_params,
+            &ms->prev_der[ms->head * full_size]
+    );
+}
+
+
+void
+cplx_ensemble_general_multistep(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceMS ws,
+        Rarray a,
+        Rarray b,
+        unsigned int iter,
+        Carray ynext
+)
+{
+    int
+        j,
+        m,
+        s,
+        n,
+        stride;
+    double
+        w[2 * MULTISTEP_MAX_ORDER + 1];
+    Carray
+        der,
+        v[2 * MULTISTEP_MAX_ORDER + 1];
+    ComplexWorkspaceMS
+        ms;
+    _ComplexEnsembleInputParameters
+        ens_params;
+
+    ms = ws->ms;
+    m = ms->ms_order;
+    s = ws->system_size * ws->ensemble_size;
+    der = ms->prev_der;
+
+    /* weights and previous steps read through circular index skipping
+     * zero coefficients, as in `cplx_general_multistep` */
+    n = 0;
+    for (j = 1; j <= m; j++)
+    {
+        stride = ((ms->head + j - 1) % m) * s;
+        if (b[j] != 0)
+        {
+            n++;
+            w[n] = h * b[j];
+            v[n] = &der[stride];
+        }
+        if (a[j] != 0)
+        {
+            n++;
+            w[n] = - a[j];
+            v[n] = &ms->yhist[stride];
+        }
+    }
+
+    if (!iter)
+    {
+        carr_lincomb(s, NULL, 1.0, n, &w[1], &v[1], ynext);
+        return;
+    }
+
+    /* Implicit scheme used as corrector *
+     * `ynext` must provide a prediction */
+    ens_params.x = x + h;
+    ens_params.y = ynext;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_cplx_ensemble_layout(ws->members, &ens_params);
+    w[0] = h * b[0];
+    v[0] = &der[m * s];
+    while (iter > 0)
+    {
+        cplx_ensemble_eval(yprime, ws->members, &ens_params, &der[m * s]);
+        carr_lincomb(s, NULL, 1.0, n + 1, w, v, ynext);
+        iter--;
+    }
+}
+
+
+void
+real_ensemble_general_multistep(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceMS ws,
+        Rarray a,
+        Rarray b,
+        unsigned int iter,
+        Rarray ynext
+)
+{
+    int
+        j,
+        m,
+        s,
+        n,
+        stride;
+    double
+        w[2 * MULTISTEP_MAX_ORDER + 1];
+    Rarray
+        der,
+        v[2 * MULTISTEP_MAX_ORDER + 1];
+    RealWorkspaceMS
+        ms;
+    _RealEnsembleInputParameters
+        ens_params;
+
+    ms = ws->ms;
+    m = ms->ms_order;
+    s = ws->system_size * ws->ensemble_size;
+    der = ms->prev_der;
+
+    /* weights and previous steps read through circular index skipping
+     * zero coefficients, as in `real_general_multistep` */
+    n = 0;
+    for (j = 1; j <= m; j++)
+    {
+        stride = ((ms->head + j - 1) % m) * s;
+        if (b[j] != 0)
+        {
+            n++;
+            w[n] = h * b[j];
+            v[n] = &der[stride];
+        }
+        if (a[j] != 0)
+        {
+            n++;
+            w[n] = - a[j];
+            v[n] = &ms->yhist[stride];
+        }
+    }
+
+    if (!iter)
+    {
+        rarr_lincomb(s, NULL, 1.0, n, &w[1], &v[1], ynext);
+        return;
+    }
+
+    /* Implicit scheme used as corrector *
+     * `ynext` must provide a prediction */
+    ens_params.x = x + h;
+    ens_params.y = ynext;
+    ens_params.extra_args = args;
+    ens_params.system_size = ws->system_size;
+    ens_params.ensemble_size = ws->ensemble_size;
+    set_real_ensemble_layout(ws->members, &ens_params);
+    w[0] = h * b[0];
+    v[0] = &der[m * s];
+    while (iter > 0)
+    {
+        real_ensemble_eval(yprime, ws->members, &ens_params, &der[m * s]);
+        rarr_lincomb(s, NULL, 1.0, n + 1, w, v, ynext);
+        iter--;
+    }
+}
+
+
+void
+cplx_ensemble_adams4pc(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceMS ws,
+        unsigned int iter,
+        Carray ynext
+)
+{
+    cplx_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS4_LEFT, ADAMS4_PRED, 0, ynext
+    );
+    if (iter == 0) return;
+    cplx_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS4_LEFT, ADAMS4_CORR, iter, ynext
+    );
+}
+
+
+void
+real_ensemble_adams4pc(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceMS ws,
+        unsigned int iter,
+        Rarray ynext
+)
+{
+    real_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS4_LEFT, ADAMS4_PRED, 0, ynext
+    );
+    if (iter == 0) return;
+    real_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS4_LEFT, ADAMS4_CORR, iter, ynext
+    );
+}
+
+
+void
+cplx_ensemble_adams6pc(
+        double h,
+        double x,
+        cplx_ensemble_der yprime,
+        void * args,
+        ComplexEnsembleWorkspaceMS ws,
+        unsigned int iter,
+        Carray ynext
+)
+{
+    cplx_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS6_LEFT, ADAMS6_PRED, 0, ynext
+    );
+    if (iter == 0) return;
+    cplx_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS6_LEFT, ADAMS6_CORR, iter, ynext
+    );
+}
+
+
+void
+real_ensemble_adams6pc(
+        double h,
+        double x,
+        real_ensemble_der yprime,
+        void * args,
+        RealEnsembleWorkspaceMS ws,
+        unsigned int iter,
+        Rarray ynext
+)
+{
+    real_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS6_LEFT, ADAMS6_PRED, 0, ynext
+    );
+    if (iter == 0) return;
+    real_ensemble_general_multistep(
+            h, x, yprime, args, ws, ADAMS6_LEFT, ADAMS6_CORR, iter, ynext
+    );
+}
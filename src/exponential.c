@@ -0,0 +1,448 @@
+/**
+ * \file exponential.c
+ * \author Alex Andriati
+ * \brief Source code for exponential integrators of complex systems
+ *
+ * See function signature and description in header exponential.h
+ * The ETDRK4 method follows ref. [1] with the phi-functions computed as
+ * in ref. [2], by the mean over points of a circle of radius one around
+ * each `h L`, which avoids the cancellation of the explicit formulas for
+ * small `h L`. The circle is complete, since `L` is complex. Some refs
+ *
+ * [1] S.M. Cox and P.C. Matthews, Exponential time differencing for stiff
+ * systems, J. Comput. Phys. 176 (2002) 430-455
+ * [2] A.K. Kassam and L.N. Trefethen, Fourth-order time-stepping for stiff
+ * PDEs, SIAM J. Sci. Comput. 26 (2005) 1214-1233
+ * [3] J.D. Lawson, Generalized Runge-Kutta processes for stable systems
+ * with large Lipschitz constants, SIAM J. Numer. Anal. 4 (1967) 372-380
+ * [4] M. Hochbruck and A. Ostermann, Exponential integrators, Acta
+ * Numerica 19 (2010) 209-286
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "exponential.h"
+
+
+/* Number of points in the contour integral of phi-functions, ref. [2] */
+#define ETD_CONTOUR_POINTS 32
+
+
+static Carray
+exponential_alloc_carr(unsigned int size)
+{
+    Carray ptr = (Carray) malloc(size * sizeof(double complex));
+    if (ptr == NULL)
+    {
+        printf("\n\nProblem in Carray allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+
+ComplexWorkspaceETD
+get_cplx_etd_ws(int sys_size, Carray lin)
+{
+    int
+        i;
+    ComplexWorkspaceETD
+        ws;
+    ws = (ComplexWorkspaceETD) malloc(sizeof(_ComplexWorkspaceETD));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceETD allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->h = 0;
+    ws->lin = exponential_alloc_carr(sys_size);
+    ws->e = exponential_alloc_carr(sys_size);
+    ws->e2 = exponential_alloc_carr(sys_size);
+    ws->q = exponential_alloc_carr(sys_size);
+    ws->f1 = exponential_alloc_carr(sys_size);
+    ws->f2 = exponential_alloc_carr(sys_size);
+    ws->f3 = exponential_alloc_carr(sys_size);
+    ws->nv = exponential_alloc_carr(sys_size);
+    ws->na = exponential_alloc_carr(sys_size);
+    ws->nb = exponential_alloc_carr(sys_size);
+    ws->nc = exponential_alloc_carr(sys_size);
+    ws->a = exponential_alloc_carr(sys_size);
+    ws->b = exponential_alloc_carr(sys_size);
+    for (i = 0; i < sys_size; i++) ws->lin[i] = lin[i];
+    return ws;
+}
+
+
+void
+destroy_cplx_etd_ws(ComplexWorkspaceETD ws)
+{
+    free(ws->lin);
+    free(ws->e);
+    free(ws->e2);
+    free(ws->q);
+    free(ws->f1);
+    free(ws->f2);
+    free(ws->f3);
+    free(ws->nv);
+    free(ws->na);
+    free(ws->nb);
+    free(ws->nc);
+    free(ws->a);
+    free(ws->b);
+    free(ws);
+}
+
+
+/** \brief Index of exponential `exp(d h L)`, appended if not present
+ *
+ * Return -1 for `d = 0` (identity)
+ */
+static int
+lawson_exp_index(ComplexWorkspaceLawson ws, double d)
+{
+    int
+        i;
+    if (d == 0) return -1;
+    for (i = 0; i < ws->nexp; i++)
+    {
+        if (ws->exp_frac[i] == d) return i;
+    }
+    ws->exp_frac[ws->nexp] = d;
+    ws->nexp++;
+    return ws->nexp - 1;
+}
+
+
+/** \brief Collect nonzero terms of tableau and their exponentials */
+static void
+lawson_set_terms(ComplexWorkspaceLawson ws)
+{
+    int
+        i,
+        j,
+        n,
+        s;
+    double
+        node,
+        coef;
+    const ButcherTableau
+        * tab;
+
+    tab = ws->tableau;
+    s = tab->stages;
+    ws->nexp = 0;
+    for (i = 0; i < s + 2; i++)
+    {
+        node = i < s ? tab->c[i] : 1.0;
+        ws->row_exp[i] = lawson_exp_index(ws, node);
+        n = 0;
+        for (j = 0; j < s; j++)
+        {
+            if (i < s)
+            {
+                if (j >= i) break;
+                coef = tab->a[i * s + j];
+            }
+            else if (i == s) coef = tab->b[j];
+            else if (tab->bhat != NULL) coef = tab->b[j] - tab->bhat[j];
+            else coef = 0;
+            if (coef != 0)
+            {
+                ws->term_stage[i * s + n] = j;
+                ws->term_weight[i * s + n] = coef;
+                ws->term_exp[i * s + n] = lawson_exp_index(ws, node - tab->c[j]);
+                n++;
+            }
+        }
+        ws->nterms[i] = n;
+    }
+}
+
+
+ComplexWorkspaceLawson
+get_cplx_lawson_ws(int sys_size, Carray lin, const ButcherTableau * tab)
+{
+    int
+        i,
+        s,
+        maxexp;
+    ComplexWorkspaceLawson
+        ws;
+
+    ws = (ComplexWorkspaceLawson) malloc(sizeof(_ComplexWorkspaceLawson));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceLawson allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    s = tab->stages;
+    /* each row has at most one exponential for `y` and one per term */
+    maxexp = (s + 2) * (s + 1);
+    ws->system_size = sys_size;
+    ws->stages = s;
+    ws->h = 0;
+    ws->tableau = tab;
+    ws->nterms = (int *) malloc((s + 2) * sizeof(int));
+    ws->row_exp = (int *) malloc((s + 2) * sizeof(int));
+    ws->term_stage = (int *) malloc((s + 2) * s * sizeof(int));
+    ws->term_exp = (int *) malloc((s + 2) * s * sizeof(int));
+    ws->term_weight = (double *) malloc((s + 2) * s * sizeof(double));
+    ws->exp_frac = (double *) malloc(maxexp * sizeof(double));
+    ws->k = (Carray *) malloc(s * sizeof(Carray));
+    if (ws->nterms == NULL || ws->row_exp == NULL || ws->term_stage == NULL
+            || ws->term_exp == NULL || ws->term_weight == NULL
+            || ws->exp_frac == NULL || ws->k == NULL)
+    {
+        printf("\n\nProblem in Lawson workspace allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    lawson_set_terms(ws);
+    ws->expo = (Carray *) malloc((ws->nexp + 1) * sizeof(Carray));
+    if (ws->expo == NULL)
+    {
+        printf("\n\nProblem in Lawson workspace allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    for (i = 0; i < ws->nexp; i++)
+    {
+        ws->expo[i] = exponential_alloc_carr(sys_size);
+    }
+    for (i = 0; i < s; i++) ws->k[i] = exponential_alloc_carr(sys_size);
+    ws->karg = exponential_alloc_carr(sys_size);
+    ws->lin = exponential_alloc_carr(sys_size);
+    for (i = 0; i < sys_size; i++) ws->lin[i] = lin[i];
+    return ws;
+}
+
+
+void
+destroy_cplx_lawson_ws(ComplexWorkspaceLawson ws)
+{
+    int
+        i;
+    for (i = 0; i < ws->nexp; i++) free(ws->expo[i]);
+    for (i = 0; i < ws->stages; i++) free(ws->k[i]);
+    free(ws->expo);
+    free(ws->k);
+    free(ws->karg);
+    free(ws->lin);
+    free(ws->exp_frac);
+    free(ws->term_weight);
+    free(ws->term_exp);
+    free(ws->term_stage);
+    free(ws->row_exp);
+    free(ws->nterms);
+    free(ws);
+}
+
+
+/** \brief Compute ETDRK4 coefficients for step size `h` */
+static void
+etd_coefficients(double h, ComplexWorkspaceETD ws)
+{
+    int
+        i,
+        j;
+    double complex
+        z,
+        zr,
+        ez,
+        zr3,
+        sq,
+        s1,
+        s2,
+        s3,
+        circle[ETD_CONTOUR_POINTS];
+
+    for (j = 0; j < ETD_CONTOUR_POINTS; j++)
+    {
+        circle[j] = cexp(2 * I * M_PI * (j + 0.5) / ETD_CONTOUR_POINTS);
+    }
+    for (i = 0; i < ws->system_size; i++)
+    {
+        z = h * ws->lin[i];
+        ws->e[i] = cexp(z);
+        ws->e2[i] = cexp(z / 2);
+        sq = 0;
+        s1 = 0;
+        s2 = 0;
+        s3 = 0;
+        for (j = 0; j < ETD_CONTOUR_POINTS; j++)
+        {
+            zr = z + circle[j];
+            ez = cexp(zr);
+            zr3 = zr * zr * zr;
+            sq = sq + (cexp(zr / 2) - 1) / zr;
+            s1 = s1 + (- 4 - zr + ez * (4 - 3 * zr + zr * zr)) / zr3;
+            s2 = s2 + (2 + zr + ez * (zr - 2)) / zr3;
+            s3 = s3 + (- 4 - 3 * zr - zr * zr + ez * (4 - zr)) / zr3;
+        }
+        ws->q[i] = h * sq / ETD_CONTOUR_POINTS;
+        ws->f1[i] = h * s1 / ETD_CONTOUR_POINTS;
+        ws->f2[i] = h * s2 / ETD_CONTOUR_POINTS;
+        ws->f3[i] = h * s3 / ETD_CONTOUR_POINTS;
+    }
+    ws->h = h;
+}
+
+
+void
+cplx_etdrk4_step(
+        double h,
+        double x,
+        cplx_odesys_der nonlinear,
+        void * args,
+        ComplexWorkspaceETD ws,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        i,
+        sys_size;
+    _ComplexODEInputParameters
+        sys_params;
+
+    if (h != ws->h) etd_coefficients(h, ws);
+    sys_size = ws->system_size;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    sys_params.x = x;
+    sys_params.y = y;
+    nonlinear(&sys_params, ws->nv);
+    for (i = 0; i < sys_size; i++)
+    {
+        ws->a[i] = ws->e2[i] * y[i] + ws->q[i] * ws->nv[i];
+    }
+    sys_params.x = x + 0.5 * h;
+    sys_params.y = ws->a;
+    nonlinear(&sys_params, ws->na);
+    for (i = 0; i < sys_size; i++)
+    {
+        ws->b[i] = ws->e2[i] * y[i] + ws->q[i] * ws->na[i];
+    }
+    sys_params.y = ws->b;
+    nonlinear(&sys_params, ws->nb);
+    for (i = 0; i < sys_size; i++)
+    {
+        ws->b[i] = ws->e2[i] * ws->a[i]
+                 + ws->q[i] * (2 * ws->nb[i] - ws->nv[i]);
+    }
+    sys_params.x = x + h;
+    nonlinear(&sys_params, ws->nc);
+    for (i = 0; i < sys_size; i++)
+    {
+        ynext[i] = ws->e[i] * y[i] + ws->f1[i] * ws->nv[i]
+                 + 2 * ws->f2[i] * (ws->na[i] + ws->nb[i])
+                 + ws->f3[i] * ws->nc[i];
+    }
+}
+
+
+/** \brief Compute exponentials of Lawson method for step size `h` */
+static void
+lawson_exponentials(double h, ComplexWorkspaceLawson ws)
+{
+    int
+        i,
+        j;
+    for (j = 0; j < ws->nexp; j++)
+    {
+        for (i = 0; i < ws->system_size; i++)
+        {
+            ws->expo[j][i] = cexp(ws->exp_frac[j] * h * ws->lin[i]);
+        }
+    }
+    ws->h = h;
+}
+
+
+/** \brief Combine a row of terms with their exponentials
+ *
+ * `out = exp(c h L) y + h * sum w exp((c - c_j) h L) k_j` with `y` NULL
+ * taken as zero
+ */
+static void
+lawson_row(
+        double h,
+        ComplexWorkspaceLawson ws,
+        int row,
+        Carray y,
+        Carray out
+)
+{
+    int
+        i,
+        t,
+        n,
+        s;
+    double complex
+        acc,
+        kv;
+    Carray
+        ey;
+
+    s = ws->stages;
+    n = ws->nterms[row];
+    ey = ws->row_exp[row] < 0 ? NULL : ws->expo[ws->row_exp[row]];
+    for (i = 0; i < ws->system_size; i++)
+    {
+        if (y == NULL)      acc = 0;
+        else if (ey == NULL) acc = y[i];
+        else                acc = ey[i] * y[i];
+        for (t = 0; t < n; t++)
+        {
+            kv = ws->k[ws->term_stage[row * s + t]][i];
+            if (ws->term_exp[row * s + t] >= 0)
+            {
+                kv = ws->expo[ws->term_exp[row * s + t]][i] * kv;
+            }
+            acc = acc + h * ws->term_weight[row * s + t] * kv;
+        }
+        out[i] = acc;
+    }
+}
+
+
+void
+cplx_lawson_step(
+        double h,
+        double x,
+        cplx_odesys_der nonlinear,
+        void * args,
+        ComplexWorkspaceLawson ws,
+        Carray y,
+        Carray ynext,
+        Carray yerr
+)
+{
+    int
+        i,
+        s;
+    _ComplexODEInputParameters
+        sys_params;
+
+    if (h != ws->h) lawson_exponentials(h, ws);
+    s = ws->stages;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = ws->system_size;
+
+    sys_params.x = x;
+    sys_params.y = y;
+    nonlinear(&sys_params, ws->k[0]);
+    sys_params.y = ws->karg;
+    for (i = 1; i < s; i++)
+    {
+        lawson_row(h, ws, i, y, ws->karg);
+        sys_params.x = x + ws->tableau->c[i] * h;
+        nonlinear(&sys_params, ws->k[i]);
+    }
+    lawson_row(h, ws, s, y, ynext);
+    if (yerr == NULL || ws->tableau->bhat == NULL) return;
+    lawson_row(h, ws, s + 1, NULL, yerr);
+}
@@ -0,0 +1,795 @@
+/**
+ * \file integrate.c
+ * \author Alex Andriati
+ * \brief Source code of drivers to integrate over a full interval
+ *
+ * See function signature and description in header integrate.h
+ * The grid points are computed as `x0 + i * h` to avoid accumulation of
+ * rounding errors. Since `init_*_multistep` starts at `x = 0`, in the
+ * startup the derivative routine is wrapped to shift the grid by `x0`
+ *
+ * Events are located with the Illinois variant of regula falsi, see
+ * M. Dowell and P. Jarratt, A modified regula falsi method for computing
+ * the root of an equation, BIT 11 (1971) 168-174
+ */
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include "integrate.h"
+#include "arrays_assistant.h"
+#include "dense.h"
+#include "tableau.h"
+
+/** \brief Max number of iterations to locate an event inside a step */
+#define EVENT_MAX_ITER 100
+
+
+/** \brief Derivative routine and arguments to shift the grid by `x0` */
+typedef struct{
+    cplx_odesys_der
+        yprime;
+    void
+        * args;
+    double
+        x0;
+} _ComplexShiftedDer;
+
+
+/** \brief Derivative routine and arguments to shift the grid by `x0` */
+typedef struct{
+    real_odesys_der
+        yprime;
+    void
+        * args;
+    double
+        x0;
+} _RealShiftedDer;
+
+
+static void
+cplx_shifted_der(ComplexODEInputParameters inp, Carray der)
+{
+    _ComplexShiftedDer
+        * shifted;
+    shifted = (_ComplexShiftedDer *) inp->extra_args;
+    inp->x = inp->x + shifted->x0;
+    inp->extra_args = shifted->args;
+    shifted->yprime(inp, der);
+    inp->extra_args = (void *) shifted;
+    inp->x = inp->x - shifted->x0;
+}
+
+
+static void
+real_shifted_der(RealODEInputParameters inp, Rarray der)
+{
+    _RealShiftedDer
+        * shifted;
+    shifted = (_RealShiftedDer *) inp->extra_args;
+    inp->x = inp->x + shifted->x0;
+    inp->extra_args = shifted->args;
+    shifted->yprime(inp, der);
+    inp->extra_args = (void *) shifted;
+    inp->x = inp->x - shifted->x0;
+}
+
+
+/** \brief Call observer if step `i` of `nsteps` is an output point */
+static void
+cplx_observe(
+        cplx_odesys_observer observer,
+        void * obs_args,
+        unsigned int out_every,
+        unsigned int i,
+        unsigned int nsteps,
+        double x,
+        unsigned int sys_size,
+        Carray y
+)
+{
+    _ComplexODEInputParameters
+        obs_params;
+    if (observer == NULL) return;
+    if (i % out_every != 0 && i != nsteps) return;
+    obs_params.system_size = sys_size;
+    obs_params.x = x;
+    obs_params.y = y;
+    obs_params.extra_args = obs_args;
+    observer(&obs_params);
+}
+
+
+/** \brief Call observer if step `i` of `nsteps` is an output point */
+static void
+real_observe(
+        real_odesys_observer observer,
+        void * obs_args,
+        unsigned int out_every,
+        unsigned int i,
+        unsigned int nsteps,
+        double x,
+        unsigned int sys_size,
+        Rarray y
+)
+{
+    _RealODEInputParameters
+        obs_params;
+    if (observer == NULL) return;
+    if (i % out_every != 0 && i != nsteps) return;
+    obs_params.system_size = sys_size;
+    obs_params.x = x;
+    obs_params.y = y;
+    obs_params.extra_args = obs_args;
+    observer(&obs_params);
+}
+
+
+static cplx_rk_routine
+cplx_rk_method(FixedStepMethod method)
+{
+    switch (method)
+    {
+        case RUNGEKUTTA2:
+            return &cplx_rungekutta2;
+        case RUNGEKUTTA4:
+        case ADAMS4PC:
+            return &cplx_rungekutta4;
+        default:
+            return &cplx_rungekutta5;
+    }
+}
+
+
+/** \brief Number of Runge-Kutta work arrays used by method (or starter) */
+static int
+rk_method_stages(FixedStepMethod method)
+{
+    switch (method)
+    {
+        case RUNGEKUTTA2:
+            return RK2_WS_STAGES;
+        case RUNGEKUTTA4:
+        case ADAMS4PC:
+            return RK4_WS_STAGES;
+        default:
+            return RK5_WS_STAGES;
+    }
+}
+
+
+/** \brief Tableau of Runge-Kutta method (or starter) for event driver */
+static const ButcherTableau *
+rk_method_tableau(FixedStepMethod method)
+{
+    switch (method)
+    {
+        case RUNGEKUTTA2:
+            return &TABLEAU_HEUN_RK2;
+        case RUNGEKUTTA4:
+        case ADAMS4PC:
+            return &TABLEAU_RK4;
+        default:
+            return &TABLEAU_BUTCHER_RK5;
+    }
+}
+
+
+static real_rk_routine
+real_rk_method(FixedStepMethod method)
+{
+    switch (method)
+    {
+        case RUNGEKUTTA2:
+            return &real_rungekutta2;
+        case RUNGEKUTTA4:
+        case ADAMS4PC:
+            return &real_rungekutta4;
+        default:
+            return &real_rungekutta5;
+    }
+}
+
+
+void
+cplx_integrate(
+        FixedStepMethod method,
+        unsigned int corrector_iter,
+        unsigned int sys_size,
+        double x0,
+        double x1,
+        unsigned int nsteps,
+        cplx_odesys_der yprime,
+        void * args,
+        unsigned int out_every,
+        cplx_odesys_observer observer,
+        void * obs_args,
+        Carray y
+)
+{
+    unsigned int
+        i,
+        j,
+        ms_order;
+    double
+        h;
+    Carray
+        buffer,
+        ycur;
+    ComplexWorkspaceRK
+        wsrk;
+    ComplexWorkspaceMS
+        wsms;
+    cplx_rk_routine
+        rk;
+    _ComplexShiftedDer
+        shifted;
+
+    if (nsteps == 0) return;
+    if (out_every == 0) out_every = nsteps;
+    h = (x1 - x0) / nsteps;
+    rk = cplx_rk_method(method);
+    cplx_observe(observer, obs_args, out_every, 0, nsteps, x0, sys_size, y);
+
+    ms_order = 0;
+    if (method == ADAMS4PC) ms_order = 4;
+    if (method == ADAMS6PC) ms_order = 6;
+
+    if (ms_order == 0 || nsteps < ms_order)
+    {
+        /* Runge-Kutta routines support in-place steps */
+        wsrk = get_cplx_rungekutta_ws_arena(
+                sys_size, rk_method_stages(method), NULL
+        );
+        for (i = 0; i < nsteps; i++)
+        {
+            rk(h, x0 + i * h, yprime, args, wsrk, y, y);
+            cplx_observe(
+                    observer, obs_args, out_every, i + 1, nsteps,
+                    x0 + (i + 1) * h, sys_size, y
+            );
+        }
+        destroy_cplx_rungekutta_ws(wsrk);
+        return;
+    }
+
+    buffer = alloc_carr(sys_size);
+
+    /* multistep in history mode, where set_next only moves an index */
+    wsms = get_cplx_multistep_history_ws(ms_order, sys_size);
+    shifted.yprime = yprime;
+    shifted.args = args;
+    shifted.x0 = x0;
+    init_cplx_multistep(
+            h, &cplx_shifted_der, (void *) &shifted, wsms, y, rk, NULL
+    );
+    for (i = 1; i < ms_order; i++)
+    {
+        cplx_observe(
+                observer, obs_args, out_every, i, nsteps, x0 + i * h,
+                sys_size, cplx_multistep_prev_step(wsms, ms_order - 1 - i)
+        );
+    }
+    for (i = ms_order - 1; i < nsteps; i++)
+    {
+        if (method == ADAMS4PC)
+        {
+            cplx_adams4pc(
+                    h, x0 + i * h, yprime, args, wsms, NULL, corrector_iter,
+                    buffer
+            );
+        }
+        else
+        {
+            cplx_adams6pc(
+                    h, x0 + i * h, yprime, args, wsms, NULL, corrector_iter,
+                    buffer
+            );
+        }
+        cplx_set_next_multistep(
+                x0 + (i + 1) * h, yprime, args, wsms, NULL, buffer
+        );
+        cplx_observe(
+                observer, obs_args, out_every, i + 1, nsteps,
+                x0 + (i + 1) * h, sys_size, cplx_multistep_prev_step(wsms, 0)
+        );
+    }
+    ycur = cplx_multistep_prev_step(wsms, 0);
+    for (j = 0; j < sys_size; j++) y[j] = ycur[j];
+    destroy_cplx_multistep_ws(wsms);
+    free(buffer);
+}
+
+
+void
+real_integrate(
+        FixedStepMethod method,
+        unsigned int corrector_iter,
+        unsigned int sys_size,
+        double x0,
+        double x1,
+        unsigned int nsteps,
+        real_odesys_der yprime,
+        void * args,
+        unsigned int out_every,
+        real_odesys_observer observer,
+        void * obs_args,
+        Rarray y
+)
+{
+    unsigned int
+        i,
+        j,
+        ms_order;
+    double
+        h;
+    Rarray
+        buffer,
+        ycur;
+    RealWorkspaceRK
+        wsrk;
+    RealWorkspaceMS
+        wsms;
+    real_rk_routine
+        rk;
+    _RealShiftedDer
+        shifted;
+
+    if (nsteps == 0) return;
+    if (out_every == 0) out_every = nsteps;
+    h = (x1 - x0) / nsteps;
+    rk = real_rk_method(method);
+    real_observe(observer, obs_args, out_every, 0, nsteps, x0, sys_size, y);
+
+    ms_order = 0;
+    if (method == ADAMS4PC) ms_order = 4;
+    if (method == ADAMS6PC) ms_order = 6;
+
+    if (ms_order == 0 || nsteps < ms_order)
+    {
+        /* Runge-Kutta routines support in-place steps */
+        wsrk = get_real_rungekutta_ws_arena(
+                sys_size, rk_method_stages(method), NULL
+        );
+        for (i = 0; i < nsteps; i++)
+        {
+            rk(h, x0 + i * h, yprime, args, wsrk, y, y);
+            real_observe(
+                    observer, obs_args, out_every, i + 1, nsteps,
+                    x0 + (i + 1) * h, sys_size, y
+            );
+        }
+        destroy_real_rungekutta_ws(wsrk);
+        return;
+    }
+
+    buffer = alloc_rarr(sys_size);
+
+    /* multistep in history mode, where set_next only moves an index */
+    wsms = get_real_multistep_history_ws(ms_order, sys_size);
+    shifted.yprime = yprime;
+    shifted.args = args;
+    shifted.x0 = x0;
+    init_real_multistep(
+            h, &real_shifted_der, (void *) &shifted, wsms, y, rk, NULL
+    );
+    for (i = 1; i < ms_order; i++)
+    {
+        real_observe(
+                observer, obs_args, out_every, i, nsteps, x0 + i * h,
+                sys_size, real_multistep_prev_step(wsms, ms_order - 1 - i)
+        );
+    }
+    for (i = ms_order - 1; i < nsteps; i++)
+    {
+        if (method == ADAMS4PC)
+        {
+            real_adams4pc(
+                    h, x0 + i * h, yprime, args, wsms, NULL, corrector_iter,
+                    buffer
+            );
+        }
+        else
+        {
+            real_adams6pc(
+                    h, x0 + i * h, yprime, args, wsms, NULL, corrector_iter,
+                    buffer
+            );
+        }
+        real_set_next_multistep(
+                x0 + (i + 1) * h, yprime, args, wsms, NULL, buffer
+        );
+        real_observe(
+                observer, obs_args, out_every, i + 1, nsteps,
+                x0 + (i + 1) * h, sys_size, real_multistep_prev_step(wsms, 0)
+        );
+    }
+    ycur = real_multistep_prev_step(wsms, 0);
+    for (j = 0; j < sys_size; j++) y[j] = ycur[j];
+    destroy_real_multistep_ws(wsms);
+    free(buffer);
+}
+
+
+/** \brief Data of a step to locate events inside it
+ *
+ * The solution inside the step is the cubic Hermite interpolant of the
+ * solution `y0` and derivative `f0` at `x` and `y1`, `f1` at `x + h`,
+ * only set in `dense` if some event is crossed. The arrays of the step
+ * are not owned by this struct
+ */
+typedef struct{
+    unsigned int
+        sys_size,
+        nevents;
+    const RealODEEvent
+        * events;
+    void
+        * args;         /// extra arguments of event functions
+    double
+        x,              /// grid point at beginning of step
+        h,              /// step size
+        * gprev,        /// event functions at `x`
+        * gnext,        /// event functions at `x + h`
+        * root;         /// fraction of step of crossings (-1 if none)
+    Rarray
+        y0,
+        f0,
+        y1,
+        f1,
+        yint;           /// interpolated solution
+    RealDenseOutput
+        dense;          /// interpolant of the step
+} _RealEventSearch;
+
+
+/** \brief Evaluate all event functions at `x` with solution `y` */
+static void
+real_events_at(_RealEventSearch * search, double x, Rarray y, double * g)
+{
+    unsigned int
+        e;
+    _RealODEInputParameters
+        ev_params;
+
+    ev_params.system_size = search->sys_size;
+    ev_params.x = x;
+    ev_params.y = y;
+    ev_params.extra_args = search->args;
+    for (e = 0; e < search->nevents; e++)
+    {
+        g[e] = search->events[e].g(&ev_params);
+    }
+}
+
+
+/** \brief Value of event `e` with interpolated solution at `x + t * h` */
+static double
+real_event_inside(_RealEventSearch * search, unsigned int e, double t)
+{
+    _RealODEInputParameters
+        ev_params;
+
+    ev_params.system_size = search->sys_size;
+    ev_params.x = search->x + t * search->h;
+    real_dense_eval_at(search->dense, ev_params.x, search->yint);
+    ev_params.y = search->yint;
+    ev_params.extra_args = search->args;
+    return search->events[e].g(&ev_params);
+}
+
+
+/** \brief Return nonzero if sign change of `g` matches the direction */
+static int
+event_triggered(int direction, double gprev, double gnext)
+{
+    if (direction >= 0 && gprev < 0 && gnext >= 0) return 1;
+    if (direction <= 0 && gprev > 0 && gnext <= 0) return 1;
+    return 0;
+}
+
+
+/** \brief Fraction of step of the crossing of event `e` (Illinois)
+ *
+ * The bracket end returned is the one where the event function already
+ * changed sign, thus the crossing is not found again from the event
+ */
+static double
+real_event_root(_RealEventSearch * search, unsigned int e)
+{
+    int
+        iter;
+    double
+        a,
+        b,
+        c,
+        fa,
+        fb,
+        fc,
+        tol;
+
+    a = 0;
+    b = 1;
+    fa = search->gprev[e];
+    fb = search->gnext[e];
+    tol = 4 * DBL_EPSILON * (1 + fabs(search->x / search->h));
+    for (iter = 0; iter < EVENT_MAX_ITER && fabs(b - a) > tol; iter++)
+    {
+        c = b - fb * (b - a) / (fb - fa);
+        fc = real_event_inside(search, e, c);
+        if (fc == 0) return c;
+        if ((fc > 0) != (fb > 0))
+        {
+            a = b;
+            fa = fb;
+        }
+        else
+        {
+            /* same end kept twice, halve its value (Illinois) */
+            fa = 0.5 * fa;
+        }
+        b = c;
+        fb = fc;
+    }
+    if (fb == 0 || (fb > 0) != (search->gprev[e] > 0)) return b;
+    return a;
+}
+
+
+/** \brief Report events crossed in the step in the order they occur
+ *
+ * \return index of first terminal event, with `yint` set with solution
+ *         at event point in `xstop`, or -1 if integration proceeds
+ */
+static int
+real_process_events(
+        _RealEventSearch * search,
+        real_odesys_event_handler handler,
+        void * obs_args,
+        double * xstop
+)
+{
+    unsigned int
+        e,
+        first;
+    int
+        found;
+    double
+        t;
+    _RealODEInputParameters
+        ev_params;
+
+    found = 0;
+    for (e = 0; e < search->nevents; e++)
+    {
+        search->root[e] = -1;
+        if (event_triggered(search->events[e].direction,
+                    search->gprev[e], search->gnext[e]))
+        {
+            if (!found)
+            {
+                real_dense_hermite3(
+                        search->h, search->x, search->y0, search->f0,
+                        search->y1, search->f1, search->dense
+                );
+            }
+            found = 1;
+            search->root[e] = real_event_root(search, e);
+        }
+    }
+    while (1)
+    {
+        found = 0;
+        first = 0;
+        for (e = 0; e < search->nevents; e++)
+        {
+            if (search->root[e] < 0) continue;
+            if (!found || search->root[e] < search->root[first]) first = e;
+            found = 1;
+        }
+        if (!found) return -1;
+        t = search->root[first];
+        search->root[first] = -1;
+        real_dense_eval_at(search->dense, search->x + t * search->h,
+                search->yint);
+        if (handler != NULL)
+        {
+            ev_params.system_size = search->sys_size;
+            ev_params.x = search->x + t * search->h;
+            ev_params.y = search->yint;
+            ev_params.extra_args = obs_args;
+            handler(first, &ev_params);
+        }
+        if (search->events[first].terminal)
+        {
+            *xstop = search->x + t * search->h;
+            return first;
+        }
+    }
+}
+
+
+int
+real_integrate_events(
+        FixedStepMethod method,
+        unsigned int corrector_iter,
+        unsigned int sys_size,
+        double x0,
+        double x1,
+        unsigned int nsteps,
+        real_odesys_der yprime,
+        void * args,
+        unsigned int out_every,
+        real_odesys_observer observer,
+        void * obs_args,
+        unsigned int nevents,
+        const RealODEEvent * events,
+        real_odesys_event_handler handler,
+        double * xstop,
+        Rarray y
+)
+{
+    unsigned int
+        i,
+        j,
+        ms_order;
+    int
+        stop;
+    double
+        h,
+        * gswap;
+    Rarray
+        block,
+        ycur,
+        ynext;
+    RealWorkspaceTableau
+        wstab;
+    RealWorkspaceMS
+        wsms;
+    _RealShiftedDer
+        shifted;
+    _RealEventSearch
+        search;
+    _RealODEInputParameters
+        sys_params;
+
+    *xstop = x0;
+    if (nsteps == 0) return -1;
+    if (out_every == 0) out_every = nsteps;
+    h = (x1 - x0) / nsteps;
+    real_observe(observer, obs_args, out_every, 0, nsteps, x0, sys_size, y);
+
+    ms_order = 0;
+    if (method == ADAMS4PC) ms_order = 4;
+    if (method == ADAMS6PC) ms_order = 6;
+
+    /* event values, roots, interpolated solution and solution buffer */
+    block = alloc_rarr(3 * nevents + 2 * sys_size);
+    search.sys_size = sys_size;
+    search.nevents = nevents;
+    search.events = events;
+    search.args = args;
+    search.h = h;
+    search.gprev = block;
+    search.gnext = &block[nevents];
+    search.root = &block[2 * nevents];
+    search.yint = &block[3 * nevents];
+    search.dense = get_real_dense_ws(sys_size);
+    real_events_at(&search, x0, y, search.gprev);
+    stop = -1;
+
+    if (ms_order == 0 || nsteps < ms_order)
+    {
+        wstab = get_real_tableau_ws(sys_size, rk_method_tableau(method));
+        sys_params.system_size = sys_size;
+        sys_params.extra_args = args;
+        sys_params.x = x0;
+        sys_params.y = y;
+        yprime(&sys_params, wstab->k[0]);
+        ycur = y;
+        ynext = &block[3 * nevents + sys_size];
+        for (i = 0; i < nsteps; i++)
+        {
+            search.x = x0 + i * h;
+            real_tableau_step(
+                    h, search.x, yprime, args, wstab, 1, ycur, ynext, NULL
+            );
+            /* the last stage is no longer required and holds the
+             * derivative at the new point, exchanged to be the first
+             * stage of the next step as done for FSAL tableaus */
+            sys_params.x = x0 + (i + 1) * h;
+            sys_params.y = ynext;
+            yprime(&sys_params, wstab->k[wstab->stages - 1]);
+            search.y0 = ycur;
+            search.f0 = wstab->k[0];
+            search.y1 = ynext;
+            search.f1 = wstab->k[wstab->stages - 1];
+            real_events_at(&search, sys_params.x, ynext, search.gnext);
+            stop = real_process_events(&search, handler, obs_args, xstop);
+            if (stop >= 0)
+            {
+                ycur = search.yint;
+                break;
+            }
+            real_observe(
+                    observer, obs_args, out_every, i + 1, nsteps,
+                    sys_params.x, sys_size, ynext
+            );
+            real_tableau_swap_fsal(wstab);
+            search.y0 = ycur;
+            ycur = ynext;
+            ynext = search.y0;
+            gswap = search.gprev;
+            search.gprev = search.gnext;
+            search.gnext = gswap;
+        }
+        if (ycur != y)
+        {
+            for (j = 0; j < sys_size; j++) y[j] = ycur[j];
+        }
+        destroy_real_tableau_ws(wstab);
+    }
+    else
+    {
+        /* multistep in history mode, where set_next only moves an index */
+        wsms = get_real_multistep_history_ws(ms_order, sys_size);
+        shifted.yprime = yprime;
+        shifted.args = args;
+        shifted.x0 = x0;
+        init_real_multistep(
+                h, &real_shifted_der, (void *) &shifted, wsms, y,
+                real_rk_method(method), NULL
+        );
+        ynext = &block[3 * nevents + sys_size];
+        for (i = 1; i <= nsteps; i++)
+        {
+            /* steps of the startup are already in the history */
+            j = 0;
+            if (i < ms_order) j = ms_order - 1 - i;
+            else
+            {
+                if (method == ADAMS4PC)
+                {
+                    real_adams4pc(
+                            h, x0 + (i - 1) * h, yprime, args, wsms, NULL,
+                            corrector_iter, ynext
+                    );
+                }
+                else
+                {
+                    real_adams6pc(
+                            h, x0 + (i - 1) * h, yprime, args, wsms, NULL,
+                            corrector_iter, ynext
+                    );
+                }
+                real_set_next_multistep(
+                        x0 + i * h, yprime, args, wsms, NULL, ynext
+                );
+            }
+            search.x = x0 + (i - 1) * h;
+            search.y0 = real_multistep_prev_step(wsms, j + 1);
+            search.f0 = real_multistep_prev_der(wsms, j + 1);
+            search.y1 = real_multistep_prev_step(wsms, j);
+            search.f1 = real_multistep_prev_der(wsms, j);
+            real_events_at(&search, x0 + i * h, search.y1, search.gnext);
+            stop = real_process_events(&search, handler, obs_args, xstop);
+            if (stop >= 0) break;
+            real_observe(
+                    observer, obs_args, out_every, i, nsteps, x0 + i * h,
+                    sys_size, search.y1
+            );
+            gswap = search.gprev;
+            search.gprev = search.gnext;
+            search.gnext = gswap;
+        }
+        ycur = search.yint;
+        if (stop < 0) ycur = real_multistep_prev_step(wsms, 0);
+        for (j = 0; j < sys_size; j++) y[j] = ycur[j];
+        destroy_real_multistep_ws(wsms);
+    }
+
+    destroy_real_dense_ws(search.dense);
+    free(block);
+    if (stop < 0) *xstop = x1;
+    return stop;
+}
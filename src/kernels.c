@@ -0,0 +1,511 @@
+/**
+ * \file kernels.c
+ * \author Alex Andriati
+ * \brief Source code for SIMD linear combination kernels
+ *
+ * See function signature and description in header kernels.h
+ * The instruction set is selected once in the first call, using the CPU
+ * features reported by the compiler builtins, guarded by `pthread_once`
+ * as the first call may come from several threads at the same time.
+ * Each kernel processes at most `KERNEL_MAX_TERMS` weighted terms per
+ * pass, and longer sums (as in high order multistep methods) are split
+ * in several passes which accumulate their scaled partial sums in the
+ * output array. Thus the output cannot be one of the arrays of the later
+ * passes, which are read after it was written.
+ *
+ * This file must be compiled without floating point contraction, see
+ * CMakeLists.txt, to keep the scalar fallback bit-identical to SIMD.
+ *
+ * When built with `ODESYS_OPENMP` the `*_threads` variants split the
+ * arrays in contiguous chunks, one per thread, with boundaries at whole
+ * cache lines (`KERNEL_LINE` doubles). The same partition is used by the
+ * first-touch routines, thus a thread writes the pages it first touched.
+ * Every element undergoes the same operations in any partition, thus
+ * the result does not depend on the number of threads.
+ */
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "kernels.h"
+
+#ifdef ODESYS_OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNELS_X86_DISPATCH
+#include <immintrin.h>
+#endif
+
+#define KERNEL_MAX_TERMS 8
+/* Number of doubles in a cache line, the granularity of thread chunks */
+#define KERNEL_LINE 8
+/* Minimum number of doubles per thread to run in parallel */
+#define KERNEL_MIN_CHUNK 16384
+
+
+typedef void (*lincomb_kernel)(
+        unsigned int,
+        double *,
+        double,
+        unsigned int,
+        double *,
+        double **,
+        double *
+);
+
+
+static void
+lincomb_scalar(
+        unsigned int size,
+        double * base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        double ** v,
+        double * out
+)
+{
+    unsigned int
+        i,
+        k;
+    double
+        acc;
+
+    for (i = 0; i < size; i++)
+    {
+        acc = w[0] * v[0][i];
+        for (k = 1; k < nterms; k++) acc = acc + w[k] * v[k][i];
+        if (base == NULL) out[i] = scale * acc;
+        else              out[i] = base[i] + scale * acc;
+    }
+}
+
+
+#ifdef KERNELS_X86_DISPATCH
+
+__attribute__((target("avx2")))
+static void
+lincomb_avx2(
+        unsigned int size,
+        double * base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        double ** v,
+        double * out
+)
+{
+    unsigned int
+        i,
+        k;
+    double
+        * vtail[KERNEL_MAX_TERMS];
+    __m256d
+        acc,
+        vscale,
+        wk[KERNEL_MAX_TERMS];
+
+    vscale = _mm256_set1_pd(scale);
+    for (k = 0; k < nterms; k++) wk[k] = _mm256_set1_pd(w[k]);
+    for (i = 0; i + 4 <= size; i += 4)
+    {
+        acc = _mm256_mul_pd(wk[0], _mm256_loadu_pd(&v[0][i]));
+        for (k = 1; k < nterms; k++)
+        {
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(wk[k], _mm256_loadu_pd(&v[k][i])));
+        }
+        acc = _mm256_mul_pd(vscale, acc);
+        if (base != NULL) acc = _mm256_add_pd(_mm256_loadu_pd(&base[i]), acc);
+        _mm256_storeu_pd(&out[i], acc);
+    }
+    if (i < size)
+    {
+        for (k = 0; k < nterms; k++) vtail[k] = &v[k][i];
+        lincomb_scalar(
+                size - i, (base == NULL) ? NULL : &base[i],
+                scale, nterms, w, vtail, &out[i]
+        );
+    }
+}
+
+
+__attribute__((target("avx512f")))
+static void
+lincomb_avx512(
+        unsigned int size,
+        double * base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        double ** v,
+        double * out
+)
+{
+    unsigned int
+        i,
+        k;
+    double
+        * vtail[KERNEL_MAX_TERMS];
+    __m512d
+        acc,
+        vscale,
+        wk[KERNEL_MAX_TERMS];
+
+    vscale = _mm512_set1_pd(scale);
+    for (k = 0; k < nterms; k++) wk[k] = _mm512_set1_pd(w[k]);
+    for (i = 0; i + 8 <= size; i += 8)
+    {
+        acc = _mm512_mul_pd(wk[0], _mm512_loadu_pd(&v[0][i]));
+        for (k = 1; k < nterms; k++)
+        {
+            acc = _mm512_add_pd(acc, _mm512_mul_pd(wk[k], _mm512_loadu_pd(&v[k][i])));
+        }
+        acc = _mm512_mul_pd(vscale, acc);
+        if (base != NULL) acc = _mm512_add_pd(_mm512_loadu_pd(&base[i]), acc);
+        _mm512_storeu_pd(&out[i], acc);
+    }
+    if (i < size)
+    {
+        for (k = 0; k < nterms; k++) vtail[k] = &v[k][i];
+        lincomb_scalar(
+                size - i, (base == NULL) ? NULL : &base[i],
+                scale, nterms, w, vtail, &out[i]
+        );
+    }
+}
+
+#endif
+
+
+static lincomb_kernel
+    selected_kernel = &lincomb_scalar;
+
+static const char
+    * selected_name = "scalar";
+
+static pthread_once_t
+    selected_once = PTHREAD_ONCE_INIT;
+
+
+/** \brief Set the widest kernel supported by the CPU (run only once) */
+static void
+select_kernel(void)
+{
+    lincomb_kernel
+        kernel = &lincomb_scalar;
+#ifdef KERNELS_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        kernel = &lincomb_avx512;
+        selected_name = "avx512";
+    }
+    else if (__builtin_cpu_supports("avx2"))
+    {
+        kernel = &lincomb_avx2;
+        selected_name = "avx2";
+    }
+#endif
+    selected_kernel = kernel;
+}
+
+
+const char *
+kernels_simd_name(void)
+{
+    pthread_once(&selected_once, &select_kernel);
+    return selected_name;
+}
+
+
+/** \brief Split the weighted terms in passes of `KERNEL_MAX_TERMS`
+ *
+ * Only the elements from `start` (inclusive) to `end` (exclusive) are
+ * computed, with array addresses given from the first element
+ */
+static void
+lincomb_passes(
+        unsigned int start,
+        unsigned int end,
+        double * base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        double ** v,
+        double * out
+)
+{
+    unsigned int
+        i,
+        k,
+        nchunk;
+    double
+        * vr[KERNEL_MAX_TERMS];
+
+    if (nterms == 0)
+    {
+        for (i = start; i < end; i++)
+        {
+            out[i] = (base == NULL) ? 0 : base[i];
+        }
+        return;
+    }
+    while (nterms > 0)
+    {
+        nchunk = nterms < KERNEL_MAX_TERMS ? nterms : KERNEL_MAX_TERMS;
+        for (k = 0; k < nchunk; k++) vr[k] = v[k] + start;
+        selected_kernel(
+                end - start, (base == NULL) ? NULL : base + start,
+                scale, nchunk, w, vr, out + start
+        );
+        /* further passes accumulate over the partial sum */
+        base = out;
+        nterms = nterms - nchunk;
+        w = w + nchunk;
+        v = v + nchunk;
+    }
+}
+
+
+/** \brief Number of threads actually used for arrays of `size` doubles */
+static int
+kernel_threads(int nthreads, unsigned int size)
+{
+#ifdef ODESYS_OPENMP
+    if (nthreads > (int) (size / KERNEL_MIN_CHUNK))
+    {
+        nthreads = size / KERNEL_MIN_CHUNK;
+    }
+    return nthreads < 1 ? 1 : nthreads;
+#else
+    (void) nthreads;
+    (void) size;
+    return 1;
+#endif
+}
+
+
+#ifdef ODESYS_OPENMP
+
+/** \brief Chunk of thread `t` among `nt` with cache line boundaries */
+static void
+thread_chunk(
+        unsigned int size,
+        unsigned int t,
+        unsigned int nt,
+        unsigned int * start,
+        unsigned int * end
+)
+{
+    unsigned int
+        lines,
+        per,
+        extra;
+
+    lines = (size + KERNEL_LINE - 1) / KERNEL_LINE;
+    per = lines / nt;
+    extra = lines % nt;
+    *start = t * per + (t < extra ? t : extra);
+    *end = *start + per + (t < extra ? 1 : 0);
+    *start = *start * KERNEL_LINE;
+    *end = *end * KERNEL_LINE;
+    if (*start > size) *start = size;
+    if (*end > size) *end = size;
+}
+
+#endif
+
+
+/** \brief Run the linear combination splitting the arrays among threads */
+static void
+lincomb_parallel(
+        int nthreads,
+        unsigned int size,
+        double * base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        double ** v,
+        double * out
+)
+{
+    unsigned int
+        k;
+
+    /* arrays of later passes are read after the partial sum is written */
+    for (k = KERNEL_MAX_TERMS; k < nterms; k++)
+    {
+        if (v[k] == out)
+        {
+            printf("\n\nOutput of linear combination is term %u, beyond "
+                   "the %d terms of first pass\n\n", k, KERNEL_MAX_TERMS);
+            exit(EXIT_FAILURE);
+        }
+    }
+    pthread_once(&selected_once, &select_kernel);
+    nthreads = kernel_threads(nthreads, size);
+    if (nthreads == 1)
+    {
+        lincomb_passes(0, size, base, scale, nterms, w, v, out);
+        return;
+    }
+#ifdef ODESYS_OPENMP
+    #pragma omp parallel num_threads(nthreads)
+    {
+        unsigned int
+            start,
+            end;
+        thread_chunk(
+                size, omp_get_thread_num(), omp_get_num_threads(),
+                &start, &end
+        );
+        lincomb_passes(start, end, base, scale, nterms, w, v, out);
+    }
+#endif
+}
+
+
+/** \brief Set array to zero with the pages first touched by its thread */
+static void
+first_touch(int nthreads, unsigned int size, double * arr)
+{
+    unsigned int
+        i;
+
+    nthreads = kernel_threads(nthreads, size);
+    if (nthreads == 1)
+    {
+        for (i = 0; i < size; i++) arr[i] = 0;
+        return;
+    }
+#ifdef ODESYS_OPENMP
+    #pragma omp parallel num_threads(nthreads)
+    {
+        unsigned int
+            j,
+            start,
+            end;
+        thread_chunk(
+                size, omp_get_thread_num(), omp_get_num_threads(),
+                &start, &end
+        );
+        for (j = start; j < end; j++) arr[j] = 0;
+    }
+#endif
+}
+
+
+void
+rarr_lincomb(
+        unsigned int size,
+        Rarray base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        Rarray * v,
+        Rarray out
+)
+{
+    lincomb_parallel(1, size, base, scale, nterms, w, v, out);
+}
+
+
+void
+carr_lincomb(
+        unsigned int size,
+        Carray base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        Carray * v,
+        Carray out
+)
+{
+    carr_lincomb_threads(1, size, base, scale, nterms, w, v, out);
+}
+
+
+void
+rarr_lincomb_threads(
+        int nthreads,
+        unsigned int size,
+        Rarray base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        Rarray * v,
+        Rarray out
+)
+{
+    lincomb_parallel(nthreads, size, base, scale, nterms, w, v, out);
+}
+
+
+void
+carr_lincomb_threads(
+        int nthreads,
+        unsigned int size,
+        Carray base,
+        double scale,
+        unsigned int nterms,
+        double * w,
+        Carray * v,
+        Carray out
+)
+{
+    unsigned int
+        k,
+        nchunk;
+    double
+        * vr[KERNEL_MAX_TERMS];
+
+    /* arrays of later passes are read after the partial sum is written */
+    for (k = KERNEL_MAX_TERMS; k < nterms; k++)
+    {
+        if (v[k] == out)
+        {
+            printf("\n\nOutput of linear combination is term %u, beyond "
+                   "the %d terms of first pass\n\n", k, KERNEL_MAX_TERMS);
+            exit(EXIT_FAILURE);
+        }
+    }
+    /* real weights scale real and imaginary parts independently */
+    if (nterms == 0)
+    {
+        lincomb_parallel(
+                nthreads, 2 * size, (double *) base, scale, 0, w, vr,
+                (double *) out
+        );
+        return;
+    }
+    while (nterms > 0)
+    {
+        nchunk = nterms < KERNEL_MAX_TERMS ? nterms : KERNEL_MAX_TERMS;
+        for (k = 0; k < nchunk; k++) vr[k] = (double *) v[k];
+        lincomb_parallel(
+                nthreads, 2 * size, (double *) base, scale, nchunk, w, vr,
+                (double *) out
+        );
+        base = out;
+        nterms = nterms - nchunk;
+        w = w + nchunk;
+        v = v + nchunk;
+    }
+}
+
+
+void
+rarr_first_touch(int nthreads, unsigned int size, Rarray arr)
+{
+    first_touch(nthreads, size, arr);
+}
+
+
+void
+carr_first_touch(int nthreads, unsigned int size, Carray arr)
+{
+    first_touch(nthreads, 2 * size, (double *) arr);
+}
@@ -0,0 +1,673 @@
+/**
+ * \file lowstorage.c
+ * \author Alex Andriati
+ * \brief Source code for low-storage Runge-Kutta methods
+ *
+ * See function signature and description in header lowstorage.h
+ * The 2N form is implemented with the increment divided by `h`, thus
+ * the derivative of the first stage is written in the increment itself
+ * Some references
+ *
+ * [1] J.H. Williamson, Low-storage Runge-Kutta schemes, J. Comput. Phys.
+ * 35 (1980) 48-56
+ * [2] M.H. Carpenter and C.A. Kennedy, Fourth-order 2N-storage Runge-Kutta
+ * schemes, NASA TM 109112 (1994)
+ * [3] C.A. Kennedy, M.H. Carpenter and R.M. Lewis, Low-storage, explicit
+ * Runge-Kutta schemes for the compressible Navier-Stokes equations, Appl.
+ * Numer. Math. 35 (2000) 177-219
+ * [4] D.I. Ketcheson, Highly efficient strong stability-preserving
+ * Runge-Kutta methods with low-storage implementations, SIAM J. Sci.
+ * Comput. 30 (2008) 2113-2136
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lowstorage.h"
+#include "singlestep.h"
+#include "kernels.h"
+
+
+static const double
+    WILLIAMSON_3_A[3] = {0, - 5.0 / 9, - 153.0 / 128},
+    WILLIAMSON_3_B[3] = {1.0 / 3, 15.0 / 16, 8.0 / 15},
+    WILLIAMSON_3_C[3] = {0, 1.0 / 3, 3.0 / 4};
+
+static const double
+    CARPENTER_KENNEDY_4_A[5] = {
+        0,
+        - 567301805773.0 / 1357537059087,
+        - 2404267990393.0 / 2016746695238,
+        - 3550918686646.0 / 2091501179385,
+        - 1275806237668.0 / 842570457699
+    },
+    CARPENTER_KENNEDY_4_B[5] = {
+        1432997174477.0 / 9575080441755,
+        5161836677717.0 / 13612068292357,
+        1720146321549.0 / 2090206949498,
+        3134564353537.0 / 4481467310338,
+        2277821191437.0 / 14882151754819
+    },
+    CARPENTER_KENNEDY_4_C[5] = {
+        0,
+        1432997174477.0 / 9575080441755,
+        2526269341429.0 / 6820363962896,
+        2006345519317.0 / 3224310063776,
+        2802321613138.0 / 2924317926251
+    };
+
+static const double
+    WRAY_3_A[2] = {8.0 / 15, 5.0 / 12},
+    WRAY_3_B[3] = {1.0 / 4, 0, 3.0 / 4},
+    WRAY_3_C[3] = {0, 8.0 / 15, 2.0 / 3};
+
+/* Ref. [4], SSPRK(10,4) in which the stage after the fifth mixes in the
+ * initial solution accumulated in `S2`, which is reused in the last one */
+static const double
+    SSP_10_4_GAMMA1[10] = {
+        1.0, 1.0, 1.0, 1.0, 2.0 / 5, 1.0, 1.0, 1.0, 1.0, 3.0 / 5
+    },
+    SSP_10_4_GAMMA2[10] = {
+        0, 0, 0, 0, 3.0 / 5, 0, 0, 0, 0, - 1.0 / 2
+    },
+    SSP_10_4_BETA[10] = {
+        1.0 / 6, 1.0 / 6, 1.0 / 6, 1.0 / 6, 1.0 / 15,
+        1.0 / 6, 1.0 / 6, 1.0 / 6, 1.0 / 6, 1.0 / 10
+    },
+    SSP_10_4_DELTA[10] = {
+        1.0, 0, 0, 0, 0, - 9.0 / 5, 0, 0, 0, 0
+    },
+    SSP_10_4_C[10] = {
+        0, 1.0 / 6, 1.0 / 3, 1.0 / 2, 2.0 / 3,
+        1.0 / 3, 1.0 / 2, 2.0 / 3, 5.0 / 6, 1.0
+    };
+
+/* Ref. [4], SSPRK(4,3) with the initial solution kept in `S3` */
+static const double
+    SSP_4_3_GAMMA1[4] = {1.0, 1.0, 1.0 / 3, 1.0},
+    SSP_4_3_GAMMA2[4] = {0, 0, 0, 0},
+    SSP_4_3_GAMMA3[4] = {0, 0, 2.0 / 3, 0},
+    SSP_4_3_BETA[4] = {1.0 / 2, 1.0 / 2, 1.0 / 6, 1.0 / 2},
+    SSP_4_3_DELTA[4] = {0, 0, 0, 0},
+    SSP_4_3_C[4] = {0, 1.0 / 2, 1.0, 1.0 / 2};
+
+const LowStorage2N LS2N_WILLIAMSON_3 = {
+    "williamson_3", 3, 3, WILLIAMSON_3_A, WILLIAMSON_3_B, WILLIAMSON_3_C
+};
+
+const LowStorage2N LS2N_CARPENTER_KENNEDY_4 = {
+    "carpenter_kennedy_4", 5, 4,
+    CARPENTER_KENNEDY_4_A, CARPENTER_KENNEDY_4_B, CARPENTER_KENNEDY_4_C
+};
+
+const LowStorage3R LS3R_WRAY_3 = {
+    "wray_3", 3, 3, WRAY_3_A, WRAY_3_B, WRAY_3_C
+};
+
+const LowStorage3S LS2S_KETCHESON_SSP_10_4 = {
+    "ketcheson_ssp_10_4", 10, 4,
+    SSP_10_4_GAMMA1, SSP_10_4_GAMMA2, NULL, SSP_10_4_BETA, SSP_10_4_DELTA,
+    SSP_10_4_C
+};
+
+const LowStorage3S LS3S_KETCHESON_SSP_4_3 = {
+    "ketcheson_ssp_4_3", 4, 3,
+    SSP_4_3_GAMMA1, SSP_4_3_GAMMA2, SSP_4_3_GAMMA3, SSP_4_3_BETA,
+    SSP_4_3_DELTA, SSP_4_3_C
+};
+
+
+ComplexWorkspaceLowStorage
+get_cplx_lowstorage_ws(int sys_size, int registers)
+{
+    unsigned long
+        stride;
+    char
+        * block;
+    ComplexWorkspaceLowStorage
+        ws;
+
+    if (registers < LOWSTORAGE_REGISTERS ||
+        registers > LOWSTORAGE_3S_REGISTERS)
+    {
+        printf("\n\nInvalid number of low-storage registers %d\n\n",
+               registers);
+        exit(EXIT_FAILURE);
+    }
+    ws = (ComplexWorkspaceLowStorage)
+        malloc(sizeof(_ComplexWorkspaceLowStorage));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceLowStorage allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    /* same padding between registers of the Runge-Kutta arena */
+    stride = cplx_rungekutta_ws_bytes(sys_size, registers) / registers;
+    block = (char *) aligned_alloc(RK_WS_ALIGNMENT, registers * stride);
+    if (block == NULL)
+    {
+        printf("\n\nProblem in low-storage registers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->registers = registers;
+    ws->nthreads = 1;
+    ws->arena = block;
+    ws->work1 = (Carray) block;
+    ws->work2 = (Carray) (block + stride);
+    ws->work3 = NULL;
+    if (registers > 2) ws->work3 = (Carray) (block + 2 * stride);
+    return ws;
+}
+
+
+RealWorkspaceLowStorage
+get_real_lowstorage_ws(int sys_size, int registers)
+{
+    unsigned long
+        stride;
+    char
+        * block;
+    RealWorkspaceLowStorage
+        ws;
+
+    if (registers < LOWSTORAGE_REGISTERS ||
+        registers > LOWSTORAGE_3S_REGISTERS)
+    {
+        printf("\n\nInvalid number of low-storage registers %d\n\n",
+               registers);
+        exit(EXIT_FAILURE);
+    }
+    ws = (RealWorkspaceLowStorage) malloc(sizeof(_RealWorkspaceLowStorage));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceLowStorage allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    /* same padding between registers of the Runge-Kutta arena */
+    stride = real_rungekutta_ws_bytes(sys_size, registers) / registers;
+    block = (char *) aligned_alloc(RK_WS_ALIGNMENT, registers * stride);
+    if (block == NULL)
+    {
+        printf("\n\nProblem in low-storage registers allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->registers = registers;
+    ws->nthreads = 1;
+    ws->arena = block;
+    ws->work1 = (Rarray) block;
+    ws->work2 = (Rarray) (block + stride);
+    ws->work3 = NULL;
+    if (registers > 2) ws->work3 = (Rarray) (block + 2 * stride);
+    return ws;
+}
+
+
+void
+set_cplx_lowstorage_threads(ComplexWorkspaceLowStorage ws, int nthreads)
+{
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    carr_first_touch(ws->nthreads, ws->system_size, ws->work1);
+    carr_first_touch(ws->nthreads, ws->system_size, ws->work2);
+    if (ws->work3 != NULL)
+    {
+        carr_first_touch(ws->nthreads, ws->system_size, ws->work3);
+    }
+}
+
+
+void
+set_real_lowstorage_threads(RealWorkspaceLowStorage ws, int nthreads)
+{
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    rarr_first_touch(ws->nthreads, ws->system_size, ws->work1);
+    rarr_first_touch(ws->nthreads, ws->system_size, ws->work2);
+    if (ws->work3 != NULL)
+    {
+        rarr_first_touch(ws->nthreads, ws->system_size, ws->work3);
+    }
+}
+
+
+void
+destroy_cplx_lowstorage_ws(ComplexWorkspaceLowStorage ws)
+{
+    free(ws->arena);
+    free(ws);
+}
+
+
+void
+destroy_real_lowstorage_ws(RealWorkspaceLowStorage ws)
+{
+    free(ws->arena);
+    free(ws);
+}
+
+
+void
+cplx_lowstorage2n_step(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceLowStorage ws,
+        const LowStorage2N * method,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        i,
+        nthreads,
+        sys_size;
+    double
+        w[2];
+    Carray
+        r,
+        k,
+        v[2];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    r = ws->work1;
+    k = ws->work2;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* First stage has A[0] = 0 thus the increment is the derivative */
+    sys_params.x = x;
+    sys_params.y = y;
+    yprime(&sys_params, r);
+    w[0] = method->B[0];
+    v[0] = r;
+    carr_lincomb_threads(nthreads, sys_size, y, h, 1, w, v, ynext);
+    sys_params.y = ynext;
+    v[1] = k;
+    for (i = 1; i < method->stages; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        yprime(&sys_params, k);
+        w[0] = method->A[i];
+        w[1] = 1.0;
+        carr_lincomb_threads(nthreads, sys_size, NULL, 1.0, 2, w, v, r);
+        w[0] = method->B[i];
+        carr_lincomb_threads(nthreads, sys_size, ynext, h, 1, w, v, ynext);
+    }
+}
+
+
+void
+real_lowstorage2n_step(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceLowStorage ws,
+        const LowStorage2N * method,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        i,
+        nthreads,
+        sys_size;
+    double
+        w[2];
+    Rarray
+        r,
+        k,
+        v[2];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    r = ws->work1;
+    k = ws->work2;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* First stage has A[0] = 0 thus the increment is the derivative */
+    sys_params.x = x;
+    sys_params.y = y;
+    yprime(&sys_params, r);
+    w[0] = method->B[0];
+    v[0] = r;
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 1, w, v, ynext);
+    sys_params.y = ynext;
+    v[1] = k;
+    for (i = 1; i < method->stages; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        yprime(&sys_params, k);
+        w[0] = method->A[i];
+        w[1] = 1.0;
+        rarr_lincomb_threads(nthreads, sys_size, NULL, 1.0, 2, w, v, r);
+        w[0] = method->B[i];
+        rarr_lincomb_threads(nthreads, sys_size, ynext, h, 1, w, v, ynext);
+    }
+}
+
+
+void
+cplx_lowstorage3r_step(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceLowStorage ws,
+        const LowStorage3R * method,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        i,
+        j,
+        s,
+        nthreads,
+        sys_size;
+    double
+        w[1];
+    Carray
+        base,
+        karg,
+        k,
+        v[1];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    karg = ws->work1;
+    k = ws->work2;
+    s = method->stages;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* Until first update the solution register is the input `y` */
+    base = y;
+    sys_params.y = y;
+    v[0] = k;
+    for (i = 0; i < s; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        yprime(&sys_params, k);
+        if (i < s - 1)
+        {
+            w[0] = method->a[i];
+            carr_lincomb_threads(nthreads, sys_size, base, h, 1, w, v, karg);
+            sys_params.y = karg;
+        }
+        if (method->b[i] != 0)
+        {
+            w[0] = method->b[i];
+            carr_lincomb_threads(nthreads, sys_size, base, h, 1, w, v, ynext);
+            base = ynext;
+        }
+    }
+    if (base != ynext)
+    {
+        for (j = 0; j < sys_size; j++) ynext[j] = y[j];
+    }
+}
+
+
+void
+real_lowstorage3r_step(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceLowStorage ws,
+        const LowStorage3R * method,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        i,
+        j,
+        s,
+        nthreads,
+        sys_size;
+    double
+        w[1];
+    Rarray
+        base,
+        karg,
+        k,
+        v[1];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    karg = ws->work1;
+    k = ws->work2;
+    s = method->stages;
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* Until first update the solution register is the input `y` */
+    base = y;
+    sys_params.y = y;
+    v[0] = k;
+    for (i = 0; i < s; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        yprime(&sys_params, k);
+        if (i < s - 1)
+        {
+            w[0] = method->a[i];
+            rarr_lincomb_threads(nthreads, sys_size, base, h, 1, w, v, karg);
+            sys_params.y = karg;
+        }
+        if (method->b[i] != 0)
+        {
+            w[0] = method->b[i];
+            rarr_lincomb_threads(nthreads, sys_size, base, h, 1, w, v, ynext);
+            base = ynext;
+        }
+    }
+    if (base != ynext)
+    {
+        for (j = 0; j < sys_size; j++) ynext[j] = y[j];
+    }
+}
+
+
+void
+cplx_lowstorage3s_step(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceLowStorage ws,
+        const LowStorage3S * method,
+        Carray y,
+        Carray ynext
+)
+{
+    int
+        i,
+        j,
+        n,
+        s2_set,
+        nthreads,
+        sys_size;
+    double
+        w[4];
+    Carray
+        s1,
+        s2,
+        s3,
+        k,
+        v[4];
+    _ComplexODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    k = ws->work1;
+    s2 = ws->work2;
+    s3 = NULL;
+
+    if (method->gamma3 != NULL)
+    {
+        if (ws->work3 == NULL)
+        {
+            printf("\n\nMethod %s requires %d low-storage registers\n\n",
+                   method->name, LOWSTORAGE_3S_REGISTERS);
+            exit(EXIT_FAILURE);
+        }
+        /* the input is overwritten only in the in-place step */
+        s3 = y;
+        if (ynext == y)
+        {
+            s3 = ws->work3;
+            for (j = 0; j < sys_size; j++) s3[j] = y[j];
+        }
+    }
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* Until first stage is done the register `S1` is the input `y` */
+    s1 = y;
+    s2_set = 0;
+    for (i = 0; i < method->stages; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        sys_params.y = s1;
+        yprime(&sys_params, k);
+        if (method->delta[i] != 0)
+        {
+            w[0] = method->delta[i];
+            v[0] = s1;
+            carr_lincomb_threads(
+                    nthreads, sys_size, s2_set ? s2 : NULL, 1.0, 1, w, v, s2
+            );
+            s2_set = 1;
+        }
+        n = 0;
+        w[n] = method->gamma1[i];
+        v[n++] = s1;
+        if (s2_set && method->gamma2[i] != 0)
+        {
+            w[n] = method->gamma2[i];
+            v[n++] = s2;
+        }
+        if (s3 != NULL && method->gamma3[i] != 0)
+        {
+            w[n] = method->gamma3[i];
+            v[n++] = s3;
+        }
+        w[n] = h * method->beta[i];
+        v[n++] = k;
+        carr_lincomb_threads(nthreads, sys_size, NULL, 1.0, n, w, v, ynext);
+        s1 = ynext;
+    }
+}
+
+
+void
+real_lowstorage3s_step(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceLowStorage ws,
+        const LowStorage3S * method,
+        Rarray y,
+        Rarray ynext
+)
+{
+    int
+        i,
+        j,
+        n,
+        s2_set,
+        nthreads,
+        sys_size;
+    double
+        w[4];
+    Rarray
+        s1,
+        s2,
+        s3,
+        k,
+        v[4];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    nthreads = ws->nthreads;
+    k = ws->work1;
+    s2 = ws->work2;
+    s3 = NULL;
+
+    if (method->gamma3 != NULL)
+    {
+        if (ws->work3 == NULL)
+        {
+            printf("\n\nMethod %s requires %d low-storage registers\n\n",
+                   method->name, LOWSTORAGE_3S_REGISTERS);
+            exit(EXIT_FAILURE);
+        }
+        /* the input is overwritten only in the in-place step */
+        s3 = y;
+        if (ynext == y)
+        {
+            s3 = ws->work3;
+            for (j = 0; j < sys_size; j++) s3[j] = y[j];
+        }
+    }
+
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    /* Until first stage is done the register `S1` is the input `y` */
+    s1 = y;
+    s2_set = 0;
+    for (i = 0; i < method->stages; i++)
+    {
+        sys_params.x = x + method->c[i] * h;
+        sys_params.y = s1;
+        yprime(&sys_params, k);
+        if (method->delta[i] != 0)
+        {
+            w[0] = method->delta[i];
+            v[0] = s1;
+            rarr_lincomb_threads(
+                    nthreads, sys_size, s2_set ? s2 : NULL, 1.0, 1, w, v, s2
+            );
+            s2_set = 1;
+        }
+        n = 0;
+        w[n] = method->gamma1[i];
+        v[n++] = s1;
+        if (s2_set && method->gamma2[i] != 0)
+        {
+            w[n] = method->gamma2[i];
+            v[n++] = s2;
+        }
+        if (s3 != NULL && method->gamma3[i] != 0)
+        {
+            w[n] = method->gamma3[i];
+            v[n++] = s3;
+        }
+        w[n] = h * method->beta[i];
+        v[n++] = k;
+        rarr_lincomb_threads(nthreads, sys_size, NULL, 1.0, n, w, v, ynext);
+        s1 = ynext;
+    }
+}
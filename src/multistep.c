@@ -21,19 +21,12 @@
  * differential equations, Cambridge, 2nd Edition, cap. 3
  */
 
+#include <math.h>
 #include "multistep.h"
 #include "arrays_assistant.h"
-
-
-static double
-    ADAMS4_LEFT[5] = {1.0, -1.0, 0.0, 0.0, 0.0},
-    ADAMS4_PRED[5] = {0.0, 55.0 / 24, -59.0 / 24, 37.0 / 24, -9.0 / 24},
-    ADAMS4_CORR[5] = {9.0 / 24, 19.0 / 24, -5.0 / 24, 1.0 / 24, 0.0};
-
-static double
-    ADAMS6_LEFT[7] = {1.0, -1.0, 0.0, 0.0, 0.0, 0.0, 0.0},
-    ADAMS6_PRED[7] = {0.0, 4277.0 / 1440, -7923.0 / 1440, 9982.0 / 1440, -7298.0 / 1440, 2877.0 / 1440, -475.0 / 1440},
-    ADAMS6_CORR[7] = {475.0 / 1440, 1427.0 / 1440, -798.0 / 1440, 482.0 / 1440, -173.0 / 1440, 27.0 / 1440, 0.0};
+#include "adams_coefficients.h"
+#include "kernels.h"
+#include "stats_assistant.h"
 
 
 void
@@ -42,6 +35,32 @@ alloc_cplx_multistep_wsarray(ComplexWorkspaceMS ws)
     unsigned int
         full_size = (ws->ms_order + 1) * ws->system_size;
     ws->prev_der = alloc_carr(full_size);
+    ws->yhist = NULL;
+    ws->head = 0;
+    ws->nthreads = 1;
+    ws->stats = NULL;
+}
+
+
+void
+alloc_cplx_multistep_wshistory(ComplexWorkspaceMS ws)
+{
+    ws->yhist = alloc_carr(ws->ms_order * ws->system_size);
+    ws->head = 0;
+}
+
+
+Carray
+cplx_multistep_prev_step(ComplexWorkspaceMS ws, unsigned int j)
+{
+    return &ws->yhist[((ws->head + j) % ws->ms_order) * ws->system_size];
+}
+
+
+Carray
+cplx_multistep_prev_der(ComplexWorkspaceMS ws, unsigned int j)
+{
+    return &ws->prev_der[((ws->head + j) % ws->ms_order) * ws->system_size];
 }
 
 
@@ -51,6 +70,53 @@ alloc_real_multistep_wsarray(RealWorkspaceMS ws)
     unsigned int
         full_size = (ws->ms_order + 1) * ws->system_size;
     ws->prev_der = alloc_rarr(full_size);
+    ws->yhist = NULL;
+    ws->head = 0;
+    ws->nthreads = 1;
+    ws->stats = NULL;
+}
+
+
+void
+alloc_real_multistep_wshistory(RealWorkspaceMS ws)
+{
+    ws->yhist = alloc_rarr(ws->ms_order * ws->system_size);
+    ws->head = 0;
+}
+
+
+Rarray
+real_multistep_prev_step(RealWorkspaceMS ws, unsigned int j)
+{
+    return &ws->yhist[((ws->head + j) % ws->ms_order) * ws->system_size];
+}
+
+
+Rarray
+real_multistep_prev_der(RealWorkspaceMS ws, unsigned int j)
+{
+    return &ws->prev_der[((ws->head + j) % ws->ms_order) * ws->system_size];
+}
+
+
+void
+set_cplx_multistep_threads(ComplexWorkspaceMS ws, int nthreads)
+{
+    int
+        j,
+        s;
+
+    s = ws->system_size;
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    for (j = 0; j <= ws->ms_order; j++)
+    {
+        carr_first_touch(ws->nthreads, s, &ws->prev_der[j * s]);
+    }
+    if (ws->yhist == NULL) return;
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        carr_first_touch(ws->nthreads, s, &ws->yhist[j * s]);
+    }
 }
 
 
@@ -58,6 +124,28 @@ void
 free_cplx_multistep_wsarray(ComplexWorkspaceMS ws)
 {
     free(ws->prev_der);
+    if (ws->yhist != NULL) free(ws->yhist);
+}
+
+
+void
+set_real_multistep_threads(RealWorkspaceMS ws, int nthreads)
+{
+    int
+        j,
+        s;
+
+    s = ws->system_size;
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    for (j = 0; j <= ws->ms_order; j++)
+    {
+        rarr_first_touch(ws->nthreads, s, &ws->prev_der[j * s]);
+    }
+    if (ws->yhist == NULL) return;
+    for (j = 0; j < ws->ms_order; j++)
+    {
+        rarr_first_touch(ws->nthreads, s, &ws->yhist[j * s]);
+    }
 }
 
 
@@ -65,6 +153,7 @@ void
 free_real_multistep_wsarray(RealWorkspaceMS ws)
 {
     free(ws->prev_der);
+    if (ws->yhist != NULL) free(ws->yhist);
 }
 
 
@@ -83,37 +172,44 @@ init_real_multistep(
         i,
         j,
         sys_size;
-    Rarray
-        ywork;
     RealWorkspaceRK
         wsrk;
     _RealODEInputParameters
         inp;
 
+    if (yms_init == NULL && ws->yhist == NULL)
+    {
+        printf("\n\nMultistep initialization requires the array of "
+               "previous steps or workspace in history mode\n\n");
+        exit(EXIT_FAILURE);
+    }
     sys_size = ws->system_size;
-    ywork = alloc_rarr(sys_size);
     wsrk = get_real_rungekutta_ws(sys_size);
-    rarr_copy_values(sys_size, y0, ywork);
+    wsrk->stats = ws->stats;
+    if (yms_init == NULL)
+    {
+        yms_init = ws->yhist;
+        ws->head = 0;
+    }
+    j = (ws->ms_order - 1) * sys_size;
+    rarr_copy_values(sys_size, y0, &yms_init[j]);
 
     inp.x = 0;
-    inp.y = ywork;
+    inp.y = &yms_init[j];
     inp.extra_args = args;
     inp.system_size = sys_size;
+    STATS_RHS(ws->stats, yprime(&inp, &ws->prev_der[j]));
 
-    j = (ws->ms_order - 1) * sys_size;
-    rarr_copy_values(sys_size, ywork, &yms_init[j]);
-    yprime(&inp, &ws->prev_der[j]);
-
+    /* each step starts from the previous chunk, no extra copy needed */
     for (i = 1; i < ws->ms_order; i++)
     {
         j = (ws->ms_order - 1 - i) * sys_size;
-        (*rk)(h, inp.x, yprime, args, wsrk, ywork, &yms_init[j]);
-        rarr_copy_values(sys_size, &yms_init[j], ywork);
+        (*rk)(h, inp.x, yprime, args, wsrk, &yms_init[j + sys_size], &yms_init[j]);
         inp.x = i * h;
-        yprime(&inp, &ws->prev_der[j]);
+        inp.y = &yms_init[j];
+        STATS_RHS(ws->stats, yprime(&inp, &ws->prev_der[j]));
     }
 
-    free(ywork);
     destroy_real_rungekutta_ws(wsrk);
 }
 
@@ -133,37 +229,44 @@ init_cplx_multistep(
         i,
         j,
         sys_size;
-    Carray
-        ywork;
     ComplexWorkspaceRK
         wsrk;
     _ComplexODEInputParameters
         inp;
 
+    if (yms_init == NULL && ws->yhist == NULL)
+    {
+        printf("\n\nMultistep initialization requires the array of "
+               "previous steps or workspace in history mode\n\n");
+        exit(EXIT_FAILURE);
+    }
     sys_size = ws->system_size;
-    ywork = alloc_carr(sys_size);
     wsrk = get_cplx_rungekutta_ws(sys_size);
-    carr_copy_values(sys_size, y0, ywork);
+    wsrk->stats = ws->stats;
+    if (yms_init == NULL)
+    {
+        yms_init = ws->yhist;
+        ws->head = 0;
+    }
+    j = (ws->ms_order - 1) * sys_size;
+    carr_copy_values(sys_size, y0, &yms_init[j]);
 
     inp.x = 0;
-    inp.y = ywork;
+    inp.y = &yms_init[j];
     inp.extra_args = args;
     inp.system_size = sys_size;
+    STATS_RHS(ws->stats, yprime(&inp, &ws->prev_der[j]));
 
-    j = (ws->ms_order - 1) * sys_size;
-    carr_copy_values(sys_size, ywork, &yms_init[j]);
-    yprime(&inp, &ws->prev_der[j]);
-
+    /* each step starts from the previous chunk, no extra copy needed */
     for (i = 1; i < ws->ms_order; i++)
     {
         j = (ws->ms_order - 1 - i) * sys_size;
-        (*rk)(h, inp.x, yprime, args, wsrk, ywork, &yms_init[j]);
-        carr_copy_values(sys_size, &yms_init[j], ywork);
+        (*rk)(h, inp.x, yprime, args, wsrk, &yms_init[j + sys_size], &yms_init[j]);
         inp.x = i * h;
-        yprime(&inp, &ws->prev_der[j]);
+        inp.y = &yms_init[j];
+        STATS_RHS(ws->stats, yprime(&inp, &ws->prev_der[j]));
     }
 
-    free(ywork);
     destroy_cplx_rungekutta_ws(wsrk);
 }
 
@@ -179,6 +282,11 @@ get_cplx_multistep_ws(unsigned int ms_order, unsigned int sys_size)
         printf("\n\nProblem in ComplexWorkspaceMS allocation\n\n");
         exit(EXIT_FAILURE);
     }
+    if (ms_order < 1 || ms_order > MULTISTEP_MAX_ORDER)
+    {
+        printf("\n\nInvalid multistep order %u\n\n", ms_order);
+        exit(EXIT_FAILURE);
+    }
     ws->ms_order = ms_order;
     ws->system_size = sys_size;
     alloc_cplx_multistep_wsarray(ws);
@@ -197,6 +305,11 @@ get_real_multistep_ws(unsigned int ms_order, unsigned int sys_size)
         printf("\n\nProbelm in RealWorkspaceMS allocation\n\n");
         exit(EXIT_FAILURE);
     }
+    if (ms_order < 1 || ms_order > MULTISTEP_MAX_ORDER)
+    {
+        printf("\n\nInvalid multistep order %u\n\n", ms_order);
+        exit(EXIT_FAILURE);
+    }
     ws->ms_order = ms_order;
     ws->system_size = sys_size;
     alloc_real_multistep_wsarray(ws);
@@ -204,18 +317,40 @@ get_real_multistep_ws(unsigned int ms_order, unsigned int sys_size)
 }
 
 
+ComplexWorkspaceMS
+get_cplx_multistep_history_ws(unsigned int ms_order, unsigned int sys_size)
+{
+    ComplexWorkspaceMS
+        ws;
+    ws = get_cplx_multistep_ws(ms_order, sys_size);
+    alloc_cplx_multistep_wshistory(ws);
+    return ws;
+}
+
+
 void
 destroy_cplx_multistep_ws(ComplexWorkspaceMS ws)
 {
-    free(ws->prev_der);
+    free_cplx_multistep_wsarray(ws);
     free(ws);
 }
 
 
+RealWorkspaceMS
+get_real_multistep_history_ws(unsigned int ms_order, unsigned int sys_size)
+{
+    RealWorkspaceMS
+        ws;
+    ws = get_real_multistep_ws(ms_order, sys_size);
+    alloc_real_multistep_wshistory(ws);
+    return ws;
+}
+
+
 void
 destroy_real_multistep_ws(RealWorkspaceMS ws)
 {
-    free(ws->prev_der);
+    free_real_multistep_wsarray(ws);
     free(ws);
 }
 
@@ -248,6 +383,18 @@ cplx_set_next_multistep(
     sys_params.y = ynext;
     sys_params.system_size = s;
     sys_params.extra_args = args;
+    STATS_BEGIN(ws->stats);
+    STATS_ADD(ws->stats, steps, 1);
+
+    if (ws->yhist != NULL)
+    {
+        /* oldest chunk of circular history becomes the most recent */
+        ws->head = (ws->head + m - 1) % m;
+        carr_copy_values(s, ynext, &ws->yhist[ws->head * s]);
+        STATS_RHS(ws->stats, yprime(&sys_params, &der[ws->head * s]));
+        STATS_END(ws->stats);
+        return;
+    }
 
     /* shift chunks representing concatenated previous steps */
     for (j = m - 1; j > 0; j--)
@@ -259,7 +406,8 @@ cplx_set_next_multistep(
         }
     }
     carr_copy_values(s, ynext, y);
-    yprime(&sys_params, der);
+    STATS_RHS(ws->stats, yprime(&sys_params, der));
+    STATS_END(ws->stats);
 }
 
 
@@ -291,6 +439,18 @@ real_set_next_multistep(
     sys_params.y = ynext;
     sys_params.system_size = s;
     sys_params.extra_args = args;
+    STATS_BEGIN(ws->stats);
+    STATS_ADD(ws->stats, steps, 1);
+
+    if (ws->yhist != NULL)
+    {
+        /* oldest chunk of circular history becomes the most recent */
+        ws->head = (ws->head + m - 1) % m;
+        rarr_copy_values(s, ynext, &ws->yhist[ws->head * s]);
+        STATS_RHS(ws->stats, yprime(&sys_params, &der[ws->head * s]));
+        STATS_END(ws->stats);
+        return;
+    }
 
     /* shift chunks representing concatenated previous steps */
     for (j = m - 1; j > 0; j--)
@@ -302,7 +462,8 @@ real_set_next_multistep(
         }
     }
     rarr_copy_values(s, ynext, y);
-    yprime(&sys_params, der);
+    STATS_RHS(ws->stats, yprime(&sys_params, der));
+    STATS_END(ws->stats);
 }
 
 
@@ -321,58 +482,70 @@ cplx_general_multistep(
 )
 {
     int
-        i,
         j,
         m,
         s,
+        n,
         stride;
-    double complex
-        summ;
+    double
+        w[2 * MULTISTEP_MAX_ORDER + 1];
     Carray
-        der;
+        der,
+        yprev,
+        v[2 * MULTISTEP_MAX_ORDER + 1];
+    _ComplexODEInputParameters
+        sys_params;
 
     m = ws->ms_order;
     s = ws->system_size;
     der = ws->prev_der;
+    yprev = (ws->yhist != NULL) ? ws->yhist : y;
+    STATS_BEGIN(ws->stats);
 
-    if (!iter)
+    /* weights and previous steps `y_j ... y_j+1-m` read through circular
+     * index, skipping zero coefficients. First term is left for implicit
+     * derivative `y'_j+1` used only in the corrector */
+    n = 0;
+    for (j = 1; j <= m; j++)
     {
-        for (i = 0; i < s; i++)
+        stride = ((ws->head + j - 1) % m) * s;
+        if (b[j] != 0)
+        {
+            n++;
+            w[n] = h * b[j];
+            v[n] = &der[stride];
+        }
+        if (a[j] != 0)
         {
-            summ = 0;
-            for (j = 1; j <= m; j++)
-            {
-                stride = i + (j - 1) * s;
-                summ = summ + h * b[j] * der[stride] - a[j] * y[stride];
-            }
-            ynext[i] = summ;
+            n++;
+            w[n] = - a[j];
+            v[n] = &yprev[stride];
         }
+    }
+
+    if (!iter)
+    {
+        carr_lincomb_threads(ws->nthreads, s, NULL, 1.0, n, &w[1], &v[1], ynext);
+        STATS_END(ws->stats);
         return;
     }
 
     /* Implicit scheme used as corrector *
      * `ynext` must provide a prediction */
-    _ComplexODEInputParameters
-        sys_params;
     sys_params.x = x + h;
     sys_params.y = ynext;
     sys_params.extra_args = args;
     sys_params.system_size = ws->system_size;
+    w[0] = h * b[0];
+    v[0] = &der[m * s];
+    STATS_ADD(ws->stats, iterations, iter);
     while (iter > 0)
     {
-        yprime(&sys_params, &der[m * s]);
-        for (i = 0; i < s; i++)
-        {
-            summ = h * b[0] * der[i + m * s];
-            for (j = 1; j <= m; j++)
-            {
-                stride = i + (j - 1) * s;
-                summ = summ + h * b[j] * der[stride] - a[j] * y[stride];
-            }
-            ynext[i] = summ;
-        }
+        STATS_RHS(ws->stats, yprime(&sys_params, &der[m * s]));
+        carr_lincomb_threads(ws->nthreads, s, NULL, 1.0, n + 1, w, v, ynext);
         iter--;
     }
+    STATS_END(ws->stats);
 }
 
 
@@ -391,58 +564,70 @@ real_general_multistep(
 )
 {
     int
-        i,
         j,
         m,
         s,
+        n,
         stride;
     double
-        summ;
+        w[2 * MULTISTEP_MAX_ORDER + 1];
     Rarray
-        der;
+        der,
+        yprev,
+        v[2 * MULTISTEP_MAX_ORDER + 1];
+    _RealODEInputParameters
+        sys_params;
 
     m = ws->ms_order;
     s = ws->system_size;
     der = ws->prev_der;
+    yprev = (ws->yhist != NULL) ? ws->yhist : y;
+    STATS_BEGIN(ws->stats);
 
-    if (!iter)
+    /* weights and previous steps `y_j ... y_j+1-m` read through circular
+     * index, skipping zero coefficients. First term is left for implicit
+     * derivative `y'_j+1` used only in the corrector */
+    n = 0;
+    for (j = 1; j <= m; j++)
     {
-        for (i = 0; i < s; i++)
+        stride = ((ws->head + j - 1) % m) * s;
+        if (b[j] != 0)
+        {
+            n++;
+            w[n] = h * b[j];
+            v[n] = &der[stride];
+        }
+        if (a[j] != 0)
         {
-            summ = 0;
-            for (j = 1; j <= m; j++)
-            {
-                stride = i + (j - 1) * s;
-                summ = summ + h * b[j] * der[stride] - a[j] * y[stride];
-            }
-            ynext[i] = summ;
+            n++;
+            w[n] = - a[j];
+            v[n] = &yprev[stride];
         }
+    }
+
+    if (!iter)
+    {
+        rarr_lincomb_threads(ws->nthreads, s, NULL, 1.0, n, &w[1], &v[1], ynext);
+        STATS_END(ws->stats);
         return;
     }
 
     /* Implicit scheme used as corrector *
      * `ynext` must provide a prediction */
-    _RealODEInputParameters
-        sys_params;
     sys_params.x = x + h;
     sys_params.y = ynext;
     sys_params.extra_args = args;
     sys_params.system_size = ws->system_size;
+    w[0] = h * b[0];
+    v[0] = &der[m * s];
+    STATS_ADD(ws->stats, iterations, iter);
     while (iter > 0)
     {
-        yprime(&sys_params, &der[m * s]);
-        for (i = 0; i < s; i++)
-        {
-            summ = h * b[0] * der[i + m * s];
-            for (j = 1; j <= m; j++)
-            {
-                stride = i + (j - 1) * s;
-                summ = summ + h * b[j] * der[stride] - a[j] * y[stride];
-            }
-            ynext[i] = summ;
-        }
+        STATS_RHS(ws->stats, yprime(&sys_params, &der[m * s]));
+        rarr_lincomb_threads(ws->nthreads, s, NULL, 1.0, n + 1, w, v, ynext);
         iter--;
     }
+    STATS_END(ws->stats);
 }
 
 
@@ -532,3 +717,313 @@ real_adams6pc(
             h, x, yprime, args, ws, y, ADAMS6_LEFT, ADAMS6_CORR, iter, ynext
     );
 }
+
+
+ComplexCorrectorControl
+get_cplx_corrector_control(
+        int sys_size,
+        unsigned int max_iter,
+        double abs_tol,
+        double rel_tol
+)
+{
+    ComplexCorrectorControl
+        ctrl = (ComplexCorrectorControl) malloc(sizeof(_ComplexCorrectorControl));
+    if (ctrl == NULL)
+    {
+        printf("\n\nProblem in ComplexCorrectorControl allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ctrl->system_size = sys_size;
+    ctrl->max_iter = (max_iter > 0) ? max_iter : 1;
+    ctrl->abs_tol = abs_tol;
+    ctrl->rel_tol = rel_tol;
+    ctrl->iterations = 0;
+    ctrl->converged = 0;
+    ctrl->change_norm = 0;
+    ctrl->milne_norm = 0;
+    ctrl->ypred = alloc_carr(sys_size);
+    ctrl->yprev = alloc_carr(sys_size);
+    return ctrl;
+}
+
+
+RealCorrectorControl
+get_real_corrector_control(
+        int sys_size,
+        unsigned int max_iter,
+        double abs_tol,
+        double rel_tol
+)
+{
+    RealCorrectorControl
+        ctrl = (RealCorrectorControl) malloc(sizeof(_RealCorrectorControl));
+    if (ctrl == NULL)
+    {
+        printf("\n\nProblem in RealCorrectorControl allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ctrl->system_size = sys_size;
+    ctrl->max_iter = (max_iter > 0) ? max_iter : 1;
+    ctrl->abs_tol = abs_tol;
+    ctrl->rel_tol = rel_tol;
+    ctrl->iterations = 0;
+    ctrl->converged = 0;
+    ctrl->change_norm = 0;
+    ctrl->milne_norm = 0;
+    ctrl->ypred = alloc_rarr(sys_size);
+    ctrl->yprev = alloc_rarr(sys_size);
+    return ctrl;
+}
+
+
+void
+destroy_cplx_corrector_control(ComplexCorrectorControl ctrl)
+{
+    free(ctrl->ypred);
+    free(ctrl->yprev);
+    free(ctrl);
+}
+
+
+void
+destroy_real_corrector_control(RealCorrectorControl ctrl)
+{
+    free(ctrl->ypred);
+    free(ctrl->yprev);
+    free(ctrl);
+}
+
+
+/** \brief Weighted root-mean-square norm of `factor * (y - yref)` */
+static double
+cplx_weighted_diff_norm(ComplexCorrectorControl ctrl, double factor,
+                        Carray y, Carray yref)
+{
+    int
+        i;
+    double
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ctrl->system_size; i++)
+    {
+        e = factor * cabs(y[i] - yref[i])
+          / (ctrl->abs_tol + ctrl->rel_tol * cabs(y[i]));
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ctrl->system_size);
+}
+
+
+/** \brief Weighted root-mean-square norm of `factor * (y - yref)` */
+static double
+real_weighted_diff_norm(RealCorrectorControl ctrl, double factor,
+                        Rarray y, Rarray yref)
+{
+    int
+        i;
+    double
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ctrl->system_size; i++)
+    {
+        e = factor * (y[i] - yref[i])
+          / (ctrl->abs_tol + ctrl->rel_tol * fabs(y[i]));
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ctrl->system_size);
+}
+
+
+/** \brief Predictor followed by corrector iterated until convergence */
+static int
+cplx_adams_controlled(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceMS ws,
+        Carray y,
+        Rarray left,
+        Rarray pred,
+        Rarray corr,
+        double milne,
+        ComplexCorrectorControl ctrl,
+        Carray yerr,
+        Carray ynext
+)
+{
+    int
+        i,
+        s;
+
+    s = ws->system_size;
+    STATS_BEGIN(ws->stats);
+    cplx_general_multistep(h, x, yprime, args, ws, y, left, pred, 0, ynext);
+    carr_copy_values(s, ynext, ctrl->ypred);
+    ctrl->converged = 0;
+    ctrl->iterations = 0;
+    while (ctrl->iterations < ctrl->max_iter)
+    {
+        carr_copy_values(s, ynext, ctrl->yprev);
+        cplx_general_multistep(
+                h, x, yprime, args, ws, y, left, corr, 1, ynext
+        );
+        ctrl->iterations++;
+        ctrl->change_norm = cplx_weighted_diff_norm(
+                ctrl, 1.0, ynext, ctrl->yprev
+        );
+        if (ctrl->change_norm <= 1)
+        {
+            ctrl->converged = 1;
+            break;
+        }
+    }
+
+    /* Milne device with the predictor minus corrector difference */
+    ctrl->milne_norm = cplx_weighted_diff_norm(ctrl, milne, ctrl->ypred, ynext);
+    if (yerr != NULL)
+    {
+        for (i = 0; i < s; i++) yerr[i] = milne * (ctrl->ypred[i] - ynext[i]);
+    }
+    STATS_END(ws->stats);
+    return ctrl->converged ? 0 : -1;
+}
+
+
+/** \brief Predictor followed by corrector iterated until convergence */
+static int
+real_adams_controlled(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceMS ws,
+        Rarray y,
+        Rarray left,
+        Rarray pred,
+        Rarray corr,
+        double milne,
+        RealCorrectorControl ctrl,
+        Rarray yerr,
+        Rarray ynext
+)
+{
+    int
+        i,
+        s;
+
+    s = ws->system_size;
+    STATS_BEGIN(ws->stats);
+    real_general_multistep(h, x, yprime, args, ws, y, left, pred, 0, ynext);
+    rarr_copy_values(s, ynext, ctrl->ypred);
+    ctrl->converged = 0;
+    ctrl->iterations = 0;
+    while (ctrl->iterations < ctrl->max_iter)
+    {
+        rarr_copy_values(s, ynext, ctrl->yprev);
+        real_general_multistep(
+                h, x, yprime, args, ws, y, left, corr, 1, ynext
+        );
+        ctrl->iterations++;
+        ctrl->change_norm = real_weighted_diff_norm(
+                ctrl, 1.0, ynext, ctrl->yprev
+        );
+        if (ctrl->change_norm <= 1)
+        {
+            ctrl->converged = 1;
+            break;
+        }
+    }
+
+    /* Milne device with the predictor minus corrector difference */
+    ctrl->milne_norm = real_weighted_diff_norm(ctrl, milne, ctrl->ypred, ynext);
+    if (yerr != NULL)
+    {
+        for (i = 0; i < s; i++) yerr[i] = milne * (ctrl->ypred[i] - ynext[i]);
+    }
+    STATS_END(ws->stats);
+    return ctrl->converged ? 0 : -1;
+}
+
+
+int
+cplx_adams4pc_controlled(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceMS ws,
+        Carray y,
+        ComplexCorrectorControl ctrl,
+        Carray yerr,
+        Carray ynext
+)
+{
+    return cplx_adams_controlled(
+            h, x, yprime, args, ws, y, ADAMS4_LEFT, ADAMS4_PRED,
+            ADAMS4_CORR, ADAMS4_MILNE, ctrl, yerr, ynext
+    );
+}
+
+
+int
+cplx_adams6pc_controlled(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceMS ws,
+        Carray y,
+        ComplexCorrectorControl ctrl,
+        Carray yerr,
+        Carray ynext
+)
+{
+    return cplx_adams_controlled(
+            h, x, yprime, args, ws, y, ADAMS6_LEFT, ADAMS6_PRED,
+            ADAMS6_CORR, ADAMS6_MILNE, ctrl, yerr, ynext
+    );
+}
+
+
+int
+real_adams4pc_controlled(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceMS ws,
+        Rarray y,
+        RealCorrectorControl ctrl,
+        Rarray yerr,
+        Rarray ynext
+)
+{
+    return real_adams_controlled(
+            h, x, yprime, args, ws, y, ADAMS4_LEFT, ADAMS4_PRED,
+            ADAMS4_CORR, ADAMS4_MILNE, ctrl, yerr, ynext
+    );
+}
+
+
+int
+real_adams6pc_controlled(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceMS ws,
+        Rarray y,
+        RealCorrectorControl ctrl,
+        Rarray yerr,
+        Rarray ynext
+)
+{
+    return real_adams_controlled(
+            h, x, yprime, args, ws, y, ADAMS6_LEFT, ADAMS6_PRED,
+            ADAMS6_CORR, ADAMS6_MILNE, ctrl, yerr, ynext
+    );
+}
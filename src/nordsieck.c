@@ -0,0 +1,1224 @@
+/**
+ * \file nordsieck.c
+ * \author Alex Andriati
+ * \brief Source code for variable step and order Adams methods
+ *
+ * See function signature and description in header nordsieck.h
+ * The method coefficients, corrector convergence test and the selection
+ * of step size and order are those of the Adams mode of LSODE, ref. [1].
+ * The initial step size estimate follows ref. [2] sec. II.4
+ *
+ * [1] K. Radhakrishnan and A.C. Hindmarsh, Description and Use of LSODE,
+ * the Livermore Solver for Ordinary Differential Equations, NASA (1993)
+ * [2] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "nordsieck.h"
+#include "arrays_assistant.h"
+
+
+/* Maximum number of corrector iterations in a step attempt */
+#define NORDSIECK_MAX_CORR 3
+/* Maximum number of corrector failures in a single step */
+#define NORDSIECK_MAX_CONV_FAIL 10
+/* Maximum number of error test failures in a single step */
+#define NORDSIECK_MAX_ERR_FAIL 10
+
+
+/** \brief Set Adams coefficients `el` and error test constants `tesco`
+ *
+ * For each order `q` the corrector coefficients are those of the
+ * polynomial `(x + 1) * (x + 2) * ... * (x + q - 1)` integrated in
+ * [-1, 0], as in routine CFODE of LSODE. The `tesco` constants are
+ * used in the error estimates at orders `q - 1`, `q` and `q + 1`
+ */
+static void
+nordsieck_coef(
+        double el[NORDSIECK_MAX_ORDER + 1][NORDSIECK_MAX_ORDER + 1],
+        double tesco[NORDSIECK_MAX_ORDER + 1][3]
+)
+{
+    int
+        i,
+        q;
+    double
+        rqfac,
+        rq1fac,
+        pint,
+        xpin,
+        tsign,
+        ragq,
+        pc[NORDSIECK_MAX_ORDER + 1];
+
+    for (q = 0; q <= NORDSIECK_MAX_ORDER; q++)
+    {
+        for (i = 0; i <= NORDSIECK_MAX_ORDER; i++) el[q][i] = 0;
+        for (i = 0; i < 3; i++) tesco[q][i] = 0;
+    }
+    el[1][0] = 1.0;
+    el[1][1] = 1.0;
+    tesco[1][0] = 0.0;
+    tesco[1][1] = 2.0;
+    tesco[2][0] = 1.0;
+    pc[0] = 1.0;
+    rqfac = 1.0;
+    for (q = 2; q <= NORDSIECK_MAX_ORDER; q++)
+    {
+        rq1fac = rqfac;
+        rqfac = rqfac / q;
+        /* multiply the polynomial by (x + q - 1) */
+        pc[q - 1] = 0;
+        for (i = q - 1; i > 0; i--) pc[i] = pc[i - 1] + (q - 1) * pc[i];
+        pc[0] = (q - 1) * pc[0];
+        /* integrals of p(x) and x * p(x) in [-1, 0] */
+        pint = pc[0];
+        xpin = pc[0] / 2;
+        tsign = 1.0;
+        for (i = 1; i < q; i++)
+        {
+            tsign = - tsign;
+            pint = pint + tsign * pc[i] / (i + 1);
+            xpin = xpin + tsign * pc[i] / (i + 2);
+        }
+        el[q][0] = pint * rq1fac;
+        el[q][1] = 1.0;
+        for (i = 1; i < q; i++) el[q][i + 1] = rq1fac * pc[i] / (i + 1);
+        ragq = 1.0 / (rq1fac * xpin);
+        tesco[q][1] = ragq;
+        if (q < NORDSIECK_MAX_ORDER) tesco[q + 1][0] = ragq * rqfac / (q + 1);
+        tesco[q - 1][2] = ragq;
+    }
+}
+
+
+ComplexWorkspaceNordsieck
+get_cplx_nordsieck_ws(
+        int max_order,
+        int sys_size,
+        double abs_tol,
+        double rel_tol
+)
+{
+    ComplexWorkspaceNordsieck
+        ws;
+    ws = (ComplexWorkspaceNordsieck) malloc(
+            sizeof(_ComplexWorkspaceNordsieck)
+    );
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceNordsieck allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    if (max_order < 1) max_order = 1;
+    if (max_order > NORDSIECK_MAX_ORDER) max_order = NORDSIECK_MAX_ORDER;
+    ws->system_size = sys_size;
+    ws->max_order = max_order;
+    ws->order = 1;
+    ws->started = 0;
+    ws->wait = 0;
+    ws->x = 0;
+    ws->h = 0;
+    ws->abs_tol = abs_tol;
+    ws->rel_tol = rel_tol;
+    ws->h_min = 0;
+    ws->h_max = 0;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+    ws->accepted = 0;
+    ws->rejected = 0;
+    ws->conv_failures = 0;
+    ws->rhs_evals = 0;
+    nordsieck_coef(ws->el, ws->tesco);
+    ws->z = alloc_carr((max_order + 1) * sys_size);
+    ws->acor = alloc_carr(sys_size);
+    ws->savf = alloc_carr(sys_size);
+    ws->ewt = alloc_rarr(sys_size);
+    ws->ywork = alloc_carr(sys_size);
+    return ws;
+}
+
+
+RealWorkspaceNordsieck
+get_real_nordsieck_ws(
+        int max_order,
+        int sys_size,
+        double abs_tol,
+        double rel_tol
+)
+{
+    RealWorkspaceNordsieck
+        ws;
+    ws = (RealWorkspaceNordsieck) malloc(sizeof(_RealWorkspaceNordsieck));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceNordsieck allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    if (max_order < 1) max_order = 1;
+    if (max_order > NORDSIECK_MAX_ORDER) max_order = NORDSIECK_MAX_ORDER;
+    ws->system_size = sys_size;
+    ws->max_order = max_order;
+    ws->order = 1;
+    ws->started = 0;
+    ws->wait = 0;
+    ws->x = 0;
+    ws->h = 0;
+    ws->abs_tol = abs_tol;
+    ws->rel_tol = rel_tol;
+    ws->h_min = 0;
+    ws->h_max = 0;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+    ws->accepted = 0;
+    ws->rejected = 0;
+    ws->conv_failures = 0;
+    ws->rhs_evals = 0;
+    nordsieck_coef(ws->el, ws->tesco);
+    ws->z = alloc_rarr((max_order + 1) * sys_size);
+    ws->acor = alloc_rarr(sys_size);
+    ws->savf = alloc_rarr(sys_size);
+    ws->ewt = alloc_rarr(sys_size);
+    ws->ywork = alloc_rarr(sys_size);
+    return ws;
+}
+
+
+void
+destroy_cplx_nordsieck_ws(ComplexWorkspaceNordsieck ws)
+{
+    free(ws->z);
+    free(ws->acor);
+    free(ws->savf);
+    free(ws->ewt);
+    free(ws->ywork);
+    free(ws);
+}
+
+
+void
+destroy_real_nordsieck_ws(RealWorkspaceNordsieck ws)
+{
+    free(ws->z);
+    free(ws->acor);
+    free(ws->savf);
+    free(ws->ewt);
+    free(ws->ywork);
+    free(ws);
+}
+
+
+void
+reset_cplx_nordsieck_ws(ComplexWorkspaceNordsieck ws)
+{
+    ws->started = 0;
+    ws->order = 1;
+    ws->wait = 0;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+}
+
+
+void
+reset_real_nordsieck_ws(RealWorkspaceNordsieck ws)
+{
+    ws->started = 0;
+    ws->order = 1;
+    ws->wait = 0;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+}
+
+
+void
+cplx_nordsieck_rescale(ComplexWorkspaceNordsieck ws, double h)
+{
+    int
+        i,
+        j,
+        n;
+    double
+        r,
+        rj;
+    Carray
+        zj;
+
+    n = ws->system_size;
+    r = h / ws->h;
+    rj = 1.0;
+    for (j = 1; j <= ws->order; j++)
+    {
+        rj = rj * r;
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) zj[i] = zj[i] * rj;
+    }
+    ws->h = h;
+    ws->wait = ws->order + 1;
+}
+
+
+void
+real_nordsieck_rescale(RealWorkspaceNordsieck ws, double h)
+{
+    int
+        i,
+        j,
+        n;
+    double
+        r,
+        rj;
+    Rarray
+        zj;
+
+    n = ws->system_size;
+    r = h / ws->h;
+    rj = 1.0;
+    for (j = 1; j <= ws->order; j++)
+    {
+        rj = rj * r;
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) zj[i] = zj[i] * rj;
+    }
+    ws->h = h;
+    ws->wait = ws->order + 1;
+}
+
+
+void
+cplx_nordsieck_interpolate(ComplexWorkspaceNordsieck ws, double x, Carray y)
+{
+    int
+        i,
+        j,
+        n;
+    double
+        s;
+    Carray
+        zj;
+
+    n = ws->system_size;
+    s = (x - ws->x) / ws->h;
+    zj = &ws->z[ws->order * n];
+    for (i = 0; i < n; i++) y[i] = zj[i];
+    for (j = ws->order - 1; j >= 0; j--)
+    {
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) y[i] = zj[i] + s * y[i];
+    }
+}
+
+
+void
+real_nordsieck_interpolate(RealWorkspaceNordsieck ws, double x, Rarray y)
+{
+    int
+        i,
+        j,
+        n;
+    double
+        s;
+    Rarray
+        zj;
+
+    n = ws->system_size;
+    s = (x - ws->x) / ws->h;
+    zj = &ws->z[ws->order * n];
+    for (i = 0; i < n; i++) y[i] = zj[i];
+    for (j = ws->order - 1; j >= 0; j--)
+    {
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) y[i] = zj[i] + s * y[i];
+    }
+}
+
+
+/** \brief Weighted root-mean-square norm with weights in `ewt` */
+static double
+cplx_nordsieck_norm(ComplexWorkspaceNordsieck ws, Carray v)
+{
+    int
+        i;
+    double
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        e = cabs(v[i]) / ws->ewt[i];
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ws->system_size);
+}
+
+
+/** \brief Weighted root-mean-square norm with weights in `ewt` */
+static double
+real_nordsieck_norm(RealWorkspaceNordsieck ws, Rarray v)
+{
+    int
+        i;
+    double
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        e = v[i] / ws->ewt[i];
+        summ = summ + e * e;
+    }
+    return sqrt(summ / ws->system_size);
+}
+
+
+/** \brief Predictor as Taylor expansion, Pascal triangle applied to `z` */
+static void
+cplx_nordsieck_predict(ComplexWorkspaceNordsieck ws)
+{
+    int
+        i,
+        j,
+        k,
+        n;
+    Carray
+        zj,
+        zj1;
+
+    n = ws->system_size;
+    for (k = 0; k < ws->order; k++)
+    {
+        for (j = ws->order - 1; j >= k; j--)
+        {
+            zj = &ws->z[j * n];
+            zj1 = &ws->z[(j + 1) * n];
+            for (i = 0; i < n; i++) zj[i] = zj[i] + zj1[i];
+        }
+    }
+}
+
+
+/** \brief Predictor as Taylor expansion, Pascal triangle applied to `z` */
+static void
+real_nordsieck_predict(RealWorkspaceNordsieck ws)
+{
+    int
+        i,
+        j,
+        k,
+        n;
+    Rarray
+        zj,
+        zj1;
+
+    n = ws->system_size;
+    for (k = 0; k < ws->order; k++)
+    {
+        for (j = ws->order - 1; j >= k; j--)
+        {
+            zj = &ws->z[j * n];
+            zj1 = &ws->z[(j + 1) * n];
+            for (i = 0; i < n; i++) zj[i] = zj[i] + zj1[i];
+        }
+    }
+}
+
+
+/** \brief Undo the predictor to retry the step */
+static void
+cplx_nordsieck_retract(ComplexWorkspaceNordsieck ws)
+{
+    int
+        i,
+        j,
+        k,
+        n;
+    Carray
+        zj,
+        zj1;
+
+    n = ws->system_size;
+    for (k = 0; k < ws->order; k++)
+    {
+        for (j = ws->order - 1; j >= k; j--)
+        {
+            zj = &ws->z[j * n];
+            zj1 = &ws->z[(j + 1) * n];
+            for (i = 0; i < n; i++) zj[i] = zj[i] - zj1[i];
+        }
+    }
+}
+
+
+/** \brief Undo the predictor to retry the step */
+static void
+real_nordsieck_retract(RealWorkspaceNordsieck ws)
+{
+    int
+        i,
+        j,
+        k,
+        n;
+    Rarray
+        zj,
+        zj1;
+
+    n = ws->system_size;
+    for (k = 0; k < ws->order; k++)
+    {
+        for (j = ws->order - 1; j >= k; j--)
+        {
+            zj = &ws->z[j * n];
+            zj1 = &ws->z[(j + 1) * n];
+            for (i = 0; i < n; i++) zj[i] = zj[i] - zj1[i];
+        }
+    }
+}
+
+
+/** \brief Change the step size by the ratio `rh` within allowed bounds */
+static void
+cplx_nordsieck_change_step(ComplexWorkspaceNordsieck ws, double rh)
+{
+    if (rh < ws->h_min / ws->h) rh = ws->h_min / ws->h;
+    if (rh > ws->rmax) rh = ws->rmax;
+    if (ws->h_max > 0 && ws->h * rh > ws->h_max) rh = ws->h_max / ws->h;
+    cplx_nordsieck_rescale(ws, ws->h * rh);
+}
+
+
+/** \brief Change the step size by the ratio `rh` within allowed bounds */
+static void
+real_nordsieck_change_step(RealWorkspaceNordsieck ws, double rh)
+{
+    if (rh < ws->h_min / ws->h) rh = ws->h_min / ws->h;
+    if (rh > ws->rmax) rh = ws->rmax;
+    if (ws->h_max > 0 && ws->h * rh > ws->h_max) rh = ws->h_max / ws->h;
+    real_nordsieck_rescale(ws, ws->h * rh);
+}
+
+
+/** \brief Initial step size estimate as in ref. [2] sec. II.4
+ *
+ * The derivative at the initial point must be in `savf`
+ */
+static double
+cplx_nordsieck_initial_step(
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceNordsieck ws,
+        Carray y
+)
+{
+    int
+        i,
+        n;
+    double
+        w,
+        d0,
+        d1,
+        d2,
+        h0,
+        h1;
+    _ComplexODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    d0 = 0;
+    d1 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->ewt[i];
+        d0 = d0 + (cabs(y[i]) / w) * (cabs(y[i]) / w);
+        d1 = d1 + (cabs(ws->savf[i]) / w) * (cabs(ws->savf[i]) / w);
+    }
+    d0 = sqrt(d0 / n);
+    d1 = sqrt(d1 / n);
+    if (d0 < 1E-5 || d1 < 1E-5) h0 = 1E-6;
+    else                        h0 = 0.01 * d0 / d1;
+
+    for (i = 0; i < n; i++) ws->ywork[i] = y[i] + h0 * ws->savf[i];
+    sys_params.x = ws->x + h0;
+    sys_params.y = ws->ywork;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    yprime(&sys_params, ws->acor);
+    ws->rhs_evals++;
+    d2 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->ewt[i] * h0;
+        d2 = d2 + (cabs(ws->acor[i] - ws->savf[i]) / w)
+                * (cabs(ws->acor[i] - ws->savf[i]) / w);
+    }
+    d2 = sqrt(d2 / n);
+
+    if (fmax(d1, d2) <= 1E-15) h1 = fmax(1E-6, h0 * 1E-3);
+    else h1 = pow(0.01 / fmax(d1, d2), 0.5);
+    return fmin(100 * h0, h1);
+}
+
+
+/** \brief Initial step size estimate as in ref. [2] sec. II.4
+ *
+ * The derivative at the initial point must be in `savf`
+ */
+static double
+real_nordsieck_initial_step(
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceNordsieck ws,
+        Rarray y
+)
+{
+    int
+        i,
+        n;
+    double
+        w,
+        d0,
+        d1,
+        d2,
+        h0,
+        h1;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    d0 = 0;
+    d1 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->ewt[i];
+        d0 = d0 + (y[i] / w) * (y[i] / w);
+        d1 = d1 + (ws->savf[i] / w) * (ws->savf[i] / w);
+    }
+    d0 = sqrt(d0 / n);
+    d1 = sqrt(d1 / n);
+    if (d0 < 1E-5 || d1 < 1E-5) h0 = 1E-6;
+    else                        h0 = 0.01 * d0 / d1;
+
+    for (i = 0; i < n; i++) ws->ywork[i] = y[i] + h0 * ws->savf[i];
+    sys_params.x = ws->x + h0;
+    sys_params.y = ws->ywork;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    yprime(&sys_params, ws->acor);
+    ws->rhs_evals++;
+    d2 = 0;
+    for (i = 0; i < n; i++)
+    {
+        w = ws->ewt[i] * h0;
+        d2 = d2 + ((ws->acor[i] - ws->savf[i]) / w)
+                * ((ws->acor[i] - ws->savf[i]) / w);
+    }
+    d2 = sqrt(d2 / n);
+
+    if (fmax(d1, d2) <= 1E-15) h1 = fmax(1E-6, h0 * 1E-3);
+    else h1 = pow(0.01 / fmax(d1, d2), 0.5);
+    return fmin(100 * h0, h1);
+}
+
+
+/** \brief Set the Nordsieck array of order 1 from the solution `y` */
+static void
+cplx_nordsieck_start(
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceNordsieck ws,
+        double x,
+        double h,
+        Carray y
+)
+{
+    int
+        i,
+        n;
+    _ComplexODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    ws->x = x;
+    for (i = 0; i < n; i++)
+    {
+        ws->z[i] = y[i];
+        ws->ewt[i] = ws->abs_tol + ws->rel_tol * cabs(y[i]);
+    }
+    sys_params.x = x;
+    sys_params.y = ws->z;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    yprime(&sys_params, ws->savf);
+    ws->rhs_evals++;
+    if (h <= 0) h = cplx_nordsieck_initial_step(yprime, args, ws, y);
+    if (ws->h_max > 0 && h > ws->h_max) h = ws->h_max;
+    for (i = 0; i < n; i++) ws->z[n + i] = h * ws->savf[i];
+    ws->h = h;
+    ws->order = 1;
+    ws->wait = 2;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+    ws->started = 1;
+}
+
+
+/** \brief Set the Nordsieck array of order 1 from the solution `y` */
+static void
+real_nordsieck_start(
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceNordsieck ws,
+        double x,
+        double h,
+        Rarray y
+)
+{
+    int
+        i,
+        n;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    ws->x = x;
+    for (i = 0; i < n; i++)
+    {
+        ws->z[i] = y[i];
+        ws->ewt[i] = ws->abs_tol + ws->rel_tol * fabs(y[i]);
+    }
+    sys_params.x = x;
+    sys_params.y = ws->z;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+    yprime(&sys_params, ws->savf);
+    ws->rhs_evals++;
+    if (h <= 0) h = real_nordsieck_initial_step(yprime, args, ws, y);
+    if (ws->h_max > 0 && h > ws->h_max) h = ws->h_max;
+    for (i = 0; i < n; i++) ws->z[n + i] = h * ws->savf[i];
+    ws->h = h;
+    ws->order = 1;
+    ws->wait = 2;
+    ws->rmax = 1E4;
+    ws->conv_rate = 0.7;
+    ws->started = 1;
+}
+
+
+/** \brief Corrector by functional iteration of the predicted step
+ *
+ * The correction relative to the predictor is accumulated in `acor`
+ *
+ * \return 0 if converged and -1 if diverged or too slow
+ */
+static int
+cplx_nordsieck_correct(
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceNordsieck ws
+)
+{
+    int
+        i,
+        m,
+        n,
+        q;
+    double
+        del,
+        dcon,
+        delp,
+        conit;
+    Carray
+        z0,
+        z1;
+    _ComplexODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    q = ws->order;
+    z0 = ws->z;
+    z1 = &ws->z[n];
+    conit = 0.5 / (q + 2);
+    for (i = 0; i < n; i++)
+    {
+        ws->ywork[i] = z0[i];
+        ws->acor[i] = 0;
+    }
+    sys_params.x = ws->x + ws->h;
+    sys_params.y = ws->ywork;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+
+    delp = 0;
+    for (m = 0; m < NORDSIECK_MAX_CORR; m++)
+    {
+        yprime(&sys_params, ws->savf);
+        ws->rhs_evals++;
+        for (i = 0; i < n; i++)
+        {
+            ws->savf[i] = ws->h * ws->savf[i] - z1[i];
+            ws->ywork[i] = ws->savf[i] - ws->acor[i];
+        }
+        del = cplx_nordsieck_norm(ws, ws->ywork);
+        for (i = 0; i < n; i++)
+        {
+            ws->ywork[i] = z0[i] + ws->el[q][0] * ws->savf[i];
+            ws->acor[i] = ws->savf[i];
+        }
+        if (m > 0) ws->conv_rate = fmax(0.2 * ws->conv_rate, del / delp);
+        dcon = del * fmin(1.0, 1.5 * ws->conv_rate);
+        if (dcon <= ws->tesco[q][1] * conit) return 0;
+        if (m > 0 && del > 2 * delp) return -1;
+        delp = del;
+    }
+    return -1;
+}
+
+
+/** \brief Corrector by functional iteration of the predicted step
+ *
+ * The correction relative to the predictor is accumulated in `acor`
+ *
+ * \return 0 if converged and -1 if diverged or too slow
+ */
+static int
+real_nordsieck_correct(
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceNordsieck ws
+)
+{
+    int
+        i,
+        m,
+        n,
+        q;
+    double
+        del,
+        dcon,
+        delp,
+        conit;
+    Rarray
+        z0,
+        z1;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    q = ws->order;
+    z0 = ws->z;
+    z1 = &ws->z[n];
+    conit = 0.5 / (q + 2);
+    for (i = 0; i < n; i++)
+    {
+        ws->ywork[i] = z0[i];
+        ws->acor[i] = 0;
+    }
+    sys_params.x = ws->x + ws->h;
+    sys_params.y = ws->ywork;
+    sys_params.extra_args = args;
+    sys_params.system_size = n;
+
+    delp = 0;
+    for (m = 0; m < NORDSIECK_MAX_CORR; m++)
+    {
+        yprime(&sys_params, ws->savf);
+        ws->rhs_evals++;
+        for (i = 0; i < n; i++)
+        {
+            ws->savf[i] = ws->h * ws->savf[i] - z1[i];
+            ws->ywork[i] = ws->savf[i] - ws->acor[i];
+        }
+        del = real_nordsieck_norm(ws, ws->ywork);
+        for (i = 0; i < n; i++)
+        {
+            ws->ywork[i] = z0[i] + ws->el[q][0] * ws->savf[i];
+            ws->acor[i] = ws->savf[i];
+        }
+        if (m > 0) ws->conv_rate = fmax(0.2 * ws->conv_rate, del / delp);
+        dcon = del * fmin(1.0, 1.5 * ws->conv_rate);
+        if (dcon <= ws->tesco[q][1] * conit) return 0;
+        if (m > 0 && del > 2 * delp) return -1;
+        delp = del;
+    }
+    return -1;
+}
+
+
+/** \brief Select step size ratio and order from the error estimates
+ *
+ * Estimate the step size ratios allowed by orders `q - 1`, `q` and
+ * `q + 1` (the last only if `up` is nonzero) and set the new order,
+ * returning the ratio. If the order is raised the new column of the
+ * Nordsieck array is set from the last correction
+ */
+static double
+cplx_nordsieck_select(ComplexWorkspaceNordsieck ws, double dsm, int up, int ok)
+{
+    int
+        i,
+        n,
+        q;
+    double
+        r,
+        rhup,
+        rhsm,
+        rhdn,
+        dup,
+        ddn;
+    Carray
+        zq,
+        zsaved;
+
+    n = ws->system_size;
+    q = ws->order;
+    zq = &ws->z[q * n];
+    zsaved = &ws->z[ws->max_order * n];
+
+    rhup = 0;
+    if (up && q < ws->max_order)
+    {
+        for (i = 0; i < n; i++) ws->savf[i] = ws->acor[i] - zsaved[i];
+        dup = cplx_nordsieck_norm(ws, ws->savf) / ws->tesco[q][2];
+        rhup = 1.0 / (1.4 * pow(dup, 1.0 / (q + 2)) + 1.4E-6);
+    }
+    rhsm = 1.0 / (1.2 * pow(dsm, 1.0 / (q + 1)) + 1.2E-6);
+    rhdn = 0;
+    if (q > 1)
+    {
+        ddn = cplx_nordsieck_norm(ws, zq) / ws->tesco[q][0];
+        rhdn = 1.0 / (1.3 * pow(ddn, 1.0 / q) + 1.3E-6);
+    }
+
+    if (rhsm >= rhup && rhsm >= rhdn) return rhsm;
+    if (rhup > rhdn)
+    {
+        if (rhup < 1.1) return rhup;
+        r = ws->el[q][q] / (q + 1);
+        zq = &ws->z[(q + 1) * n];
+        for (i = 0; i < n; i++) zq[i] = ws->acor[i] * r;
+        ws->order = q + 1;
+        return rhup;
+    }
+    ws->order = q - 1;
+    if (!ok && rhdn > 1.0) return 1.0;
+    return rhdn;
+}
+
+
+/** \brief Select step size ratio and order from the error estimates
+ *
+ * Estimate the step size ratios allowed by orders `q - 1`, `q` and
+ * `q + 1` (the last only if `up` is nonzero) and set the new order,
+ * returning the ratio. If the order is raised the new column of the
+ * Nordsieck array is set from the last correction
+ */
+static double
+real_nordsieck_select(RealWorkspaceNordsieck ws, double dsm, int up, int ok)
+{
+    int
+        i,
+        n,
+        q;
+    double
+        r,
+        rhup,
+        rhsm,
+        rhdn,
+        dup,
+        ddn;
+    Rarray
+        zq,
+        zsaved;
+
+    n = ws->system_size;
+    q = ws->order;
+    zq = &ws->z[q * n];
+    zsaved = &ws->z[ws->max_order * n];
+
+    rhup = 0;
+    if (up && q < ws->max_order)
+    {
+        for (i = 0; i < n; i++) ws->savf[i] = ws->acor[i] - zsaved[i];
+        dup = real_nordsieck_norm(ws, ws->savf) / ws->tesco[q][2];
+        rhup = 1.0 / (1.4 * pow(dup, 1.0 / (q + 2)) + 1.4E-6);
+    }
+    rhsm = 1.0 / (1.2 * pow(dsm, 1.0 / (q + 1)) + 1.2E-6);
+    rhdn = 0;
+    if (q > 1)
+    {
+        ddn = real_nordsieck_norm(ws, zq) / ws->tesco[q][0];
+        rhdn = 1.0 / (1.3 * pow(ddn, 1.0 / q) + 1.3E-6);
+    }
+
+    if (rhsm >= rhup && rhsm >= rhdn) return rhsm;
+    if (rhup > rhdn)
+    {
+        if (rhup < 1.1) return rhup;
+        r = ws->el[q][q] / (q + 1);
+        zq = &ws->z[(q + 1) * n];
+        for (i = 0; i < n; i++) zq[i] = ws->acor[i] * r;
+        ws->order = q + 1;
+        return rhup;
+    }
+    ws->order = q - 1;
+    if (!ok && rhdn > 1.0) return 1.0;
+    return rhdn;
+}
+
+
+int
+cplx_nordsieck_step(
+        double xend,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceNordsieck ws,
+        double * x,
+        double * h,
+        Carray y
+)
+{
+    int
+        i,
+        j,
+        n,
+        q,
+        err_fails,
+        conv_fails;
+    double
+        rh,
+        dsm;
+    Carray
+        zj;
+    _ComplexODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    if (!ws->started) cplx_nordsieck_start(yprime, args, ws, *x, *h, y);
+    else if (*h > 0 && *h != ws->h) cplx_nordsieck_rescale(ws, *h);
+
+    for (i = 0; i < n; i++)
+    {
+        ws->ewt[i] = ws->abs_tol + ws->rel_tol * cabs(ws->z[i]);
+    }
+    if (ws->x + ws->h > xend)
+    {
+        if (xend <= ws->x) return -1;
+        cplx_nordsieck_rescale(ws, xend - ws->x);
+    }
+
+    err_fails = 0;
+    conv_fails = 0;
+    while (1)
+    {
+        if (ws->x + ws->h == ws->x) return -1;
+        cplx_nordsieck_predict(ws);
+        if (cplx_nordsieck_correct(yprime, args, ws))
+        {
+            /* corrector failed: retry with quarter of the step size */
+            cplx_nordsieck_retract(ws);
+            ws->conv_failures++;
+            conv_fails++;
+            if (ws->h <= ws->h_min * 1.00001) return -1;
+            if (conv_fails == NORDSIECK_MAX_CONV_FAIL) return -1;
+            cplx_nordsieck_change_step(ws, 0.25);
+            continue;
+        }
+
+        q = ws->order;
+        dsm = cplx_nordsieck_norm(ws, ws->acor) / ws->tesco[q][1];
+        if (dsm <= 1.0) break;
+
+        /* error test failed */
+        cplx_nordsieck_retract(ws);
+        ws->rejected++;
+        err_fails++;
+        ws->rmax = 2.0;
+        if (ws->h <= ws->h_min * 1.00001) return -1;
+        if (err_fails == NORDSIECK_MAX_ERR_FAIL) return -1;
+        if (err_fails < 3)
+        {
+            rh = cplx_nordsieck_select(ws, dsm, 0, 0);
+            if (err_fails == 2 && rh > 0.2) rh = 0.2;
+            cplx_nordsieck_change_step(ws, rh);
+            continue;
+        }
+        /* repeated failures: restart with order 1 from current solution */
+        rh = 0.1;
+        if (rh < ws->h_min / ws->h) rh = ws->h_min / ws->h;
+        ws->h = ws->h * rh;
+        sys_params.x = ws->x;
+        sys_params.y = ws->z;
+        sys_params.extra_args = args;
+        sys_params.system_size = n;
+        yprime(&sys_params, ws->savf);
+        ws->rhs_evals++;
+        for (i = 0; i < n; i++) ws->z[n + i] = ws->h * ws->savf[i];
+        ws->order = 1;
+        ws->wait = 5;
+    }
+
+    /* accepted step: apply correction to all columns */
+    ws->accepted++;
+    ws->x = ws->x + ws->h;
+    for (j = 0; j <= q; j++)
+    {
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) zj[i] = zj[i] + ws->el[q][j] * ws->acor[i];
+    }
+    *x = ws->x;
+    for (i = 0; i < n; i++) y[i] = ws->z[i];
+
+    ws->wait--;
+    if (ws->wait == 0)
+    {
+        rh = cplx_nordsieck_select(ws, dsm, 1, 1);
+        if (rh < 1.1)
+        {
+            /* change not worth it: keep current order and step size */
+            ws->order = q;
+            ws->wait = 3;
+        }
+        else
+        {
+            cplx_nordsieck_change_step(ws, rh);
+            ws->rmax = 10.0;
+        }
+    }
+    else if (ws->wait == 1 && q < ws->max_order)
+    {
+        zj = &ws->z[ws->max_order * n];
+        for (i = 0; i < n; i++) zj[i] = ws->acor[i];
+    }
+    *h = ws->h;
+    return 0;
+}
+
+
+
+int
+real_nordsieck_step(
+        double xend,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceNordsieck ws,
+        double * x,
+        double * h,
+        Rarray y
+)
+{
+    int
+        i,
+        j,
+        n,
+        q,
+        err_fails,
+        conv_fails;
+    double
+        rh,
+        dsm;
+    Rarray
+        zj;
+    _RealODEInputParameters
+        sys_params;
+
+    n = ws->system_size;
+    if (!ws->started) real_nordsieck_start(yprime, args, ws, *x, *h, y);
+    else if (*h > 0 && *h != ws->h) real_nordsieck_rescale(ws, *h);
+
+    for (i = 0; i < n; i++)
+    {
+        ws->ewt[i] = ws->abs_tol + ws->rel_tol * fabs(ws->z[i]);
+    }
+    if (ws->x + ws->h > xend)
+    {
+        if (xend <= ws->x) return -1;
+        real_nordsieck_rescale(ws, xend - ws->x);
+    }
+
+    err_fails = 0;
+    conv_fails = 0;
+    while (1)
+    {
+        if (ws->x + ws->h == ws->x) return -1;
+        real_nordsieck_predict(ws);
+        if (real_nordsieck_correct(yprime, args, ws))
+        {
+            /* corrector failed: retry with quarter of the step size */
+            real_nordsieck_retract(ws);
+            ws->conv_failures++;
+            conv_fails++;
+            if (ws->h <= ws->h_min * 1.00001) return -1;
+            if (conv_fails == NORDSIECK_MAX_CONV_FAIL) return -1;
+            real_nordsieck_change_step(ws, 0.25);
+            continue;
+        }
+
+        q = ws->order;
+        dsm = real_nordsieck_norm(ws, ws->acor) / ws->tesco[q][1];
+        if (dsm <= 1.0) break;
+
+        /* error test failed */
+        real_nordsieck_retract(ws);
+        ws->rejected++;
+        err_fails++;
+        ws->rmax = 2.0;
+        if (ws->h <= ws->h_min * 1.00001) return -1;
+        if (err_fails == NORDSIECK_MAX_ERR_FAIL) return -1;
+        if (err_fails < 3)
+        {
+            rh = real_nordsieck_select(ws, dsm, 0, 0);
+            if (err_fails == 2 && rh > 0.2) rh = 0.2;
+            real_nordsieck_change_step(ws, rh);
+            continue;
+        }
+        /* repeated failures: restart with order 1 from current solution */
+        rh = 0.1;
+        if (rh < ws->h_min / ws->h) rh = ws->h_min / ws->h;
+        ws->h = ws->h * rh;
+        sys_params.x = ws->x;
+        sys_params.y = ws->z;
+        sys_params.extra_args = args;
+        sys_params.system_size = n;
+        yprime(&sys_params, ws->savf);
+        ws->rhs_evals++;
+        for (i = 0; i < n; i++) ws->z[n + i] = ws->h * ws->savf[i];
+        ws->order = 1;
+        ws->wait = 5;
+    }
+
+    /* accepted step: apply correction to all columns */
+    ws->accepted++;
+    ws->x = ws->x + ws->h;
+    for (j = 0; j <= q; j++)
+    {
+        zj = &ws->z[j * n];
+        for (i = 0; i < n; i++) zj[i] = zj[i] + ws->el[q][j] * ws->acor[i];
+    }
+    *x = ws->x;
+    for (i = 0; i < n; i++) y[i] = ws->z[i];
+
+    ws->wait--;
+    if (ws->wait == 0)
+    {
+        rh = real_nordsieck_select(ws, dsm, 1, 1);
+        if (rh < 1.1)
+        {
+            /* change not worth it: keep current order and step size */
+            ws->order = q;
+            ws->wait = 3;
+        }
+        else
+        {
+            real_nordsieck_change_step(ws, rh);
+            ws->rmax = 10.0;
+        }
+    }
+    else if (ws->wait == 1 && q < ws->max_order)
+    {
+        zj = &ws->z[ws->max_order * n];
+        for (i = 0; i < n; i++) zj[i] = ws->acor[i];
+    }
+    *h = ws->h;
+    return 0;
+}
@@ -0,0 +1,522 @@
+/**
+ * \file secondorder.c
+ * \author Alex Andriati
+ * \brief Source code for integration of second order systems
+ *
+ * See function signature and description in header secondorder.h
+ * The Runge-Kutta-Nystrom 4th order method is the one of ref. [3] sec.
+ * II.14 with 3 stages. Its embedded 3rd order solution was obtained
+ * replacing the last stage by the derivative at the new point for the
+ * velocities and with weights `(1/3, 0, 1/6)` for the positions, which
+ * only satisfy the order conditions up to the 3rd order. Some refs
+ *
+ * [1] E. Forest and R.D. Ruth, Fourth-order symplectic integration,
+ * Physica D 43 (1990) 105-117
+ * [2] H. Yoshida, Construction of higher order symplectic integrators,
+ * Phys. Lett. A 150 (1990) 262-268
+ * [3] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ * [4] E. Hairer, C. Lubich and G. Wanner, Geometric Numerical Integration,
+ * Springer, 2nd Edition
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "secondorder.h"
+#include "kernels.h"
+
+
+/* Step size control parameters as in adaptive.c */
+#define STEP_SAFETY 0.9
+#define STEP_MIN_FACTOR 0.2
+#define STEP_MAX_FACTOR 5.0
+
+
+static const double
+    VELOCITY_VERLET_W[1] = {1.0};
+
+/* w1 = 1 / (2 - 2^(1/3)) and w0 = 1 - 2 * w1 */
+static const double
+    FOREST_RUTH_4_W[3] = {
+        1.3512071919596578, - 1.7024143839193155, 1.3512071919596578
+    };
+
+/* w3, w2, w1, w0, w1, w2, w3 with w0 = 1 - 2 * (w1 + w2 + w3) */
+static const double
+    YOSHIDA_6_W[7] = {
+        0.784513610477560, 0.235573213359357, - 1.17767998417887,
+        1.3151863206839063,
+        - 1.17767998417887, 0.235573213359357, 0.784513610477560
+    };
+
+const SymplecticComposition COMPOSITION_VELOCITY_VERLET = {
+    "velocity_verlet", 1, 2, VELOCITY_VERLET_W
+};
+
+const SymplecticComposition COMPOSITION_FOREST_RUTH_4 = {
+    "forest_ruth_4", 3, 4, FOREST_RUTH_4_W
+};
+
+const SymplecticComposition COMPOSITION_YOSHIDA_6 = {
+    "yoshida_6", 7, 6, YOSHIDA_6_W
+};
+
+
+static Rarray
+secondorder_alloc_rarr(unsigned int size)
+{
+    Rarray ptr = (Rarray) malloc(size * sizeof(double));
+    if (ptr == NULL)
+    {
+        printf("\n\nProblem in Rarray allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+
+RealWorkspaceSymplectic
+get_real_symplectic_ws(int sys_size)
+{
+    RealWorkspaceSymplectic
+        ws;
+    ws = (RealWorkspaceSymplectic) malloc(sizeof(_RealWorkspaceSymplectic));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceSymplectic allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->acc_ready = 0;
+    ws->acc = secondorder_alloc_rarr(sys_size);
+    return ws;
+}
+
+
+void
+destroy_real_symplectic_ws(RealWorkspaceSymplectic ws)
+{
+    free(ws->acc);
+    free(ws);
+}
+
+
+RealWorkspaceRKN
+get_real_rkn_ws(int sys_size, double abs_tol, double rel_tol)
+{
+    RealWorkspaceRKN
+        ws;
+    ws = (RealWorkspaceRKN) malloc(sizeof(_RealWorkspaceRKN));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceRKN allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->system_size = sys_size;
+    ws->k1_ready = 0;
+    ws->abs_tol = abs_tol;
+    ws->rel_tol = rel_tol;
+    ws->h_min = 0;
+    ws->h_max = 0;
+    ws->accepted = 0;
+    ws->rejected = 0;
+    ws->k1 = secondorder_alloc_rarr(sys_size);
+    ws->k2 = secondorder_alloc_rarr(sys_size);
+    ws->k3 = secondorder_alloc_rarr(sys_size);
+    ws->k4 = secondorder_alloc_rarr(sys_size);
+    ws->qarg = secondorder_alloc_rarr(sys_size);
+    ws->qnext = secondorder_alloc_rarr(sys_size);
+    ws->vnext = secondorder_alloc_rarr(sys_size);
+    ws->qerr = secondorder_alloc_rarr(sys_size);
+    ws->verr = secondorder_alloc_rarr(sys_size);
+    return ws;
+}
+
+
+void
+destroy_real_rkn_ws(RealWorkspaceRKN ws)
+{
+    free(ws->k1);
+    free(ws->k2);
+    free(ws->k3);
+    free(ws->k4);
+    free(ws->qarg);
+    free(ws->qnext);
+    free(ws->vnext);
+    free(ws->qerr);
+    free(ws->verr);
+    free(ws);
+}
+
+
+void
+real_symplectic_step(
+        double h,
+        double x,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceSymplectic ws,
+        const SymplecticComposition * method,
+        Rarray q,
+        Rarray v
+)
+{
+    int
+        i,
+        m,
+        sys_size;
+    double
+        kick,
+        xsub,
+        w[1];
+    Rarray
+        terms[1];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    m = method->nsteps;
+
+    sys_params.y = q;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    sys_params.x = x;
+    if (!ws->acc_ready) yprime2(&sys_params, ws->acc);
+    /* half kicks of consecutive Verlet steps are merged, ref. [4] II.4 */
+    kick = 0.5 * method->w[0];
+    xsub = x;
+    for (i = 0; i < m; i++)
+    {
+        w[0] = kick;
+        terms[0] = ws->acc;
+        rarr_lincomb(sys_size, v, h, 1, w, terms, v);
+        w[0] = method->w[i];
+        terms[0] = v;
+        rarr_lincomb(sys_size, q, h, 1, w, terms, q);
+        if (i < m - 1)
+        {
+            xsub = xsub + method->w[i] * h;
+            kick = 0.5 * (method->w[i] + method->w[i + 1]);
+        }
+        else
+        {
+            xsub = x + h;
+            kick = 0.5 * method->w[i];
+        }
+        sys_params.x = xsub;
+        yprime2(&sys_params, ws->acc);
+    }
+    w[0] = kick;
+    terms[0] = ws->acc;
+    rarr_lincomb(sys_size, v, h, 1, w, terms, v);
+    ws->acc_ready = 1;
+}
+
+
+/** \brief Set the 3 stages of the 4th order Runge-Kutta-Nystrom method
+ *
+ * If `k1_ready` is nonzero the first stage is not computed
+ */
+static void
+nystrom4_stages(
+        double h,
+        double x,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceRKN ws,
+        int k1_ready,
+        Rarray q,
+        Rarray v
+)
+{
+    int
+        sys_size;
+    double
+        w[2];
+    Rarray
+        terms[2];
+    _RealODEInputParameters
+        sys_params;
+
+    sys_size = ws->system_size;
+    sys_params.y = q;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    sys_params.x = x;
+    if (!k1_ready) yprime2(&sys_params, ws->k1);
+    sys_params.y = ws->qarg;
+    w[0] = 0.5;
+    w[1] = h / 8;
+    terms[0] = v;
+    terms[1] = ws->k1;
+    rarr_lincomb(sys_size, q, h, 2, w, terms, ws->qarg);
+    sys_params.x = x + 0.5 * h;
+    yprime2(&sys_params, ws->k2);
+    w[0] = 1.0;
+    w[1] = h / 2;
+    terms[1] = ws->k2;
+    rarr_lincomb(sys_size, q, h, 2, w, terms, ws->qarg);
+    sys_params.x = x + h;
+    yprime2(&sys_params, ws->k3);
+}
+
+
+/** \brief Combine stages of `nystrom4_stages` in the new solution */
+static void
+nystrom4_solution(
+        double h,
+        RealWorkspaceRKN ws,
+        Rarray q,
+        Rarray v,
+        Rarray qnext,
+        Rarray vnext
+)
+{
+    double
+        w[3];
+    Rarray
+        terms[3];
+
+    w[0] = 1.0;
+    w[1] = h / 6;
+    w[2] = h / 3;
+    terms[0] = v;
+    terms[1] = ws->k1;
+    terms[2] = ws->k2;
+    rarr_lincomb(ws->system_size, q, h, 3, w, terms, qnext);
+    w[0] = (1.0 / 6);
+    w[1] = (2.0 / 3);
+    w[2] = (1.0 / 6);
+    terms[0] = ws->k1;
+    terms[1] = ws->k2;
+    terms[2] = ws->k3;
+    rarr_lincomb(ws->system_size, v, h, 3, w, terms, vnext);
+}
+
+
+void
+real_nystrom4(
+        double h,
+        double x,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceRKN ws,
+        Rarray q,
+        Rarray v,
+        Rarray qnext,
+        Rarray vnext
+)
+{
+    nystrom4_stages(h, x, yprime2, args, ws, 0, q, v);
+    nystrom4_solution(h, ws, q, v, qnext, vnext);
+}
+
+
+void
+real_nystrom43(
+        double h,
+        double x,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceRKN ws,
+        int k1_ready,
+        Rarray q,
+        Rarray v,
+        Rarray qnext,
+        Rarray vnext,
+        Rarray qerr,
+        Rarray verr
+)
+{
+    double
+        w[3];
+    Rarray
+        terms[3];
+    _RealODEInputParameters
+        sys_params;
+
+    nystrom4_stages(h, x, yprime2, args, ws, k1_ready, q, v);
+    nystrom4_solution(h, ws, q, v, qnext, vnext);
+    /* last stage evaluated at the solution itself (FSAL) */
+    sys_params.x = x + h;
+    sys_params.y = qnext;
+    sys_params.extra_args = args;
+    sys_params.system_size = ws->system_size;
+    yprime2(&sys_params, ws->k4);
+    w[0] = (1.0 / 6);
+    w[1] = (- 1.0 / 6);
+    terms[0] = ws->k3;
+    terms[1] = ws->k4;
+    rarr_lincomb(ws->system_size, NULL, h, 2, w, terms, verr);
+    w[0] = (- h / 6);
+    w[1] = (h / 3);
+    w[2] = (- h / 6);
+    terms[0] = ws->k1;
+    terms[1] = ws->k2;
+    terms[2] = ws->k3;
+    rarr_lincomb(ws->system_size, NULL, h, 3, w, terms, qerr);
+}
+
+
+/** \brief Weighted root-mean-square norm of positions and velocities */
+static double
+rkn_weighted_norm(
+        RealWorkspaceRKN ws,
+        Rarray q,
+        Rarray qnext,
+        Rarray dq,
+        Rarray v,
+        Rarray vnext,
+        Rarray dv
+)
+{
+    int
+        i;
+    double
+        w,
+        e,
+        summ;
+    summ = 0;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        w = fmax(fabs(q[i]), fabs(qnext[i]));
+        e = dq[i] / (ws->abs_tol + ws->rel_tol * w);
+        summ = summ + e * e;
+        w = fmax(fabs(v[i]), fabs(vnext[i]));
+        e = dv[i] / (ws->abs_tol + ws->rel_tol * w);
+        summ = summ + e * e;
+    }
+    return sqrt(summ / (2 * ws->system_size));
+}
+
+
+/** \brief Initial step size estimate following ref. [3] sec. II.4
+ *
+ * The ratio of positions and velocities norms gives the time scale of
+ * the motion. The second derivative is kept in `k1` for the first step
+ */
+static double
+rkn_initial_step(
+        double x,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceRKN ws,
+        Rarray q,
+        Rarray v
+)
+{
+    double
+        d0,
+        d1,
+        d2,
+        h;
+    _RealODEInputParameters
+        sys_params;
+
+    sys_params.x = x;
+    sys_params.y = q;
+    sys_params.extra_args = args;
+    sys_params.system_size = ws->system_size;
+    yprime2(&sys_params, ws->k1);
+    ws->k1_ready = 1;
+
+    d0 = rkn_weighted_norm(ws, q, q, q, q, q, q);
+    d1 = rkn_weighted_norm(ws, q, q, v, q, q, v);
+    d2 = rkn_weighted_norm(ws, q, q, ws->k1, q, q, ws->k1);
+    if (d0 < 1E-5 || d1 < 1E-5) h = 1E-6;
+    else                        h = 0.01 * d0 / d1;
+    if (d2 > 1E-15 && d0 >= 1E-5) h = fmin(h, sqrt(0.01 * d0 / d2));
+    return h;
+}
+
+
+/** \brief Factor to scale step size based on error norm */
+static double
+step_factor(double err, int order)
+{
+    double
+        fac;
+    if (err == 0) return STEP_MAX_FACTOR;
+    fac = STEP_SAFETY * pow(err, -1.0 / (order + 1));
+    if (fac != fac || fac < STEP_MIN_FACTOR) return STEP_MIN_FACTOR;
+    if (fac > STEP_MAX_FACTOR) return STEP_MAX_FACTOR;
+    return fac;
+}
+
+
+int
+real_nystrom_adaptive_step(
+        double xend,
+        real_odesys_der2 yprime2,
+        void * args,
+        RealWorkspaceRKN ws,
+        double * x,
+        double * h,
+        Rarray q,
+        Rarray v
+)
+{
+    int
+        i,
+        last_rejected;
+    double
+        err,
+        fac,
+        hstep,
+        hfree;
+    Rarray
+        swap;
+
+    if (*h <= 0) *h = rkn_initial_step(*x, yprime2, args, ws, q, v);
+    hstep = *h;
+    last_rejected = 0;
+
+    while (1)
+    {
+        if (ws->h_max > 0 && hstep > ws->h_max) hstep = ws->h_max;
+        if (hstep < ws->h_min || *x + hstep == *x) return -1;
+        /* step before truncation at `xend`, kept for the next proposal */
+        hfree = hstep;
+        if (*x + hstep > xend) hstep = xend - *x;
+
+        real_nystrom43(
+                hstep, *x, yprime2, args, ws, ws->k1_ready,
+                q, v, ws->qnext, ws->vnext, ws->qerr, ws->verr
+        );
+        /* the derivative at `x` is kept even if the step is rejected */
+        ws->k1_ready = 1;
+
+        err = rkn_weighted_norm(
+                ws, q, ws->qnext, ws->qerr, v, ws->vnext, ws->verr
+        );
+        fac = step_factor(err, 3);
+        if (err <= 1) break;
+
+        ws->rejected++;
+        last_rejected = 1;
+        hstep = hstep * fac;
+    }
+
+    ws->accepted++;
+    *x = *x + hstep;
+    for (i = 0; i < ws->system_size; i++)
+    {
+        q[i] = ws->qnext[i];
+        v[i] = ws->vnext[i];
+    }
+
+    /* First Same As Last stage becomes first stage of next step */
+    swap = ws->k1;
+    ws->k1 = ws->k4;
+    ws->k4 = swap;
+
+    /* do not increase the step right after a rejection */
+    if (last_rejected && fac > 1) fac = 1;
+    *h = hstep * fac;
+    /* a step truncated at `xend` does not shrink the next one */
+    if (hstep < hfree) *h = fmax(*h, hfree);
+    return 0;
+}
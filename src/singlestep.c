@@ -17,64 +17,241 @@
  * differential equations, Cambridge, 2nd Edition, cap. 3
  */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include "singlestep.h"
-#include "arrays_assistant.h"
+#include "kernels.h"
+#include "stats_assistant.h"
+
+
+#define ARENA_PAGE 4096
+#define ARENA_GUARD 256
+
+
+/** \brief Distance in bytes between consecutive work arrays in arena
+ *
+ * Start from the array size rounded up to the alignment and increase
+ * it while two arrays start less than `ARENA_GUARD` bytes apart modulo
+ * page size, in which case loads and stores at the same index alias in
+ * the lowest 12 address bits and stall the memory pipeline
+ */
+static unsigned long
+arena_stride(unsigned long array_bytes, int nstages)
+{
+    int
+        i,
+        conflict;
+    unsigned long
+        r,
+        stride;
+    stride = (array_bytes + RK_WS_ALIGNMENT - 1) / RK_WS_ALIGNMENT;
+    stride = stride * RK_WS_ALIGNMENT;
+    do
+    {
+        conflict = 0;
+        for (i = 1; i < nstages; i++)
+        {
+            if (i * stride < ARENA_PAGE - ARENA_GUARD) continue;
+            r = (i * stride) % ARENA_PAGE;
+            if (r < ARENA_GUARD || r > ARENA_PAGE - ARENA_GUARD) conflict = 1;
+        }
+        if (conflict) stride = stride + RK_WS_ALIGNMENT;
+    } while (conflict);
+    return stride;
+}
+
+
+/** \brief Return aligned arena, allocated if `mem` is NULL */
+static char *
+arena_block(unsigned long bytes, void * mem, void ** owned)
+{
+    *owned = NULL;
+    if (mem != NULL)
+    {
+        if ((unsigned long) mem % RK_WS_ALIGNMENT != 0)
+        {
+            printf("\n\nRunge-Kutta workspace memory is not aligned to "
+                   "%d bytes\n\n", RK_WS_ALIGNMENT);
+            exit(EXIT_FAILURE);
+        }
+        return (char *) mem;
+    }
+    *owned = aligned_alloc(RK_WS_ALIGNMENT, bytes);
+    if (*owned == NULL)
+    {
+        printf("\n\nProblem in Runge-Kutta workspace arena allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    return (char *) *owned;
+}
+
+
+unsigned long
+cplx_rungekutta_ws_bytes(int sys_size, int nstages)
+{
+    return nstages * arena_stride(sys_size * sizeof(double complex), nstages);
+}
+
+
+unsigned long
+real_rungekutta_ws_bytes(int sys_size, int nstages)
+{
+    return nstages * arena_stride(sys_size * sizeof(double), nstages);
+}
+
+
+void
+set_cplx_rungekutta_wsarrays(ComplexWorkspaceRK ws, int nstages, void * mem)
+{
+    int
+        i;
+    unsigned long
+        stride;
+    char
+        * block;
+    Carray
+        * work[RK5_WS_STAGES];
+
+    if (nstages < 1 || nstages > RK5_WS_STAGES)
+    {
+        printf("\n\nInvalid number of Runge-Kutta work arrays %d\n\n", nstages);
+        exit(EXIT_FAILURE);
+    }
+    work[0] = &ws->work1;
+    work[1] = &ws->work2;
+    work[2] = &ws->work3;
+    work[3] = &ws->work4;
+    work[4] = &ws->work5;
+    work[5] = &ws->work6;
+    work[6] = &ws->work7;
+    stride = arena_stride(ws->system_size * sizeof(double complex), nstages);
+    block = arena_block(nstages * stride, mem, &ws->arena);
+    ws->nstages = nstages;
+    ws->nthreads = 1;
+    ws->stats = NULL;
+    for (i = 0; i < RK5_WS_STAGES; i++)
+    {
+        if (i < nstages) *work[i] = (Carray) (block + i * stride);
+        else             *work[i] = NULL;
+    }
+}
+
+
+void
+set_real_rungekutta_wsarrays(RealWorkspaceRK ws, int nstages, void * mem)
+{
+    int
+        i;
+    unsigned long
+        stride;
+    char
+        * block;
+    Rarray
+        * work[RK5_WS_STAGES];
+
+    if (nstages < 1 || nstages > RK5_WS_STAGES)
+    {
+        printf("\n\nInvalid number of Runge-Kutta work arrays %d\n\n", nstages);
+        exit(EXIT_FAILURE);
+    }
+    work[0] = &ws->work1;
+    work[1] = &ws->work2;
+    work[2] = &ws->work3;
+    work[3] = &ws->work4;
+    work[4] = &ws->work5;
+    work[5] = &ws->work6;
+    work[6] = &ws->work7;
+    stride = arena_stride(ws->system_size * sizeof(double), nstages);
+    block = arena_block(nstages * stride, mem, &ws->arena);
+    ws->nstages = nstages;
+    ws->nthreads = 1;
+    ws->stats = NULL;
+    for (i = 0; i < RK5_WS_STAGES; i++)
+    {
+        if (i < nstages) *work[i] = (Rarray) (block + i * stride);
+        else             *work[i] = NULL;
+    }
+}
 
 
 void
 alloc_cplx_rungekutta_wsarrays(ComplexWorkspaceRK ws)
 {
-    ws->work1 = alloc_carr(ws->system_size);
-    ws->work2 = alloc_carr(ws->system_size);
-    ws->work3 = alloc_carr(ws->system_size);
-    ws->work4 = alloc_carr(ws->system_size);
-    ws->work5 = alloc_carr(ws->system_size);
-    ws->work6 = alloc_carr(ws->system_size);
-    ws->work7 = alloc_carr(ws->system_size);
+    set_cplx_rungekutta_wsarrays(ws, RK5_WS_STAGES, NULL);
 }
 
 
 void
 alloc_real_rungekutta_wsarrays(RealWorkspaceRK ws)
 {
-    ws->work1 = alloc_rarr(ws->system_size);
-    ws->work2 = alloc_rarr(ws->system_size);
-    ws->work3 = alloc_rarr(ws->system_size);
-    ws->work4 = alloc_rarr(ws->system_size);
-    ws->work5 = alloc_rarr(ws->system_size);
-    ws->work6 = alloc_rarr(ws->system_size);
-    ws->work7 = alloc_rarr(ws->system_size);
+    set_real_rungekutta_wsarrays(ws, RK5_WS_STAGES, NULL);
 }
 
 
 void
 free_cplx_rungekutta_wsarrays(ComplexWorkspaceRK ws)
 {
-    if (ws->work1 != NULL) free(ws->work1);
-    if (ws->work2 != NULL) free(ws->work2);
-    if (ws->work3 != NULL) free(ws->work3);
-    if (ws->work4 != NULL) free(ws->work4);
-    if (ws->work5 != NULL) free(ws->work5);
-    if (ws->work6 != NULL) free(ws->work6);
-    if (ws->work7 != NULL) free(ws->work7);
+    if (ws->arena != NULL) free(ws->arena);
+    ws->arena = NULL;
 }
 
 
 void
 free_real_rungekutta_wsarrays(RealWorkspaceRK ws)
 {
-    if (ws->work1 != NULL) free(ws->work1);
-    if (ws->work2 != NULL) free(ws->work2);
-    if (ws->work3 != NULL) free(ws->work3);
-    if (ws->work4 != NULL) free(ws->work4);
-    if (ws->work5 != NULL) free(ws->work5);
-    if (ws->work6 != NULL) free(ws->work6);
-    if (ws->work7 != NULL) free(ws->work7);
+    if (ws->arena != NULL) free(ws->arena);
+    ws->arena = NULL;
+}
+
+
+void
+set_cplx_rungekutta_threads(ComplexWorkspaceRK ws, int nthreads)
+{
+    int
+        i;
+    Carray
+        work[RK5_WS_STAGES];
+
+    work[0] = ws->work1;
+    work[1] = ws->work2;
+    work[2] = ws->work3;
+    work[3] = ws->work4;
+    work[4] = ws->work5;
+    work[5] = ws->work6;
+    work[6] = ws->work7;
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    for (i = 0; i < ws->nstages; i++)
+    {
+        carr_first_touch(ws->nthreads, ws->system_size, work[i]);
+    }
+}
+
+
+void
+set_real_rungekutta_threads(RealWorkspaceRK ws, int nthreads)
+{
+    int
+        i;
+    Rarray
+        work[RK5_WS_STAGES];
+
+    work[0] = ws->work1;
+    work[1] = ws->work2;
+    work[2] = ws->work3;
+    work[3] = ws->work4;
+    work[4] = ws->work5;
+    work[5] = ws->work6;
+    work[6] = ws->work7;
+    ws->nthreads = nthreads < 1 ? 1 : nthreads;
+    for (i = 0; i < ws->nstages; i++)
+    {
+        rarr_first_touch(ws->nthreads, ws->system_size, work[i]);
+    }
 }
 
 
 ComplexWorkspaceRK
-get_cplx_rungekutta_ws(int sys_size)
+get_cplx_rungekutta_ws_arena(int sys_size, int nstages, void * mem)
 {
     ComplexWorkspaceRK
         ws = (ComplexWorkspaceRK) malloc(sizeof(_ComplexWorkspaceRK));
@@ -84,13 +261,13 @@ get_cplx_rungekutta_ws(int sys_size)
         exit(EXIT_FAILURE);
     }
     ws->system_size = sys_size;
-    alloc_cplx_rungekutta_wsarrays(ws);
+    set_cplx_rungekutta_wsarrays(ws, nstages, mem);
     return ws;
 }
 
 
 RealWorkspaceRK
-get_real_rungekutta_ws(int sys_size)
+get_real_rungekutta_ws_arena(int sys_size, int nstages, void * mem)
 {
     RealWorkspaceRK
         ws = (RealWorkspaceRK) malloc(sizeof(_RealWorkspaceRK));
@@ -100,11 +277,25 @@ get_real_rungekutta_ws(int sys_size)
         exit(EXIT_FAILURE);
     }
     ws->system_size = sys_size;
-    alloc_real_rungekutta_wsarrays(ws);
+    set_real_rungekutta_wsarrays(ws, nstages, mem);
     return ws;
 }
 
 
+ComplexWorkspaceRK
+get_cplx_rungekutta_ws(int sys_size)
+{
+    return get_cplx_rungekutta_ws_arena(sys_size, RK5_WS_STAGES, NULL);
+}
+
+
+RealWorkspaceRK
+get_real_rungekutta_ws(int sys_size)
+{
+    return get_real_rungekutta_ws_arena(sys_size, RK5_WS_STAGES, NULL);
+}
+
+
 void
 destroy_real_rungekutta_ws(RealWorkspaceRK ws)
 {
@@ -133,8 +324,10 @@ cplx_rungekutta5(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[5];
     Carray
         k1,
         k2,
@@ -142,11 +335,13 @@ cplx_rungekutta5(
         k4,
         k5,
         k6,
-        karg;
+        karg,
+        v[5];
     _ComplexODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     k3 = ws->work3;
@@ -154,55 +349,61 @@ cplx_rungekutta5(
     k5 = ws->work5;
     k6 = ws->work6;
     karg = ws->work7;
-    carr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* Start 5th order RungeKutta taken from Ref [2] table 236a p.103 */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 4) * k1[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 1;
+    v[0] = k1;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 4, 1, w, v, karg);
     sys_params.x = x + 0.25 * h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 8) * (k1[i] + k2[i]);
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 1;
+    w[1] = 1;
+    v[1] = k2;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 8, 2, w, v, karg);
     sys_params.x = x + 0.25 * h;
-    yprime(&sys_params, k3);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 2) * k3[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = 1;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 2, 1, w, &k3, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k4);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 16) * (
-                3 * k1[i] - 6 * k2[i] + 6 * k3[i] + 9 * k4[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = 3;
+    w[1] = - 6;
+    w[2] = 6;
+    w[3] = 9;
+    v[2] = k3;
+    v[3] = k4;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 16, 4, w, v, karg);
     sys_params.x = x + 0.75 * h;
-    yprime(&sys_params, k5);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 7) * (
-                - 3 * k1[i] + 8 * k2[i] + 6 * k3[i] - 12 * k4[i] + 8 * k5[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = - 3;
+    w[1] = 8;
+    w[2] = 6;
+    w[3] = - 12;
+    w[4] = 8;
+    v[4] = k5;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 7, 5, w, v, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k6);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + (h / 90) * (
-                7 * k1[i] + 32 * k3[i] + 12 * k4[i] + 32 * k5[i] + 7 * k6[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = 7;
+    w[1] = 32;
+    w[2] = 12;
+    w[3] = 32;
+    w[4] = 7;
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 90, 5, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
 
 
@@ -218,8 +419,10 @@ real_rungekutta5(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[5];
     Rarray
         k1,
         k2,
@@ -227,11 +430,13 @@ real_rungekutta5(
         k4,
         k5,
         k6,
-        karg;
+        karg,
+        v[5];
     _RealODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     k3 = ws->work3;
@@ -239,55 +444,61 @@ real_rungekutta5(
     k5 = ws->work5;
     k6 = ws->work6;
     karg = ws->work7;
-    rarr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* Start 5th order RungeKutta taken from Ref [2] table 236a p.103 */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 4) * k1[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 1;
+    v[0] = k1;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 4, 1, w, v, karg);
     sys_params.x = x + 0.25 * h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 8) * (k1[i] + k2[i]);
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 1;
+    w[1] = 1;
+    v[1] = k2;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 8, 2, w, v, karg);
     sys_params.x = x + 0.25 * h;
-    yprime(&sys_params, k3);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 2) * k3[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = 1;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 2, 1, w, &k3, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k4);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 16) * (
-                3 * k1[i] - 6 * k2[i] + 6 * k3[i] + 9 * k4[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = 3;
+    w[1] = - 6;
+    w[2] = 6;
+    w[3] = 9;
+    v[2] = k3;
+    v[3] = k4;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 16, 4, w, v, karg);
     sys_params.x = x + 0.75 * h;
-    yprime(&sys_params, k5);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = y[i] + (h / 7) * (
-                - 3 * k1[i] + 8 * k2[i] + 6 * k3[i] - 12 * k4[i] + 8 * k5[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k5));
+    w[0] = - 3;
+    w[1] = 8;
+    w[2] = 6;
+    w[3] = - 12;
+    w[4] = 8;
+    v[4] = k5;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 7, 5, w, v, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k6);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + (h / 90) * (
-                7 * k1[i] + 32 * k3[i] + 12 * k4[i] + 32 * k5[i] + 7 * k6[i]
-        );
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k6));
+    w[0] = 7;
+    w[1] = 32;
+    w[2] = 12;
+    w[3] = 32;
+    w[4] = 7;
+    v[1] = k3;
+    v[2] = k4;
+    v[3] = k5;
+    v[4] = k6;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 90, 5, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
 
 
@@ -303,54 +514,59 @@ cplx_rungekutta4(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[4];
     Carray
         k1,
         k2,
         k3,
         k4,
-        karg;
+        karg,
+        v[4];
     _ComplexODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     k3 = ws->work3;
     k4 = ws->work4;
     karg = ws->work5;
-    carr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* Start 4-th order Runge-Kutta algorithm as in Ref [1] Eq (2.11.5) */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = 0.5 * h * k1[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 0.5;
+    carr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k1, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = 0.5 * h * k2[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    carr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k2, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k3);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = h * k3[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = 1;
+    carr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k3, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k4);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) * h / 6;
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = 1;
+    w[1] = 2;
+    w[2] = 2;
+    w[3] = 1;
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    v[3] = k4;
+    carr_lincomb_threads(nthreads, sys_size, y, h / 6, 4, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
 
 
@@ -366,54 +582,59 @@ real_rungekutta4(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[4];
     Rarray
         k1,
         k2,
         k3,
         k4,
-        karg;
+        karg,
+        v[4];
     _RealODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     k3 = ws->work3;
     k4 = ws->work4;
     karg = ws->work5;
-    rarr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* Start 4-th order Runge-Kutta algorithm as in Ref [1] Eq (2.11.5) */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = 0.5 * h * k1[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 0.5;
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k1, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = 0.5 * h * k2[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k2, karg);
     sys_params.x = x + 0.5 * h;
-    yprime(&sys_params, k3);
-    for (i = 0; i < sys_size; i++)
-    {
-        karg[i] = h * k3[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k3));
+    w[0] = 1;
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k3, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k4);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]) * h / 6;
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k4));
+    w[0] = 1;
+    w[1] = 2;
+    w[2] = 2;
+    w[3] = 1;
+    v[0] = k1;
+    v[1] = k2;
+    v[2] = k3;
+    v[3] = k4;
+    rarr_lincomb_threads(nthreads, sys_size, y, h / 6, 4, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
 
 
@@ -429,38 +650,44 @@ cplx_rungekutta2(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[2];
     Carray
         k1,
         k2,
-        karg;
+        karg,
+        v[2];
     _ComplexODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     karg = ws->work3;
-    carr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* start 2nd order Runge-Kutta scheme as in Ref [1] Eq (2.5.2) */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for(i = 0; i < sys_size; i++)
-    {
-        karg[i] = h * k1[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 1;
+    carr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k1, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + 0.5 * h * (k1[i] + k2[i]);
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 0.5;
+    w[1] = 0.5;
+    v[0] = k1;
+    v[1] = k2;
+    carr_lincomb_threads(nthreads, sys_size, y, h, 2, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
 
 
@@ -476,36 +703,42 @@ real_rungekutta2(
 )
 {
     int
-        i,
-        sys_size;
+        sys_size,
+        nthreads;
+    double
+        w[2];
     Rarray
         k1,
         k2,
-        karg;
+        karg,
+        v[2];
     _RealODEInputParameters
         sys_params;
 
     sys_size = ws->system_size;
+    nthreads = ws->nthreads;
     k1 = ws->work1;
     k2 = ws->work2;
     karg = ws->work3;
-    rarr_copy_values(sys_size, y, karg);
 
-    sys_params.y = karg;
+    sys_params.y = y;
     sys_params.extra_args = args;
     sys_params.system_size = sys_size;
+    STATS_BEGIN(ws->stats);
 
     /* start 2nd order Runge-Kutta scheme as in Ref [1] Eq (2.5.2) */
     sys_params.x = x;
-    yprime(&sys_params, k1);
-    for(i = 0; i < sys_size; i++)
-    {
-        karg[i] = h * k1[i] + y[i];
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k1));
+    sys_params.y = karg;
+    w[0] = 1;
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 1, w, &k1, karg);
     sys_params.x = x + h;
-    yprime(&sys_params, k2);
-    for (i = 0; i < sys_size; i++)
-    {
-        ynext[i] = y[i] + 0.5 * h * (k1[i] + k2[i]);
-    }
+    STATS_RHS(ws->stats, yprime(&sys_params, k2));
+    w[0] = 0.5;
+    w[1] = 0.5;
+    v[0] = k1;
+    v[1] = k2;
+    rarr_lincomb_threads(nthreads, sys_size, y, h, 2, w, v, ynext);
+    STATS_ADD(ws->stats, steps, 1);
+    STATS_END(ws->stats);
 }
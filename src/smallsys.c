@@ -0,0 +1,380 @@
+/**
+ * \file smallsys.c
+ * \author Alex Andriati
+ * \brief Source code of routines specialized for small system sizes
+ *
+ * See function signature and description in header smallsys.h
+ * The routines are generated by macros for each size, where the loops
+ * over the system size have a constant trip count and are unrolled by
+ * the compiler. The stage combinations repeat the order of operations
+ * of the vector kernels, see kernels.c, and as the kernels this file
+ * must be compiled without floating point contraction (CMakeLists.txt)
+ */
+
+#include "smallsys.h"
+#include "adams_coefficients.h"
+
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define SMALL_LOOP(N) _Pragma("GCC unroll 8") for (i = 0; i < N; i++)
+#else
+#define SMALL_LOOP(N) for (i = 0; i < N; i++)
+#endif
+
+
+Carray
+cplx_small_prev_step(ComplexSmallHistory * hist, int j)
+{
+    return hist->y[(hist->head + j) % hist->ms_order];
+}
+
+
+Rarray
+real_small_prev_step(RealSmallHistory * hist, int j)
+{
+    return hist->y[(hist->head + j) % hist->ms_order];
+}
+
+
+#define SMALLSYS_DEFINE(PREFIX, T, DER, PARAMS, HIST, N)                    \
+void                                                                        \
+PREFIX##_rungekutta2_n##N(                                                  \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        T * y,                                                              \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i;                                                                  \
+    T                                                                       \
+        k1[N],                                                              \
+        k2[N],                                                              \
+        karg[N];                                                            \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    sys_params.y = y;                                                       \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    sys_params.x = x;                                                       \
+    yprime(&sys_params, k1);                                                \
+    sys_params.y = karg;                                                    \
+    SMALL_LOOP(N) karg[i] = y[i] + h * (1.0 * k1[i]);                       \
+    sys_params.x = x + h;                                                   \
+    yprime(&sys_params, k2);                                                \
+    SMALL_LOOP(N) ynext[i] = y[i] + h * (0.5 * k1[i] + 0.5 * k2[i]);        \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_rungekutta4_n##N(                                                  \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        T * y,                                                              \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i;                                                                  \
+    T                                                                       \
+        k1[N],                                                              \
+        k2[N],                                                              \
+        k3[N],                                                              \
+        k4[N],                                                              \
+        karg[N];                                                            \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    sys_params.y = y;                                                       \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    sys_params.x = x;                                                       \
+    yprime(&sys_params, k1);                                                \
+    sys_params.y = karg;                                                    \
+    SMALL_LOOP(N) karg[i] = y[i] + h * (0.5 * k1[i]);                       \
+    sys_params.x = x + 0.5 * h;                                             \
+    yprime(&sys_params, k2);                                                \
+    SMALL_LOOP(N) karg[i] = y[i] + h * (0.5 * k2[i]);                       \
+    sys_params.x = x + 0.5 * h;                                             \
+    yprime(&sys_params, k3);                                                \
+    SMALL_LOOP(N) karg[i] = y[i] + h * (1.0 * k3[i]);                       \
+    sys_params.x = x + h;                                                   \
+    yprime(&sys_params, k4);                                                \
+    SMALL_LOOP(N)                                                           \
+    {                                                                       \
+        ynext[i] = y[i] + h / 6 * (                                         \
+                1.0 * k1[i] + 2.0 * k2[i] + 2.0 * k3[i] + 1.0 * k4[i]       \
+        );                                                                  \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_rungekutta5_n##N(                                                  \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        T * y,                                                              \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i;                                                                  \
+    T                                                                       \
+        k1[N],                                                              \
+        k2[N],                                                              \
+        k3[N],                                                              \
+        k4[N],                                                              \
+        k5[N],                                                              \
+        k6[N],                                                              \
+        karg[N];                                                            \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    sys_params.y = y;                                                       \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    sys_params.x = x;                                                       \
+    yprime(&sys_params, k1);                                                \
+    sys_params.y = karg;                                                    \
+    SMALL_LOOP(N) karg[i] = y[i] + h / 4 * (1.0 * k1[i]);                   \
+    sys_params.x = x + 0.25 * h;                                            \
+    yprime(&sys_params, k2);                                                \
+    SMALL_LOOP(N) karg[i] = y[i] + h / 8 * (1.0 * k1[i] + 1.0 * k2[i]);     \
+    sys_params.x = x + 0.25 * h;                                            \
+    yprime(&sys_params, k3);                                                \
+    SMALL_LOOP(N) karg[i] = y[i] + h / 2 * (1.0 * k3[i]);                   \
+    sys_params.x = x + 0.5 * h;                                             \
+    yprime(&sys_params, k4);                                                \
+    SMALL_LOOP(N)                                                           \
+    {                                                                       \
+        karg[i] = y[i] + h / 16 * (                                         \
+                3.0 * k1[i] + (- 6.0) * k2[i] + 6.0 * k3[i] + 9.0 * k4[i]   \
+        );                                                                  \
+    }                                                                       \
+    sys_params.x = x + 0.75 * h;                                            \
+    yprime(&sys_params, k5);                                                \
+    SMALL_LOOP(N)                                                           \
+    {                                                                       \
+        karg[i] = y[i] + h / 7 * (                                          \
+                (- 3.0) * k1[i] + 8.0 * k2[i] + 6.0 * k3[i]                 \
+                + (- 12.0) * k4[i] + 8.0 * k5[i]                            \
+        );                                                                  \
+    }                                                                       \
+    sys_params.x = x + h;                                                   \
+    yprime(&sys_params, k6);                                                \
+    SMALL_LOOP(N)                                                           \
+    {                                                                       \
+        ynext[i] = y[i] + h / 90 * (                                        \
+                7.0 * k1[i] + 32.0 * k3[i] + 12.0 * k4[i]                   \
+                + 32.0 * k5[i] + 7.0 * k6[i]                                \
+        );                                                                  \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_small_multistep_init_n##N(                                         \
+        double h,                                                           \
+        double x0,                                                          \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        int ms_order,                                                       \
+        T * y0,                                                             \
+        HIST * hist                                                         \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i,                                                                  \
+        j;                                                                  \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    hist->ms_order = ms_order;                                              \
+    hist->head = 0;                                                         \
+    j = ms_order - 1;                                                       \
+    SMALL_LOOP(N) hist->y[j][i] = y0[i];                                    \
+    sys_params.x = x0;                                                      \
+    sys_params.y = hist->y[j];                                              \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    yprime(&sys_params, hist->der[j]);                                      \
+    for (j = ms_order - 2; j >= 0; j--)                                     \
+    {                                                                       \
+        if (ms_order == 4)                                                  \
+        {                                                                   \
+            PREFIX##_rungekutta4_n##N(                                      \
+                    h, sys_params.x, yprime, args, hist->y[j + 1], hist->y[j]\
+            );                                                              \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            PREFIX##_rungekutta5_n##N(                                      \
+                    h, sys_params.x, yprime, args, hist->y[j + 1], hist->y[j]\
+            );                                                              \
+        }                                                                   \
+        sys_params.x = x0 + (ms_order - 1 - j) * h;                         \
+        sys_params.y = hist->y[j];                                          \
+        yprime(&sys_params, hist->der[j]);                                  \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+                                                                            \
+static void                                                                 \
+PREFIX##_small_general_n##N(                                                \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        HIST * hist,                                                        \
+        double * a,                                                         \
+        double * b,                                                         \
+        unsigned int iter,                                                  \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i,                                                                  \
+        j,                                                                  \
+        k,                                                                  \
+        m,                                                                  \
+        n,                                                                  \
+        row;                                                                \
+    double                                                                  \
+        w[2 * SMALLSYS_MAX_ORDER + 1];                                      \
+    T                                                                       \
+        acc,                                                                \
+        * v[2 * SMALLSYS_MAX_ORDER + 1];                                    \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    /* same terms of `*_general_multistep`, at most 8 (a kernel pass) */    \
+    m = hist->ms_order;                                                     \
+    n = 0;                                                                  \
+    for (j = 1; j <= m; j++)                                                \
+    {                                                                       \
+        row = (hist->head + j - 1) % m;                                     \
+        if (b[j] != 0)                                                      \
+        {                                                                   \
+            n++;                                                            \
+            w[n] = h * b[j];                                                \
+            v[n] = hist->der[row];                                          \
+        }                                                                   \
+        if (a[j] != 0)                                                      \
+        {                                                                   \
+            n++;                                                            \
+            w[n] = - a[j];                                                  \
+            v[n] = hist->y[row];                                            \
+        }                                                                   \
+    }                                                                       \
+    if (!iter)                                                              \
+    {                                                                       \
+        SMALL_LOOP(N)                                                       \
+        {                                                                   \
+            acc = 0;                                                        \
+            for (k = 1; k <= n; k++) acc = acc + w[k] * v[k][i];            \
+            ynext[i] = 1.0 * acc;                                           \
+        }                                                                   \
+        return;                                                             \
+    }                                                                       \
+    sys_params.x = x + h;                                                   \
+    sys_params.y = ynext;                                                   \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    w[0] = h * b[0];                                                        \
+    v[0] = hist->der[m];                                                    \
+    while (iter > 0)                                                        \
+    {                                                                       \
+        yprime(&sys_params, hist->der[m]);                                  \
+        SMALL_LOOP(N)                                                       \
+        {                                                                   \
+            acc = w[0] * v[0][i];                                           \
+            for (k = 1; k <= n; k++) acc = acc + w[k] * v[k][i];            \
+            ynext[i] = 1.0 * acc;                                           \
+        }                                                                   \
+        iter--;                                                             \
+    }                                                                       \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_adams4pc_n##N(                                                     \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        HIST * hist,                                                        \
+        unsigned int iter,                                                  \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    PREFIX##_small_general_n##N(                                            \
+            h, x, yprime, args, hist, ADAMS4_LEFT, ADAMS4_PRED, 0, ynext    \
+    );                                                                      \
+    if (iter == 0) return;                                                  \
+    PREFIX##_small_general_n##N(                                            \
+            h, x, yprime, args, hist, ADAMS4_LEFT, ADAMS4_CORR, iter, ynext \
+    );                                                                      \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_adams6pc_n##N(                                                     \
+        double h,                                                           \
+        double x,                                                           \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        HIST * hist,                                                        \
+        unsigned int iter,                                                  \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    PREFIX##_small_general_n##N(                                            \
+            h, x, yprime, args, hist, ADAMS6_LEFT, ADAMS6_PRED, 0, ynext    \
+    );                                                                      \
+    if (iter == 0) return;                                                  \
+    PREFIX##_small_general_n##N(                                            \
+            h, x, yprime, args, hist, ADAMS6_LEFT, ADAMS6_CORR, iter, ynext \
+    );                                                                      \
+}                                                                           \
+                                                                            \
+                                                                            \
+void                                                                        \
+PREFIX##_small_set_next_n##N(                                               \
+        double xnext,                                                       \
+        DER yprime,                                                         \
+        void * args,                                                        \
+        HIST * hist,                                                        \
+        T * ynext                                                           \
+)                                                                           \
+{                                                                           \
+    int                                                                     \
+        i;                                                                  \
+    PARAMS                                                                  \
+        sys_params;                                                         \
+                                                                            \
+    hist->head = (hist->head + hist->ms_order - 1) % hist->ms_order;        \
+    SMALL_LOOP(N) hist->y[hist->head][i] = ynext[i];                        \
+    sys_params.x = xnext;                                                   \
+    sys_params.y = hist->y[hist->head];                                     \
+    sys_params.extra_args = args;                                           \
+    sys_params.system_size = N;                                             \
+    yprime(&sys_params, hist->der[hist->head]);                             \
+}
+
+
+#define SMALLSYS_DEFINE_REAL(N) SMALLSYS_DEFINE(                            \
+        real, double, real_odesys_der, _RealODEInputParameters,             \
+        RealSmallHistory, N)
+#define SMALLSYS_DEFINE_CPLX(N) SMALLSYS_DEFINE(                            \
+        cplx, double complex, cplx_odesys_der, _ComplexODEInputParameters,  \
+        ComplexSmallHistory, N)
+
+SMALLSYS_SIZES(SMALLSYS_DEFINE_REAL)
+SMALLSYS_SIZES(SMALLSYS_DEFINE_CPLX)
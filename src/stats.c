@@ -0,0 +1,91 @@
+/**
+ * \file stats.c
+ * \author Alex Andriati
+ * \brief Source code of integration counters and timers
+ *
+ * See function signature and description in header stats.h
+ * The counters are updated inside the integration routines through the
+ * macros of stats_assistant.h, here are only the struct management and
+ * the export routines
+ */
+
+#include <stdlib.h>
+#include "stats_assistant.h"
+
+
+IntegratorStats
+get_integrator_stats(void)
+{
+    IntegratorStats
+        stats;
+    stats = (IntegratorStats) malloc(sizeof(_IntegratorStats));
+    if (stats == NULL)
+    {
+        printf("\n\nProblem in IntegratorStats allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    reset_integrator_stats(stats);
+    return stats;
+}
+
+
+void
+reset_integrator_stats(IntegratorStats stats)
+{
+    stats->rhs_calls = 0;
+    stats->steps = 0;
+    stats->rejected = 0;
+    stats->iterations = 0;
+    stats->jac_evals = 0;
+    stats->lu_decomps = 0;
+    stats->rhs_ticks = 0;
+    stats->step_ticks = 0;
+    stats->depth = 0;
+    stats->start = 0;
+}
+
+
+void
+destroy_integrator_stats(IntegratorStats stats)
+{
+    free(stats);
+}
+
+
+int
+integrator_stats_enabled(void)
+{
+#ifdef ODESYS_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+
+int
+integrator_stats_json(IntegratorStats stats, FILE * out)
+{
+    int
+        n;
+    unsigned long long
+        library_ticks;
+
+    library_ticks = 0;
+    if (stats->step_ticks > stats->rhs_ticks)
+    {
+        library_ticks = stats->step_ticks - stats->rhs_ticks;
+    }
+    n = fprintf(out,
+            "{\"enabled\": %s, \"tick_unit\": \"%s\", "
+            "\"rhs_calls\": %lu, \"steps\": %lu, \"rejected\": %lu, "
+            "\"iterations\": %lu, \"jac_evals\": %lu, "
+            "\"lu_decomps\": %lu, \"rhs_ticks\": %llu, "
+            "\"step_ticks\": %llu, \"library_ticks\": %llu}\n",
+            integrator_stats_enabled() ? "true" : "false", STATS_TICK_UNIT,
+            stats->rhs_calls, stats->steps, stats->rejected,
+            stats->iterations, stats->jac_evals, stats->lu_decomps,
+            stats->rhs_ticks, stats->step_ticks, library_ticks
+    );
+    return n < 0 ? -1 : 0;
+}
@@ -0,0 +1,796 @@
+/**
+ * \file tableau.c
+ * \author Alex Andriati
+ * \brief Source code for Runge-Kutta methods given by Butcher tableau
+ *
+ * See function signature and description in header tableau.h
+ * The coefficients of the library were checked against all order
+ * conditions (rooted trees) up to the order of each solution. Refs
+ *
+ * [1] J.C. Butcher, Numerical methods for ordinary differential equations,
+ * Wiley, 3rd Edition
+ * [2] E. Hairer, S.P. Norsett and G. Wanner, Solving Ordinary Differential
+ * Equations I, Springer, 2nd Edition
+ * [3] J.H. Verner, Explicit Runge-Kutta methods with estimates of the
+ * local truncation error, SIAM J. Numer. Anal. 15 (1978) 772-790
+ * [4] Ch. Tsitouras, Runge-Kutta pairs of order 5(4) satisfying only the
+ * first column simplifying assumption, Comput. Math. Appl. 62 (2011)
+ * 770-775
+ * [5] E. Fehlberg, Classical fifth-, sixth-, seventh-, and eighth-order
+ * Runge-Kutta formulas with stepsize control, NASA TR R-287 (1968)
+ * [6] J.H. Verner, Numerically optimal Runge-Kutta pairs with
+ * interpolants, Numer. Algorithms 53 (2010) 383-396
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "tableau.h"
+#include "singlestep.h"
+#include "kernels.h"
+
+
+/* Heun's method of `*_rungekutta2`, ref. [2] sec. II.1 */
+static const double
+    HEUN_RK2_A[4] = {
+    0, 0,
+    1.0, 0
+};
+
+static const double
+    HEUN_RK2_B[2] = {
+    1.0 / 2, 1.0 / 2
+};
+
+static const double
+    HEUN_RK2_C[2] = {
+    0, 1.0
+};
+
+/* Classical method of `*_rungekutta4`, ref. [2] sec. II.1 */
+static const double
+    RK4_A[16] = {
+    0, 0, 0, 0,
+    1.0 / 2, 0, 0, 0,
+    0, 1.0 / 2, 0, 0,
+    0, 0, 1.0, 0
+};
+
+static const double
+    RK4_B[4] = {
+    1.0 / 6, 1.0 / 3, 1.0 / 3, 1.0 / 6
+};
+
+static const double
+    RK4_C[4] = {
+    0, 1.0 / 2, 1.0 / 2, 1.0
+};
+
+/* 3/8-rule of Kutta, ref. [2] sec. II.1 */
+static const double
+    RK4_38_A[16] = {
+    0, 0, 0, 0,
+    1.0 / 3, 0, 0, 0,
+    - 1.0 / 3, 1.0, 0, 0,
+    1.0, - 1.0, 1.0, 0
+};
+
+static const double
+    RK4_38_B[4] = {
+    1.0 / 8, 3.0 / 8, 3.0 / 8, 1.0 / 8
+};
+
+static const double
+    RK4_38_C[4] = {
+    0, 1.0 / 3, 2.0 / 3, 1.0
+};
+
+/* Same as `*_rungekutta5`, ref. [1] table 236a */
+static const double
+    BUTCHER_RK5_A[36] = {
+    0, 0, 0, 0, 0, 0,
+    1.0 / 4, 0, 0, 0, 0, 0,
+    1.0 / 8, 1.0 / 8, 0, 0, 0, 0,
+    0, 0, 1.0 / 2, 0, 0, 0,
+    3.0 / 16, - 3.0 / 8, 3.0 / 8, 9.0 / 16, 0, 0,
+    - 3.0 / 7, 8.0 / 7, 6.0 / 7, - 12.0 / 7, 8.0 / 7, 0
+};
+
+static const double
+    BUTCHER_RK5_B[6] = {
+    7.0 / 90, 0, 16.0 / 45, 2.0 / 15, 16.0 / 45, 7.0 / 90
+};
+
+static const double
+    BUTCHER_RK5_C[6] = {
+    0, 1.0 / 4, 1.0 / 4, 1.0 / 2, 3.0 / 4, 1.0
+};
+
+/* Ref. [2] table 5.2 */
+static const double
+    DOPRI5_A[49] = {
+    0, 0, 0, 0, 0, 0, 0,
+    1.0 / 5, 0, 0, 0, 0, 0, 0,
+    3.0 / 40, 9.0 / 40, 0, 0, 0, 0, 0,
+    44.0 / 45, - 56.0 / 15, 32.0 / 9, 0, 0, 0, 0,
+    19372.0 / 6561, - 25360.0 / 2187, 64448.0 / 6561, - 212.0 / 729, 0, 0, 0,
+    9017.0 / 3168, - 355.0 / 33, 46732.0 / 5247, 49.0 / 176, - 5103.0 / 18656,
+    0, 0,
+    35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, - 2187.0 / 6784, 11.0 / 84, 0
+};
+
+static const double
+    DOPRI5_B[7] = {
+    35.0 / 384, 0, 500.0 / 1113, 125.0 / 192, - 2187.0 / 6784, 11.0 / 84, 0
+};
+
+static const double
+    DOPRI5_C[7] = {
+    0, 1.0 / 5, 3.0 / 10, 4.0 / 5, 8.0 / 9, 1.0, 1.0
+};
+
+static const double
+    DOPRI5_BHAT[7] = {
+    5179.0 / 57600, 0, 7571.0 / 16695, 393.0 / 640, - 92097.0 / 339200,
+    187.0 / 2100, 1.0 / 40
+};
+
+/* Ref. [1], order 6 with 7 stages and rational coefficients */
+static const double
+    BUTCHER_RK6_A[49] = {
+    0, 0, 0, 0, 0, 0, 0,
+    1.0 / 3, 0, 0, 0, 0, 0, 0,
+    0, 2.0 / 3, 0, 0, 0, 0, 0,
+    1.0 / 12, 1.0 / 3, - 1.0 / 12, 0, 0, 0, 0,
+    - 1.0 / 16, 9.0 / 8, - 3.0 / 16, - 3.0 / 8, 0, 0, 0,
+    0, 9.0 / 8, - 3.0 / 8, - 3.0 / 4, 1.0 / 2, 0, 0,
+    9.0 / 44, - 9.0 / 11, 63.0 / 44, 18.0 / 11, 0, - 16.0 / 11, 0
+};
+
+static const double
+    BUTCHER_RK6_B[7] = {
+    11.0 / 120, 0, 27.0 / 40, 27.0 / 40, - 4.0 / 15, - 4.0 / 15, 11.0 / 120
+};
+
+static const double
+    BUTCHER_RK6_C[7] = {
+    0, 1.0 / 3, 2.0 / 3, 1.0 / 3, 1.0 / 2, 1.0 / 2, 1.0
+};
+
+/* Ref. [3], the 6(5) pair of DVERK */
+static const double
+    VERNER_65_A[64] = {
+    0, 0, 0, 0, 0, 0, 0, 0,
+    1.0 / 6, 0, 0, 0, 0, 0, 0, 0,
+    4.0 / 75, 16.0 / 75, 0, 0, 0, 0, 0, 0,
+    5.0 / 6, - 8.0 / 3, 5.0 / 2, 0, 0, 0, 0, 0,
+    - 165.0 / 64, 55.0 / 6, - 425.0 / 64, 85.0 / 96, 0, 0, 0, 0,
+    12.0 / 5, - 8.0, 4015.0 / 612, - 11.0 / 36, 88.0 / 255, 0, 0, 0,
+    - 8263.0 / 15000, 124.0 / 75, - 643.0 / 680, - 81.0 / 250, 2484.0 / 10625,
+    0, 0, 0,
+    3501.0 / 1720, - 300.0 / 43, 297275.0 / 52632, - 319.0 / 2322,
+    24068.0 / 84065, 0, 3850.0 / 26703, 0
+};
+
+static const double
+    VERNER_65_B[8] = {
+    3.0 / 40, 0, 875.0 / 2244, 23.0 / 72, 264.0 / 1955, 0, 125.0 / 11592,
+    43.0 / 616
+};
+
+static const double
+    VERNER_65_C[8] = {
+    0, 1.0 / 6, 4.0 / 15, 2.0 / 3, 5.0 / 6, 1.0, 1.0 / 15, 1.0
+};
+
+static const double
+    VERNER_65_BHAT[8] = {
+    13.0 / 160, 0, 2375.0 / 5984, 5.0 / 16, 12.0 / 85, 3.0 / 44, 0, 0
+};
+
+/* Ref. [4] with the embedded weights of its error estimate */
+static const double
+    TSIT5_A[49] = {
+    0, 0, 0, 0, 0, 0, 0,
+    0.161, 0, 0, 0, 0, 0, 0,
+    - 0.008480655492356989, 0.335480655492357, 0, 0, 0, 0, 0,
+    2.897153057105493, - 6.359448489975075, 4.3622954328695815, 0, 0, 0, 0,
+    5.325864828439257, - 11.748883564062828, 7.4955393428898365,
+    - 0.09249506636175525, 0, 0, 0,
+    5.86145544294642, - 12.92096931784711, 8.159367898576159,
+    - 0.071584973281401, - 0.028269050394068383, 0, 0,
+    0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742,
+    - 3.290069515436081, 2.324710524099774, 0
+};
+
+static const double
+    TSIT5_B[7] = {
+    0.09646076681806523, 0.01, 0.4798896504144996, 1.379008574103742,
+    - 3.290069515436081, 2.324710524099774, 0
+};
+
+static const double
+    TSIT5_C[7] = {
+    0, 0.161, 0.327, 0.9, 0.9800255409045097, 1.0, 1.0
+};
+
+static const double
+    TSIT5_BHAT[7] = {
+    0.09824077787029101, 0.010816434459656746, 0.4720087724042376,
+    1.5237195812770048, - 3.872426680888636, 2.7827926300289607,
+    - 0.015151515151515152
+};
+
+/* Ref. [5], see also ref. [2] sec. II.5 */
+static const double
+    FEHLBERG_78_A[169] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    2.0 / 27, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1.0 / 36, 1.0 / 12, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1.0 / 24, 0, 1.0 / 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    5.0 / 12, 0, - 25.0 / 16, 25.0 / 16, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1.0 / 20, 0, 0, 1.0 / 4, 1.0 / 5, 0, 0, 0, 0, 0, 0, 0, 0,
+    - 25.0 / 108, 0, 0, 125.0 / 108, - 65.0 / 27, 125.0 / 54, 0, 0, 0, 0, 0,
+    0, 0,
+    31.0 / 300, 0, 0, 0, 61.0 / 225, - 2.0 / 9, 13.0 / 900, 0, 0, 0, 0, 0, 0,
+    2.0, 0, 0, - 53.0 / 6, 704.0 / 45, - 107.0 / 9, 67.0 / 90, 3.0, 0, 0, 0,
+    0, 0,
+    - 91.0 / 108, 0, 0, 23.0 / 108, - 976.0 / 135, 311.0 / 54, - 19.0 / 60,
+    17.0 / 6, - 1.0 / 12, 0, 0, 0, 0,
+    2383.0 / 4100, 0, 0, - 341.0 / 164, 4496.0 / 1025, - 301.0 / 82,
+    2133.0 / 4100, 45.0 / 82, 45.0 / 164, 18.0 / 41, 0, 0, 0,
+    3.0 / 205, 0, 0, 0, 0, - 6.0 / 41, - 3.0 / 205, - 3.0 / 41, 3.0 / 41,
+    6.0 / 41, 0, 0, 0,
+    - 1777.0 / 4100, 0, 0, - 341.0 / 164, 4496.0 / 1025, - 289.0 / 82,
+    2193.0 / 4100, 51.0 / 82, 33.0 / 164, 12.0 / 41, 0, 1.0, 0
+};
+
+static const double
+    FEHLBERG_78_B[13] = {
+    41.0 / 840, 0, 0, 0, 0, 34.0 / 105, 9.0 / 35, 9.0 / 35, 9.0 / 280,
+    9.0 / 280, 41.0 / 840, 0, 0
+};
+
+static const double
+    FEHLBERG_78_C[13] = {
+    0, 2.0 / 27, 1.0 / 9, 1.0 / 6, 5.0 / 12, 1.0 / 2, 5.0 / 6, 1.0 / 6,
+    2.0 / 3, 1.0 / 3, 1.0, 0, 1.0
+};
+
+static const double
+    FEHLBERG_78_BHAT[13] = {
+    0, 0, 0, 0, 0, 34.0 / 105, 9.0 / 35, 9.0 / 35, 9.0 / 280, 9.0 / 280, 0,
+    41.0 / 840, 41.0 / 840
+};
+
+
+/* Ref. [6], the most efficient 7(6) pair */
+static const double
+    VERNER_76_A[100] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0.005, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    - 1.07679012345679, 1.185679012345679, 0, 0, 0, 0, 0, 0, 0, 0,
+    0.04083333333333333, 0, 0.1225, 0, 0, 0, 0, 0, 0, 0,
+    0.6389139236255726, 0, - 2.455672638223657, 2.272258714598084, 0, 0, 0, 0,
+    0, 0,
+    - 2.6615773750187572, 0, 10.804513886456137, - 8.3539146573962,
+    0.820487594956657, 0, 0, 0, 0, 0,
+    6.067741434696772, 0, - 24.711273635911088, 20.427517930788895,
+    - 1.9061579788166472, 1.006172249242068, 0, 0, 0, 0,
+    12.054670076253203, 0, - 49.75478495046899, 41.142888638604674,
+    - 4.461760149974004, 2.042334822239175, - 0.09834843665406107, 0, 0, 0,
+    10.138146522881808, 0, - 42.6411360317175, 35.76384003992257,
+    - 4.348022840392907, 2.0098622683770357, 0.3487490460338272,
+    - 0.27143900510483127, 0, 0,
+    - 45.030072034298676, 0, 187.3272437654589, - 154.02882369350186,
+    18.56465306347536, - 7.141809679295079, 1.3088085781613787, 0, 0, 0
+};
+
+static const double
+    VERNER_76_B[10] = {
+    0.04715561848627222, 0, 0, 0.25750564298434153, 0.26216653977412624,
+    0.15216092656738558, 0.4939969170032485, - 0.29430311714032503,
+    0.08131747232495111, 0
+};
+
+static const double
+    VERNER_76_C[10] = {
+    0, 0.005, 0.10888888888888888, 0.16333333333333333, 0.4555,
+    0.6095094489978381, 0.884, 0.925, 1.0, 1.0
+};
+
+static const double
+    VERNER_76_BHAT[10] = {
+    0.044608606606341174, 0, 0, 0.26716403785713727, 0.22010183001772932,
+    0.2188431703143157, 0.22898717054112028, 0, 0, 0.02029518466335628
+};
+
+/* Ref. [6], the most efficient 8(7) pair */
+static const double
+    VERNER_87_A[169] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0.05, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    - 0.0069931640625, 0.1135556640625, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0.0399609375, 0, 0.1198828125, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0.36139756280045754, 0, - 1.3415240667004928, 1.3701265039000352, 0, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0.049047202797202795, 0, 0, 0.23509720422144048, 0.18085559298135673, 0, 0,
+    0, 0, 0, 0, 0, 0,
+    0.06169289044289044, 0, 0, 0.11236568314640277, - 0.03885046071451367,
+    0.01979188712522046, 0, 0, 0, 0, 0, 0, 0,
+    - 1.767630240222327, 0, 0, - 62.5, - 6.061889377376669, 5.6508231982227635,
+    65.62169641937624, 0, 0, 0, 0, 0, 0,
+    - 1.1809450665549708, 0, 0, - 41.50473441114321, - 4.434438319103725,
+    4.260408188586133, 43.75364022446172, 0.00787142548991231, 0, 0, 0, 0, 0,
+    - 1.2814059994414884, 0, 0, - 45.047139960139866, - 4.731362069449577,
+    4.514967016593808, 47.44909557172985, 0.010592282971116612,
+    - 0.0057468422638446166, 0, 0, 0, 0,
+    - 1.7244701342624853, 0, 0, - 60.92349008483054, - 5.951518376222393,
+    5.556523730698456, 63.98301198033305, 0.014642028250414961,
+    0.06460408772358203, - 0.0793032316900888, 0, 0, 0,
+    - 3.301622667747079, 0, 0, - 118.01127235975251, - 10.141422388456112,
+    9.139311332232058, 123.37594282840426, 4.62324437887458,
+    - 3.3832777380682018, 4.527592100324618, - 5.828495485811623, 0, 0,
+    - 3.039515033766309, 0, 0, - 109.26086808941763, - 9.290642497400293,
+    8.43050498176491, 114.20100103783314, - 0.9637271342145479,
+    - 5.0348840888021895, 5.958130824002923, 0, 0, 0
+};
+
+static const double
+    VERNER_87_B[13] = {
+    0.04427989419007951, 0, 0, 0, 0, 0.3541049391724449, 0.2479692154956438,
+    - 15.694202038838084, 25.084064965558564, - 31.738367786260277,
+    22.938283273988784, - 0.2361324633071542, 0
+};
+
+static const double
+    VERNER_87_C[13] = {
+    0, 0.05, 0.1065625, 0.15984375, 0.39, 0.465, 0.155, 0.943,
+    0.901802041735857, 0.909, 0.94, 1.0, 1.0
+};
+
+static const double
+    VERNER_87_BHAT[13] = {
+    0.044312615229089795, 0, 0, 0, 0, 0.35460956423432266, 0.2478480431366653,
+    4.4481347324757845, 19.846886366118735, - 23.58162337746562, 0, 0,
+    - 0.36016794372897754
+};
+
+const ButcherTableau TABLEAU_HEUN_RK2 = {
+    "heun_rk2", 2, 2, 0, 0, HEUN_RK2_A, HEUN_RK2_B, HEUN_RK2_C, NULL
+};
+
+const ButcherTableau TABLEAU_RK4 = {
+    "rk4", 4, 4, 0, 0, RK4_A, RK4_B, RK4_C, NULL
+};
+
+const ButcherTableau TABLEAU_RK4_38 = {
+    "rk4_38", 4, 4, 0, 0, RK4_38_A, RK4_38_B, RK4_38_C, NULL
+};
+
+const ButcherTableau TABLEAU_BUTCHER_RK5 = {
+    "butcher_rk5", 6, 5, 0, 0,
+    BUTCHER_RK5_A, BUTCHER_RK5_B, BUTCHER_RK5_C, NULL
+};
+
+const ButcherTableau TABLEAU_DORMAND_PRINCE_54 = {
+    "dormand_prince_54", 7, 5, 4, 1, DOPRI5_A, DOPRI5_B, DOPRI5_C, DOPRI5_BHAT
+};
+
+const ButcherTableau TABLEAU_TSITOURAS_54 = {
+    "tsitouras_54", 7, 5, 4, 1, TSIT5_A, TSIT5_B, TSIT5_C, TSIT5_BHAT
+};
+
+const ButcherTableau TABLEAU_BUTCHER_RK6 = {
+    "butcher_rk6", 7, 6, 0, 0,
+    BUTCHER_RK6_A, BUTCHER_RK6_B, BUTCHER_RK6_C, NULL
+};
+
+const ButcherTableau TABLEAU_VERNER_65 = {
+    "verner_65", 8, 6, 5, 0,
+    VERNER_65_A, VERNER_65_B, VERNER_65_C, VERNER_65_BHAT
+};
+
+const ButcherTableau TABLEAU_FEHLBERG_78 = {
+    "fehlberg_78", 13, 7, 8, 0,
+    FEHLBERG_78_A, FEHLBERG_78_B, FEHLBERG_78_C, FEHLBERG_78_BHAT
+};
+
+const ButcherTableau TABLEAU_VERNER_76 = {
+    "verner_76", 10, 7, 6, 0,
+    VERNER_76_A, VERNER_76_B, VERNER_76_C, VERNER_76_BHAT
+};
+
+const ButcherTableau TABLEAU_VERNER_87 = {
+    "verner_87", 13, 8, 7, 0,
+    VERNER_87_A, VERNER_87_B, VERNER_87_C, VERNER_87_BHAT
+};
+
+
+/** \brief Collect nonzero coefficients of tableau in rows of terms
+ *
+ * See the workspace struct in tableau.h for the layout of the rows
+ */
+static void
+set_terms(
+        const ButcherTableau * tab,
+        int * nterms,
+        int * term_stage,
+        double * term_weight
+)
+{
+    int
+        i,
+        j,
+        n,
+        s;
+    double
+        coef;
+
+    s = tab->stages;
+    for (i = 0; i < s + 2; i++)
+    {
+        n = 0;
+        for (j = 0; j < s; j++)
+        {
+            if (i < s)
+            {
+                if (j >= i) break;
+                coef = tab->a[i * s + j];
+            }
+            else if (i == s) coef = tab->b[j];
+            else if (tab->bhat != NULL) coef = tab->b[j] - tab->bhat[j];
+            else coef = 0;
+            if (coef != 0)
+            {
+                term_stage[i * s + n] = j;
+                term_weight[i * s + n] = coef;
+                n++;
+            }
+        }
+        nterms[i] = n;
+    }
+}
+
+
+/** \brief Alloc coefficient rows and work arrays in a single block each
+ *
+ * The work arrays follow the layout of the Runge-Kutta workspace arena
+ * with `stages + 1` arrays, the last one for the stage arguments
+ */
+static void *
+alloc_tableau_arrays(
+        const ButcherTableau * tab,
+        unsigned long bytes,
+        int ** nterms,
+        int ** term_stage,
+        double ** term_weight
+)
+{
+    int
+        s;
+    void
+        * arena;
+
+    s = tab->stages;
+    if (s < 1)
+    {
+        printf("\n\nInvalid number of tableau stages %d\n\n", s);
+        exit(EXIT_FAILURE);
+    }
+    *nterms = (int *) malloc((s + 2) * sizeof(int));
+    *term_stage = (int *) malloc((s + 2) * s * sizeof(int));
+    *term_weight = (double *) malloc((s + 2) * s * sizeof(double));
+    arena = aligned_alloc(RK_WS_ALIGNMENT, bytes);
+    if (*nterms == NULL || *term_stage == NULL || *term_weight == NULL
+            || arena == NULL)
+    {
+        printf("\n\nProblem in tableau workspace allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    set_terms(tab, *nterms, *term_stage, *term_weight);
+    return arena;
+}
+
+
+ComplexWorkspaceTableau
+get_cplx_tableau_ws(int sys_size, const ButcherTableau * tab)
+{
+    int
+        i;
+    unsigned long
+        bytes,
+        stride;
+    ComplexWorkspaceTableau
+        ws;
+
+    ws = (ComplexWorkspaceTableau) malloc(sizeof(_ComplexWorkspaceTableau));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in ComplexWorkspaceTableau allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    bytes = cplx_rungekutta_ws_bytes(sys_size, tab->stages + 1);
+    stride = bytes / (tab->stages + 1);
+    ws->system_size = sys_size;
+    ws->stages = tab->stages;
+    ws->tableau = tab;
+    ws->arena = alloc_tableau_arrays(
+            tab, bytes, &ws->nterms, &ws->term_stage, &ws->term_weight
+    );
+    ws->k = (Carray *) malloc(2 * tab->stages * sizeof(Carray));
+    if (ws->k == NULL)
+    {
+        printf("\n\nProblem in tableau workspace allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->v = ws->k + tab->stages;
+    for (i = 0; i < tab->stages; i++)
+    {
+        ws->k[i] = (Carray) ((char *) ws->arena + i * stride);
+    }
+    ws->karg = (Carray) ((char *) ws->arena + tab->stages * stride);
+    return ws;
+}
+
+
+RealWorkspaceTableau
+get_real_tableau_ws(int sys_size, const ButcherTableau * tab)
+{
+    int
+        i;
+    unsigned long
+        bytes,
+        stride;
+    RealWorkspaceTableau
+        ws;
+
+    ws = (RealWorkspaceTableau) malloc(sizeof(_RealWorkspaceTableau));
+    if (ws == NULL)
+    {
+        printf("\n\nProblem in RealWorkspaceTableau allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    bytes = real_rungekutta_ws_bytes(sys_size, tab->stages + 1);
+    stride = bytes / (tab->stages + 1);
+    ws->system_size = sys_size;
+    ws->stages = tab->stages;
+    ws->tableau = tab;
+    ws->arena = alloc_tableau_arrays(
+            tab, bytes, &ws->nterms, &ws->term_stage, &ws->term_weight
+    );
+    ws->k = (Rarray *) malloc(2 * tab->stages * sizeof(Rarray));
+    if (ws->k == NULL)
+    {
+        printf("\n\nProblem in tableau workspace allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    ws->v = ws->k + tab->stages;
+    for (i = 0; i < tab->stages; i++)
+    {
+        ws->k[i] = (Rarray) ((char *) ws->arena + i * stride);
+    }
+    ws->karg = (Rarray) ((char *) ws->arena + tab->stages * stride);
+    return ws;
+}
+
+
+void
+destroy_cplx_tableau_ws(ComplexWorkspaceTableau ws)
+{
+    free(ws->k);
+    free(ws->arena);
+    free(ws->term_weight);
+    free(ws->term_stage);
+    free(ws->nterms);
+    free(ws);
+}
+
+
+void
+destroy_real_tableau_ws(RealWorkspaceTableau ws)
+{
+    free(ws->k);
+    free(ws->arena);
+    free(ws->term_weight);
+    free(ws->term_stage);
+    free(ws->nterms);
+    free(ws);
+}
+
+
+void
+cplx_tableau_swap_fsal(ComplexWorkspaceTableau ws)
+{
+    Carray
+        tmp;
+    tmp = ws->k[0];
+    ws->k[0] = ws->k[ws->stages - 1];
+    ws->k[ws->stages - 1] = tmp;
+}
+
+
+void
+real_tableau_swap_fsal(RealWorkspaceTableau ws)
+{
+    Rarray
+        tmp;
+    tmp = ws->k[0];
+    ws->k[0] = ws->k[ws->stages - 1];
+    ws->k[ws->stages - 1] = tmp;
+}
+
+
+/** \brief Set arrays of row terms in `ws->v` and return the weights */
+static double *
+cplx_row_terms(ComplexWorkspaceTableau ws, int row)
+{
+    int
+        n,
+        s;
+    s = ws->stages;
+    for (n = 0; n < ws->nterms[row]; n++)
+    {
+        ws->v[n] = ws->k[ws->term_stage[row * s + n]];
+    }
+    return ws->term_weight + row * s;
+}
+
+
+/** \brief Set arrays of row terms in `ws->v` and return the weights */
+static double *
+real_row_terms(RealWorkspaceTableau ws, int row)
+{
+    int
+        n,
+        s;
+    s = ws->stages;
+    for (n = 0; n < ws->nterms[row]; n++)
+    {
+        ws->v[n] = ws->k[ws->term_stage[row * s + n]];
+    }
+    return ws->term_weight + row * s;
+}
+
+
+void
+cplx_tableau_step(
+        double h,
+        double x,
+        cplx_odesys_der yprime,
+        void * args,
+        ComplexWorkspaceTableau ws,
+        int k1_ready,
+        Carray y,
+        Carray ynext,
+        Carray yerr
+)
+{
+    int
+        i,
+        j,
+        s,
+        sys_size;
+    double
+        * w;
+    Carray
+        karg;
+    const ButcherTableau
+        * tab;
+    _ComplexODEInputParameters
+        sys_params;
+
+    tab = ws->tableau;
+    s = ws->stages;
+    sys_size = ws->system_size;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    sys_params.x = x;
+    if (!k1_ready) yprime(&sys_params, ws->k[0]);
+    for (i = 1; i < s; i++)
+    {
+        /* the last stage argument of FSAL tableau is the solution */
+        if (tab->fsal && i == s - 1) karg = ynext;
+        else                         karg = ws->karg;
+        if (ws->nterms[i] > 0)
+        {
+            w = cplx_row_terms(ws, i);
+            carr_lincomb(sys_size, y, h, ws->nterms[i], w, ws->v, karg);
+            sys_params.y = karg;
+        }
+        else
+        {
+            for (j = 0; j < sys_size; j++) karg[j] = y[j];
+            sys_params.y = karg;
+        }
+        sys_params.x = x + tab->c[i] * h;
+        yprime(&sys_params, ws->k[i]);
+    }
+    if (!tab->fsal || s == 1)
+    {
+        w = cplx_row_terms(ws, s);
+        carr_lincomb(sys_size, y, h, ws->nterms[s], w, ws->v, ynext);
+    }
+    if (yerr == NULL || tab->bhat == NULL) return;
+    if (ws->nterms[s + 1] == 0)
+    {
+        for (j = 0; j < sys_size; j++) yerr[j] = 0;
+        return;
+    }
+    w = cplx_row_terms(ws, s + 1);
+    carr_lincomb(sys_size, NULL, h, ws->nterms[s + 1], w, ws->v, yerr);
+}
+
+
+void
+real_tableau_step(
+        double h,
+        double x,
+        real_odesys_der yprime,
+        void * args,
+        RealWorkspaceTableau ws,
+        int k1_ready,
+        Rarray y,
+        Rarray ynext,
+        Rarray yerr
+)
+{
+    int
+        i,
+        j,
+        s,
+        sys_size;
+    double
+        * w;
+    Rarray
+        karg;
+    const ButcherTableau
+        * tab;
+    _RealODEInputParameters
+        sys_params;
+
+    tab = ws->tableau;
+    s = ws->stages;
+    sys_size = ws->system_size;
+
+    sys_params.y = y;
+    sys_params.extra_args = args;
+    sys_params.system_size = sys_size;
+
+    sys_params.x = x;
+    if (!k1_ready) yprime(&sys_params, ws->k[0]);
+    for (i = 1; i < s; i++)
+    {
+        /* the last stage argument of FSAL tableau is the solution */
+        if (tab->fsal && i == s - 1) karg = ynext;
+        else                         karg = ws->karg;
+        if (ws->nterms[i] > 0)
+        {
+            w = real_row_terms(ws, i);
+            rarr_lincomb(sys_size, y, h, ws->nterms[i], w, ws->v, karg);
+            sys_params.y = karg;
+        }
+        else
+        {
+            for (j = 0; j < sys_size; j++) karg[j] = y[j];
+            sys_params.y = karg;
+        }
+        sys_params.x = x + tab->c[i] * h;
+        yprime(&sys_params, ws->k[i]);
+    }
+    if (!tab->fsal || s == 1)
+    {
+        w = real_row_terms(ws, s);
+        rarr_lincomb(sys_size, y, h, ws->nterms[s], w, ws->v, ynext);
+    }
+    if (yerr == NULL || tab->bhat == NULL) return;
+    if (ws->nterms[s + 1] == 0)
+    {
+        for (j = 0; j < sys_size; j++) yerr[j] = 0;
+        return;
+    }
+    w = real_row_terms(ws, s + 1);
+    rarr_lincomb(sys_size, NULL, h, ws->nterms[s + 1], w, ws->v, yerr);
+}
@@ -0,0 +1,344 @@
+/**
+ * \file trajectory.c
+ * \author Alex Andriati
+ * \brief Source code of binary trajectory sink and reader
+ *
+ * See function signature and description in header trajectory.h
+ * The two buffers alternate between the client (appending records) and
+ * the writer thread. Handing over a buffer takes the lock only once per
+ * buffer, and the writer thread is the only one doing system calls
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "trajectory.h"
+
+#define TRAJECTORY_MAGIC "ODESYSTR"
+#define TRAJECTORY_ENDIAN_TAG 0x01020304u
+
+/** \brief Default size in bytes of each buffer */
+#define TRAJECTORY_BUFFER_BYTES (4 * 1024 * 1024)
+
+
+/** \brief Write all bytes, resuming after partial writes or signals */
+static int
+write_all(int fd, const char * data, size_t nbytes)
+{
+    ssize_t
+        n;
+    while (nbytes > 0)
+    {
+        n = write(fd, data, nbytes);
+        if (n < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        nbytes -= n;
+    }
+    return 0;
+}
+
+
+/** \brief Writer thread: write buffers handed over until sink closes */
+static void *
+trajectory_writer(void * arg)
+{
+    size_t
+        nbytes;
+    Rarray
+        buf;
+    RealTrajectorySink
+        sink;
+
+    sink = (RealTrajectorySink) arg;
+    pthread_mutex_lock(&sink->lock);
+    while (1)
+    {
+        while (sink->inflight == NULL && !sink->closing)
+        {
+            pthread_cond_wait(&sink->work, &sink->lock);
+        }
+        if (sink->inflight == NULL) break;
+        buf = sink->inflight;
+        nbytes = sink->ninflight * (sink->ncomp + 1) * sizeof(double);
+        pthread_mutex_unlock(&sink->lock);
+
+        if (write_all(sink->fd, (const char *) buf, nbytes) != 0)
+        {
+            sink->status = -1;
+        }
+
+        pthread_mutex_lock(&sink->lock);
+        sink->inflight = NULL;
+        pthread_cond_signal(&sink->done);
+    }
+    pthread_mutex_unlock(&sink->lock);
+    return NULL;
+}
+
+
+/** \brief Hand active buffer to writer thread and switch to the other */
+static void
+trajectory_hand_over(RealTrajectorySink sink)
+{
+    unsigned int
+        record_size;
+    record_size = sink->ncomp + 1;
+    pthread_mutex_lock(&sink->lock);
+    /* the other buffer must be released by the writer */
+    while (sink->inflight != NULL)
+    {
+        pthread_cond_wait(&sink->done, &sink->lock);
+    }
+    sink->inflight = sink->active;
+    sink->ninflight = sink->nfill;
+    pthread_cond_signal(&sink->work);
+    pthread_mutex_unlock(&sink->lock);
+    if (sink->active == sink->buffers)
+    {
+        sink->active = &sink->buffers[sink->capacity * record_size];
+    }
+    else
+    {
+        sink->active = sink->buffers;
+    }
+    sink->nfill = 0;
+}
+
+
+RealTrajectorySink
+open_real_trajectory(
+        const char * fname,
+        int sys_size,
+        int ncomp,
+        const int * comp,
+        unsigned int every,
+        unsigned int capacity
+)
+{
+    int
+        i,
+        fd,
+        all;
+    uint32_t
+        * header;
+    size_t
+        header_bytes;
+    RealTrajectorySink
+        sink;
+
+    all = ncomp <= 0 || comp == NULL;
+    if (all) ncomp = sys_size;
+    if (every == 0) every = 1;
+    if (capacity == 0)
+    {
+        capacity = TRAJECTORY_BUFFER_BYTES / ((ncomp + 1) * sizeof(double));
+        if (capacity == 0) capacity = 1;
+    }
+
+    fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return NULL;
+
+    sink = (RealTrajectorySink) malloc(sizeof(_RealTrajectorySink));
+    header_bytes = 8 + (4 + ncomp) * sizeof(uint32_t);
+    header = (uint32_t *) malloc(header_bytes);
+    if (sink == NULL || header == NULL)
+    {
+        printf("\n\nProblem in RealTrajectorySink allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    sink->comp = (int *) malloc(ncomp * sizeof(int));
+    sink->buffers = (Rarray) malloc(
+            2 * (size_t) capacity * (ncomp + 1) * sizeof(double)
+    );
+    if (sink->comp == NULL || sink->buffers == NULL)
+    {
+        printf("\n\nProblem in RealTrajectorySink allocation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    sink->fd = fd;
+    sink->system_size = sys_size;
+    sink->ncomp = ncomp;
+    sink->closing = 0;
+    sink->status = 0;
+    sink->every = every;
+    sink->calls = 0;
+    sink->capacity = capacity;
+    sink->nfill = 0;
+    sink->ninflight = 0;
+    sink->active = sink->buffers;
+    sink->inflight = NULL;
+    for (i = 0; i < ncomp; i++)
+    {
+        sink->comp[i] = all ? i : comp[i];
+    }
+
+    memcpy(header, TRAJECTORY_MAGIC, 8);
+    header[2] = TRAJECTORY_VERSION;
+    header[3] = TRAJECTORY_ENDIAN_TAG;
+    header[4] = ncomp;
+    header[5] = sys_size;
+    for (i = 0; i < ncomp; i++) header[6 + i] = sink->comp[i];
+    if (write_all(fd, (const char *) header, header_bytes) != 0)
+    {
+        free(header);
+        free(sink->buffers);
+        free(sink->comp);
+        free(sink);
+        close(fd);
+        return NULL;
+    }
+    free(header);
+
+    pthread_mutex_init(&sink->lock, NULL);
+    pthread_cond_init(&sink->work, NULL);
+    pthread_cond_init(&sink->done, NULL);
+    if (pthread_create(&sink->writer, NULL, &trajectory_writer, sink) != 0)
+    {
+        printf("\n\nProblem in trajectory writer thread creation\n\n");
+        exit(EXIT_FAILURE);
+    }
+    return sink;
+}
+
+
+void
+real_trajectory_append(RealTrajectorySink sink, double x, Rarray y)
+{
+    int
+        i;
+    Rarray
+        rec;
+
+    if (sink->calls++ % sink->every != 0) return;
+    rec = &sink->active[sink->nfill * (sink->ncomp + 1)];
+    rec[0] = x;
+    for (i = 0; i < sink->ncomp; i++) rec[i + 1] = y[sink->comp[i]];
+    sink->nfill++;
+    if (sink->nfill == sink->capacity) trajectory_hand_over(sink);
+}
+
+
+int
+close_real_trajectory(RealTrajectorySink sink)
+{
+    int
+        status;
+
+    if (sink->nfill > 0) trajectory_hand_over(sink);
+    pthread_mutex_lock(&sink->lock);
+    sink->closing = 1;
+    pthread_cond_signal(&sink->work);
+    pthread_mutex_unlock(&sink->lock);
+    pthread_join(sink->writer, NULL);
+
+    status = sink->status;
+    if (close(sink->fd) != 0) status = -1;
+    pthread_cond_destroy(&sink->done);
+    pthread_cond_destroy(&sink->work);
+    pthread_mutex_destroy(&sink->lock);
+    free(sink->buffers);
+    free(sink->comp);
+    free(sink);
+    return status;
+}
+
+
+static uint32_t
+swap_uint32(uint32_t v)
+{
+    return ((v & 0xFFu) << 24) | ((v & 0xFF00u) << 8)
+         | ((v >> 8) & 0xFF00u) | (v >> 24);
+}
+
+
+long
+real_trajectory_to_csv(const char * fname, FILE * out)
+{
+    int
+        fd,
+        swap,
+        b;
+    uint32_t
+        ncomp,
+        head[4];
+    size_t
+        i,
+        j,
+        nrec,
+        file_bytes,
+        header_bytes;
+    unsigned char
+        * data,
+        * src,
+        * dst;
+    double
+        v;
+    struct stat
+        st;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) return -1;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < 8 + sizeof(head))
+    {
+        close(fd);
+        return -1;
+    }
+    file_bytes = st.st_size;
+    data = (unsigned char *) mmap(NULL, file_bytes, PROT_READ, MAP_PRIVATE,
+            fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return -1;
+
+    memcpy(head, data + 8, sizeof(head));
+    swap = head[1] != TRAJECTORY_ENDIAN_TAG;
+    if (swap)
+    {
+        for (i = 0; i < 4; i++) head[i] = swap_uint32(head[i]);
+    }
+    ncomp = head[2];
+    header_bytes = 8 + (4 + (size_t) ncomp) * sizeof(uint32_t);
+    if (memcmp(data, TRAJECTORY_MAGIC, 8) != 0
+            || head[0] != TRAJECTORY_VERSION
+            || head[1] != TRAJECTORY_ENDIAN_TAG
+            || file_bytes < header_bytes)
+    {
+        munmap(data, file_bytes);
+        return -1;
+    }
+
+    fprintf(out, "x");
+    for (i = 0; i < ncomp; i++)
+    {
+        memcpy(&head[3], data + 8 + (4 + i) * sizeof(uint32_t), 4);
+        if (swap) head[3] = swap_uint32(head[3]);
+        fprintf(out, ",y%u", head[3]);
+    }
+    fprintf(out, "\n");
+
+    /* an incomplete last record of interrupted run is ignored */
+    nrec = (file_bytes - header_bytes) / ((ncomp + 1) * sizeof(double));
+    src = data + header_bytes;
+    dst = (unsigned char *) &v;
+    for (i = 0; i < nrec; i++)
+    {
+        for (j = 0; j <= ncomp; j++)
+        {
+            if (swap) for (b = 0; b < 8; b++) dst[b] = src[7 - b];
+            else      memcpy(dst, src, 8);
+            src += 8;
+            fprintf(out, j == 0 ? "%.17g" : ",%.17g", v);
+        }
+        fprintf(out, "\n");
+    }
+    munmap(data, file_bytes);
+    return nrec;
+}